@@ -0,0 +1,175 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Round trip time of GATT requests issued in parallel on two ATT bearers.
+
+The headset answers a request on the bearer it was received on
+(headset_gatt.h): a slow Fast Pair Key-based Pairing write on one bearer
+shall not delay a Device Information read on another. For each round this
+tool sends the write on the fixed ATT channel and, right after, the read on
+an Enhanced ATT bearer, then reports the round trip time of both against the
+read alone:
+
+    gatt_latency.py <LE PEER> [ROUNDS]
+
+PEER is le:ADDR or le-random:ADDR. The headset shall be built with
+EATT_ENABLE=1 and FASTPAIR_ENABLE=1. The host needs a Linux kernel with
+enhanced credit based L2CAP channels (bluetooth module enable_ecred=1), the
+link is encrypted for the EATT bearer, the host pairs with the headset if
+needed. bluetoothd shall not hold the ATT channel of the link.
+
+The Key-based Pairing write carries random bytes, the headset tries every
+stored account key before rejecting it. Fast Pair providers ignore the
+writes after about ten failures until they restart, ROUNDS defaults to 5.
+"""
+import os
+import select
+import socket
+import statistics
+import sys
+import time
+from struct import pack
+
+from spp_bulk import (_le_peer, ResponseError, SOL_BLUETOOTH, BT_SECURITY, BT_SECURITY_MEDIUM, BT_RCVMTU,
+                      ATT_CID, ATT_MTU, ATT_READ_REQ, ATT_READ_RSP, ATT_ERROR_RSP)
+
+KEY_PAIRING_HANDLE = 0x72   # HANDLE_FASTPAIR_SERVICE_CHAR_KEY_PAIRING_VAL
+MFR_NAME_HANDLE = 0x42      # HANDLE_HSENS_DEV_INFO_SERVICE_CHAR_MFR_NAME_VAL
+EATT_PSM = 0x0027
+ROUNDS = 5
+TIMEOUT = 5.0
+
+# Linux Bluetooth socket constants
+BT_MODE = 15
+BT_MODE_EXT_FLOWCTL = 0x04
+
+ATT_WRITE_REQ = 0x12
+ATT_WRITE_RSP = 0x13
+
+
+def _bearer(address, address_type, eatt):
+    sock = socket.socket(socket.AF_BLUETOOTH, socket.SOCK_SEQPACKET, socket.BTPROTO_L2CAP)
+    try:
+        sock.setsockopt(SOL_BLUETOOTH, BT_RCVMTU, ATT_MTU)
+        if eatt:
+            sock.setsockopt(SOL_BLUETOOTH, BT_MODE, BT_MODE_EXT_FLOWCTL)
+            sock.setsockopt(SOL_BLUETOOTH, BT_SECURITY, pack("<BB", BT_SECURITY_MEDIUM, 0))
+            sock.connect((address, EATT_PSM, 0, address_type))
+        else:
+            sock.connect((address, 0, ATT_CID, address_type))
+    except (OSError, TypeError):
+        sock.close()
+        raise
+    return sock
+
+
+def _requests(pending):
+    """Wait for the response of every {socket: (opcode, start)}, return
+    {socket: round trip time in ms}. An error response also ends a request."""
+    rtt = {}
+    deadline = time.perf_counter() + TIMEOUT
+    while len(rtt) < len(pending):
+        waiting = [sock for sock in pending if sock not in rtt]
+        readable, _, _ = select.select(waiting, [], [], max(0, deadline - time.perf_counter()))
+        if not readable:
+            raise ResponseError("no response within %.0f s" % TIMEOUT)
+        for sock in readable:
+            pdu = sock.recv(65536)
+            now = time.perf_counter()
+            if not pdu:
+                raise ConnectionError("connection closed")
+            # Notifications and indications of the headset are skipped.
+            if pdu[0] in (pending[sock][0], ATT_ERROR_RSP):
+                rtt[sock] = (now - pending[sock][1]) * 1000
+    return rtt
+
+
+def measure(peer, rounds=ROUNDS):
+    """Return {"read alone", "read", "write": [round trip times in ms]}."""
+    le = _le_peer(peer)
+    if le is None:
+        raise ValueError("GATT needs an le: or le-random: peer")
+    att = _bearer(le[0], le[1], False)
+    try:
+        eatt = _bearer(le[0], le[1], True)
+    except OSError:
+        att.close()
+        raise
+    read = pack("<BH", ATT_READ_REQ, MFR_NAME_HANDLE)
+    results = {"read alone": [], "read": [], "write": []}
+    try:
+        for _ in range(rounds):
+            eatt.send(read)
+            rtt = _requests({eatt: (ATT_READ_RSP, time.perf_counter())})
+            results["read alone"].append(rtt[eatt])
+
+            att.send(pack("<BH", ATT_WRITE_REQ, KEY_PAIRING_HANDLE) + os.urandom(16))
+            write_start = time.perf_counter()
+            eatt.send(read)
+            rtt = _requests({att: (ATT_WRITE_RSP, write_start), eatt: (ATT_READ_RSP, time.perf_counter())})
+            results["write"].append(rtt[att])
+            results["read"].append(rtt[eatt])
+    finally:
+        eatt.close()
+        att.close()
+    return results
+
+
+def main(argv):
+    if not argv:
+        print(__doc__)
+        return 2
+
+    rounds = int(argv[1]) if len(argv) > 1 else ROUNDS
+    if rounds < 1:
+        print(__doc__)
+        return 2
+
+    try:
+        results = measure(argv[0], rounds)
+    except ResponseError as error:
+        print("Error: %s" % error)
+        return 1
+
+    print("Request                          min ms   mean ms    max ms")
+    for name, label in (("read alone", "Read, EATT, alone"),
+                        ("read", "Read, EATT, during the write"),
+                        ("write", "Key-based Pairing write, ATT")):
+        values = results[name]
+        print("%-30s %8.1f %9.1f %9.1f" % (label, min(values), statistics.mean(values), max(values)))
+    delay = statistics.mean(results["read"]) - statistics.mean(results["read alone"])
+    print("Read delayed by the write: %.1f ms (write takes %.1f ms)" % (delay, statistics.mean(results["write"])))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -37,7 +37,8 @@ import traceback
 import re
 import sys
 import time
-from enum import Enum, IntEnum
+from collections import namedtuple
+from enum import Enum, IntEnum, IntFlag
 from struct import pack, unpack
 
 import serial
@@ -144,6 +145,17 @@ class CommandID(IntEnum):
     PUSH_NVRAM = (GROUP_HCI_AUDIO << 8) | 0x03
     BT_START = (GROUP_HCI_AUDIO << 8) | 0x04
     BUTTON = (GROUP_HCI_AUDIO << 8) | 0x30
+    AFH_WIFI_CHANNELS = (GROUP_HCI_AUDIO << 8) | 0x40
+    AFH_CLASSIFICATION = (GROUP_HCI_AUDIO << 8) | 0x41
+    AFH_BLOCKLIST = (GROUP_HCI_AUDIO << 8) | 0x42
+    AVRC_INFO = (GROUP_HCI_AUDIO << 8) | 0x43
+    WARM_RESTART = (GROUP_HCI_AUDIO << 8) | 0x44
+    CAPABILITIES = (GROUP_HCI_AUDIO << 8) | 0x45
+    STATS = (GROUP_HCI_AUDIO << 8) | 0x46
+    FASTPAIR_PROFILE = (GROUP_HCI_AUDIO << 8) | 0x47
+    P256_BENCH = (GROUP_HCI_AUDIO << 8) | 0x48
+    TIMELINE = (GROUP_HCI_AUDIO << 8) | 0x49
+    TUNING = (GROUP_HCI_AUDIO << 8) | 0x4A
 
 class EventID(Enum):
     DEVICE_STARTED = (GROUP_DEVICE << 8) | 0x05
@@ -159,8 +171,56 @@ class EventID(Enum):
     STREAM_MIC_GAIN = (GROUP_HCI_AUDIO << 8 ) | 0x07
     WRITE_NVRAM_DATA = (GROUP_HCI_AUDIO << 8 ) | 0x08
     DELETE_NVRAM_DATA = (GROUP_HCI_AUDIO << 8 ) | 0x09
+    AFH_BLOCKLIST = (GROUP_HCI_AUDIO << 8 ) | 0x40
+    AVRC_INFO = (GROUP_HCI_AUDIO << 8 ) | 0x41
+    WARM_RESTART = (GROUP_HCI_AUDIO << 8 ) | 0x42
+    CAPABILITIES = (GROUP_HCI_AUDIO << 8 ) | 0x43
+    STATS = (GROUP_HCI_AUDIO << 8 ) | 0x44
+    FASTPAIR_PROFILE = (GROUP_HCI_AUDIO << 8 ) | 0x45
+    P256_BENCH = (GROUP_HCI_AUDIO << 8 ) | 0x46
+    TIMELINE = (GROUP_HCI_AUDIO << 8 ) | 0x47
+    TUNING = (GROUP_HCI_AUDIO << 8 ) | 0x48
     COMMAND_COMPLETED = 0x0E
 
+# Reasons of a channel in the AFH host channel blocklist
+AFH_BLOCK_WIFI = 0x01
+AFH_BLOCK_LE_ADV = 0x02
+
+class Capability(IntFlag):
+    AUDIO_SN_HEADER = 0x01
+    AUDIO_AGGREGATION = 0x02
+    AUDIO_COMPRESSION = 0x04
+    FLOW_CREDITS = 0x08
+    STATS = 0x10
+    WARM_RESTART = 0x20
+    AVRC_INFO = 0x40
+    AFH = 0x80
+    FASTPAIR_PROFILE = 0x100
+    TIMELINE = 0x200
+    TUNING = 0x400
+
+# Transport options this host implements.
+HOST_CAPABILITIES = Capability.AUDIO_SN_HEADER
+
+Capabilities = namedtuple(
+    "Capabilities", "version flags baud_default baud_max mic_buffer_len"
+)
+
+# Fast Pair profile steps, in the order reported by the device.
+FASTPAIR_STEPS = ("ecdh", "key_pairing", "passkey", "account_key")
+
+FastPairStep = namedtuple("FastPairStep", "count last_us max_us total_us")
+
+FastPairKeys = namedtuple(
+    "FastPairKeys", "key_num store_len chunks reads chunk_writes chunk_skips"
+)
+
+P256_BENCH_STATUS = {1: "busy", 2: "failed"}
+
+P256Bench = namedtuple(
+    "P256Bench", "iterations rom_base_us fast_base_us rom_var_us fast_var_us mismatches"
+)
+
 class BthciCmdCBB(IntEnum):
     RESET = BTHCI_CMD_OGF_CONTROLLER_AND_BASEBAND << 10 | 0x003
     UPDATE_BAUD_RATE = BTHCI_CMD_OGF_VENDOR_SPECIFIC << 10 | 0x018
@@ -202,10 +262,18 @@ class Error(Exception):
 
 
 class Controller:
-    def __init__(self, port, baudrate):
+    def __init__(self, port, baudrate, discover=False):
         self.event_queue = queue.Queue()
         self.command_result_event_queue = queue.Queue()
         self.audio_queue = queue.Queue()
+        # Callable receiving (event id, payload) of the audio events instead
+        # of audio_queue, called on the reader thread. It shall not drop the
+        # stream and NVRAM events, it may only block briefly for them.
+        self.audio_sink = None
+        self.app_event_queue = queue.Queue()
+        self.capabilities = None
+        # Defaults for a device which does not report its capabilities
+        self.audio_sn_included = True
 
         logger.info("Opening {0} at {1:,} bps ...".format(port, baudrate))
         try:
@@ -225,11 +293,16 @@ class Controller:
             self.read_thread.start()
             protocol = self.read_thread.connect()[1]
             protocol.event_received = self.event_received
+            self.protocol = protocol
         except (ValueError, serial.SerialException) as exc:
             self.read_thread = None
+            self.protocol = None
             logger.error("Failed to open HCI: %s", exc)
             raise Error("Failed to open {0} at {1:,} bps".format(port, baudrate))
 
+        if discover:
+            self.discover()
+
     def __del__(self):
         self.close()
 
@@ -259,7 +332,10 @@ class Controller:
               event_id == EventID.STREAM_MIC_GAIN or \
               event_id == EventID.WRITE_NVRAM_DATA or \
               event_id == EventID.DELETE_NVRAM_DATA):
-            self.audio_queue.put((event_id.value, payload))
+            if self.audio_sink:
+                self.audio_sink((event_id.value, payload))
+            else:
+                self.audio_queue.put((event_id.value, payload))
         elif (event_id == EventID.SCRIPT_RET_CODE or event_id == EventID.SCRIPT_UNKNOWN_CMD):
             logger.debug("Received %s, length: %s, %s", event_id, len(payload), payload)
             self.command_result_event_queue.put((event_id, payload))
@@ -268,6 +344,19 @@ class Controller:
         elif event_id == EventID.DEVICE_STARTED:
             logger.debug("Received %s", event_id)
             self.event_queue.put((event_id, payload))
+        elif event_id in (
+            EventID.AFH_BLOCKLIST,
+            EventID.AVRC_INFO,
+            EventID.WARM_RESTART,
+            EventID.CAPABILITIES,
+            EventID.STATS,
+            EventID.FASTPAIR_PROFILE,
+            EventID.P256_BENCH,
+            EventID.TIMELINE,
+            EventID.TUNING,
+        ):
+            logger.debug("Received %s, length: %s", event_id, len(payload))
+            self.app_event_queue.put((event_id, payload))
         else:
             logger.warning(
                 "Skip event: 0x{0:04x}, length: {1}, {2}".format(
@@ -280,7 +369,9 @@ class Controller:
 
     def write(self, command, payload):
         data = pack("<BHH", HCI_PACKET_INDICATOR_WICED, command, len(payload)) + payload
-        logger.verbose("UART TX[%s]:" + " %02x" * len(data), len(data), *data)
+        # Checked first, the arguments are built even when VERBOSE is disabled
+        if logger.isEnabledFor(logging.VERBOSE):
+            logger.verbose("UART TX[%s]:" + " %02x" * len(data), len(data), *data)
         self.read_thread.write(data)
 
     def read_event(self, t):
@@ -293,7 +384,8 @@ class Controller:
 
     def bthci_write(self, command, payload=b""):
         data = pack("<BHB", HCI_PACKET_INDICATOR_BTHCI, command, len(payload)) + payload
-        logger.verbose("UART TX[%s]:" + " %02x" * len(data), len(data), *data)
+        if logger.isEnabledFor(logging.VERBOSE):
+            logger.verbose("UART TX[%s]:" + " %02x" * len(data), len(data), *data)
         self.read_thread.write(data)
         try:
             event, payload = self.event_queue.get(timeout=1)
@@ -381,11 +473,139 @@ class Controller:
     def start_bt(self):
         self.write(CommandID.BT_START, b'')
 
+    def request(self, command, payload, event_id, timeout=1):
+        """Send an application command and wait for its reply event."""
+        self.write(command, payload)
+        deadline = time.time() + timeout
+        while True:
+            try:
+                event, data = self.app_event_queue.get(timeout=max(0, deadline - time.time()))
+            except queue.Empty:
+                raise Error("Timeout waiting for {!r}".format(event_id))
+            if event == event_id:
+                return data
+            logger.warning("Skip unexpected event: %s", event)
+
+    def afh_wifi_channels(self, channels):
+        self.write(CommandID.AFH_WIFI_CHANNELS, bytes(channels))
+
+    def afh_classification(self, enable):
+        self.write(CommandID.AFH_CLASSIFICATION, pack("<B", 1 if enable else 0))
+
+    def afh_blocklist(self):
+        """Return (classification enabled, block reasons[79], channel map[10]).
+        The reasons are a mask of AFH_BLOCK_WIFI and AFH_BLOCK_LE_ADV."""
+        payload = self.request(CommandID.AFH_BLOCKLIST, b'', EventID.AFH_BLOCKLIST)
+        classification = payload[0]
+        reasons = list(payload[1:80])
+        channel_map = payload[80:90]
+        return classification, reasons, channel_map
+
+    def avrc_info(self):
+        """Return (play status, song length ms, song position ms, {attribute id: bytes})."""
+        payload = self.request(CommandID.AVRC_INFO, b'', EventID.AVRC_INFO)
+        play_status, song_len, song_pos, attr_num = unpack("<BLLB", payload[:10])
+        attrs = {}
+        offset = 10
+        for _ in range(attr_num):
+            attr_id, length = payload[offset], payload[offset + 1]
+            attrs[attr_id] = bytes(payload[offset + 2:offset + 2 + length])
+            offset += 2 + length
+        return play_status, song_len, song_pos, attrs
+
+    def discover(self, timeout=1):
+        """Read the device capabilities and enable the transport options
+        supported by both sides. Return None for a device which does not
+        report them (the defaults are kept).
+
+        The baud rate is not negotiated: the device runs its HCI UART at
+        the rate it reports, the port shall be opened at that rate."""
+        try:
+            payload = self.request(CommandID.CAPABILITIES, b'', EventID.CAPABILITIES, timeout)
+        except Error:
+            logger.info("Device capabilities not available, using defaults")
+            return None
+
+        version, flags, baud_default, baud_max, mic_buffer_len = unpack("<BLLLH", payload[:15])
+        self.capabilities = Capabilities(
+            version, Capability(flags), baud_default, baud_max, mic_buffer_len
+        )
+        common = self.capabilities.flags & HOST_CAPABILITIES
+        self.audio_sn_included = bool(common & Capability.AUDIO_SN_HEADER)
+
+        if baud_default != self.serial_instance.baudrate:
+            logger.warning(
+                "Device HCI UART runs at {0:,} bps, port opened at {1:,} bps".format(
+                    baud_default, self.serial_instance.baudrate
+                )
+            )
+        logger.info("Device capabilities: %s", self.capabilities)
+        return self.capabilities
+
+    def stats(self):
+        """Return the raw statistics snapshot, see stats.decode()."""
+        return self.request(CommandID.STATS, b'', EventID.STATS)
+
+    def fastpair_profile(self, clear=False):
+        """Return (flags, {step name: FastPairStep}, FastPairKeys) of the Fast
+        Pair crypto timings, flags bit 0: profiling built in, bit 1: fast
+        P-256 in use. The account key store is None on older firmware."""
+        payload = self.request(
+            CommandID.FASTPAIR_PROFILE, pack("<B", 1 if clear else 0), EventID.FASTPAIR_PROFILE
+        )
+        version, flags, step_num = unpack("<BBB", payload[:3])
+        steps = {}
+        for i in range(step_num):
+            step = FastPairStep(*unpack("<4L", payload[3 + 16 * i:19 + 16 * i]))
+            name = FASTPAIR_STEPS[i] if i < len(FASTPAIR_STEPS) else "step{}".format(i)
+            steps[name] = step
+        keys = None
+        offset = 3 + 16 * step_num
+        if version >= 2 and len(payload) >= offset + 16:
+            keys = FastPairKeys(*unpack("<BHB3L", payload[offset:offset + 16]))
+        return flags, steps, keys
+
+    def p256_bench(self, iterations=4):
+        """Time the ROM and the application P-256 on the device, return P256Bench
+        (average microseconds per scalar multiplication). Raise Error if a run
+        is already in progress or the device could not complete this one."""
+        payload = self.request(
+            CommandID.P256_BENCH, pack("<H", iterations), EventID.P256_BENCH, 10 + 2 * iterations
+        )
+        result = P256Bench(*unpack("<H4LH", payload[:20]))
+        status = payload[20] if len(payload) > 20 else 0
+        if status != 0:
+            raise Error(
+                "P-256 bench {} after {} iterations".format(P256_BENCH_STATUS.get(status, status), result.iterations),
+                result=result,
+            )
+        return result
+
+    def timeline(self, clear=False):
+        """Return the raw pairing and connection timelines, see timeline.decode()."""
+        return self.request(CommandID.TIMELINE, pack("<B", 1 if clear else 0), EventID.TIMELINE)
+
+    def tuning(self, command):
+        """Send a runtime tuning command, return the raw response, see
+        tuning.encode_xxx() and tuning.decode()."""
+        return self.request(CommandID.TUNING, command, EventID.TUNING)
+
+    def warm_restart(self, timeout=10):
+        """Restart the Bluetooth stack in place, return (status, duration ms)."""
+        payload = self.request(CommandID.WARM_RESTART, b'', EventID.WARM_RESTART, timeout)
+        return unpack("<BL", payload[:5])
+
 
 class WicedHciProtocol(serial.threaded.Protocol):
     def __init__(self):
         self._data_buffer = bytearray()
         self._event_received = None
+        # Reception counters, read by the metrics exporter
+        self.rx_bytes = 0
+        self.events = 0
+        self.parse_errors = 0
+        self.resyncs = 0
+        self.resync_bytes = 0
 
     @property
     def event_received(self):
@@ -399,8 +619,10 @@ class WicedHciProtocol(serial.threaded.Protocol):
         pass
 
     def data_received(self, data):
-        logger.verbose("UART RX[%s]:" + " %02x" * len(data), len(data), *data)
+        if logger.isEnabledFor(logging.VERBOSE):
+            logger.verbose("UART RX[%s]:" + " %02x" * len(data), len(data), *data)
         self._data_buffer += data
+        self.rx_bytes += len(data)
 
         if not self._event_received:
             return
@@ -410,8 +632,12 @@ class WicedHciProtocol(serial.threaded.Protocol):
                 indicator, event, payload = self.parse_event()
             except (Error, ValueError):
                 # Handle packet lost, find the next valid header
+                self.parse_errors += 1
                 i = self._data_buffer.find(b'\x19')
                 if i >= 0:
+                    if i > 0:
+                        self.resyncs += 1
+                        self.resync_bytes += i
                     self._data_buffer = self._data_buffer[i:]
                     continue
                 else:
@@ -421,6 +647,7 @@ class WicedHciProtocol(serial.threaded.Protocol):
                 raise
 
             if event:
+                self.events += 1
                 self._event_received(indicator, event, payload)
             else:
                 break
@@ -0,0 +1,263 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Headless control of play_headset.py.
+
+Commands are text lines, from a pipe or file (-commands=PATH, "-" for the
+standard input), from TCP clients on the loopback interface
+(-command_port=PORT, one reply line per command) or from a scenario file
+(-scenario=FILE) run once from the top:
+
+    pairing | play_pause | prev | next    button actions of F1 to F4
+    button <ID> <EVENT> <STATE>           e.g. button PLAY CLICK RELEASED
+    wait_stream [A2DP|HFP|ANY] [TIMEOUT]  wait until a stream is started
+    wait_stop [TIMEOUT]                   wait until no stream is started
+    sleep <SECONDS>
+    record <SECONDS> [DIR]                record the streams to WAV files
+    status
+    quit
+
+A scenario line may start with "at <T>" to run the command T seconds after
+the start of the scenario; "#" starts a comment. The scenario stops at the
+first failing command, and play_headset.py exits when the scenario ends,
+with status 1 if a command failed.
+"""
+import os
+import shlex
+import socketserver
+import stat
+import sys
+import threading
+import time
+
+import recorder
+
+STREAM_TYPES = {"A2DP": 0, "HFP": 1}
+WAIT_TIMEOUT = 30
+
+
+class CommandError(Exception):
+    pass
+
+
+class Stopped(CommandError):
+    """A command was interrupted by quit or Ctrl + C."""
+
+    def __init__(self):
+        super().__init__("stopped")
+
+
+class StreamState:
+    """Started stream type, updated by the audio parser."""
+
+    def __init__(self):
+        self.stream_type = None
+        self._changed = threading.Condition()
+
+    def update(self, stream_type):
+        with self._changed:
+            self.stream_type = stream_type
+            self._changed.notify_all()
+
+    def wait(self, predicate, timeout):
+        with self._changed:
+            return self._changed.wait_for(lambda: predicate(self.stream_type), timeout)
+
+
+class Commands:
+    """Run command lines.
+
+    button(tokens) sends a button action, set_recorder(recorder) replaces
+    the recorder fed by the audio loop and returns the previous one, stop
+    is set by quit."""
+
+    def __init__(self, button, stream_state, set_recorder, stop):
+        self.button = button
+        self.stream_state = stream_state
+        self.set_recorder = set_recorder
+        self.stop = stop
+        self._lock = threading.Lock()
+
+    def execute(self, line):
+        """Run one command, return its reply, raise CommandError on failure."""
+        tokens = shlex.split(line, comments=True)
+        if not tokens:
+            return ""
+        name, args = tokens[0].lower(), tokens[1:]
+        handler = getattr(self, "_cmd_" + name, None)
+        if handler is None:
+            raise CommandError("unknown command: {}".format(name))
+        try:
+            return handler(*args) or "ok"
+        except (TypeError, ValueError) as exc:
+            raise CommandError("{}: {}".format(name, exc))
+
+    def _cmd_pairing(self):
+        self.button(["pairing"])
+
+    def _cmd_play_pause(self):
+        self.button(["play_pause"])
+
+    def _cmd_prev(self):
+        self.button(["prev"])
+
+    def _cmd_next(self):
+        self.button(["next"])
+
+    def _cmd_button(self, button_id, event, state):
+        self.button([button_id.upper(), event.upper(), state.upper()])
+
+    def _cmd_wait_stream(self, stream="ANY", timeout=WAIT_TIMEOUT):
+        stream = stream.upper()
+        if stream != "ANY" and stream not in STREAM_TYPES:
+            raise ValueError("stream type is A2DP, HFP or ANY")
+        wanted = STREAM_TYPES.get(stream)
+        if not self.stream_state.wait(
+            lambda current: current is not None and (wanted is None or current == wanted),
+            float(timeout),
+        ):
+            raise CommandError("no {} stream after {} s".format(stream, timeout))
+
+    def _cmd_wait_stop(self, timeout=WAIT_TIMEOUT):
+        if not self.stream_state.wait(lambda current: current is None, float(timeout)):
+            raise CommandError("stream still started after {} s".format(timeout))
+
+    def _cmd_sleep(self, seconds):
+        if self.stop.wait(float(seconds)):
+            raise Stopped()
+
+    def _cmd_record(self, seconds, directory="recordings"):
+        seconds = float(seconds)
+        with self._lock:
+            stream_recorder = recorder.Recorder(directory)
+            stream_recorder.start()
+            previous = self.set_recorder(stream_recorder)
+            try:
+                self.stop.wait(seconds)
+            finally:
+                self.set_recorder(previous)
+                stream_recorder.stop()
+        return "recorded {}".format(", ".join(stream_recorder.files) or "nothing")
+
+    def _cmd_status(self):
+        stream_type = self.stream_state.stream_type
+        names = {value: name for name, value in STREAM_TYPES.items()}
+        return "stream {}".format(names.get(stream_type, "none" if stream_type is None else stream_type))
+
+    def _cmd_quit(self):
+        self.stop.set()
+
+
+def _reply(line, commands):
+    try:
+        return commands.execute(line)
+    except CommandError as exc:
+        return "error: {}".format(exc)
+
+
+def run_scenario(path, commands, done):
+    """Run the scenario in path, done(ok) is always called at its end. A stop
+    requested by the user ends the scenario without failure."""
+    ok = True
+    start = time.monotonic()
+    try:
+        with open(path) as file:
+            lines = file.readlines()
+        for number, line in enumerate(lines, 1):
+            tokens = shlex.split(line, comments=True)
+            if len(tokens) >= 2 and tokens[0].lower() == "at":
+                delay = start + float(tokens[1]) - time.monotonic()
+                if delay > 0 and commands.stop.wait(delay):
+                    break
+                line = shlex.join(tokens[2:])
+            if commands.stop.is_set():
+                break
+            reply = commands.execute(line)
+            if reply:
+                print("[Scenario] {}:{} {}: {}".format(os.path.basename(path), number, line.strip(), reply))
+    except Stopped:
+        pass
+    except Exception as exc:
+        print("[Scenario] {} failed: {}".format(path, exc))
+        ok = False
+    finally:
+        done(ok)
+
+
+def read_commands(path, commands):
+    """Run the lines read from a file, a named pipe or the standard input.
+    A pipe is opened again when its writer closes it."""
+    while not commands.stop.is_set():
+        try:
+            file = sys.stdin if path == "-" else open(path)
+        except OSError as exc:
+            print("[Commands] cannot open {}: {}".format(path, exc))
+            return
+        with file:
+            for line in file:
+                reply = _reply(line, commands)
+                if reply:
+                    print("[Commands] {}: {}".format(line.strip(), reply))
+        if path == "-" or not stat.S_ISFIFO(os.stat(path).st_mode):
+            return
+
+
+class _CommandHandler(socketserver.StreamRequestHandler):
+    def handle(self):
+        for line in self.rfile:
+            reply = _reply(line.decode("utf-8", "replace"), self.server.commands)
+            self.wfile.write((reply or "ok").encode() + b"\n")
+
+
+class CommandServer(socketserver.ThreadingTCPServer):
+    """Line commands from TCP clients, bound to the loopback interface."""
+
+    daemon_threads = True
+    allow_reuse_address = True
+
+    def __init__(self, port, commands):
+        super().__init__(("127.0.0.1", port), _CommandHandler)
+        self.commands = commands
+        self._thread = threading.Thread(target=self.serve_forever, name="commands", daemon=True)
+
+    def start(self):
+        self._thread.start()
+
+    def stop(self):
+        self.shutdown()
+        self.server_close()
+
+
+def start_thread(name, target, *args):
+    thread = threading.Thread(target=target, args=args, name=name, daemon=True)
+    thread.start()
+    return thread
@@ -35,8 +35,12 @@ import sys
 import getopt
 import traceback
 import struct
+import time
 
 import hci
+import stats
+import timeline
+import tuning
 from ctypes.wintypes import CHAR
 
 BUTTON_VALUE_INVALID = 0xFF
@@ -75,6 +79,22 @@ def print_usage():
     print("           -button_id <BUTTON>: available values are PLAY, PAUSE, VOL+, VOL-, NEXT, PRE, VREC");
     print("           -button_event <BUTTON_EVENT>: available values are CLICK, SHORT, MEDIUM, LONG, VERY_LONG, DOUBLE_CLICK, HOLDING");
     print("           -button_state <BUTTON_STATE>: available values are HELD, RELEASED");
+    print("           -afh_wifi <CHANNELS>: comma separated Wi-Fi channels in use, OFF if none");
+    print("           -afh_classify <0|1>: disable/enable host AFH channel classification");
+    print("           -afh_blocklist: print the channels blocked by the host and the map sent");
+    print("           -avrc_info: print the AVRCP play status and track metadata");
+    print("           -restart: restart the Bluetooth stack without a firmware download");
+    print("           -stats: print the device statistics snapshot");
+    print("           -stats_period <SECONDS>: poll the statistics and print the rates until Ctrl+C");
+    print("           -fastpair_profile: print the Fast Pair crypto timings (build with FASTPAIR_PROFILE=1)");
+    print("           -fastpair_profile_clear: print and clear the Fast Pair crypto timings");
+    print("           -p256_bench <ITERATIONS>: compare the ROM and the application P-256 on the target");
+    print("           -timeline: print the pairing and connection setup timeline of each peer");
+    print("           -timeline_clear: print and clear the timelines");
+    print("           -tuning: print the runtime tuning parameters");
+    print("           -tuning_set <NAME=VALUE,...>: set tuning parameters, applied from the next restart");
+    print("           -tuning_defaults: restore the default tuning parameters");
+    print("           -tuning_commit: write the tuning parameters to NVRAM");
 
 # Check the parameters (passed on the Command Line)
 def check_parameter(param):
@@ -124,6 +144,123 @@ def button_event_send():
             print("Error: button_id, button_event, and button_state shall be used together");
             return;
 
+def afh_command_send():
+    if 'afh_wifi' in globals():
+        if afh_wifi.upper() == "OFF":
+            channels = [];
+        else:
+            channels = [int(channel) for channel in afh_wifi.split(",")];
+        controller.afh_wifi_channels(channels);
+
+    if 'afh_classify' in globals():
+        controller.afh_classification(int(afh_classify) != 0);
+
+    if check_parameter("-afh_blocklist"):
+        classification, reasons, channel_map = controller.afh_blocklist();
+        print("Host classification: %s" % ("enabled" if classification else "disabled"));
+        print("Channel  MHz  Map  Blocked by");
+        for channel in range(len(reasons)):
+            used = (channel_map[channel // 8] >> (channel % 8)) & 1;
+            sources = [];
+            if reasons[channel] & hci.AFH_BLOCK_WIFI:
+                sources.append("Wi-Fi");
+            if reasons[channel] & hci.AFH_BLOCK_LE_ADV:
+                sources.append("LE advertising");
+            print("%7d %4d   %s   %s" % (channel, 2402 + channel, "-" if used else "X", ", ".join(sources)));
+
+def avrc_command_send():
+    if check_parameter("-avrc_info"):
+        play_status, song_len, song_pos, attrs = controller.avrc_info();
+        status = {0: "stopped", 1: "playing", 2: "paused", 3: "fwd seek", 4: "rev seek"};
+        names = {1: "Title", 2: "Artist", 3: "Album"};
+        print("Status:   %s" % status.get(play_status, "error"));
+        if song_pos != 0xFFFFFFFF:
+            print("Position: %d:%02d" % (song_pos // 60000, song_pos // 1000 % 60));
+        if song_len != 0xFFFFFFFF:
+            print("Length:   %d:%02d" % (song_len // 60000, song_len // 1000 % 60));
+        for attr_id in attrs:
+            print("%-9s %s" % (names.get(attr_id, str(attr_id)) + ":", attrs[attr_id].decode("utf-8", "replace")));
+
+def stats_print(name, values):
+    if isinstance(values, dict):
+        print("%s:" % name);
+        for key in values:
+            stats_print("  " + str(key), values[key]);
+    elif isinstance(values, list):
+        for index in range(len(values)):
+            stats_print("%s[%d]" % (name, index), values[index]);
+    elif isinstance(values, float):
+        print("%s: %.1f" % (name, values));
+    else:
+        print("%s: %s" % (name, values));
+
+def stats_command_send():
+    if check_parameter("-stats"):
+        snapshot = stats.decode(controller.stats());
+        for name in snapshot:
+            stats_print(name, snapshot[name]);
+
+    if 'stats_period' in globals():
+        rates = stats.Rates();
+        try:
+            while True:
+                result = rates.update(stats.decode(controller.stats()));
+                if result is not None:
+                    for name in result:
+                        stats_print(name, result[name]);
+                    print("");
+                time.sleep(float(stats_period));
+        except KeyboardInterrupt:
+            pass;
+
+def fastpair_command_send():
+    if check_parameter("-fastpair_profile") or check_parameter("-fastpair_profile_clear"):
+        flags, steps, keys = controller.fastpair_profile(check_parameter("-fastpair_profile_clear"));
+        print("Profiling: %s, P-256: %s" % ("on" if flags & 0x01 else "off", "fast" if flags & 0x02 else "ROM"));
+        print("Step          Count   Last(us)    Max(us)    Avg(us)");
+        for name in steps:
+            step = steps[name];
+            print("%-12s %6d %10d %10d %10d" % (name, step.count, step.last_us, step.max_us, step.total_us // step.count if step.count else 0));
+        if keys is not None:
+            print("Account keys: %d max, %d bytes in %d NVRAM items" % (keys.key_num, keys.store_len, keys.chunks));
+            print("Store: %d reads from RAM, %d items written, %d unchanged" % (keys.reads, keys.chunk_writes, keys.chunk_skips));
+
+    if 'p256_bench' in globals():
+        try:
+            result = controller.p256_bench(int(p256_bench));
+        except hci.Error as error:
+            print("P-256 bench error: %s" % error);
+            return;
+        print("P-256, %d iterations, average us per multiplication" % result.iterations);
+        print("               ROM      Fast  Speedup");
+        for name, rom, fast in (("fixed base", result.rom_base_us, result.fast_base_us), ("variable base", result.rom_var_us, result.fast_var_us)):
+            print("%-13s %8d %8d  %6.1fx" % (name, rom, fast, float(rom) / fast if fast else 0));
+        print("Mismatches: %d" % result.mismatches);
+
+def timeline_command_send():
+    if check_parameter("-timeline") or check_parameter("-timeline_clear"):
+        for line in timeline.render(timeline.decode(controller.timeline(check_parameter("-timeline_clear")))):
+            print(line);
+
+def tuning_command_send():
+    try:
+        if check_parameter("-tuning_defaults"):
+            tuning.decode(controller.tuning(bytes([tuning.OP_DEFAULTS])));
+        if 'tuning_set' in globals():
+            tuning.decode(controller.tuning(tuning.encode_set(tuning.parse_assignments(tuning_set))));
+        if check_parameter("-tuning_commit"):
+            tuning.decode(controller.tuning(bytes([tuning.OP_COMMIT])));
+            print("Tuning committed, applied from the next restart");
+        if check_parameter("-tuning"):
+            opcode, result = tuning.decode(controller.tuning(tuning.encode_get()));
+            print("Tuning version %d%s%s" % (result["version"],
+                                             ", stored" if result["flags"] & tuning.FLAG_STORED else "",
+                                             ", changed" if result["flags"] & tuning.FLAG_CHANGED else ""));
+            for name in result["values"]:
+                print("%-24s %d" % (name, result["values"][name]));
+    except tuning.TuningError as error:
+        print("Tuning error: %s" % error);
+
 """
 Program Starts
 """
@@ -157,6 +294,21 @@ if check_parameter("-button_event"):
 if check_parameter("-button_state"):
     button_state = sys.argv[sys.argv.index('-button_state')+1];
 
+if check_parameter("-afh_wifi"):
+    afh_wifi = sys.argv[sys.argv.index('-afh_wifi')+1];
+
+if check_parameter("-afh_classify"):
+    afh_classify = sys.argv[sys.argv.index('-afh_classify')+1];
+
+if check_parameter("-stats_period"):
+    stats_period = sys.argv[sys.argv.index('-stats_period')+1];
+
+if check_parameter("-p256_bench"):
+    p256_bench = sys.argv[sys.argv.index('-p256_bench')+1];
+
+if check_parameter("-tuning_set"):
+    tuning_set = sys.argv[sys.argv.index('-tuning_set')+1];
+
 # Download file to target board
 if 'file' in locals():
     command = 'py fw_download.py ' + serialport + ' ' + file;
@@ -171,8 +323,31 @@ except:
     traceback.print_exc();
     sys.exit();
 
+# Restart the Bluetooth stack of the target
+if check_parameter("-restart"):
+    status, duration = controller.warm_restart();
+    print("Warm restart status: %d, %d ms" % (status, duration));
+
 # Send button event to target
 button_event_send();
 
+# Send AFH commands to target
+afh_command_send();
+
+# Send AVRCP commands to target
+avrc_command_send();
+
+# Read statistics from target
+stats_command_send();
+
+# Read Fast Pair timings and run the P-256 benchmark on target
+fastpair_command_send();
+
+# Read the pairing and connection timelines from target
+timeline_command_send();
+
+# Read and change the runtime tuning parameters of target
+tuning_command_send();
+
 # Close COM port
 controller.close();
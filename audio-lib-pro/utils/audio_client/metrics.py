@@ -0,0 +1,248 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Metrics in the Prometheus text format, for the node exporter textfile collector.
+
+The hot path only increments plain counters or calls Histogram.observe()
+(a bisect on a dozen buckets). Exporter renders the registry every period
+seconds on its own thread, after running the collectors which copy the
+values kept elsewhere (HCI reception counters, pipeline rings, device
+statistics), then replaces the file by an atomic rename so that a scrape
+never reads a partial file.
+"""
+import bisect
+import logging
+import os
+import threading
+import time
+
+logger = logging.getLogger(__name__)
+
+# Seconds, from 0.5 ms to 1 s
+LATENCY_BUCKETS = (0.0005, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0)
+
+
+class Counter:
+    """Monotonic value, its name ends with _total."""
+
+    def __init__(self):
+        self.value = 0
+
+    def inc(self, amount=1):
+        self.value += amount
+
+    def set(self, value):
+        """Copy a counter maintained elsewhere."""
+        self.value = value
+
+    def samples(self, name, labels):
+        yield name, labels, self.value
+
+
+class Gauge:
+    def __init__(self):
+        self.value = 0
+
+    def set(self, value):
+        self.value = value
+
+    def samples(self, name, labels):
+        yield name, labels, self.value
+
+
+class Histogram:
+    def __init__(self, buckets=LATENCY_BUCKETS):
+        self.buckets = tuple(buckets)
+        self.counts = [0] * (len(self.buckets) + 1)
+        self.count = 0
+        self.sum = 0.0
+
+    def observe(self, value):
+        self.counts[bisect.bisect_left(self.buckets, value)] += 1
+        self.count += 1
+        self.sum += value
+
+    def quantile(self, q):
+        """Estimate of the q quantile, interpolated within its bucket."""
+        if not self.count:
+            return 0.0
+        rank = q * self.count
+        cumulated = 0
+        for i, count in enumerate(self.counts):
+            if count and cumulated + count >= rank:
+                if i == len(self.buckets):
+                    return self.buckets[-1]
+                lower = self.buckets[i - 1] if i else 0.0
+                return lower + (self.buckets[i] - lower) * (rank - cumulated) / count
+            cumulated += count
+        return self.buckets[-1]
+
+    def samples(self, name, labels):
+        cumulated = 0
+        for bound, count in zip(self.buckets + ("+Inf",), self.counts):
+            cumulated += count
+            yield name + "_bucket", labels + (("le", str(bound)),), cumulated
+        yield name + "_sum", labels, self.sum
+        yield name + "_count", labels, self.count
+
+
+_TYPES = {Counter: "counter", Gauge: "gauge", Histogram: "histogram"}
+
+
+class Registry:
+    """Metric families by name, each metric of a family by its labels."""
+
+    def __init__(self):
+        self._families = {}
+        self._lock = threading.Lock()
+
+    def _get(self, kind, name, help, labels, **kwargs):
+        key = tuple(sorted(labels.items()))
+        with self._lock:
+            family = self._families.get(name)
+            if family is None:
+                family = self._families[name] = (kind, help, {})
+            elif family[0] is not kind:
+                raise ValueError("{} is a {}".format(name, _TYPES[family[0]]))
+            metric = family[2].get(key)
+            if metric is None:
+                metric = family[2][key] = kind(**kwargs)
+        return metric
+
+    def counter(self, name, help="", **labels):
+        return self._get(Counter, name, help, labels)
+
+    def gauge(self, name, help="", **labels):
+        return self._get(Gauge, name, help, labels)
+
+    def histogram(self, name, help="", buckets=LATENCY_BUCKETS, **labels):
+        return self._get(Histogram, name, help, labels, buckets=buckets)
+
+    def render(self):
+        lines = []
+        with self._lock:
+            families = [(name, family[0], family[1], list(family[2].items()))
+                        for name, family in sorted(self._families.items())]
+        for name, kind, help, metrics in families:
+            if help:
+                lines.append("# HELP {} {}".format(name, help))
+            lines.append("# TYPE {} {}".format(name, _TYPES[kind]))
+            for labels, metric in metrics:
+                for sample, sample_labels, value in metric.samples(name, labels):
+                    if sample_labels:
+                        sample += "{" + ",".join(
+                            '{}="{}"'.format(key, str(label).replace("\\", "\\\\").replace('"', '\\"'))
+                            for key, label in sample_labels
+                        ) + "}"
+                    lines.append("{} {}".format(sample, value))
+        return "\n".join(lines) + "\n"
+
+
+def _metric_name(*parts):
+    return "_".join(str(part) for part in parts if part != "").replace(" ", "_")
+
+
+def export_device_stats(registry, snapshot, monotonic, prefix="headset_device"):
+    """Copy a decoded statistics snapshot (stats.decode()) into the registry.
+    The fields listed in monotonic ({record: field names}) are exported as
+    counters, everything else as gauges. Lists are labelled by index, nested
+    dictionaries (per link records) by Bluetooth address."""
+
+    def export(record, field, value, labels):
+        if isinstance(value, bool) or not isinstance(value, (int, float)):
+            return
+        name = _metric_name(prefix, record, field)
+        if field in monotonic.get(record, ()):
+            registry.counter(name + "_total", **labels).set(value)
+        else:
+            registry.gauge(name, **labels).set(value)
+
+    for record, values in snapshot.items():
+        if isinstance(values, dict):
+            for key, value in values.items():
+                if isinstance(value, dict):
+                    for field, field_value in value.items():
+                        export(record, field, field_value, {"addr": key})
+                else:
+                    export(record, key, value, {})
+        elif isinstance(values, list):
+            for index, value in enumerate(values):
+                for field, field_value in value.items():
+                    export(record, field, field_value, {"index": index})
+        else:
+            export(record, "", values, {})
+
+
+class Exporter(threading.Thread):
+    """Write registry to path every period seconds. collectors are called
+    with the registry before each write, an exception of a collector is
+    logged and the others still run."""
+
+    def __init__(self, path, registry, period=15, collectors=()):
+        super().__init__(name="metrics", daemon=True)
+        self.path = os.path.abspath(path)
+        self.registry = registry
+        self.period = period
+        self.collectors = list(collectors)
+        self._stopped = threading.Event()
+        self._duration = registry.gauge("headset_host_metrics_collect_seconds",
+                                        "Time spent collecting and writing the metrics")
+
+    def write(self):
+        start = time.perf_counter()
+        for collector in self.collectors:
+            try:
+                collector(self.registry)
+            except Exception as exc:
+                logger.warning("Metrics collector %s failed: %s", getattr(collector, "__name__", collector), exc)
+        self._duration.set(round(time.perf_counter() - start, 6))
+        temp_path = "{}.{}.tmp".format(self.path, os.getpid())
+        with open(temp_path, "w") as file:
+            file.write(self.registry.render())
+        os.replace(temp_path, self.path)
+
+    def _update(self):
+        try:
+            self.write()
+        except OSError as exc:
+            logger.warning("Cannot write %s: %s", self.path, exc)
+
+    def run(self):
+        while not self._stopped.wait(self.period):
+            self._update()
+
+    def stop(self, timeout=5):
+        """Stop and write the final values."""
+        self._stopped.set()
+        if self.is_alive():
+            self.join(timeout)
+        self._update()
@@ -0,0 +1,256 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Shared memory export of the decoded A2DP/SCO PCM.
+
+The publisher owns a memory mapped file (in /dev/shm when available, else in
+the temporary directory) holding a ring of fixed size slots. Any number of
+readers map the same file read only and follow the write index at their own
+pace: the publisher never waits for them, a reader which falls more than a
+ring behind skips ahead and counts the frames lost.
+
+Layout, little endian:
+
+    Header (64 bytes)
+        0   magic "HSPCMRNG"
+        8   version u32, header size u32, slot count u32, slot size u32
+        24  slot header size u32, reserved u32
+        32  write index u64: number of frames published
+    Slot (SLOT_HEADER_SIZE + slot size bytes), frame n in slot n % count
+        0   sequence u64: n once the frame is complete, INVALID while written
+        8   timestamp_ns u64 (time.monotonic_ns of the publisher)
+        16  sample rate u32, length u32
+        24  stream type u8 (0 A2DP, 1 HFP), channels u8, sample bits u8,
+            reserved u8, serial number u16 (NO_SERIAL if none), reserved u16
+        32  PCM
+
+A reader gets a memoryview on the mapping, no copy. The slot may be
+overwritten while the reader uses it; Frame.valid() tells whether it was.
+
+Run this module to attach a reader and print the received streams.
+"""
+import mmap
+import os
+import struct
+import tempfile
+import time
+import weakref
+from collections import namedtuple
+
+MAGIC = b"HSPCMRNG"
+VERSION = 1
+DEFAULT_NAME = "headset_pcm"
+
+HEADER_SIZE = 64
+SLOT_HEADER_SIZE = 32
+INVALID = 0xFFFFFFFFFFFFFFFF
+NO_SERIAL = 0xFFFF
+
+STREAM_A2DP = 0
+STREAM_HFP = 1
+
+_HEADER = struct.Struct("<8s6L")
+_WRITE_INDEX = struct.Struct("<Q")
+_WRITE_INDEX_OFFSET = 32
+_SLOT = struct.Struct("<QQLLBBBBHH")
+
+FrameInfo = namedtuple(
+    "FrameInfo", "index timestamp_ns sample_rate stream_type channels bits serial"
+)
+
+
+def path(name=DEFAULT_NAME, directory=None):
+    """Path of the ring file of name."""
+    if directory is None:
+        directory = "/dev/shm" if os.path.isdir("/dev/shm") else tempfile.gettempdir()
+    return os.path.join(directory, name)
+
+
+class Publisher:
+    """Writer of the ring, one per name."""
+
+    def __init__(self, name=DEFAULT_NAME, slot_count=256, slot_size=4096, directory=None):
+        self.path = path(name, directory)
+        self.slot_count = slot_count
+        self.slot_size = slot_size
+        self._stride = SLOT_HEADER_SIZE + slot_size
+        size = HEADER_SIZE + slot_count * self._stride
+        self.index = 0
+        self.truncated = 0
+
+        with open(self.path, "w+b") as f:
+            f.truncate(size)
+            self._map = mmap.mmap(f.fileno(), size)
+        _HEADER.pack_into(
+            self._map, 0, MAGIC, VERSION, HEADER_SIZE, slot_count, slot_size, SLOT_HEADER_SIZE, 0
+        )
+        _WRITE_INDEX.pack_into(self._map, _WRITE_INDEX_OFFSET, 0)
+        for slot in range(slot_count):
+            _WRITE_INDEX.pack_into(self._map, HEADER_SIZE + slot * self._stride, INVALID)
+
+    def publish(self, stream_type, sample_rate, channels, pcm, serial=NO_SERIAL, bits=16):
+        """Append one frame, longer frames are truncated to the slot size."""
+        length = min(len(pcm), self.slot_size)
+        if length < len(pcm):
+            self.truncated += 1
+        offset = HEADER_SIZE + (self.index % self.slot_count) * self._stride
+
+        _WRITE_INDEX.pack_into(self._map, offset, INVALID)
+        self._map[offset + SLOT_HEADER_SIZE:offset + SLOT_HEADER_SIZE + length] = pcm[:length]
+        _SLOT.pack_into(
+            self._map, offset,
+            INVALID, time.monotonic_ns(), sample_rate, length,
+            stream_type, channels, bits, 0, serial, 0,
+        )
+        _WRITE_INDEX.pack_into(self._map, offset, self.index)
+
+        self.index += 1
+        _WRITE_INDEX.pack_into(self._map, _WRITE_INDEX_OFFSET, self.index)
+
+    def close(self, remove=True):
+        if self._map is not None:
+            self._map.close()
+            self._map = None
+            if remove:
+                try:
+                    os.remove(self.path)
+                except OSError:
+                    pass  # still mapped by a reader (Windows)
+
+
+class Frame:
+    """A frame of the ring, pcm is a memoryview on the mapping, released by
+    Reader.close()."""
+
+    def __init__(self, reader, offset, info, pcm):
+        self._reader = reader
+        self._offset = offset
+        self.info = info
+        self.pcm = pcm
+
+    def valid(self):
+        """False if the publisher has overwritten the frame since it was read."""
+        return self._reader._sequence(self._offset) == self.info.index
+
+
+class Reader:
+    """Follower of the ring, starts with the next frame published."""
+
+    def __init__(self, name=DEFAULT_NAME, directory=None):
+        self.path = path(name, directory)
+        with open(self.path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, header_size, self.slot_count, self.slot_size, slot_header_size, _ = \
+            _HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC or version != VERSION:
+            self._map.close()
+            raise ValueError("{} is not a PCM ring (version {})".format(self.path, VERSION))
+        self._header_size = header_size
+        self._slot_header_size = slot_header_size
+        self._stride = slot_header_size + self.slot_size
+        self._view = memoryview(self._map)
+        self._frames = weakref.WeakSet()
+        self.index = self.write_index()
+        self.lost = 0
+
+    def write_index(self):
+        return _WRITE_INDEX.unpack_from(self._map, _WRITE_INDEX_OFFSET)[0]
+
+    def _sequence(self, offset):
+        return _WRITE_INDEX.unpack_from(self._map, offset)[0]
+
+    def read(self):
+        """Return the next Frame, None if there is no new frame."""
+        while True:
+            write_index = self.write_index()
+            if self.index >= write_index:
+                return None
+            if write_index - self.index > self.slot_count:
+                self.lost += write_index - self.slot_count - self.index
+                self.index = write_index - self.slot_count
+
+            offset = self._header_size + (self.index % self.slot_count) * self._stride
+            sequence, timestamp_ns, sample_rate, length, stream_type, channels, bits, _, serial, _ = \
+                _SLOT.unpack_from(self._map, offset)
+            if sequence != self.index:
+                # Overwritten (or being written) since the write index was read.
+                self.lost += 1
+                self.index += 1
+                continue
+
+            info = FrameInfo(self.index, timestamp_ns, sample_rate, stream_type, channels, bits, serial)
+            start = offset + self._slot_header_size
+            self.index += 1
+            frame = Frame(self, offset, info, self._view[start:start + length])
+            self._frames.add(frame)
+            return frame
+
+    def close(self):
+        """Release the pcm views of the frames still alive, then unmap the ring.
+        Views taken from a frame (slices, numpy arrays) shall be dropped
+        first, the mapping cannot be closed while they exist (BufferError)."""
+        for frame in list(self._frames):
+            frame.pcm.release()
+        self._frames.clear()
+        self._view.release()
+        self._map.close()
+
+
+if __name__ == "__main__":
+    import sys
+
+    reader = Reader(sys.argv[1] if len(sys.argv) > 1 else DEFAULT_NAME)
+    print("Attached to {} ({} slots of {} bytes)".format(reader.path, reader.slot_count, reader.slot_size))
+    frames = 0
+    bytes_received = 0
+    last = None
+    report = time.monotonic() + 1
+    try:
+        while True:
+            frame = reader.read()
+            if frame is None:
+                time.sleep(0.005)
+            else:
+                stream = (frame.info.stream_type, frame.info.sample_rate, frame.info.channels)
+                if stream != last:
+                    print("Stream {}: {} Hz, {} channels".format(
+                        "A2DP" if stream[0] == STREAM_A2DP else "HFP", stream[1], stream[2]))
+                    last = stream
+                frames += 1
+                bytes_received += len(frame.pcm)
+            if time.monotonic() >= report:
+                print("{} frames, {} bytes, {} lost".format(frames, bytes_received, reader.lost))
+                report += 1
+    except KeyboardInterrupt:
+        pass
+    finally:
+        reader.close()
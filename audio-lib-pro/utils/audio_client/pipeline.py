@@ -0,0 +1,289 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Threaded audio pipeline for the host client.
+
+Each stage runs on its own thread and hands its output to the next stage
+through a bounded single-producer/single-consumer ring. The ring indices are
+only written by one side each, so the data path takes no lock under the GIL;
+a stage waits on an Event only when its input ring is empty. A full ring
+drops the new audio item and counts it, the audio producer never blocks.
+Control items (stream start and stop, NVRAM writes) are put with wait=True
+instead: the producer waits for room, they are never dropped and keep their
+order with the audio items.
+
+The blocking calls of the stages (serial read, PyAudio write, file write)
+release the GIL, so a slow stage no longer stalls the others. Every stage
+reports the items handled, the drops of its input ring and the longest time
+spent on one item. GapMeter measures the longest interval between two
+events, e.g. between two audio writes while streaming.
+
+Run this module to measure the output gap of a synthetic stream while
+another stage does slow writes and the interpreter collects garbage.
+"""
+import threading
+import time
+
+
+class SpscRing:
+    """Bounded ring, one producer thread and one consumer thread."""
+
+    def __init__(self, size):
+        self._slots = [None] * (size + 1)
+        self._head = 0  # written by the consumer only
+        self._tail = 0  # written by the producer only
+        self._ready = threading.Event()
+        self._space = threading.Event()
+        self.drops = 0
+        self.fill_max = 0
+
+    def __len__(self):
+        return (self._tail - self._head) % len(self._slots)
+
+    def put(self, item):
+        """Append an item, return False (and count a drop) if the ring is full."""
+        if not self._append(item):
+            self.drops += 1
+            return False
+        return True
+
+    def put_wait(self, item, timeout):
+        """Append an item, waiting up to timeout seconds for room. Return
+        False if the ring stayed full, no drop is counted."""
+        end = time.perf_counter() + timeout
+        while not self._append(item):
+            self._space.clear()
+            # The consumer may have removed an item between the two calls.
+            if self._append(item):
+                return True
+            remaining = end - time.perf_counter()
+            if remaining <= 0:
+                return False
+            self._space.wait(remaining)
+        return True
+
+    def _append(self, item):
+        tail = self._tail
+        next_tail = (tail + 1) % len(self._slots)
+        if next_tail == self._head:
+            return False
+        self._slots[tail] = item
+        self._tail = next_tail
+        self.fill_max = max(self.fill_max, len(self))
+        if not self._ready.is_set():
+            self._ready.set()
+        return True
+
+    def get(self, timeout=None):
+        """Remove the oldest item, None if the ring stays empty for timeout seconds."""
+        head = self._head
+        if head == self._tail:
+            self._ready.clear()
+            # The producer may have appended between the check and the clear.
+            if head == self._tail and not self._ready.wait(timeout):
+                return None
+            if head == self._tail:
+                return None
+        item = self._slots[head]
+        self._slots[head] = None
+        self._head = (head + 1) % len(self._slots)
+        if not self._space.is_set():
+            self._space.set()
+        return item
+
+
+class GapMeter:
+    """Longest interval between two tick() calls since the last reset()."""
+
+    def __init__(self):
+        self.reset()
+
+    def reset(self):
+        self._last = None
+        self.max_ms = 0.0
+        self.ticks = 0
+
+    def tick(self):
+        now = time.perf_counter()
+        if self._last is not None:
+            self.max_ms = max(self.max_ms, (now - self._last) * 1000)
+        self._last = now
+        self.ticks += 1
+
+
+class Stage(threading.Thread):
+    """Thread calling handler(item) for every item of its input ring.
+
+    The handler forwards its results with emit(item), which puts them in the
+    input ring of the next stage."""
+
+    def __init__(self, name, handler, ring_size=256):
+        super().__init__(name=name, daemon=True)
+        self.handler = handler
+        self.input = SpscRing(ring_size)
+        self.next = None
+        self.items = 0
+        self.busy_max_ms = 0.0
+        self.busy_total_ms = 0.0
+        self._running = threading.Event()
+
+    def put(self, item, wait=False):
+        """Append an item to the input ring. With wait, block until there is
+        room or the stage stops instead of dropping the item."""
+        if not wait:
+            return self.input.put(item)
+        while not self.input.put_wait(item, 0.1):
+            if not self._running.is_set():
+                return False
+        return True
+
+    def emit(self, item, wait=False):
+        if self.next is not None:
+            self.next.put(item, wait)
+
+    def start(self):
+        self._running.set()
+        super().start()
+
+    def stop(self):
+        self._running.clear()
+        self.input._ready.set()
+
+    def run(self):
+        while self._running.is_set():
+            item = self.input.get(0.5)
+            if item is None:
+                continue
+            start = time.perf_counter()
+            self.handler(item)
+            busy_ms = (time.perf_counter() - start) * 1000
+            self.busy_max_ms = max(self.busy_max_ms, busy_ms)
+            self.busy_total_ms += busy_ms
+            self.items += 1
+
+    def stats(self):
+        return {
+            "items": self.items,
+            "drops": self.input.drops,
+            "fill_max": self.input.fill_max,
+            "busy_max_ms": round(self.busy_max_ms, 2),
+            "busy_total_ms": round(self.busy_total_ms, 1),
+        }
+
+
+class Pipeline:
+    """Stages chained in order, put() feeds the first one."""
+
+    def __init__(self, *stages):
+        self.stages = list(stages)
+        for stage, next_stage in zip(self.stages, self.stages[1:]):
+            stage.next = next_stage
+
+    def put(self, item, wait=False):
+        return self.stages[0].put(item, wait)
+
+    def start(self):
+        for stage in self.stages:
+            stage.start()
+
+    def stop(self, timeout=1):
+        for stage in self.stages:
+            stage.stop()
+        for stage in self.stages:
+            if stage.is_alive():
+                stage.join(timeout)
+
+    def stats(self):
+        return {stage.name: stage.stats() for stage in self.stages}
+
+
+def _measure(threaded, seconds=5, frame_bytes=480, frame_ms=2.7):
+    """Synthetic load: a reader producing stereo 16 bit frames at the A2DP rate,
+    a parser stripping the header and saving 1 KB of "NVRAM" (50 ms) every
+    100 frames, and an output paced by the sound card. Return the longest
+    output gap in ms, single threaded when threaded is False."""
+    output_gap = GapMeter()
+    nvram = Stage("nvram", lambda item: time.sleep(0.05))
+
+    def output(data):
+        output_gap.tick()
+        time.sleep(frame_ms * 0.9 / 1000)
+
+    def parse(item):
+        sn, data = item
+        if sn % 100 == 0:
+            if threaded:
+                nvram.input.put(bytes(1024))
+            else:
+                nvram.handler(bytes(1024))
+        if threaded:
+            parser.emit(data[4:])
+        else:
+            output(data[4:])
+
+    parser = Stage("parser", parse)
+    dsp = Stage("dsp", lambda data: dsp.emit(data))
+    pipeline = Pipeline(parser, dsp, Stage("output", output))
+    if threaded:
+        nvram.start()
+        pipeline.start()
+
+    garbage = []
+    sn = 0
+    end = time.perf_counter() + seconds
+    next_frame = time.perf_counter()
+    while time.perf_counter() < end:
+        if threaded:
+            pipeline.put((sn, bytes(frame_bytes + 4)))
+        else:
+            parse((sn, bytes(frame_bytes + 4)))
+        sn += 1
+        # Allocation churn to trigger the cyclic garbage collector.
+        garbage.append([[] for _ in range(50)])
+        if len(garbage) > 200:
+            garbage = []
+        next_frame += frame_ms / 1000
+        time.sleep(max(0, next_frame - time.perf_counter()))
+
+    if threaded:
+        pipeline.stop()
+        nvram.stop()
+        for name, stats in pipeline.stats().items():
+            print("  %-8s %s" % (name, stats))
+        print("  %-8s %s" % ("nvram", nvram.stats()))
+    return output_gap.max_ms
+
+
+if __name__ == "__main__":
+    for threaded in (False, True):
+        print("%s:" % ("pipeline" if threaded else "single thread"))
+        print("  output max gap %.2f ms, frame %.2f ms" % (_measure(threaded), 2.7))
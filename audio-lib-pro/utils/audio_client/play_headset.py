@@ -41,12 +41,18 @@ import traceback
 import signal
 import time
 from fw_dl import fw_download
-import pynput
-from pynput import keyboard
 from hci import EventID
 from nvram import nvram
 import base64
 import threading
+import gc
+from pipeline import GapMeter, Pipeline, Stage
+import pcm_export
+import recorder
+import metrics
+import stats
+import profiler
+import headless
 
 # Debug level
 logging.basicConfig(level=logging.INFO)
@@ -91,36 +97,125 @@ stream_volume_level = {
     "LOW":  0
 }
 
-# Signal Ctrl + C
+# Signal Ctrl + C, and termination of a headless run
 def keyboardInterruptHandler(signal, frame):
     logger.debug("KeyboardInterrupt (ID: {}) has been caught.".format(signal))
-    pynput.keyboard.Listener.stop
     exit(0)
 signal.signal(signal.SIGINT, keyboardInterruptHandler)
-
-# Serial number included in audio data frame
-audio_sn_included = 1
+signal.signal(signal.SIGTERM, keyboardInterruptHandler)
+
+# Serial number included in audio data frame, read from the device capabilities
+# unless given on the command line
+audio_sn_included = None
+
+# PCM shared memory export for other host processes, see pcm_export.py
+pcm_publisher = None
+for arg in sys.argv[1:]:
+    if arg == "-pcm_export" or arg.startswith("-pcm_export="):
+        sys.argv.remove(arg)
+        pcm_publisher = pcm_export.Publisher(arg.partition("=")[2] or pcm_export.DEFAULT_NAME)
+        print("Exporting PCM to {}".format(pcm_publisher.path))
+        break
+
+# Stream recorder, see recorder.py
+record_directory = None
+record_options = {}
+for arg in sys.argv[1:]:
+    name, _, value = arg.partition("=")
+    if name == "-record":
+        record_directory = value or "recordings"
+    elif name == "-record_flac":
+        record_options["flac"] = True
+    elif name == "-record_rotate_mb":
+        record_options["rotate_bytes"] = int(value) * 1024 * 1024
+    elif name == "-record_rotate_s":
+        record_options["rotate_seconds"] = int(value)
+    else:
+        continue
+    sys.argv.remove(arg)
+stream_recorder = None
+if record_directory is not None:
+    stream_recorder = recorder.Recorder(record_directory, **record_options)
+    stream_recorder.start()
+    print("Recording to {}".format(os.path.abspath(record_directory)))
+
+# Prometheus textfile metrics, see metrics.py
+metrics_path = None
+metrics_period = 15
+for arg in sys.argv[1:]:
+    name, _, value = arg.partition("=")
+    if name == "-metrics":
+        metrics_path = value or "headset.prom"
+    elif name == "-metrics_period":
+        metrics_period = float(value)
+    else:
+        continue
+    sys.argv.remove(arg)
+
+# Headless runtime, see headless.py
+is_headless = False
+command_path = None
+command_port = None
+scenario_path = None
+for arg in sys.argv[1:]:
+    name, _, value = arg.partition("=")
+    if name == "-headless":
+        is_headless = True
+    elif name == "-commands":
+        command_path = value or "-"
+    elif name == "-command_port":
+        command_port = int(value)
+    elif name == "-scenario":
+        scenario_path = value
+    else:
+        continue
+    sys.argv.remove(arg)
+
+# Sampling profiler and stage timers, see profiler.py
+profile_path = None
+for arg in sys.argv[1:]:
+    name, _, value = arg.partition("=")
+    if name in ("-profile", "--profile"):
+        profile_path = value or "play_headset_profile"
+        sys.argv.remove(arg)
+        break
 
 # FW Download
 is_fw_download = True
 if (len(sys.argv) == 4):
     com_port = sys.argv[1]
     hcd_path = sys.argv[2]
-    audio_sn_included = sys.argv[3]
-elif (len(sys.argv) == 3):
+    audio_sn_included = int(sys.argv[3])
+elif (len(sys.argv) == 3 and sys.argv[2] in ("0", "1")):
     com_port = sys.argv[1]
-    audio_sn_included = sys.argv[2]
+    audio_sn_included = int(sys.argv[2])
     is_fw_download = False
+elif (len(sys.argv) == 3):
+    com_port = sys.argv[1]
+    hcd_path = sys.argv[2]
 elif (len(sys.argv) == 2):
     com_port = sys.argv[1]
     is_fw_download = False
 else:
     basename = os.path.basename(sys.argv[0])
     print("Usage:")
-    print("         {} <com_port> <hcd file> <is_audio_sn_included>".format(basename))
+    print("         {} <com_port> <hcd file> [is_audio_sn_included] [-pcm_export[=NAME]] [-record[=DIR] ...]".format(basename))
     print("\n         OR\n")
-    print("         {} <com_port> <is_audio_sn_included>".format(basename))
+    print("         {} <com_port> [is_audio_sn_included]".format(basename))
     print("         {} <com_port>       : Run without downloading firmware".format(basename))
+    print("\n         is_audio_sn_included overrides the value reported by the device")
+    print("\n         -pcm_export[=NAME] publishes the PCM in shared memory, see pcm_export.py")
+    print("         -record[=DIR] records the streams to WAV files, see recorder.py")
+    print("         -record_flac records to FLAC files, the flac command line tool must be installed")
+    print("         -record_rotate_mb=N, -record_rotate_s=N start a new file after N MiB (WAV files stay below 4 GiB) or N seconds")
+    print("         -metrics[=FILE] writes the host and device metrics in the Prometheus text format")
+    print("         -metrics_period=S seconds between two metrics updates, 15 by default")
+    print("         --profile[=PREFIX] samples the threads and times the stages, writes PREFIX.folded")
+    print("           (flamegraph.pl, speedscope) and PREFIX.txt at exit")
+    print("         -headless runs without the keyboard listener")
+    print("         -commands[=PATH] reads commands from a file or a named pipe, the standard input by default")
+    print("         -command_port=PORT accepts commands from TCP clients on 127.0.0.1")
+    print("         -scenario=FILE runs the commands of FILE then exits, see headless.py")
     exit(1)
 
 if (is_fw_download):
@@ -146,68 +241,68 @@ else:
     baud_rate = 3000000
     control = hci.Controller(com_port, baud_rate)
 
+# Capability handshake
+if control.discover() is None:
+    print("Device capabilities not reported, assuming audio serial number header")
+if audio_sn_included is None:
+    audio_sn_included = 1 if control.audio_sn_included else 0
+
 nv = nvram()
 for id in nv.ids():
     key = nv.read(id)
     control.push_nvram(id, key)
 
-control.start_bt()
-
 # PyAudio
 p = pyaudio.PyAudio()
-callback_finished = threading.Event()
+# Longest wait for the microphone callback and the SCO writes in stream_stop()
+STREAM_STOP_TIMEOUT = 0.5
+callback_idle = threading.Event()  # cleared while sending sco to controller
+callback_idle.set()
 callback_stop_stream = threading.Event()
 def rec_callback(in_data, frame_count, time_info, status):
     if callback_stop_stream.is_set():
-        print("[Python] enter callback when in the stop stream process")
         return (b'', pyaudio.paContinue)
 
-    callback_finished.clear()  # flag set when sending sco to controller
+    callback_idle.clear()
     control.send_sco(in_data)
-    callback_finished.set()
+    callback_idle.set()
     return (b'', pyaudio.paContinue)
 
 def stream_stop():
-    if 'play_stream' in globals():
+    global play_stream, rec_stream
+
+    if play_stream is not None:
         if play_stream.is_active():
             play_stream.stop_stream()
-            play_stream.close()
-            del globals()['play_stream']
+        play_stream.close()
+        play_stream = None
 
-    if 'rec_stream' in globals():
+    if rec_stream is not None:
         if (rec_stream.is_active()):
             callback_stop_stream.set()  # set stop stream flag
-            if callback_finished.is_set() is False:
-                print("[Python] Found callback is not finished")
-
-            callback_finished.wait()  # wait callback finish
-            print("[Python] Waiting callback finished")
+            deadline = time.monotonic() + STREAM_STOP_TIMEOUT
+            if not callback_idle.wait(STREAM_STOP_TIMEOUT):
+                print("[Python] Microphone callback not finished after {} s".format(STREAM_STOP_TIMEOUT))
 
-            if control.serial_instance.out_waiting > 0:  # if it's in writing process
-                control.serial_instance.flush()          # blocking wait for serial write finish
-                time.sleep(0.1)
+            # Let the last SCO packets leave the serial port
+            while control.serial_instance.out_waiting > 0 and time.monotonic() < deadline:
+                time.sleep(0.005)
 
             rec_stream.stop_stream()
-            rec_stream.close()
-            del globals()['rec_stream']
-            callback_stop_stream.clear()
+        rec_stream.close()
+        rec_stream = None
+        callback_stop_stream.clear()
 
-# Kayboard handling
+# Button handling, from the keyboard or the headless commands
 play_state = False
-def on_press(key):
-    try:
-        pass
-    except AttributeError:
-        pass
-
-def on_release(key):
+def button_press(tokens):
     global play_state
 
-    if key == keyboard.Key.f1:
+    action = tokens[0]
+    if action == "pairing":
         print('Button Allow Pairing')
         data = struct.pack("3b", button_id_mapping["PLAY"], button_event_mapping["VERY_LONG"], button_state_mapping["HELD"])
-        control.send_button(data)
-    elif key == keyboard.Key.f2:
+    elif action == "play_pause":
         print('Button Play/Pause')
         if (play_state == True):
             data = struct.pack("3b", button_id_mapping["PAUSE"], button_event_mapping["CLICK"], button_state_mapping["RELEASED"])
@@ -215,28 +310,48 @@ def on_release(key):
         else:
             data = struct.pack("3b", button_id_mapping["PLAY"], button_event_mapping["CLICK"], button_state_mapping["RELEASED"])
             play_state = True
-        control.send_button(data)
-    elif key == keyboard.Key.f3:
+    elif action == "prev":
         print('Button Prev')
         data = struct.pack("3b", button_id_mapping["PRE"], button_event_mapping["VERY_LONG"], button_state_mapping["RELEASED"])
-        control.send_button(data)
-    elif key == keyboard.Key.f4:
+    elif action == "next":
         print('Button Next')
         data = struct.pack("3b", button_id_mapping["NEXT"], button_event_mapping["VERY_LONG"], button_state_mapping["RELEASED"])
-        control.send_button(data)
+    else:
+        button_id, button_event, button_state = tokens
+        if (button_id not in button_id_mapping or button_event not in button_event_mapping or
+            button_state not in button_state_mapping):
+            raise ValueError("unknown button {} {} {}".format(button_id, button_event, button_state))
+        data = struct.pack("3b", button_id_mapping[button_id], button_event_mapping[button_event], button_state_mapping[button_state])
+    control.send_button(data)
+
+# Set to stop: Ctrl+C, end of the keyboard listener, quit command or end of the scenario
+stop_event = threading.Event()
+exit_status = 0
+
+if not is_headless:
+    from pynput import keyboard
+
+    # Kayboard handling
+    keyboard_actions = {
+        keyboard.Key.f1: "pairing",
+        keyboard.Key.f2: "play_pause",
+        keyboard.Key.f3: "prev",
+        keyboard.Key.f4: "next",
+    }
+    def on_release(key):
+        if key in keyboard_actions:
+            button_press([keyboard_actions[key]])
+
+    listener = keyboard.Listener(on_release=on_release)
+    listener.start()
+    headless.start_thread("keyboard", lambda: (listener.join(), stop_event.set()))
 
-listener = keyboard.Listener(
-    on_press=on_press,
-    on_release=on_release)
-listener.start()
-
-skip_count = 0
-last_sn = -1
 print('Headset control is starting. Press Ctrl+C to stop')
-print('F1: Allow Pairing, HFP Decline')
-print('F2: A2DP Play/Pause, HFP Answer/Hang up')
-print('F3: Prev')
-print('F4: Next')
+if not is_headless:
+    print('F1: Allow Pairing, HFP Decline')
+    print('F2: A2DP Play/Pause, HFP Answer/Hang up')
+    print('F3: Prev')
+    print('F4: Next')
 
 """
 Set default value for streaming
@@ -247,116 +362,308 @@ sample_rate = 44100
 chunk = 120
 volume = 8
 
-try:
-    while (1):
-        event_id, payload = control.read_audio()
-
-        if event_id == EventID.STREAM_START.value:  # Streaming starts
-            # Check payload length
-            if (len(payload) != 1):
-                continue
-
-            # Read stream type
-            stream_type = payload[0]
-
-            if (stream_type != stream_type_mapping["A2DP"] and
-                stream_type != stream_type_mapping["HFP"]):
-                continue
-
-            if stream_type == stream_type_mapping["A2DP"]: # A2DP
-                play_state = True
-                last_sn = -1
-            elif stream_type == stream_type_mapping["HFP"]: # HFP
-                rec_stream = p.open(format = sample_format,
-                                    channels = channels,
-                                    rate = sample_rate,
-                                    frames_per_buffer = chunk,
-                                    input = True,
-                                    stream_callback = rec_callback)
-
-                rec_stream.start_stream()
-
-            play_stream = p.open(format = sample_format,
-                                 channels = channels,
-                                 rate = sample_rate,
-                                 output = True)
-            play_stream.start_stream()
-            skip_count = 3  # skip frames to avoid overflow
-        elif event_id == EventID.STREAM_STOP.value: # Stream stops
-            # Check payload length
-            if (len(payload) != 1):
-                continue
-
-            stream_stop()
-            play_state = False
-        elif event_id == EventID.STREAM_CONFIG.value: # Stream configure
+"""
+Audio pipeline: the HCI reader thread feeds the parser, which handles the
+stream control and hands the audio to the DSP stage (header and serial
+number check) and then to the output stage (PyAudio). The NVRAM files are
+written by a background stage so a slow disk never delays the audio.
+"""
+play_stream = None
+rec_stream = None
+output_gap = GapMeter()
+# Reception to audio output time of the frames, and output underflows
+registry = metrics.Registry()
+output_latency = registry.histogram("headset_host_audio_latency_seconds",
+                                    "Time from the serial reception to the audio output write")
+output_underruns = registry.counter("headset_host_playback_underruns_total",
+                                    "Audio output underflows reported by PortAudio")
+
+def nvram_handler(item):
+    command, vs_id, key = item
+    if command == "write":
+        nv.write(str(vs_id), key)
+    else:
+        nv.delete(str(vs_id))
+
+def parser_handler(item):
+    global play_state, sample_rate, channels, volume
+
+    event_id, payload, rx_time = item
+
+    if event_id == EventID.STREAM_START.value:  # Streaming starts
+        # Check payload length
+        if (len(payload) != 1):
+            return
+
+        # Read stream type
+        stream_type = payload[0]
+
+        if (stream_type != stream_type_mapping["A2DP"] and
+            stream_type != stream_type_mapping["HFP"]):
+            return
+
+        if stream_type == stream_type_mapping["A2DP"]: # A2DP
+            play_state = True
+        parser.emit(("start", stream_type, sample_rate, channels), wait=True)
+        stream_state.update(stream_type)
+    elif event_id == EventID.STREAM_STOP.value: # Stream stops
+        # Check payload length
+        if (len(payload) != 1):
+            return
+
+        parser.emit(("stop",), wait=True)
+        play_state = False
+        stream_state.update(None)
+    elif event_id == EventID.STREAM_CONFIG.value: # Stream configure
+        # Check payload length
+        if (len(payload) != 7):
+            return
+
+        # Read configuration
+        sample_rate, samples, channels, volume = struct.unpack("<i3B", payload[0:])
+
+    elif event_id == EventID.STREAM_VOLUME.value: # Stream volume
+        # Check payload length
+        if (len(payload) != struct.calcsize("i")):
+            return
+
+        # Abstract volume value
+        volume = int.from_bytes(payload[0:struct.calcsize("i")], byteorder = 'little', signed = False)
+
+        # Check volume value
+        if (volume < stream_volume_level["LOW"] or volume > stream_volume_level["HIGH"]):
+            return
+
+        print("Set volume level: ", volume);
+        # Transporm the volume to system 100% level - todo
+
+    elif (event_id == EventID.AUDIO_DATA.value or \
+          event_id == EventID.SCO_DATA.value):
+        parser.emit(("data", payload, rx_time))
+
+    elif (event_id == EventID.WRITE_NVRAM_DATA.value):
+        vs_id = int.from_bytes(payload[0:struct.calcsize("H")], byteorder = 'little', signed = False)
+        key = payload[struct.calcsize("H"):]
+        nvram_stage.put(("write", vs_id, bytes(key)), wait=True)
+
+    elif (event_id == EventID.DELETE_NVRAM_DATA.value):
+        # Check payload length
+        if (len(payload) != struct.calcsize("H")):
+            return
+
+        vs_id = int.from_bytes(payload[0:struct.calcsize("H")], byteorder = 'little', signed = False)
+        nvram_stage.put(("delete", vs_id, None), wait=True)
+
+dsp_state = {"stream_type": None, "skip_count": 0, "last_sn": -1, "sample_rate": 0, "channels": 0,
+             "recorder": stream_recorder}
+def dsp_handler(item):
+    if item[0] == "start":
+        dsp_state["stream_type"], dsp_state["sample_rate"], dsp_state["channels"] = item[1:]
+        dsp_state["skip_count"] = 3  # skip frames to avoid overflow
+        dsp_state["last_sn"] = -1
+    elif item[0] == "stop":
+        dsp_state["stream_type"] = None
+        active_recorder = dsp_state["recorder"]
+        if active_recorder is not None:
+            active_recorder.stop_stream()
+    elif item[0] == "data":
+        payload = item[1]
+        stream_type = dsp_state["stream_type"]
+
+        if stream_type is None:
+            return
+
+        if (dsp_state["skip_count"] > 0):
+            dsp_state["skip_count"] = dsp_state["skip_count"] - 1
+            return
+
+        if stream_type == stream_type_mapping["A2DP"]: # A2DP
+            if audio_sn_included == 1:
+                # Check payload length
+                if (len(payload) <= struct.calcsize("HH")):
+                    return
+                audio_type, sn = struct.unpack_from("<HH", payload)
+                # serial number check
+                last_sn = dsp_state["last_sn"]
+                if (last_sn != -1 and sn != (last_sn + 1) & 0xffff):
+                    print("Warning: serial number jumps {} to {}".format(last_sn, sn))
+                dsp_state["last_sn"] = sn
+                pcm_data = payload[struct.calcsize("HH"):]
+            else:
+                pcm_data = payload;
+        elif stream_type == stream_type_mapping["HFP"]: # HFP
             # Check payload length
-            if (len(payload) != 7):
-                continue;
+            if (len(payload) <= 0):
+                return
+            pcm_data = payload
+        item = ("data", bytes(pcm_data), item[2])
+
+        if pcm_publisher is not None:
+            pcm_publisher.publish(stream_type,
+                                  dsp_state["sample_rate"],
+                                  dsp_state["channels"],
+                                  item[1],
+                                  dsp_state["last_sn"] if stream_type == stream_type_mapping["A2DP"] and audio_sn_included == 1 else pcm_export.NO_SERIAL)
+        active_recorder = dsp_state["recorder"]
+        if active_recorder is not None:
+            active_recorder.put(stream_type, dsp_state["sample_rate"], dsp_state["channels"], item[1])
+    # Only the audio frames may be dropped, start and stop always get through
+    dsp.emit(item, wait=item[0] != "data")
+
+def output_handler(item):
+    global play_stream, rec_stream
+
+    if item[0] == "start":
+        stream_type, rate, stream_channels = item[1:]
+        stream_stop()
+        if stream_type == stream_type_mapping["HFP"]: # HFP
+            rec_stream = p.open(format = sample_format,
+                                channels = stream_channels,
+                                rate = rate,
+                                frames_per_buffer = chunk,
+                                input = True,
+                                stream_callback = rec_callback)
+
+            rec_stream.start_stream()
+
+        play_stream = p.open(format = sample_format,
+                             channels = stream_channels,
+                             rate = rate,
+                             output = True)
+        play_stream.start_stream()
+        output_gap.reset()
+    elif item[0] == "stop":
+        stream_stop()
+        if output_gap.ticks:
+            print("[Python] {} writes, max gap {:.1f} ms, {} underruns".format(output_gap.ticks, output_gap.max_ms, output_underruns.value))
+    elif item[0] == "data" and play_stream is not None:
+        output_gap.tick()
+        start = time.perf_counter()
+        try:
+            play_stream.write(item[1], exception_on_underflow=True)
+        except OSError as exc:
+            # The frame is written anyway, PortAudio only reports the underflow
+            if exc.errno != pyaudio.paOutputUnderflowed:
+                raise
+            output_underruns.inc()
+        end = time.perf_counter()
+        if timers is not None:
+            timers.add("output pyaudio write", end - start)
+        output_latency.observe(end - item[2])
+
+sampler = None
+timers = None
+if profile_path is not None:
+    sampler = profiler.Sampler()
+    timers = profiler.Timers()
+
+def profiled(name, handler):
+    """Time the handler and the age of the timestamped items on arrival."""
+    if timers is None:
+        return handler
+    def wrapper(item):
+        start = time.perf_counter()
+        if isinstance(item[-1], float):
+            timers.add(name + " item age", start - item[-1])
+        handler(item)
+        timers.add(name + " handler", time.perf_counter() - start)
+    return wrapper
+
+nvram_stage = Stage("nvram", profiled("nvram", nvram_handler), 64)
+parser = Stage("parser", profiled("parser", parser_handler), 512)
+dsp = Stage("dsp", profiled("dsp", dsp_handler))
+output = Stage("output", profiled("output", output_handler))
+pipeline = Pipeline(parser, dsp, output)
+
+hci_rate = {"events": 0, "time": time.monotonic()}
+def host_metrics(registry):
+    protocol = control.protocol
+    if protocol is not None:
+        now = time.monotonic()
+        registry.gauge("headset_host_hci_events_per_second", "HCI events received per second").set(
+            round((protocol.events - hci_rate["events"]) / max(now - hci_rate["time"], 1e-3), 1))
+        hci_rate["events"], hci_rate["time"] = protocol.events, now
+        registry.counter("headset_host_hci_events_total", "HCI events received").set(protocol.events)
+        registry.counter("headset_host_hci_rx_bytes_total", "Bytes received from the serial port").set(protocol.rx_bytes)
+        registry.counter("headset_host_hci_parse_errors_total", "Invalid HCI packet headers").set(protocol.parse_errors)
+        registry.counter("headset_host_hci_resyncs_total", "Resynchronizations on the next packet indicator").set(protocol.resyncs)
+        registry.counter("headset_host_hci_resync_bytes_total", "Bytes skipped to resynchronize").set(protocol.resync_bytes)
+    for stage in pipeline.stages + [nvram_stage]:
+        registry.gauge("headset_host_queue_depth", "Items waiting in the input ring of a stage", stage=stage.name).set(len(stage.input))
+        registry.gauge("headset_host_queue_depth_max", "Highest input ring fill of a stage", stage=stage.name).set(stage.input.fill_max)
+        registry.counter("headset_host_queue_drops_total", "Items dropped on a full input ring", stage=stage.name).set(stage.input.drops)
+        registry.counter("headset_host_stage_items_total", "Items handled by a stage", stage=stage.name).set(stage.items)
+    for q in (0.5, 0.9, 0.99):
+        registry.gauge("headset_host_audio_latency_quantile_seconds", "Estimate from the latency histogram",
+                       quantile=q).set(round(output_latency.quantile(q), 6))
+    if stream_recorder is not None:
+        recorder_stats = stream_recorder.stats()
+        registry.counter("headset_host_recorder_bytes_total", "Bytes written by the recorder").set(recorder_stats["written_bytes"])
+        registry.counter("headset_host_recorder_overflow_frames_total", "Frames dropped by the recorder").set(recorder_stats["overflow_frames"])
+
+def device_metrics(registry):
+    up = registry.gauge("headset_device_up", "Device statistics read at the last update")
+    if control.capabilities is None or not control.capabilities.flags & hci.Capability.STATS:
+        up.set(0)
+        return
+    try:
+        metrics.export_device_stats(registry, stats.decode(control.stats()), stats.MONOTONIC)
+        up.set(1)
+    except hci.Error:
+        up.set(0)
+        raise
+
+metrics_exporter = None
+if metrics_path is not None:
+    metrics_exporter = metrics.Exporter(metrics_path, registry, metrics_period, (host_metrics, device_metrics))
+    print("Writing metrics to {}".format(metrics_exporter.path))
+
+def set_recorder(new_recorder):
+    previous = dsp_state["recorder"]
+    dsp_state["recorder"] = new_recorder
+    return previous
+
+def scenario_done(ok):
+    global exit_status
+    if not ok:
+        exit_status = 1
+    stop_event.set()
+
+stream_state = headless.StreamState()
+commands = headless.Commands(button_press, stream_state, set_recorder, stop_event)
+command_server = None
+if command_port is not None:
+    command_server = headless.CommandServer(command_port, commands)
+    command_server.start()
+    print("Accepting commands on 127.0.0.1:{}".format(command_port))
+if command_path is not None:
+    headless.start_thread("commands", headless.read_commands, command_path, commands)
+
+if sampler is not None:
+    sampler.start()
+nvram_stage.start()
+pipeline.start()
+# Stamp the events on reception for the latency histogram. The audio frames
+# are dropped on a full ring, the stream and NVRAM events wait for room.
+def audio_sink(event):
+    lossy = event[0] in (EventID.AUDIO_DATA.value, EventID.SCO_DATA.value)
+    pipeline.put(event + (time.perf_counter(),), wait=not lossy)
+control.audio_sink = audio_sink
+if metrics_exporter is not None:
+    metrics_exporter.start()
 
-            # Read configuration
-            sample_rate, samples, channels, volume = struct.unpack("<i3B", payload[0:])
+control.start_bt()
 
-        elif event_id == EventID.STREAM_VOLUME.value: # Stream volume
-            # Check payload length
-            if (len(payload) != struct.calcsize("i")):
-                continue
-
-            # Abstract volume value
-            volume = int.from_bytes(payload[0:struct.calcsize("i")], byteorder = 'little', signed = False)
-
-            # Check volume value
-            if (volume < stream_volume_level["LOW"] or volume > stream_volume_level["HIGH"]):
-                continue
-
-            print("Set volume level: ", volume);
-            # Transporm the volume to system 100% level - todo
-
-        elif (event_id == EventID.AUDIO_DATA.value or \
-              event_id == EventID.SCO_DATA.value):
-            if 'stream_type' in locals() and 'play_stream' in globals():
-                if (stream_type != stream_type_mapping["A2DP"] and
-                    stream_type != stream_type_mapping["HFP"]):
-                    continue
-
-                if (skip_count > 0):
-                    skip_count = skip_count - 1
-                    continue
-
-                if stream_type == stream_type_mapping["A2DP"]: # A2DP
-                    if audio_sn_included == 1:
-                        # Check payload length
-                        if (len(payload) <= struct.calcsize("HH")):
-                            continue
-                        audio_type, sn = struct.unpack_from("<HH", payload)
-                        # serial number check
-                        if (last_sn != -1 and sn != (last_sn + 1) & 0xffff):
-                            print("Warning: serial number jumps {} to {}".format(last_sn, sn))
-                        last_sn = sn
-                        pcm_data = payload[struct.calcsize("HH"):]
-                    else:
-                        pcm_data = payload;
-                elif stream_type == stream_type_mapping["HFP"]: # HFP
-                    # Check payload length
-                    if (len(payload) <= 0):
-                        continue
-                    pcm_data = payload
-                play_stream.write(bytes(pcm_data))
-        elif (event_id == EventID.WRITE_NVRAM_DATA.value):
-            vs_id = int.from_bytes(payload[0:struct.calcsize("H")], byteorder = 'little', signed = False)
-            key = payload[struct.calcsize("H"):]
-            nv.write(str(vs_id), key)
-
-        elif (event_id == EventID.DELETE_NVRAM_DATA.value):
-            # Check payload length
-            if (len(payload) != struct.calcsize("H")):
-                continue
+if scenario_path is not None:
+    headless.start_thread("scenario", headless.run_scenario, scenario_path, commands, scenario_done)
 
-            vs_id = int.from_bytes(payload[0:struct.calcsize("H")], byteorder = 'little', signed = False)
-            nv.delete(str(vs_id))
+# Everything allocated so far lives until exit, keep it out of the collections.
+gc.freeze()
 
-        if (listener.running == False):
-            break
+try:
+    # Timed wait, an untimed one is not interrupted by Ctrl+C on Windows
+    while not stop_event.wait(1):
+        pass
 
 except SystemExit:
     exit(0)
@@ -365,9 +672,34 @@ except:
     exit(1)
 finally:
     print('Headset control stopped')
+    stop_event.set()
+    if command_server is not None:
+        command_server.stop()
+    control.audio_sink = None
+    pipeline.stop()
+    nvram_stage.stop()
+    for name, stage_stats in pipeline.stats().items():
+        print("[Python] {}: {}".format(name, stage_stats))
+    print("[Python] nvram: {}".format(nvram_stage.stats()))
     stream_stop()
+    if pcm_publisher is not None:
+        pcm_publisher.close()
+    if stream_recorder is not None:
+        stream_recorder.stop()
+        print("[Python] recorder: {}".format(stream_recorder.stats()))
+    if metrics_exporter is not None:
+        metrics_exporter.stop()
+    if sampler is not None:
+        sampler.stop()
+        sampler.write_folded(profile_path + ".folded")
+        summary = timers.summary() + [""] + sampler.summary()
+        with open(profile_path + ".txt", "w") as file:
+            file.write("\n".join(summary) + "\n")
+        print("\n".join(summary))
+        print("[Python] profile: {} samples, {}.folded, {}.txt".format(sampler.samples, profile_path, profile_path))
     p.terminate()
     control.close()
-    listener.stop()
+    if not is_headless:
+        listener.stop()
 
-exit(0)
+exit(exit_status)
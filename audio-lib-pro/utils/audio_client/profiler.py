@@ -0,0 +1,130 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Statistical profiler and timers for the host client.
+
+Sampler wakes up every interval seconds and records the Python stack of
+every other thread (sys._current_frames()). write_folded() writes the
+samples in the folded stack format, one "thread;outer;...;inner count"
+line per distinct stack, the format of py-spy --format raw, which
+flamegraph.pl, inferno and speedscope read. The cost is one stack walk
+per thread and interval, about 1 % of a core at the default 5 ms.
+
+Timers accumulates durations measured by the caller, e.g. the time an
+item waited before a stage or the time spent in a PyAudio write.
+"""
+import collections
+import os
+import sys
+import threading
+
+
+def _frame_name(code):
+    return "{} ({})".format(code.co_name, os.path.basename(code.co_filename))
+
+
+class Sampler(threading.Thread):
+    def __init__(self, interval=0.005):
+        super().__init__(name="sampler", daemon=True)
+        self.interval = interval
+        self.samples = 0
+        self.stacks = collections.Counter()
+        self._stopped = threading.Event()
+
+    def run(self):
+        own = threading.get_ident()
+        names = {}
+        while not self._stopped.wait(self.interval):
+            frames = sys._current_frames()
+            if len(names) != len(frames):
+                names = {thread.ident: thread.name for thread in threading.enumerate()}
+            for ident, frame in frames.items():
+                if ident == own:
+                    continue
+                stack = []
+                while frame is not None:
+                    stack.append(_frame_name(frame.f_code))
+                    frame = frame.f_back
+                stack.append(names.get(ident, str(ident)))
+                self.stacks[tuple(reversed(stack))] += 1
+            self.samples += 1
+
+    def stop(self, timeout=1):
+        self._stopped.set()
+        if self.is_alive():
+            self.join(timeout)
+
+    def write_folded(self, path):
+        with open(path, "w") as file:
+            for stack, count in self.stacks.most_common():
+                file.write("{} {}\n".format(";".join(stack), count))
+
+    def summary(self, top=15):
+        """Lines of the functions with the most samples on top of the stack
+        (self) and anywhere in it (total), idle waits included."""
+        own = collections.Counter()
+        total = collections.Counter()
+        for stack, count in self.stacks.items():
+            own[(stack[0], stack[-1])] += count
+            for name in set(stack[1:]):
+                total[(stack[0], name)] += count
+        lines = ["{:>7} {:>7}  {}".format("self %", "total %", "thread: function")]
+        for key, count in own.most_common(top):
+            lines.append("{:7.1f} {:7.1f}  {}: {}".format(
+                100.0 * count / max(self.samples, 1),
+                100.0 * total[key] / max(self.samples, 1), *key))
+        return lines
+
+
+class Timers:
+    def __init__(self):
+        self._timers = {}
+        self._lock = threading.Lock()
+
+    def add(self, name, seconds):
+        timer = self._timers.get(name)
+        if timer is None:
+            with self._lock:
+                timer = self._timers.setdefault(name, [0, 0.0, 0.0])
+        timer[0] += 1
+        timer[1] += seconds
+        if seconds > timer[2]:
+            timer[2] = seconds
+
+    def summary(self):
+        lines = ["{:<24} {:>8} {:>10} {:>9} {:>9}".format("timer", "count", "total ms", "avg us", "max ms")]
+        with self._lock:
+            timers = sorted(self._timers.items())
+        for name, (count, total, longest) in timers:
+            lines.append("{:<24} {:8d} {:10.1f} {:9.1f} {:9.2f}".format(
+                name, count, total * 1000, total * 1e6 / count if count else 0, longest * 1000))
+        return lines
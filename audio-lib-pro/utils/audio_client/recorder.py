@@ -0,0 +1,251 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Stream recorder for soak tests.
+
+Recorder.put() is called by the audio loop and never blocks: the frame is
+appended to a ring bounded by a memory cap, a frame which does not fit is
+dropped and counted. A writer thread batches the frames into large writes
+aligned on WRITE_ALIGN bytes of the file, and rotates the files by size or
+time, and whenever the stream (type, rate or channels) changes. A WAV file
+is always rotated before it reaches the 4 GiB limit of the RIFF sizes.
+
+Files are WAV, or FLAC when flac=True: the PCM is then piped to a flac
+encoder process (the reference "flac" command line tool must be in the
+PATH), so the encoding runs outside of this process.
+"""
+import os
+import shutil
+import struct
+import subprocess
+import threading
+import time
+
+from pipeline import SpscRing
+
+WRITE_ALIGN = 4096
+WRITE_BATCH = 16 * WRITE_ALIGN
+WRITE_INTERVAL = 0.5                # seconds, longest time a frame waits for the batch
+
+# The RIFF sizes are 32 bits: a WAV file is rotated before its data reaches
+# 4 GiB, with room for the frame added after the rotation check.
+WAV_DATA_MAX = (0xFFFFFFFF - 36) // WRITE_ALIGN * WRITE_ALIGN - WRITE_BATCH
+
+_STREAM_NAMES = ("A2DP", "HFP")
+_STREAM_END = object()
+
+
+class _Output:
+    """One recording file."""
+
+    def __init__(self, path, sample_rate, channels, flac):
+        self.path = path
+        self.data_bytes = 0
+        self.started = time.monotonic()
+        self._position = 0
+        self._process = None
+        if flac:
+            self._process = subprocess.Popen(
+                [
+                    "flac", "--silent", "--force", "--force-raw-format", "--endian=little",
+                    "--sign=signed", "--channels={}".format(channels), "--bps=16",
+                    "--sample-rate={}".format(sample_rate), "-o", path, "-",
+                ],
+                stdin=subprocess.PIPE,
+            )
+            self._file = self._process.stdin
+        else:
+            self._file = open(path, "wb", buffering=0)
+            self._write(self._wav_header(sample_rate, channels, 0))
+
+    @staticmethod
+    def _wav_header(sample_rate, channels, data_bytes):
+        return struct.pack(
+            "<4sL4s4sLHHLLHH4sL",
+            b"RIFF", 36 + data_bytes, b"WAVE", b"fmt ", 16, 1, channels, sample_rate,
+            sample_rate * channels * 2, channels * 2, 16, b"data", data_bytes,
+        )
+
+    def _write(self, data):
+        self._file.write(data)
+        self._position += len(data)
+
+    def write(self, batch, final=False):
+        """Write the aligned part of batch (all of it if final), return the
+        number of bytes consumed."""
+        if final or self._process is not None:
+            size = len(batch)
+        else:
+            size = (self._position + len(batch)) // WRITE_ALIGN * WRITE_ALIGN - self._position
+        if size > 0:
+            self._write(memoryview(batch)[:size])
+            self.data_bytes += size
+        return max(size, 0)
+
+    def close(self, sample_rate, channels):
+        if self._process is not None:
+            self._file.close()
+            self._process.wait()
+        else:
+            # The sizes are only known now, a file cut short keeps zero sizes.
+            self._file.seek(0)
+            self._file.write(self._wav_header(sample_rate, channels, self.data_bytes))
+            self._file.close()
+
+
+class Recorder(threading.Thread):
+    """Record the frames given to put() under directory."""
+
+    def __init__(self, directory, flac=False, memory_cap=8 * 1024 * 1024,
+                 rotate_bytes=512 * 1024 * 1024, rotate_seconds=3600):
+        super().__init__(name="recorder", daemon=True)
+        if flac and shutil.which("flac") is None:
+            raise RuntimeError("flac encoder not found in the PATH")
+        self.directory = directory
+        self.flac = flac
+        self.memory_cap = memory_cap
+        self.rotate_bytes = rotate_bytes if flac else min(rotate_bytes, WAV_DATA_MAX)
+        self.rotate_seconds = rotate_seconds
+        os.makedirs(directory, exist_ok=True)
+
+        self._ring = SpscRing(4096)
+        self._queued = 0            # bytes, written by put() only
+        self._dequeued = 0          # bytes written to the file, by the writer thread only
+        self._running = threading.Event()
+        self._stream = None
+        self._output = None
+        self._batch = bytearray()
+        self._batch_time = None
+
+        self.frames = 0
+        self.overflow_frames = 0
+        self.overflow_bytes = 0
+        self.written_bytes = 0
+        self.files = []
+        self.write_max_ms = 0.0
+
+    def put(self, stream_type, sample_rate, channels, pcm):
+        """Queue a frame, return False if it was dropped."""
+        if (self._queued - self._dequeued + len(pcm) > self.memory_cap or
+                not self._ring.put(((stream_type, sample_rate, channels), pcm))):
+            self.overflow_frames += 1
+            self.overflow_bytes += len(pcm)
+            return False
+        self._queued += len(pcm)
+        return True
+
+    def stop_stream(self):
+        """Close the file of the current stream once its frames are written.
+        Called from the thread calling put()."""
+        self._ring.put(_STREAM_END)
+
+    def start(self):
+        self._running.set()
+        super().start()
+
+    def stop(self, timeout=5):
+        """Write the queued frames and close the file."""
+        self._running.clear()
+        if self.is_alive():
+            self.join(timeout)
+
+    def run(self):
+        while self._running.is_set() or len(self._ring):
+            item = self._ring.get(0.1)
+            if item is None:
+                if self._batch_time is not None and time.monotonic() - self._batch_time >= WRITE_INTERVAL:
+                    self._flush()
+            elif item is _STREAM_END:
+                self._close()
+            else:
+                if item[0] != self._stream:
+                    self._close()
+                self._add(*item)
+        self._close()
+
+    def _add(self, stream, pcm):
+        self.frames += 1
+        if self._output is None:
+            self._open(stream)
+        if self._batch_time is None:
+            self._batch_time = time.monotonic()
+        self._batch += pcm
+        if len(self._batch) >= WRITE_BATCH:
+            self._flush()
+        if (self._output.data_bytes + len(self._batch) >= self.rotate_bytes or
+                time.monotonic() - self._output.started >= self.rotate_seconds):
+            self._close()
+
+    def _open(self, stream):
+        stream_type, sample_rate, channels = stream
+        stem = os.path.join(self.directory, "headset_{}_{}_{}hz_{}ch".format(
+            _STREAM_NAMES[stream_type] if stream_type < len(_STREAM_NAMES) else stream_type,
+            time.strftime("%Y%m%d-%H%M%S"), sample_rate, channels,
+        ))
+        extension = ".flac" if self.flac else ".wav"
+        path = stem + extension
+        suffix = 1
+        while os.path.exists(path):
+            path = "{}-{}{}".format(stem, suffix, extension)
+            suffix += 1
+        self._stream = stream
+        self._output = _Output(path, sample_rate, channels, self.flac)
+        self.files.append(path)
+
+    def _flush(self, final=False):
+        if self._output is not None and self._batch:
+            start = time.perf_counter()
+            size = self._output.write(self._batch, final)
+            self.write_max_ms = max(self.write_max_ms, (time.perf_counter() - start) * 1000)
+            self.written_bytes += size
+            # The batch counts toward the memory cap until it is written.
+            self._dequeued += size
+            del self._batch[:size]
+        self._batch_time = time.monotonic() if self._batch else None
+
+    def _close(self):
+        if self._output is not None:
+            self._flush(final=True)
+            self._output.close(*self._stream[1:])
+            self._output = None
+        self._stream = None
+
+    def stats(self):
+        return {
+            "frames": self.frames,
+            "written_bytes": self.written_bytes,
+            "queued_bytes": self._queued - self._dequeued,
+            "overflow_frames": self.overflow_frames,
+            "overflow_bytes": self.overflow_bytes,
+            "files": len(self.files),
+            "write_max_ms": round(self.write_max_ms, 2),
+        }
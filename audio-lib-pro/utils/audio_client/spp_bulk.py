@@ -0,0 +1,435 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Client of the SPP bulk data service of the headset (headset_spp.h), of
+its LE CoC counterpart (headset_le_coc.h) and a local stand-in for them.
+
+The headset serves RFCOMM channel 2 (the SPP record) when built with
+SPP_BULK=1, and LE PSM 0x0081 when built with LE_COC=1. Each request is
+answered before the next one is sent:
+
+    spp_bulk.py <PEER> stats                 decoded statistics snapshot
+    spp_bulk.py <PEER> timeline              pairing and connection timelines
+    spp_bulk.py <PEER> backup <FILE>         NVRAM items, nvram.py JSON format
+    spp_bulk.py <PEER> bench_tx <BYTES>      headset to host throughput
+    spp_bulk.py <PEER> bench_rx <BYTES>      host to headset throughput
+    spp_bulk.py <LE PEER> gatt_rx <BYTES>    host to headset, GATT write
+                                             without response
+    spp_bulk.py <LE PEER> compare <BYTES>    bench_rx against gatt_rx
+    spp_bulk.py standin [PORT]               serve the protocol on 127.0.0.1
+
+PEER is the Bluetooth address of the headset for SPP, le:ADDR or
+le-random:ADDR for the LE CoC (no NVRAM backup), or tcp:HOST:PORT for a
+stand-in. The stand-in answers like the headset with synthetic data, the
+client, the framing and the host side of the benchmarks can be exercised
+without a headset; over the loopback interface its throughput is the upper
+bound of the host side.
+
+The LE peers need a Linux host whose Python takes the LE address type in
+L2CAP socket addresses. The headset only accepts the LE CoC over an
+encrypted link, the host pairs with it if needed. gatt_rx writes the GATT sink characteristic over
+its own ATT socket, bluetoothd shall not hold the ATT channel of the link.
+
+The benchmarks report kbit/s against TARGET_KBPS, several times what the LE
+GATT notifications of the headset move.
+"""
+import base64
+import json
+import socket
+import socketserver
+import sys
+import time
+from struct import pack, unpack, unpack_from
+
+import stats
+import timeline
+
+RFCOMM_SCN = 2
+MTU = 994                   # WICED_APP_CFG_MAX_RX_MTU less the RFCOMM header
+LE_COC_PSM = 0x0081
+LE_COC_MTU = 986            # 4 full LE data PDUs less the SDU length
+GATT_SINK_HANDLE = 0x95     # HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL
+STANDIN_PORT = 7002
+TARGET_KBPS = 1500
+
+OP_STATS = 0x01
+OP_TIMELINE = 0x02
+OP_NVRAM = 0x03
+OP_BENCH_TX = 0x10
+OP_BENCH_RX = 0x11
+
+STATUS = {0: "success", 1: "unknown opcode", 2: "invalid parameter", 3: "link not encrypted", 4: "error"}
+
+LEN_STREAM = 0xFFFFFFFF
+
+# Linux Bluetooth socket constants
+BDADDR_LE_PUBLIC = 1
+BDADDR_LE_RANDOM = 2
+SOL_BLUETOOTH = 274
+BT_SECURITY = 4
+BT_SECURITY_MEDIUM = 2      # encrypted link
+BT_RCVMTU = 13
+ATT_CID = 4
+ATT_MTU = 365               # ble_max_rx_pdu_size of the headset
+
+ATT_EXCHANGE_MTU_REQ = 0x02
+ATT_EXCHANGE_MTU_RSP = 0x03
+ATT_READ_REQ = 0x0A
+ATT_READ_RSP = 0x0B
+ATT_ERROR_RSP = 0x01
+ATT_WRITE_CMD = 0x52
+
+
+class ResponseError(Exception):
+    pass
+
+
+def _le_peer(peer):
+    """Return (address, address type) of an le: or le-random: peer, or None."""
+    if peer.startswith("le:"):
+        return peer[3:], BDADDR_LE_PUBLIC
+    if peer.startswith("le-random:"):
+        return peer[10:], BDADDR_LE_RANDOM
+    return None
+
+
+def _le_socket(address, address_type, psm, cid):
+    sock = socket.socket(socket.AF_BLUETOOTH, socket.SOCK_SEQPACKET, socket.BTPROTO_L2CAP)
+    try:
+        sock.setsockopt(SOL_BLUETOOTH, BT_RCVMTU, LE_COC_MTU if psm else ATT_MTU)
+        if psm:
+            sock.setsockopt(SOL_BLUETOOTH, BT_SECURITY, pack("<BB", BT_SECURITY_MEDIUM, 0))
+        sock.connect((address, psm, cid, address_type))
+    except (OSError, TypeError):
+        sock.close()
+        raise
+    return sock
+
+
+class Client:
+    """Requests to the bulk data service over a connected socket.
+
+    The LE CoC socket delivers whole SDUs, the received data is buffered so
+    the responses are read the same way from a stream and from SDUs.
+    """
+
+    def __init__(self, sock, mtu=MTU):
+        self.sock = sock
+        self.mtu = mtu
+        self._rx = bytearray()
+
+    @classmethod
+    def connect(cls, peer):
+        le = _le_peer(peer)
+        if le is not None:
+            return cls(_le_socket(le[0], le[1], LE_COC_PSM, 0), LE_COC_MTU)
+        if peer.startswith("tcp:"):
+            host, port = peer[4:].rsplit(":", 1)
+            sock = socket.create_connection((host, int(port)))
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        else:
+            sock = socket.socket(socket.AF_BLUETOOTH, socket.SOCK_STREAM, socket.BTPROTO_RFCOMM)
+            sock.connect((peer, RFCOMM_SCN))
+        return cls(sock)
+
+    def close(self):
+        self.sock.close()
+
+    def _fill(self):
+        chunk = self.sock.recv(65536)
+        if not chunk:
+            raise ConnectionError("connection closed")
+        self._rx += chunk
+
+    def _recv_exact(self, length):
+        while len(self._rx) < length:
+            self._fill()
+        data = bytes(self._rx[:length])
+        del self._rx[:length]
+        return data
+
+    def _skip(self, length):
+        while length:
+            if not self._rx:
+                self._fill()
+            skip = min(length, len(self._rx))
+            del self._rx[:skip]
+            length -= skip
+
+    def _request(self, op, param=b""):
+        self.sock.sendall(pack("<BB", op, len(param)) + param)
+        rsp_op, status, length = unpack("<BBL", self._recv_exact(6))
+        if rsp_op != op:
+            raise ResponseError("response to 0x%02x, expected 0x%02x" % (rsp_op, op))
+        if status:
+            raise ResponseError(STATUS.get(status, "status %d" % status))
+        return length
+
+    def stats(self):
+        """Raw statistics snapshot, see stats.decode()."""
+        return self._recv_exact(self._request(OP_STATS))
+
+    def timeline(self):
+        """Raw timelines, see timeline.decode()."""
+        return self._recv_exact(self._request(OP_TIMELINE))
+
+    def nvram(self):
+        """Return {NVRAM ID: data} of the application items."""
+        self._request(OP_NVRAM)
+        items = {}
+        while True:
+            item_id, length = unpack("<HH", self._recv_exact(4))
+            if item_id == 0:
+                return items
+            items[item_id] = self._recv_exact(length)
+
+    def bench_tx(self, length):
+        """Receive length bytes from the peer, return kbit/s."""
+        start = time.perf_counter()
+        self._skip(self._request(OP_BENCH_TX, pack("<L", length)))
+        return length * 8 / 1000 / (time.perf_counter() - start)
+
+    def bench_rx(self, length):
+        """Send length bytes to the peer, return (host kbit/s, peer kbit/s)."""
+        frame = bytes(range(256)) * (self.mtu // 256) + bytes(self.mtu % 256)
+        start = time.perf_counter()
+        self.sock.sendall(pack("<BBL", OP_BENCH_RX, 4, length))
+        sent = 0
+        while sent < length:
+            chunk = frame[:min(self.mtu, length - sent)]
+            self.sock.sendall(chunk)
+            sent += len(chunk)
+        rsp_op, status, rsp_len = unpack("<BBL", self._recv_exact(6))
+        if rsp_op != OP_BENCH_RX or status:
+            raise ResponseError(STATUS.get(status, "status %d" % status))
+        duration_ms, = unpack("<L", self._recv_exact(rsp_len))
+        host = length * 8 / 1000 / (time.perf_counter() - start)
+        return host, (length * 8 / duration_ms if duration_ms else 0)
+
+
+class GattSink:
+    """Writes to the GATT sink characteristic over an ATT socket."""
+
+    def __init__(self, sock):
+        self.sock = sock
+        self.mtu = 23
+
+    @classmethod
+    def connect(cls, peer):
+        le = _le_peer(peer)
+        if le is None:
+            raise ValueError("GATT needs an le: or le-random: peer")
+        sink = cls(_le_socket(le[0], le[1], 0, ATT_CID))
+        sink.sock.send(pack("<BH", ATT_EXCHANGE_MTU_REQ, ATT_MTU))
+        server_mtu, = unpack("<H", sink._response(ATT_EXCHANGE_MTU_RSP))
+        sink.mtu = min(ATT_MTU, server_mtu)
+        return sink
+
+    def close(self):
+        self.sock.close()
+
+    def _response(self, opcode):
+        # Notifications and indications of the headset are not expected, skip them.
+        while True:
+            pdu = self.sock.recv(65536)
+            if not pdu:
+                raise ConnectionError("connection closed")
+            if pdu[0] == opcode:
+                return pdu[1:]
+            if pdu[0] == ATT_ERROR_RSP:
+                raise ResponseError("ATT error 0x%02x" % pdu[4])
+
+    def read(self):
+        """End the run of the sink, return (bytes, ms) seen by the headset."""
+        self.sock.send(pack("<BH", ATT_READ_REQ, GATT_SINK_HANDLE))
+        return unpack_from("<LL", self._response(ATT_READ_RSP))
+
+    def bench_rx(self, length):
+        """Write length bytes, return (host kbit/s, peer kbit/s)."""
+        payload = self.mtu - 3
+        frame = pack("<BH", ATT_WRITE_CMD, GATT_SINK_HANDLE) + bytes(i & 0xFF for i in range(payload))
+        self.read()
+        start = time.perf_counter()
+        sent = 0
+        while sent < length:
+            chunk = min(payload, length - sent)
+            self.sock.send(frame[:3 + chunk])
+            sent += chunk
+        received, duration_ms = self.read()
+        host = length * 8 / 1000 / (time.perf_counter() - start)
+        if received != length:
+            raise ResponseError("headset received %d of %d bytes" % (received, length))
+        return host, (received * 8 / duration_ms if duration_ms else 0)
+
+
+class _StandInHandler(socketserver.BaseRequestHandler):
+    """Answers like headset_spp.c with synthetic data."""
+
+    def _recv_exact(self, length):
+        data = bytearray()
+        while len(data) < length:
+            chunk = self.request.recv(length - len(data))
+            if not chunk:
+                raise ConnectionError
+            data += chunk
+        return bytes(data)
+
+    def _respond(self, op, status, length, data=b""):
+        self.request.sendall(pack("<BBL", op, status, length) + data)
+
+    def handle(self):
+        self.request.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        start = time.monotonic()
+        frame = bytes(i & 0xFF for i in range(MTU))
+        try:
+            while True:
+                op, param_len = unpack("<BB", self._recv_exact(2))
+                param = self._recv_exact(param_len)
+                now_ms = int((time.monotonic() - start) * 1000)
+                if op == OP_STATS:
+                    data = pack("<BL", stats.VERSION, now_ms) + pack("<BBL", stats.MEMORY, 4, 20000)
+                    self._respond(op, 0, len(data), data)
+                elif op == OP_TIMELINE:
+                    data = pack("<BLBB", timeline.VERSION, now_ms, len(timeline.STEPS), 0)
+                    self._respond(op, 0, len(data), data)
+                elif op == OP_NVRAM:
+                    items = b"".join(pack("<HH", 0x200 + i, 16) + bytes([i]) * 16 for i in range(3))
+                    self._respond(op, 0, LEN_STREAM, items + pack("<HH", 0, 0))
+                elif op in (OP_BENCH_TX, OP_BENCH_RX) and param_len == 4:
+                    length, = unpack("<L", param)
+                    if op == OP_BENCH_TX:
+                        self._respond(op, 0, length)
+                        while length:
+                            chunk = frame[:min(MTU, length)]
+                            self.request.sendall(chunk)
+                            length -= len(chunk)
+                    else:
+                        sink_start = time.monotonic()
+                        while length:
+                            chunk = self.request.recv(min(length, 65536))
+                            if not chunk:
+                                raise ConnectionError
+                            length -= len(chunk)
+                        duration_ms = int((time.monotonic() - sink_start) * 1000)
+                        self._respond(op, 0, 4, pack("<L", duration_ms))
+                elif op in (OP_BENCH_TX, OP_BENCH_RX):
+                    self._respond(op, 2, 0)
+                else:
+                    self._respond(op, 1, 0)
+        except ConnectionError:
+            pass
+
+
+class StandIn(socketserver.ThreadingTCPServer):
+    """Stand-in for the headset on the loopback interface."""
+
+    daemon_threads = True
+    allow_reuse_address = True
+
+    def __init__(self, port=STANDIN_PORT):
+        super().__init__(("127.0.0.1", port), _StandInHandler)
+
+
+def _print_values(name, values, indent=""):
+    if isinstance(values, dict):
+        print("%s%s:" % (indent, name))
+        for key in values:
+            _print_values(key, values[key], indent + "  ")
+    else:
+        print("%s%s: %s" % (indent, name, values))
+
+
+def _verdict(kbps):
+    return "%.0f kbit/s (target %d kbit/s: %s)" % (kbps, TARGET_KBPS, "met" if kbps >= TARGET_KBPS else "missed")
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__)
+        return 2
+
+    if argv[0] == "standin":
+        server = StandIn(int(argv[1]) if len(argv) > 1 else STANDIN_PORT)
+        print("Stand-in listening on 127.0.0.1:%d" % server.server_address[1])
+        try:
+            server.serve_forever()
+        except KeyboardInterrupt:
+            pass
+        return 0
+
+    client = Client.connect(argv[0])
+    try:
+        command = argv[1]
+        if command == "stats":
+            snapshot = stats.decode(client.stats())
+            for name in snapshot:
+                _print_values(name, snapshot[name])
+        elif command == "timeline":
+            for line in timeline.render(timeline.decode(client.timeline())):
+                print(line)
+        elif command == "backup":
+            items = client.nvram()
+            with open(argv[2], "w") as f:
+                json.dump({str(item_id): base64.b64encode(data).decode("ascii") for item_id, data in items.items()}, f)
+            print("%d NVRAM items, %d bytes" % (len(items), sum(len(data) for data in items.values())))
+        elif command == "bench_tx":
+            print("Headset to host: " + _verdict(client.bench_tx(int(argv[2]))))
+        elif command == "bench_rx":
+            host, peer = client.bench_rx(int(argv[2]))
+            print("Host to headset: " + _verdict(host) + ", %.0f kbit/s seen by the headset" % peer)
+        elif command in ("gatt_rx", "compare"):
+            results = []
+            if command == "compare":
+                results.append(("L2CAP CoC", client.bench_rx(int(argv[2]))))
+            sink = GattSink.connect(argv[0])
+            try:
+                results.append(("GATT write cmd", sink.bench_rx(int(argv[2]))))
+            finally:
+                sink.close()
+            print("Host to headset  Host kbit/s  Headset kbit/s")
+            for name, (host, peer) in results:
+                print("%-15s %12.0f %15.0f" % (name, host, peer))
+            if len(results) == 2 and results[1][1][1]:
+                print("CoC goodput: %.1fx GATT" % (results[0][1][1] / results[1][1][1]))
+        else:
+            print(__doc__)
+            return 2
+    except ResponseError as error:
+        print("Error: %s" % error)
+        return 1
+    finally:
+        client.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,312 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Decoder of the device statistics snapshot (HCI_CONTROL_HCI_AUDIO_EVENT_STATS).
+
+A snapshot is a version byte, a millisecond timestamp and TLV records.
+decode() turns one snapshot into a dictionary, Rates turns successive
+snapshots into per second rates of the monotonic counters.
+"""
+from struct import unpack_from
+
+VERSION = 1
+
+MEMORY = 0x01
+POOLS = 0x02
+MIC = 0x03
+MGMT_CB = 0x04
+WORK = 0x05
+TIMER = 0x06
+LINK = 0x07
+SNIFF = 0x08
+AVRC = 0x09
+GATT = 0x0A
+SDP = 0x0B
+LE_BOND = 0x0C
+SPP = 0x0D
+LE_COC = 0x0E
+
+WORK_PRIORITIES = ("audio", "normal", "background")
+SNIFF_MODES = ("active", "sniff", "ssr", "other")
+
+
+def _bd_addr(data, offset):
+    return ":".join("{:02x}".format(b) for b in data[offset:offset + 6])
+
+
+def _memory(value):
+    return {"free_bytes": unpack_from("<L", value)[0]}
+
+
+def _pools(value):
+    pools = []
+    for offset in range(0, len(value) - 7, 8):
+        size, in_use, max_in_use, total = unpack_from("<4H", value, offset)
+        pools.append(
+            {"size": size, "in_use": in_use, "max_in_use": max_in_use, "total": total}
+        )
+    return pools
+
+
+def _mic(value):
+    fill, fill_max, bytes_in, bytes_out, overflow, underrun = unpack_from("<2H4L", value)
+    return {
+        "fill": fill,
+        "fill_max": fill_max,
+        "bytes_in": bytes_in,
+        "bytes_out": bytes_out,
+        "overflow": overflow,
+        "underrun": underrun,
+    }
+
+
+def _mgmt_cb(value):
+    count, max_us, max_event, total_ms = unpack_from("<LLBL", value)
+    return {"count": count, "max_us": max_us, "max_event": max_event, "total_ms": total_ms}
+
+
+def _work(value):
+    count = len(WORK_PRIORITIES)
+    counters = unpack_from("<{}L".format(2 * count), value)
+    dropped, in_use_max, run_time_max_us = unpack_from("<LHL", value, 8 * count)
+    work = {
+        "dropped": dropped,
+        "in_use_max": in_use_max,
+        "run_time_max_us": run_time_max_us,
+    }
+    for i, name in enumerate(WORK_PRIORITIES):
+        work["posted_" + name] = counters[2 * i]
+        work["executed_" + name] = counters[2 * i + 1]
+    return work
+
+
+def _timer(value):
+    names = ("wakeups", "expired", "coalesced", "wakeups_per_minute", "expired_per_minute")
+    return dict(zip(names, unpack_from("<5L", value)))
+
+
+def _link(value):
+    links = {}
+    for offset in range(0, len(value) - 14, 15):
+        rssi, rssi_avg, edr_3m, switches, samples = unpack_from("<bbBHL", value, offset + 6)
+        links[_bd_addr(value, offset)] = {
+            "rssi": rssi,
+            "rssi_avg": rssi_avg,
+            "edr_3m": edr_3m,
+            "switches": switches,
+            "samples": samples,
+        }
+    return links
+
+
+def _sniff(value):
+    size = 7 + 4 * len(SNIFF_MODES)
+    links = {}
+    for offset in range(0, len(value) - size + 1, size):
+        mode = value[offset + 6]
+        times = unpack_from("<{}L".format(len(SNIFF_MODES)), value, offset + 7)
+        link = {"mode": SNIFF_MODES[mode] if mode < len(SNIFF_MODES) else mode}
+        for name, time_ms in zip(SNIFF_MODES, times):
+            link["time_ms_" + name] = time_ms
+        links[_bd_addr(value, offset)] = link
+    return links
+
+
+def _avrc(value):
+    names = ("notifications", "registrations", "metadata_requests")
+    return dict(zip(names, unpack_from("<3L", value)))
+
+
+def _gatt(value):
+    bearers = []
+    for offset in range(0, len(value) - 20, 21):
+        conn_id, mtu, eatt, requests, notifications, handler_max_us, handler_total_us = unpack_from(
+            "<HHB4L", value, offset
+        )
+        bearers.append(
+            {
+                "conn_id": conn_id,
+                "mtu": mtu,
+                "eatt": eatt,
+                "requests": requests,
+                "notifications": notifications,
+                "handler_max_us": handler_max_us,
+                "handler_avg_us": handler_total_us // requests if requests else 0,
+            }
+        )
+    return bearers
+
+
+def _sdp(value):
+    db_size, db_saved, exchanges, last_ms, max_ms, total_ms = unpack_from("<3H3L", value)
+    return {
+        "db_size": db_size,
+        "db_saved": db_saved,
+        "exchanges": exchanges,
+        "last_ms": last_ms,
+        "max_ms": max_ms,
+        "avg_ms": total_ms // exchanges if exchanges else 0,
+    }
+
+
+def _le_bond(value):
+    bonds, accept_list_size, directed_adv, reconnects, unknown_peers, last_ms, max_ms, total_ms = unpack_from(
+        "<BB3H3L", value
+    )
+    return {
+        "bonds": bonds,
+        "accept_list_size": accept_list_size,
+        "directed_adv": directed_adv,
+        "reconnects": reconnects,
+        "unknown_peers": unknown_peers,
+        "last_ms": last_ms,
+        "max_ms": max_ms,
+        "avg_ms": total_ms // reconnects if reconnects else 0,
+    }
+
+
+def _spp(value):
+    connected, connections, flow_off, rx_bytes, tx_bytes, bench_kbps = unpack_from("<B2H3L", value)
+    return {
+        "connected": connected,
+        "connections": connections,
+        "flow_off": flow_off,
+        "rx_bytes": rx_bytes,
+        "tx_bytes": tx_bytes,
+        "bench_kbps": bench_kbps,
+    }
+
+
+def _le_coc(value):
+    connected, connections, congested, sdu_len, rx_bytes, tx_bytes, bench_kbps, gatt_bytes, gatt_kbps = unpack_from("<B3H5L", value)
+    return {
+        "connected": connected,
+        "connections": connections,
+        "congested": congested,
+        "sdu_len": sdu_len,
+        "rx_bytes": rx_bytes,
+        "tx_bytes": tx_bytes,
+        "bench_kbps": bench_kbps,
+        "gatt_bytes": gatt_bytes,
+        "gatt_kbps": gatt_kbps,
+    }
+
+
+_DECODERS = {
+    MEMORY: ("memory", _memory),
+    POOLS: ("pools", _pools),
+    MIC: ("mic", _mic),
+    MGMT_CB: ("mgmt_cb", _mgmt_cb),
+    WORK: ("work", _work),
+    TIMER: ("timer", _timer),
+    LINK: ("link", _link),
+    SNIFF: ("sniff", _sniff),
+    AVRC: ("avrc", _avrc),
+    GATT: ("gatt", _gatt),
+    SDP: ("sdp", _sdp),
+    LE_BOND: ("le_bond", _le_bond),
+    SPP: ("spp", _spp),
+    LE_COC: ("le_coc", _le_coc),
+}
+
+# Counters which only grow, reported as rates.
+MONOTONIC = {
+    "mic": ("bytes_in", "bytes_out", "overflow", "underrun"),
+    "mgmt_cb": ("count", "total_ms"),
+    "work": tuple("posted_" + p for p in WORK_PRIORITIES)
+    + tuple("executed_" + p for p in WORK_PRIORITIES)
+    + ("dropped",),
+    "timer": ("wakeups", "expired", "coalesced"),
+    "avrc": ("notifications", "registrations", "metadata_requests"),
+    "le_bond": ("directed_adv", "reconnects", "unknown_peers"),
+    "spp": ("connections", "flow_off", "rx_bytes", "tx_bytes"),
+    "le_coc": ("connections", "congested", "rx_bytes", "tx_bytes", "gatt_bytes"),
+    "sniff": tuple("time_ms_" + m for m in SNIFF_MODES),
+}
+
+
+def decode(payload):
+    """Decode one snapshot. Unknown record types are skipped."""
+    payload = bytes(payload)
+    version, timestamp_ms = unpack_from("<BL", payload)
+    snapshot = {"version": version, "timestamp_ms": timestamp_ms}
+    offset = 5
+    while offset + 2 <= len(payload):
+        record_type, length = payload[offset], payload[offset + 1]
+        value = payload[offset + 2:offset + 2 + length]
+        offset += 2 + length
+        if record_type in _DECODERS:
+            name, decoder = _DECODERS[record_type]
+            snapshot[name] = decoder(value)
+    return snapshot
+
+
+def _delta(current, previous):
+    # The device counters are 32 bit wide
+    return (current - previous) & 0xFFFFFFFF
+
+
+class Rates:
+    """Per second rates between successive snapshots."""
+
+    def __init__(self):
+        self.previous = None
+
+    def update(self, snapshot):
+        """Return the rates since the previous snapshot, None for the first one."""
+        previous, self.previous = self.previous, snapshot
+        if previous is None:
+            return None
+        elapsed = _delta(snapshot["timestamp_ms"], previous["timestamp_ms"]) / 1000.0
+        if elapsed <= 0:
+            return None
+
+        rates = {"elapsed_s": elapsed}
+        for name, counters in MONOTONIC.items():
+            if name not in snapshot or name not in previous:
+                continue
+            if name == "sniff":
+                # Residency: fraction of the interval spent in each mode
+                for addr, link in snapshot[name].items():
+                    if addr not in previous[name]:
+                        continue
+                    rates["sniff " + addr] = {
+                        counter: _delta(link[counter], previous[name][addr][counter])
+                        / (elapsed * 1000.0)
+                        for counter in counters
+                    }
+                continue
+            rates[name] = {
+                counter: _delta(snapshot[name][counter], previous[name][counter]) / elapsed
+                for counter in counters
+            }
+        return rates
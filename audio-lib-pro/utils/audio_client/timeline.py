@@ -0,0 +1,127 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Decoder and text renderer of the pairing and connection setup timelines
+(HCI_CONTROL_HCI_AUDIO_EVENT_TIMELINE).
+
+Every peer timeline starts with the ACL connection, each step carries its
+offset from that start, the last status and the number of occurrences.
+render() draws the reached steps in time order with the gap from the
+previous step, the largest gap is where the setup time goes.
+"""
+from struct import unpack_from
+
+VERSION = 1
+
+NOT_REACHED = 0xFFFFFFFF
+
+# Steps, in the order reported by the device.
+STEPS = (
+    "acl_connected",
+    "io_cap_request",
+    "io_cap_response",
+    "user_confirmation",
+    "pairing_complete",
+    "encryption",
+    "link_key_update",
+    "irk_update",
+    "a2dp_connected",
+    "avrc_connected",
+    "hfp_connected",
+)
+
+
+def _bd_addr(data, offset):
+    return ":".join("{:02x}".format(b) for b in data[offset:offset + 6])
+
+
+def decode(payload):
+    """Decode one timeline event into a dictionary."""
+    payload = bytes(payload)
+    version, now_ms, step_num, peer_num = unpack_from("<BLBB", payload)
+    timeline = {"version": version, "now_ms": now_ms, "peers": []}
+    offset = 7
+    for _ in range(peer_num):
+        connected, start_ms = unpack_from("<BL", payload, offset + 6)
+        peer = {
+            "bd_addr": _bd_addr(payload, offset),
+            "connected": bool(connected),
+            "start_ms": start_ms,
+            "steps": {},
+        }
+        offset += 11
+        for i in range(step_num):
+            offset_ms, status, count = unpack_from("<LBB", payload, offset)
+            offset += 6
+            if offset_ms == NOT_REACHED:
+                continue
+            name = STEPS[i] if i < len(STEPS) else "step{}".format(i)
+            peer["steps"][name] = {"offset_ms": offset_ms, "status": status, "count": count}
+        timeline["peers"].append(peer)
+    timeline["peers"].sort(key=lambda peer: peer["start_ms"])
+    return timeline
+
+
+def render(timeline, width=40):
+    """Return the text lines of a decoded timeline, one block per peer."""
+    lines = []
+    for peer in timeline["peers"]:
+        steps = sorted(peer["steps"].items(), key=lambda item: item[1]["offset_ms"])
+        total = max([step["offset_ms"] for _, step in steps] + [1])
+        gaps = [steps[i][1]["offset_ms"] - (steps[i - 1][1]["offset_ms"] if i else 0) for i in range(len(steps))]
+        largest = gaps.index(max(gaps)) if gaps else -1
+
+        lines.append(
+            "%s  %s, started %.1f s ago, %d ms to the last step"
+            % (
+                peer["bd_addr"],
+                "connected" if peer["connected"] else "disconnected",
+                (timeline["now_ms"] - peer["start_ms"]) / 1000.0,
+                total if steps else 0,
+            )
+        )
+        for i, (name, step) in enumerate(steps):
+            position = step["offset_ms"] * width // total
+            bar = "-" * position + "*" + " " * (width - position)
+            lines.append(
+                "  %-18s %7d ms  +%6d ms  |%s|  status %d%s%s"
+                % (
+                    name,
+                    step["offset_ms"],
+                    gaps[i],
+                    bar,
+                    step["status"],
+                    "  x%d" % step["count"] if step["count"] > 1 else "",
+                    "  <- largest gap" if i == largest and gaps[i] else "",
+                )
+            )
+    return lines
@@ -0,0 +1,149 @@
+#
+# Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+# If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+# non-transferable license to copy, modify, and compile the Software
+# source code solely for use in connection with Cypress's
+# integrated circuit products.  Any reproduction, modification, translation,
+# compilation, or representation of this Software except as specified
+# above is prohibited without the express written permission of Cypress.
+#
+# Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+# reserves the right to make changes to the Software without notice. Cypress
+# does not assume any liability arising out of the application or use of the
+# Software or any product or circuit described in the Software. Cypress does
+# not authorize its products for use in any products where a malfunction or
+# failure of the Cypress product may reasonably be expected to result in
+# significant property damage, injury or death ("High Risk Product"). By
+# including Cypress's product in a High Risk Product, the manufacturer
+# of such system or application assumes all risk of such use and in doing
+# so agrees to indemnify Cypress against all liability.
+#
+"""Encoder and decoder of the runtime tuning store commands
+(HCI_CONTROL_HCI_AUDIO_COMMAND_TUNING and the tuning characteristic of the
+LE application service, see headset_tuning.h).
+
+Parameters are named as in headset_tuning_t. SET applies all the values or
+none, and rejects values which leave the button durations or the A2DP
+buffer depths out of order. COMMIT writes them to NVRAM. They take effect from the next warm
+restart, the button durations from the next boot.
+"""
+from struct import error as StructError, pack, unpack_from
+
+VERSION = 1
+
+OP_GET = 0x01
+OP_SET = 0x02
+OP_COMMIT = 0x03
+OP_DEFAULTS = 0x04
+
+STATUS = {0: "success", 1: "unknown opcode", 2: "invalid parameter", 3: "NVRAM error"}
+
+FLAG_STORED = 0x01
+FLAG_CHANGED = 0x02
+
+# ID: (name, struct format)
+PARAMS = {
+    0x01: ("a2dp_buf_depth_ms", "<H"),
+    0x02: ("a2dp_start_buf_depth", "<B"),
+    0x03: ("a2dp_target_buf_depth", "<B"),
+    0x04: ("a2dp_adj_ppm_max", "<h"),
+    0x05: ("a2dp_adj_ppm_min", "<h"),
+    0x06: ("a2dp_adj_ppb_per_msec", "<H"),
+    0x07: ("a2dp_lvl_threshold_high", "<h"),
+    0x08: ("a2dp_lvl_threshold_low", "<h"),
+    0x09: ("a2dp_proportional_gain", "<H"),
+    0x0A: ("a2dp_integral_gain", "<H"),
+    0x10: ("sbc_max_bitpool", "<B"),
+    0x20: ("discoverable_timeout", "<H"),
+    0x21: ("hfp_rfcomm_buffer_size", "<H"),
+    0x22: ("hfp_rfcomm_buffer_count", "<B"),
+    0x30: ("button_short_ms", "<H"),
+    0x31: ("button_medium_ms", "<H"),
+    0x32: ("button_long_ms", "<H"),
+    0x33: ("button_very_long_ms", "<H"),
+    0x34: ("button_debounce_ms", "<H"),
+}
+
+IDS = {name: param_id for param_id, (name, _) in PARAMS.items()}
+
+
+class TuningError(Exception):
+    pass
+
+
+def encode_get(names=()):
+    """Return the GET command, all the parameters if names is empty."""
+    return pack("<B", OP_GET) + bytes(IDS[name] for name in names)
+
+
+def encode_set(values):
+    """Return the SET command of a {name: value} dictionary. Raise
+    TuningError for an unknown name or a value which does not fit."""
+    data = pack("<B", OP_SET)
+    for name, value in values.items():
+        if name not in IDS:
+            raise TuningError("unknown parameter {}".format(name))
+        fmt = PARAMS[IDS[name]][1]
+        try:
+            value = pack(fmt, int(value))
+        except (StructError, TypeError, ValueError):
+            raise TuningError("{} out of range: {}".format(name, value)) from None
+        data += pack("<BB", IDS[name], len(value)) + value
+    return data
+
+
+def parse_assignments(text):
+    """Parse "name=value,name=value" into a dictionary. Raise TuningError
+    if the text is malformed."""
+    values = {}
+    for item in text.split(","):
+        name, sep, value = item.partition("=")
+        name = name.strip()
+        if not sep:
+            raise TuningError("expected NAME=VALUE: {}".format(item.strip()))
+        if name not in IDS:
+            raise TuningError("unknown parameter {}".format(name))
+        try:
+            values[name] = int(value.strip(), 0)
+        except ValueError:
+            raise TuningError("{} is not a number: {}".format(name, value.strip())) from None
+    return values
+
+
+def decode(payload):
+    """Decode a response, return (opcode, data). Raise TuningError if the
+    status is not success. The data of GET is a dictionary with the
+    version, the flags and the values."""
+    payload = bytes(payload)
+    opcode, status = unpack_from("<BB", payload)
+    if status != 0:
+        detail = STATUS.get(status, str(status))
+        if opcode == OP_SET and len(payload) > 2:
+            param = PARAMS.get(payload[2], ("0x{:02x}".format(payload[2]),))[0]
+            detail += ", " + param
+        raise TuningError(detail)
+    if opcode != OP_GET:
+        return opcode, None
+    version, flags = unpack_from("<BB", payload, 2)
+    result = {"version": version, "flags": flags, "values": {}}
+    offset = 4
+    while offset + 2 <= len(payload):
+        param_id, length = unpack_from("<BB", payload, offset)
+        offset += 2
+        if param_id in PARAMS:
+            name, fmt = PARAMS[param_id]
+            result["values"][name] = unpack_from(fmt, payload, offset)[0]
+        offset += length
+    return opcode, result
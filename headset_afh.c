@@ -0,0 +1,392 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application AFH host channel blocklist.
+ */
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_trace.h"
+#include "wiced_transport.h"
+#include "headset_control.h"
+#include "headset_event.h"
+#include "headset_afh.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_AFH_WIFI_HALF_WIDTH_MHZ 11      /* 22 MHz Wi-Fi channel */
+
+/* Blocking weight of each source, the LE advertising channels are released first. */
+#define HEADSET_AFH_WEIGHT_WIFI         2
+#define HEADSET_AFH_WEIGHT_LE_ADV       1
+
+#define HEADSET_AFH_BR_FREQ(channel)    (2402 + (channel))
+#define HEADSET_AFH_WIFI_FREQ(channel)  ((channel) == 14 ? 2484 : 2407 + 5 * (channel))
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint8_t      wifi_channel[HEADSET_AFH_WIFI_CHANNEL_MAX];
+    uint8_t      wifi_channel_num;
+    wiced_bool_t le_discoverable;
+    uint8_t      le_connections;
+    wiced_bool_t classification;                    /* host classification enabled */
+    uint8_t      br_map[HEADSET_AFH_BR_MAP_LEN];    /* last map sent, 1: unknown, 0: bad */
+    uint8_t      le_map[HEADSET_AFH_LE_MAP_LEN];
+} headset_afh_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+/* BR/EDR channels overlapping the LE advertising channels 37, 38 and 39 (2 MHz wide). */
+static const uint8_t headset_afh_le_adv_br_channel[] = { 0, 1, 23, 24, 25, 77, 78 };
+
+static headset_afh_cb_t headset_afh_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_afh_le_data_channel_freq
+ */
+static uint16_t headset_afh_le_data_channel_freq(uint8_t channel)
+{
+    return (channel <= 10) ? (2404 + 2 * channel) : (2428 + 2 * (channel - 11));
+}
+
+/*
+ * headset_afh_br_channel_reason
+ *
+ * Return the HEADSET_AFH_BLOCK_xxx reasons of a BR/EDR channel.
+ */
+static uint8_t headset_afh_br_channel_reason(uint8_t channel)
+{
+    uint16_t freq = HEADSET_AFH_BR_FREQ(channel);
+    uint16_t wifi_freq;
+    uint8_t  reason = 0;
+    uint8_t  i;
+
+    for (i = 0; i < headset_afh_cb.wifi_channel_num; i++)
+    {
+        wifi_freq = HEADSET_AFH_WIFI_FREQ(headset_afh_cb.wifi_channel[i]);
+
+        if ((freq + HEADSET_AFH_WIFI_HALF_WIDTH_MHZ >= wifi_freq) &&
+            (freq <= wifi_freq + HEADSET_AFH_WIFI_HALF_WIDTH_MHZ))
+        {
+            reason |= HEADSET_AFH_BLOCK_WIFI;
+        }
+    }
+
+    if (headset_afh_cb.le_discoverable)
+    {
+        for (i = 0; i < sizeof(headset_afh_le_adv_br_channel); i++)
+        {
+            if (headset_afh_le_adv_br_channel[i] == channel)
+            {
+                reason |= HEADSET_AFH_BLOCK_LE_ADV;
+            }
+        }
+    }
+
+    return reason;
+}
+
+/*
+ * headset_afh_br_channel_weight
+ */
+static uint8_t headset_afh_br_channel_weight(uint8_t channel)
+{
+    uint8_t reason = headset_afh_br_channel_reason(channel);
+
+    return ((reason & HEADSET_AFH_BLOCK_WIFI) ? HEADSET_AFH_WEIGHT_WIFI : 0) +
+           ((reason & HEADSET_AFH_BLOCK_LE_ADV) ? HEADSET_AFH_WEIGHT_LE_ADV : 0);
+}
+
+/*
+ * headset_afh_map_build
+ *
+ * Mark the channels with a blocking weight as bad. If fewer than min_good
+ * channels would be left, the channels with the lowest weight are kept.
+ */
+static void headset_afh_map_build(const uint8_t *p_weight, uint8_t channel_num, uint8_t min_good, uint8_t *p_map, uint8_t map_len)
+{
+    uint8_t good;
+    uint8_t threshold = 1;
+    uint8_t i;
+
+    /* Raise the threshold until enough channels are left. */
+    while (WICED_TRUE)
+    {
+        good = 0;
+
+        for (i = 0; i < channel_num; i++)
+        {
+            if (p_weight[i] < threshold)
+            {
+                good++;
+            }
+        }
+
+        if ((good >= min_good) || (threshold > HEADSET_AFH_WEIGHT_WIFI + HEADSET_AFH_WEIGHT_LE_ADV))
+        {
+            break;
+        }
+
+        threshold++;
+    }
+
+    memset((void *)p_map, 0, map_len);
+
+    for (i = 0; i < channel_num; i++)
+    {
+        if (p_weight[i] < threshold)
+        {
+            p_map[i / 8] |= 1 << (i % 8);
+        }
+    }
+}
+
+/*
+ * headset_afh_classification_update
+ *
+ * Send the maps built from the blocklist, if they changed.
+ */
+static void headset_afh_classification_update(void)
+{
+    uint8_t        br_map[HEADSET_AFH_BR_MAP_LEN];
+    uint8_t        le_map[HEADSET_AFH_LE_MAP_LEN];
+    uint8_t        br_weight[HEADSET_AFH_BR_CHANNEL_NUM];
+    uint8_t        le_weight[HEADSET_AFH_LE_DATA_CHANNEL_NUM];
+    uint8_t        i;
+    wiced_result_t result;
+
+    if (!headset_afh_cb.classification)
+    {
+        return;
+    }
+
+    for (i = 0; i < HEADSET_AFH_BR_CHANNEL_NUM; i++)
+    {
+        br_weight[i] = headset_afh_br_channel_weight(i);
+    }
+
+    headset_afh_map_build(br_weight,
+                          HEADSET_AFH_BR_CHANNEL_NUM,
+                          HEADSET_AFH_BR_CHANNEL_MIN,
+                          br_map,
+                          sizeof(br_map));
+
+    if (memcmp((void *)br_map, (void *)headset_afh_cb.br_map, sizeof(br_map)) != 0)
+    {
+        result = wiced_bt_dev_set_afh_channel_classification(br_map);
+
+        WICED_BT_TRACE("headset_afh BR/EDR classification %d\n", result);
+
+        memcpy((void *)headset_afh_cb.br_map, (void *)br_map, sizeof(br_map));
+    }
+
+    /* Keep the LE data channels of our own LE link away from the same sources. */
+    if (headset_afh_cb.le_connections == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < HEADSET_AFH_LE_DATA_CHANNEL_NUM; i++)
+    {
+        le_weight[i] = br_weight[headset_afh_le_data_channel_freq(i) - HEADSET_AFH_BR_FREQ(0)];
+    }
+
+    headset_afh_map_build(le_weight,
+                          HEADSET_AFH_LE_DATA_CHANNEL_NUM,
+                          HEADSET_AFH_LE_CHANNEL_MIN,
+                          le_map,
+                          sizeof(le_map));
+
+    if (memcmp((void *)le_map, (void *)headset_afh_cb.le_map, sizeof(le_map)) != 0)
+    {
+        result = wiced_bt_ble_set_channel_classification(le_map);
+
+        WICED_BT_TRACE("headset_afh LE classification %d\n", result);
+
+        memcpy((void *)headset_afh_cb.le_map, (void *)le_map, sizeof(le_map));
+    }
+}
+
+/*
+ * headset_afh_event_handler
+ */
+static void headset_afh_event_handler(const headset_event_data_t *p_data)
+{
+    switch (p_data->event)
+    {
+    case HEADSET_EVENT_LE_CONNECTED:
+        headset_afh_cb.le_connections++;
+
+        /* Force the LE map to be sent to the new link. */
+        memset((void *)headset_afh_cb.le_map, 0, sizeof(headset_afh_cb.le_map));
+        break;
+
+    case HEADSET_EVENT_LE_DISCONNECTED:
+        if (headset_afh_cb.le_connections)
+        {
+            headset_afh_cb.le_connections--;
+        }
+        return;
+
+    case HEADSET_EVENT_LE_DISCOVERABILITY:
+        headset_afh_cb.le_discoverable = p_data->status ? WICED_TRUE : WICED_FALSE;
+        break;
+
+    default:
+        return;
+    }
+
+    headset_afh_classification_update();
+}
+
+/*
+ * headset_afh_init
+ */
+void headset_afh_init(void)
+{
+    memset((void *)&headset_afh_cb, 0, sizeof(headset_afh_cb));
+
+    /* No classification sent yet, every channel is unknown. */
+    memset((void *)headset_afh_cb.br_map, 0xff, sizeof(headset_afh_cb.br_map));
+    headset_afh_cb.br_map[HEADSET_AFH_BR_MAP_LEN - 1] = 0x7f;
+
+    headset_event_subscribe(HEADSET_EVENT_MASK_LE, &headset_afh_event_handler);
+}
+
+/*
+ * headset_afh_wifi_channels_set
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_WIFI_CHANNELS.
+ *
+ * Byte: |    0 ... n-1     |
+ * Data: | Wi-Fi channels (1 - 14) in use, no data if Wi-Fi is off |
+ */
+void headset_afh_wifi_channels_set(uint8_t *p_data, uint32_t data_len)
+{
+    uint8_t i;
+
+    headset_afh_cb.wifi_channel_num = 0;
+
+    for (i = 0; (i < data_len) && (headset_afh_cb.wifi_channel_num < HEADSET_AFH_WIFI_CHANNEL_MAX); i++)
+    {
+        if ((p_data[i] >= 1) && (p_data[i] <= 14))
+        {
+            headset_afh_cb.wifi_channel[headset_afh_cb.wifi_channel_num++] = p_data[i];
+        }
+    }
+
+    WICED_BT_TRACE("headset_afh %d Wi-Fi channel(s)\n", headset_afh_cb.wifi_channel_num);
+
+    headset_afh_classification_update();
+}
+
+/*
+ * headset_afh_classification_enable
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_CLASSIFICATION.
+ *
+ * Byte: |   0    |
+ * Data: | ENABLE |
+ */
+void headset_afh_classification_enable(uint8_t *p_data, uint32_t data_len)
+{
+    if (data_len != sizeof(uint8_t))
+    {
+        return;
+    }
+
+    headset_afh_cb.classification = p_data[0] ? WICED_TRUE : WICED_FALSE;
+
+    WICED_BT_TRACE("headset_afh classification %d\n", headset_afh_cb.classification);
+
+    if (headset_afh_cb.classification)
+    {
+        headset_afh_classification_update();
+        return;
+    }
+
+    /* Back to the master's own assessment: every channel unknown. */
+    memset((void *)headset_afh_cb.br_map, 0xff, sizeof(headset_afh_cb.br_map));
+    headset_afh_cb.br_map[HEADSET_AFH_BR_MAP_LEN - 1] = 0x7f;
+
+    wiced_bt_dev_set_afh_channel_classification(headset_afh_cb.br_map);
+
+    if (headset_afh_cb.le_connections)
+    {
+        memset((void *)headset_afh_cb.le_map, 0xff, sizeof(headset_afh_cb.le_map));
+        headset_afh_cb.le_map[HEADSET_AFH_LE_MAP_LEN - 1] = 0x1f;
+
+        wiced_bt_ble_set_channel_classification(headset_afh_cb.le_map);
+    }
+}
+
+/*
+ * headset_afh_blocklist_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_BLOCKLIST, reply with
+ * HCI_CONTROL_HCI_AUDIO_EVENT_AFH_BLOCKLIST.
+ *
+ * Byte: |     0     |  1 ... 79   | 80 ... 89   |
+ * Data: | CLASSIFY  | REASON[79]  | BR_MAP[10]  |
+ *
+ * REASON is the HEADSET_AFH_BLOCK_xxx mask of each channel, BR_MAP the last
+ * map sent to the controller.
+ */
+void headset_afh_blocklist_send(uint8_t *p_data, uint32_t data_len)
+{
+    uint8_t  event[1 + HEADSET_AFH_BR_CHANNEL_NUM + HEADSET_AFH_BR_MAP_LEN];
+    uint8_t *p = event;
+    uint8_t  i;
+
+    UINT8_TO_STREAM(p, headset_afh_cb.classification);
+
+    for (i = 0; i < HEADSET_AFH_BR_CHANNEL_NUM; i++)
+    {
+        UINT8_TO_STREAM(p, headset_afh_br_channel_reason(i));
+    }
+
+    ARRAY_TO_STREAM(p, headset_afh_cb.br_map, HEADSET_AFH_BR_MAP_LEN);
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_AFH_BLOCKLIST, event, (uint16_t)(p - event));
+}
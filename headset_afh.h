@@ -0,0 +1,71 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application AFH host channel blocklist.
+ *
+ * The controller does not report per-channel errors to the application, so
+ * nothing here is measured. The blocklist is derived from what the host knows
+ * is using the band: the Wi-Fi channels it reports, and the LE advertising
+ * channels while the device is LE discoverable. When host classification is
+ * enabled, the blocked BR/EDR channels are reported as bad to the master and
+ * removed from the LE data channel map, while the channel counts stay at the
+ * minimum the specification requires. Otherwise the master's own map is used.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_AFH_BR_CHANNEL_NUM      79
+#define HEADSET_AFH_LE_DATA_CHANNEL_NUM 37
+#define HEADSET_AFH_BR_MAP_LEN          10
+#define HEADSET_AFH_LE_MAP_LEN          5
+#define HEADSET_AFH_BR_CHANNEL_MIN      20      /* N_min for AFH */
+#define HEADSET_AFH_LE_CHANNEL_MIN      2
+#define HEADSET_AFH_WIFI_CHANNEL_MAX    4       /* Wi-Fi channels tracked at once */
+
+/* Reasons a channel is blocked, reported in HCI_CONTROL_HCI_AUDIO_EVENT_AFH_BLOCKLIST */
+#define HEADSET_AFH_BLOCK_WIFI          0x01    /* inside a Wi-Fi channel reported by the host */
+#define HEADSET_AFH_BLOCK_LE_ADV        0x02    /* overlaps an LE advertising channel, device LE discoverable */
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void headset_afh_init(void);
+void headset_afh_wifi_channels_set(uint8_t *p_data, uint32_t data_len);
+void headset_afh_classification_enable(uint8_t *p_data, uint32_t data_len);
+void headset_afh_blocklist_send(uint8_t *p_data, uint32_t data_len);
@@ -0,0 +1,420 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application AVRCP play position interval and metadata cache.
+ */
+#include "wiced.h"
+#include "wiced_bt_trace.h"
+#include "wiced_bt_avrc.h"
+#include "wiced_bt_avrc_defs.h"
+#include "wiced_bt_avrc_ct.h"
+#include "wiced_transport.h"
+#include "headset_control.h"
+#include "headset_control_le.h"
+#include "headset_event.h"
+#include "headset_timer.h"
+#include "headset_avrc.h"
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint8_t len;
+    uint8_t value[HEADSET_AVRC_ATTR_LEN_MAX];
+} headset_avrc_attr_t;
+
+typedef struct
+{
+    wiced_bt_avrc_ct_rsp_cback_t p_rsp_cb;      /* bt_hs_spk library callback */
+    wiced_bt_avrc_ct_connection_state_cback_t p_connection_cb;  /* bt_hs_spk library callback */
+    uint8_t                      play_status;
+    uint32_t                     song_len;      /* ms */
+    uint32_t                     song_pos;      /* ms, at pos_time */
+    uint32_t                     pos_time;
+    headset_avrc_attr_t          attr[HEADSET_AVRC_ATTR_NUM];
+    uint8_t                      info[HEADSET_AVRC_INFO_LEN_MAX];   /* serialized at the last change */
+    uint16_t                     info_len;
+    headset_avrc_stats_t         stats;
+} headset_avrc_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+/* Element attributes cached, in the order of headset_avrc_cb.attr. */
+static uint8_t headset_avrc_attr_id[HEADSET_AVRC_ATTR_NUM] =
+{
+    AVRC_MEDIA_ATTR_ID_TITLE,
+    AVRC_MEDIA_ATTR_ID_ARTIST,
+    AVRC_MEDIA_ATTR_ID_ALBUM,
+};
+
+static headset_avrc_cb_t headset_avrc_cb = { 0 };
+
+extern wiced_result_t __real_wiced_bt_avrc_ct_init(uint32_t local_features,
+                                                   uint8_t *supported_events,
+                                                   wiced_bt_avrc_ct_connection_state_cback_t p_connection_cb,
+                                                   wiced_bt_avrc_ct_cmd_cback_t p_cmd_cb,
+                                                   wiced_bt_avrc_ct_rsp_cback_t p_rsp_cb,
+                                                   wiced_bt_avrc_ct_pt_rsp_cback_t p_ptrsp_cb);
+
+extern wiced_bt_avrc_sts_t __real_wiced_bt_avrc_bld_command(wiced_bt_avrc_command_t *p_cmd, BT_HDR **pp_pkt);
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_avrc_metadata_request
+ *
+ * Fetch the metadata and the play status of the current track.
+ */
+static void headset_avrc_metadata_request(uint8_t handle)
+{
+    wiced_bt_avrc_uid_t element_id = { 0 };     /* currently playing */
+
+    memset((void *)headset_avrc_cb.attr, 0, sizeof(headset_avrc_cb.attr));
+
+    wiced_bt_avrc_ct_get_element_attr_cmd(handle,
+                                          element_id,
+                                          HEADSET_AVRC_ATTR_NUM,
+                                          headset_avrc_attr_id);
+
+    wiced_bt_avrc_ct_get_play_status_cmd(handle);
+
+    headset_avrc_cb.stats.metadata_requests++;
+}
+
+/*
+ * headset_avrc_elem_attrs_save
+ */
+static void headset_avrc_elem_attrs_save(wiced_bt_avrc_get_elem_attrs_rsp_t *p_rsp)
+{
+    wiced_bt_avrc_attr_entry_t *p_entry;
+    uint8_t                     i;
+    uint8_t                     j;
+
+    for (i = 0; i < p_rsp->num_attr; i++)
+    {
+        p_entry = &p_rsp->p_attrs[i];
+
+        for (j = 0; j < HEADSET_AVRC_ATTR_NUM; j++)
+        {
+            if (p_entry->attr_id == headset_avrc_attr_id[j])
+            {
+                headset_avrc_cb.attr[j].len = p_entry->name.str_len < HEADSET_AVRC_ATTR_LEN_MAX ?
+                                              (uint8_t)p_entry->name.str_len : HEADSET_AVRC_ATTR_LEN_MAX;
+
+                memcpy((void *)headset_avrc_cb.attr[j].value,
+                       (void *)p_entry->name.p_str,
+                       headset_avrc_cb.attr[j].len);
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * headset_avrc_position_get
+ *
+ * Current playback position, extrapolated while playing.
+ */
+static uint32_t headset_avrc_position_get(void)
+{
+    uint32_t position = headset_avrc_cb.song_pos;
+
+    if (position == 0xFFFFFFFF)
+    {
+        return position;
+    }
+
+    if (headset_avrc_cb.play_status == AVRC_PLAYSTATE_PLAYING)
+    {
+        position += headset_timer_now_ms() - headset_avrc_cb.pos_time;
+
+        if ((headset_avrc_cb.song_len != 0xFFFFFFFF) &&
+            (position > headset_avrc_cb.song_len))
+        {
+            position = headset_avrc_cb.song_len;
+        }
+    }
+
+    return position;
+}
+
+/*
+ * headset_avrc_position_set
+ */
+static void headset_avrc_position_set(uint32_t position)
+{
+    headset_avrc_cb.song_pos = position;
+    headset_avrc_cb.pos_time = headset_timer_now_ms();
+}
+
+/*
+ * headset_avrc_info_build
+ *
+ * Serialize the cached information with the given position, return the
+ * length. p_data holds HEADSET_AVRC_INFO_LEN_MAX bytes.
+ *
+ * Byte: |      0      |   1 - 4  |   5 - 8  |     9     |        10 ...          |
+ * Data: | PLAY_STATUS | SONG_LEN | SONG_POS | ATTR_NUM  | (ATTR_ID, LEN, VALUE)*  |
+ */
+static uint16_t headset_avrc_info_build(uint8_t *p_data, uint32_t position)
+{
+    uint8_t *p = p_data;
+    uint8_t  i;
+
+    UINT8_TO_STREAM(p, headset_avrc_cb.play_status);
+    UINT32_TO_STREAM(p, headset_avrc_cb.song_len);
+    UINT32_TO_STREAM(p, position);
+    UINT8_TO_STREAM(p, HEADSET_AVRC_ATTR_NUM);
+
+    for (i = 0; i < HEADSET_AVRC_ATTR_NUM; i++)
+    {
+        UINT8_TO_STREAM(p, headset_avrc_attr_id[i]);
+        UINT8_TO_STREAM(p, headset_avrc_cb.attr[i].len);
+        ARRAY_TO_STREAM(p, headset_avrc_cb.attr[i].value, headset_avrc_cb.attr[i].len);
+    }
+
+    return (uint16_t)(p - p_data);
+}
+
+/*
+ * headset_avrc_info_update
+ *
+ * Rebuild the value read by the LE clients, see headset_avrc_info_get.
+ */
+static void headset_avrc_info_update(void)
+{
+    headset_avrc_cb.info_len = headset_avrc_info_build(headset_avrc_cb.info, headset_avrc_cb.song_pos);
+}
+
+/*
+ * headset_avrc_notification
+ *
+ * Update the cache, return WICED_TRUE if the LE clients shall be notified.
+ */
+static wiced_bool_t headset_avrc_notification(uint8_t handle, wiced_bt_avrc_reg_notif_rsp_t *p_rsp)
+{
+    switch (p_rsp->event_id)
+    {
+    case AVRC_EVT_PLAY_STATUS_CHANGE:
+        /* Keep the extrapolated position when the state changes. */
+        headset_avrc_position_set(headset_avrc_position_get());
+        headset_avrc_cb.play_status = p_rsp->param.play_status;
+        return WICED_TRUE;
+
+    case AVRC_EVT_TRACK_CHANGE:
+        headset_avrc_position_set(0);
+        headset_avrc_metadata_request(handle);
+        return WICED_TRUE;
+
+    case AVRC_EVT_PLAY_POS_CHANGED:
+        headset_avrc_position_set(p_rsp->param.play_pos);
+        headset_avrc_cb.stats.notifications++;
+
+        /* The LE clients extrapolate the position, the value is refreshed without a notification. */
+        headset_avrc_info_update();
+        return WICED_FALSE;
+
+    default:
+        return WICED_FALSE;
+    }
+}
+
+/*
+ * headset_avrc_rsp_cback
+ *
+ * AVRC CT response callback installed in place of the library one.
+ */
+static void headset_avrc_rsp_cback(uint8_t handle, wiced_bt_avrc_rsp_t *avrc_rsp)
+{
+    wiced_bool_t changed = WICED_FALSE;
+
+    switch (avrc_rsp->pdu)
+    {
+    case AVRC_PDU_REGISTER_NOTIFICATION:
+        changed = headset_avrc_notification(handle, &avrc_rsp->reg_notif);
+        break;
+
+    case AVRC_PDU_GET_PLAY_STATUS:
+        if (avrc_rsp->get_play_status.status == AVRC_STS_NO_ERROR)
+        {
+            headset_avrc_cb.play_status = avrc_rsp->get_play_status.play_status;
+            headset_avrc_cb.song_len    = avrc_rsp->get_play_status.song_len;
+            headset_avrc_position_set(avrc_rsp->get_play_status.song_pos);
+            changed = WICED_TRUE;
+        }
+        break;
+
+    case AVRC_PDU_GET_ELEMENT_ATTR:
+        if (avrc_rsp->get_elem_attrs.status == AVRC_STS_NO_ERROR)
+        {
+            headset_avrc_elem_attrs_save(&avrc_rsp->get_elem_attrs);
+            changed = WICED_TRUE;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (changed)
+    {
+        headset_avrc_info_update();
+        hci_control_le_notify(HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_VAL);
+    }
+
+    if (headset_avrc_cb.p_rsp_cb)
+    {
+        headset_avrc_cb.p_rsp_cb(handle, avrc_rsp);
+    }
+}
+
+/*
+ * headset_avrc_connection_cback
+ */
+static void headset_avrc_connection_cback(uint8_t handle,
+                                          wiced_bt_device_address_t remote_addr,
+                                          wiced_result_t status,
+                                          wiced_bt_avrc_ct_connection_state_t connection_state,
+                                          uint32_t peer_features)
+{
+    if (connection_state == REMOTE_CONTROL_CONNECTED)
+    {
+        headset_event_publish(HEADSET_EVENT_AVRC_CONNECTED, remote_addr, handle, (uint8_t)status);
+    }
+    else if (connection_state == REMOTE_CONTROL_DISCONNECTED)
+    {
+        headset_event_publish(HEADSET_EVENT_AVRC_DISCONNECTED, remote_addr, handle, (uint8_t)status);
+    }
+
+    if (headset_avrc_cb.p_connection_cb)
+    {
+        headset_avrc_cb.p_connection_cb(handle, remote_addr, status, connection_state, peer_features);
+    }
+}
+
+/*
+ * __wrap_wiced_bt_avrc_ct_init
+ *
+ * The bt_hs_spk library initializes the AVRC CT itself, interpose on its
+ * connection and response callbacks.
+ */
+wiced_result_t __wrap_wiced_bt_avrc_ct_init(uint32_t local_features,
+                                            uint8_t *supported_events,
+                                            wiced_bt_avrc_ct_connection_state_cback_t p_connection_cb,
+                                            wiced_bt_avrc_ct_cmd_cback_t p_cmd_cb,
+                                            wiced_bt_avrc_ct_rsp_cback_t p_rsp_cb,
+                                            wiced_bt_avrc_ct_pt_rsp_cback_t p_ptrsp_cb)
+{
+    memset((void *)&headset_avrc_cb, 0, sizeof(headset_avrc_cb));
+
+    headset_avrc_cb.p_rsp_cb        = p_rsp_cb;
+    headset_avrc_cb.p_connection_cb = p_connection_cb;
+    headset_avrc_cb.play_status     = AVRC_PLAYSTATE_STOPPED;
+    headset_avrc_cb.song_len        = 0xFFFFFFFF;
+    headset_avrc_cb.song_pos        = 0xFFFFFFFF;
+    headset_avrc_info_update();
+
+    return __real_wiced_bt_avrc_ct_init(local_features,
+                                        supported_events,
+                                        &headset_avrc_connection_cback,
+                                        p_cmd_cb,
+                                        &headset_avrc_rsp_cback,
+                                        p_ptrsp_cb);
+}
+
+/*
+ * __wrap_wiced_bt_avrc_bld_command
+ *
+ * The AVRC CT library registers PLAY_POS_CHANGED with no playback interval,
+ * set it before the command is built.
+ */
+wiced_bt_avrc_sts_t __wrap_wiced_bt_avrc_bld_command(wiced_bt_avrc_command_t *p_cmd, BT_HDR **pp_pkt)
+{
+    if ((p_cmd->pdu == AVRC_PDU_REGISTER_NOTIFICATION) &&
+        (p_cmd->reg_notif.event_id == AVRC_EVT_PLAY_POS_CHANGED))
+    {
+        p_cmd->reg_notif.param = HEADSET_AVRC_PLAY_POS_INTERVAL_S;
+        headset_avrc_cb.stats.registrations++;
+    }
+
+    return __real_wiced_bt_avrc_bld_command(p_cmd, pp_pkt);
+}
+
+/*
+ * headset_avrc_info_get
+ *
+ * Copy the information serialized at the last change, return the length.
+ * The position is the last one received, while playing it is at most one
+ * playback interval old.
+ */
+uint16_t headset_avrc_info_get(uint8_t *p_data, uint16_t max_len)
+{
+    if (max_len < headset_avrc_cb.info_len)
+    {
+        return 0;
+    }
+
+    memcpy((void *)p_data, (void *)headset_avrc_cb.info, headset_avrc_cb.info_len);
+
+    return headset_avrc_cb.info_len;
+}
+
+/*
+ * headset_avrc_info_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_AVRC_INFO, reply with
+ * HCI_CONTROL_HCI_AUDIO_EVENT_AVRC_INFO.
+ */
+void headset_avrc_info_send(uint8_t *p_data, uint32_t data_len)
+{
+    uint8_t  event[HEADSET_AVRC_INFO_LEN_MAX];
+    uint16_t len;
+
+    len = headset_avrc_info_build(event, headset_avrc_position_get());
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_AVRC_INFO, event, len);
+}
+
+/*
+ * headset_avrc_stats_get
+ */
+void headset_avrc_stats_get(headset_avrc_stats_t *p_stats)
+{
+    memcpy((void *)p_stats, (void *)&headset_avrc_cb.stats, sizeof(headset_avrc_stats_t));
+}
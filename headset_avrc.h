@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application AVRCP play position interval and metadata cache.
+ *
+ * The AVRC CT commands and responses of the bt_hs_spk library go through
+ * this module (see the --wrap options in the makefile):
+ * - The RegisterNotification(PLAY_POS_CHANGED) commands carry a playback
+ *   interval of HEADSET_AVRC_PLAY_POS_INTERVAL_S, so the target sends the
+ *   position at that pace instead of every second. All the responses reach
+ *   the library unchanged.
+ * - The play status, playback position and the track metadata are kept in
+ *   RAM so the host (HCI) and LE clients can read them without starting a
+ *   new AVRCP transaction. The metadata is fetched once per track change.
+ *   The serialized value is rebuilt on each change, a long read of the LE
+ *   characteristic gets a consistent value.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#ifndef HEADSET_AVRC_PLAY_POS_INTERVAL_S
+#define HEADSET_AVRC_PLAY_POS_INTERVAL_S    5       /* playback interval, seconds */
+#endif
+
+#define HEADSET_AVRC_ATTR_NUM               3       /* title, artist, album */
+#define HEADSET_AVRC_ATTR_LEN_MAX           48      /* bytes kept per attribute (UTF-8, truncated) */
+
+/* Serialized information: status, length, position, attribute count and entries. */
+#define HEADSET_AVRC_INFO_LEN_MAX           (1 + 4 + 4 + 1 + HEADSET_AVRC_ATTR_NUM * (2 + HEADSET_AVRC_ATTR_LEN_MAX))
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint32_t notifications;     /* PLAY_POS_CHANGED received */
+    uint32_t registrations;     /* PLAY_POS_CHANGED registered with the playback interval */
+    uint32_t metadata_requests;
+} headset_avrc_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+uint16_t headset_avrc_info_get(uint8_t *p_data, uint16_t max_len);
+void     headset_avrc_info_send(uint8_t *p_data, uint32_t data_len);
+void     headset_avrc_stats_get(headset_avrc_stats_t *p_stats);
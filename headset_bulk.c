@@ -0,0 +1,258 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Bulk data request engine, see headset_bulk.h.
+ */
+#if defined(HEADSET_SPP_BULK) || defined(HEADSET_LE_COC)
+
+#include "wiced.h"
+#include "headset_bulk.h"
+#include "headset_stats.h"
+#include "headset_timeline.h"
+#include "headset_timer.h"
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_bulk_kbps
+ */
+uint32_t headset_bulk_kbps(uint32_t bytes, uint32_t start_ms)
+{
+    uint32_t duration = headset_timer_now_ms() - start_ms;
+
+    return duration ? (uint32_t)(((uint64_t)bytes * 8) / duration) : 0;
+}
+
+/*
+ * headset_bulk_reset
+ *
+ * New connection: no request in progress.
+ */
+void headset_bulk_reset(headset_bulk_t *p_bulk)
+{
+    p_bulk->tx_busy         = WICED_FALSE;
+    p_bulk->tx_len          = 0;
+    p_bulk->tx_offset       = 0;
+    p_bulk->bench_remaining = 0;
+    p_bulk->sink_remaining  = 0;
+}
+
+/*
+ * headset_bulk_rsp_header
+ *
+ * Write the response header at the start of the buffer.
+ */
+void headset_bulk_rsp_header(headset_bulk_t *p_bulk, uint8_t op, uint8_t status, uint32_t len)
+{
+    uint8_t *p = p_bulk->p_buffer;
+
+    UINT8_TO_STREAM(p, op);
+    UINT8_TO_STREAM(p, status);
+    UINT32_TO_STREAM(p, len);
+
+    p_bulk->tx_len    = HEADSET_BULK_RSP_HEADER_LEN;
+    p_bulk->tx_offset = 0;
+}
+
+/*
+ * headset_bulk_tx_next
+ *
+ * Refill the buffer, return WICED_FALSE when the response is complete.
+ */
+wiced_bool_t headset_bulk_tx_next(headset_bulk_t *p_bulk)
+{
+    uint16_t len;
+    uint16_t i;
+
+    if (p_bulk->op != HEADSET_BULK_OP_BENCH_TX)
+    {
+        return p_bulk->p_tx_next ? p_bulk->p_tx_next() : WICED_FALSE;
+    }
+
+    if (p_bulk->bench_remaining == 0)
+    {
+        p_bulk->bench_kbps = headset_bulk_kbps(p_bulk->bench_len, p_bulk->start_ms);
+        return WICED_FALSE;
+    }
+
+    /* The first frame carried the response header, restore the pattern. */
+    if (!p_bulk->pattern)
+    {
+        for (i = 0; i < HEADSET_BULK_RSP_HEADER_LEN; i++)
+        {
+            p_bulk->p_buffer[i] = (uint8_t)i;
+        }
+
+        p_bulk->pattern = WICED_TRUE;
+    }
+
+    len = p_bulk->frame_len;
+
+    if (p_bulk->bench_remaining < len)
+    {
+        len = (uint16_t)p_bulk->bench_remaining;
+    }
+
+    p_bulk->bench_remaining -= len;
+    p_bulk->tx_len           = len;
+    p_bulk->tx_offset        = 0;
+    return WICED_TRUE;
+}
+
+/*
+ * headset_bulk_request
+ *
+ * Start the response to a complete request.
+ */
+void headset_bulk_request(headset_bulk_t *p_bulk, uint8_t op, uint8_t *p_param, uint8_t param_len)
+{
+    uint32_t len;
+    uint16_t data_len;
+    uint16_t i;
+
+    p_bulk->op      = op;
+    p_bulk->pattern = WICED_FALSE;
+
+    switch (op)
+    {
+    case HEADSET_BULK_OP_STATS:
+        data_len = headset_stats_build(&p_bulk->p_buffer[HEADSET_BULK_RSP_HEADER_LEN],
+                                       p_bulk->buffer_size - HEADSET_BULK_RSP_HEADER_LEN);
+        headset_bulk_rsp_header(p_bulk, op, data_len ? HEADSET_BULK_STATUS_SUCCESS : HEADSET_BULK_STATUS_ERROR, data_len);
+        p_bulk->tx_len += data_len;
+        break;
+
+    case HEADSET_BULK_OP_TIMELINE:
+        data_len = headset_timeline_build(&p_bulk->p_buffer[HEADSET_BULK_RSP_HEADER_LEN],
+                                          p_bulk->buffer_size - HEADSET_BULK_RSP_HEADER_LEN);
+        headset_bulk_rsp_header(p_bulk, op, data_len ? HEADSET_BULK_STATUS_SUCCESS : HEADSET_BULK_STATUS_ERROR, data_len);
+        p_bulk->tx_len += data_len;
+        break;
+
+    case HEADSET_BULK_OP_BENCH_TX:
+    case HEADSET_BULK_OP_BENCH_RX:
+        if (param_len < sizeof(uint32_t))
+        {
+            headset_bulk_rsp_header(p_bulk, op, HEADSET_BULK_STATUS_INVALID_PARAM, 0);
+            break;
+        }
+
+        STREAM_TO_UINT32(len, p_param);
+
+        p_bulk->bench_len = len;
+        p_bulk->start_ms  = headset_timer_now_ms();
+
+        if (op == HEADSET_BULK_OP_BENCH_TX)
+        {
+            /* The pattern is written once, the same buffer is then sent again. */
+            for (i = 0; i < p_bulk->buffer_size; i++)
+            {
+                p_bulk->p_buffer[i] = (uint8_t)i;
+            }
+
+            headset_bulk_rsp_header(p_bulk, op, HEADSET_BULK_STATUS_SUCCESS, len);
+
+            data_len = p_bulk->frame_len - HEADSET_BULK_RSP_HEADER_LEN;
+            data_len = len < data_len ? (uint16_t)len : data_len;
+
+            p_bulk->tx_len         += data_len;
+            p_bulk->bench_remaining = len - data_len;
+            break;
+        }
+
+        p_bulk->sink_remaining = len;
+
+        if (len)
+        {
+            /* The response is sent once the data has been received. */
+            return;
+        }
+
+        headset_bulk_rsp_header(p_bulk, op, HEADSET_BULK_STATUS_SUCCESS, sizeof(uint32_t));
+        p_bulk->tx_len += sizeof(uint32_t);
+        memset((void *)&p_bulk->p_buffer[HEADSET_BULK_RSP_HEADER_LEN], 0, sizeof(uint32_t));
+        break;
+
+    default:
+        if ((p_bulk->p_request == NULL) || !p_bulk->p_request(op, p_param, param_len))
+        {
+            headset_bulk_rsp_header(p_bulk, op, HEADSET_BULK_STATUS_UNKNOWN_OPCODE, 0);
+        }
+        break;
+    }
+
+    p_bulk->p_rsp_start();
+}
+
+/*
+ * headset_bulk_sink
+ *
+ * Discard the HEADSET_BULK_OP_BENCH_RX data received, send the time taken
+ * once it is complete. Return the bytes consumed.
+ */
+uint16_t headset_bulk_sink(headset_bulk_t *p_bulk, uint16_t len)
+{
+    uint32_t duration;
+    uint8_t *p;
+
+    if (p_bulk->sink_remaining == 0)
+    {
+        return 0;
+    }
+
+    len = len < p_bulk->sink_remaining ? len : (uint16_t)p_bulk->sink_remaining;
+
+    p_bulk->sink_remaining -= len;
+
+    if (p_bulk->sink_remaining == 0)
+    {
+        duration = headset_timer_now_ms() - p_bulk->start_ms;
+        p        = &p_bulk->p_buffer[HEADSET_BULK_RSP_HEADER_LEN];
+
+        p_bulk->bench_kbps = headset_bulk_kbps(p_bulk->bench_len, p_bulk->start_ms);
+
+        headset_bulk_rsp_header(p_bulk, HEADSET_BULK_OP_BENCH_RX, HEADSET_BULK_STATUS_SUCCESS, sizeof(uint32_t));
+        UINT32_TO_STREAM(p, duration);
+        p_bulk->tx_len += sizeof(uint32_t);
+
+        p_bulk->p_rsp_start();
+    }
+
+    return len;
+}
+
+#endif /* HEADSET_SPP_BULK || HEADSET_LE_COC */
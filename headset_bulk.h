@@ -0,0 +1,129 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Bulk data request engine.
+ *
+ * The request and response protocol shared by the SPP (headset_spp.h) and
+ * LE CoC (headset_le_coc.h) bulk data services. The engine builds the
+ * responses in place in the transport buffer, refills it for the streamed
+ * responses and counts the benchmark data; the transport frames the
+ * requests, writes the buffer and calls the engine back when it can take
+ * more.
+ *
+ * The peer sends a request and waits for its response:
+ * Request:
+ * Byte: |   0    |     1     | 2 ...  |
+ * Data: | OPCODE | PARAM_LEN | PARAM  |
+ * Response:
+ * Byte: |   0    |   1    | 2 - 5 | 6 ... |
+ * Data: | OPCODE | STATUS |  LEN  | DATA  |
+ *
+ * HEADSET_BULK_OP_STATS:     DATA is the statistics snapshot (headset_stats.h)
+ * HEADSET_BULK_OP_TIMELINE:  DATA is the timelines (headset_timeline.h)
+ * HEADSET_BULK_OP_NVRAM:     SPP only, see headset_spp.h
+ * HEADSET_BULK_OP_BENCH_TX:  PARAM is LEN (4), DATA is LEN bytes of pattern
+ * HEADSET_BULK_OP_BENCH_RX:  PARAM is LEN (4), the peer then sends LEN bytes
+ *                            which are discarded, DATA is the time taken in
+ *                            ms (4).
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_BULK_PARAM_MAX          4
+#define HEADSET_BULK_RSP_HEADER_LEN     6
+#define HEADSET_BULK_LEN_STREAM         0xFFFFFFFF
+
+/* Opcodes */
+enum
+{
+    HEADSET_BULK_OP_STATS       = 0x01,
+    HEADSET_BULK_OP_TIMELINE    = 0x02,
+    HEADSET_BULK_OP_NVRAM       = 0x03,
+    HEADSET_BULK_OP_BENCH_TX    = 0x10,
+    HEADSET_BULK_OP_BENCH_RX    = 0x11,
+};
+
+/* Response status */
+enum
+{
+    HEADSET_BULK_STATUS_SUCCESS         = 0,
+    HEADSET_BULK_STATUS_UNKNOWN_OPCODE  = 1,
+    HEADSET_BULK_STATUS_INVALID_PARAM   = 2,
+    HEADSET_BULK_STATUS_NOT_ENCRYPTED   = 3,
+    HEADSET_BULK_STATUS_ERROR           = 4,
+};
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    /* Transport, set before the first request */
+    uint8_t      *p_buffer;
+    uint16_t      buffer_size;
+    uint16_t      frame_len;            /* bytes of p_buffer sent per write */
+    void        (*p_rsp_start)(void);   /* send the response prepared in p_buffer */
+    wiced_bool_t (*p_request)(uint8_t op, uint8_t *p_param, uint8_t param_len);    /* transport opcodes, optional */
+    wiced_bool_t (*p_tx_next)(void);    /* refill of the transport opcodes, optional */
+
+    /* Response being sent */
+    wiced_bool_t  tx_busy;
+    uint8_t       op;
+    uint16_t      tx_len;               /* bytes of p_buffer to send */
+    uint16_t      tx_offset;
+    uint32_t      bench_remaining;      /* HEADSET_BULK_OP_BENCH_TX bytes after p_buffer */
+    wiced_bool_t  pattern;              /* p_buffer holds the benchmark pattern only */
+
+    /* HEADSET_BULK_OP_BENCH_RX bytes to discard */
+    uint32_t      sink_remaining;
+
+    uint32_t      bench_len;
+    uint32_t      start_ms;
+    uint32_t      bench_kbps;           /* last benchmark, as seen by the headset */
+} headset_bulk_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void         headset_bulk_reset(headset_bulk_t *p_bulk);
+void         headset_bulk_rsp_header(headset_bulk_t *p_bulk, uint8_t op, uint8_t status, uint32_t len);
+void         headset_bulk_request(headset_bulk_t *p_bulk, uint8_t op, uint8_t *p_param, uint8_t param_len);
+wiced_bool_t headset_bulk_tx_next(headset_bulk_t *p_bulk);
+uint16_t     headset_bulk_sink(headset_bulk_t *p_bulk, uint16_t len);
+uint32_t     headset_bulk_kbps(uint32_t bytes, uint32_t start_ms);
@@ -39,6 +39,7 @@
 #include "bt_hs_spk_control.h"
 #include "bt_hs_spk_button.h"
 #include "wiced_button_manager.h"
+#include "headset_tuning.h"
 
 /******************************************************
  *                      Macros
@@ -46,11 +47,12 @@
 
 static wiced_button_manager_configuration_t app_button_manager_configuration =
 {
-    .short_hold_duration     = 500, /*msec*/
-    .medium_hold_duration    = 700,
-    .long_hold_duration      = 1000,
-    .very_long_hold_duration = 1500,
-    .debounce_duration       = 150, /* typically a click takes around ~150-200 ms */
+    /* Durations in msec, loaded from the tuning store (see headset_tuning.h) */
+    .short_hold_duration     = HEADSET_TUNING_DEFAULT_BUTTON_SHORT_MS,
+    .medium_hold_duration    = HEADSET_TUNING_DEFAULT_BUTTON_MEDIUM_MS,
+    .long_hold_duration      = HEADSET_TUNING_DEFAULT_BUTTON_LONG_MS,
+    .very_long_hold_duration = HEADSET_TUNING_DEFAULT_BUTTON_VERY_LONG_MS,
+    .debounce_duration       = HEADSET_TUNING_DEFAULT_BUTTON_DEBOUNCE_MS,
     .continuous_hold_detect  = WICED_FALSE,
     /*if NULL button events are handled by bt_hs_spk library*/
     .event_handler = NULL,
@@ -137,6 +139,13 @@ wiced_result_t btheadset_init_button_interface(void)
 {
     wiced_result_t result;
     bt_hs_spk_button_config_t config;
+    const headset_tuning_t *p_tuning = headset_tuning_get();
+
+    app_button_manager_configuration.short_hold_duration     = p_tuning->button_short_ms;
+    app_button_manager_configuration.medium_hold_duration    = p_tuning->button_medium_ms;
+    app_button_manager_configuration.long_hold_duration      = p_tuning->button_long_ms;
+    app_button_manager_configuration.very_long_hold_duration = p_tuning->button_very_long_ms;
+    app_button_manager_configuration.debounce_duration       = p_tuning->button_debounce_ms;
 
     config.p_manager                                = &app_button_manager;
     config.p_configuration                          = &app_button_manager_configuration;
@@ -96,6 +96,8 @@
 #include "wiced_platform.h"
 #include "wiced_app.h"
 #include "wiced_bt_a2dp_sink.h"
+#include "wiced_bt_hfp_hf.h"
+#include "wiced_bt_avrc_ct.h"
 #if BTSTACK_VER >= 0x03000001
 #include "wiced_audio_sink_route_config.h"
 #endif
@@ -111,6 +113,22 @@
 #include "wiced_hal_gpio.h"
 #include "hci_control_api.h"
 #include "headset_nvram.h"
+#include "headset_le_bond.h"
+#include "headset_spp.h"
+#include "headset_le_coc.h"
+#include "headset_timer.h"
+#include "headset_work.h"
+#include "headset_event.h"
+#include "headset_sniff.h"
+#include "headset_link_monitor.h"
+#include "headset_afh.h"
+#include "headset_gatt.h"
+#include "headset_sdp.h"
+#include "headset_timeline.h"
+#include "headset_tuning.h"
+#include "headset_avrc.h"
+#include "headset_stats.h"
+#include "headset_fastpair.h"
 #include "wiced_rtos.h"
 #include "wiced_transport.h"
 #ifdef FASTPAIR_ENABLE
@@ -132,9 +150,29 @@
 *****************************************************************************/
 #define HEADSET_CONTROL_MIC_DATA_BUFFER_LEN 1024    // bytes
 
+/* The HCI UART rate is set once by wiced_transport_init(), the application
+ * cannot switch it at runtime: the maximum reported is the same rate. */
+#ifdef HCI_UART_DEFAULT_BAUD
+#define HEADSET_CONTROL_HCI_BAUD_DEFAULT    HCI_UART_DEFAULT_BAUD
+#else
+#define HEADSET_CONTROL_HCI_BAUD_DEFAULT    3000000
+#endif
+#define HEADSET_CONTROL_HCI_BAUD_MAX        HEADSET_CONTROL_HCI_BAUD_DEFAULT
+
+/* Time given to the links to go down before a warm restart is abandoned. */
+#define HEADSET_CONTROL_RESTART_DISCONNECT_MS   3000
+
 /*****************************************************************************
 **  Structures
 *****************************************************************************/
+/* Management event details traced from the application thread. */
+typedef struct
+{
+    uint8_t                   event;
+    uint8_t                   status;
+    wiced_bt_device_address_t bd_addr;
+    uint16_t                  value[3];
+} headset_control_mgmt_trace_t;
 
 /******************************************************
  *               Function Declarations
@@ -147,17 +185,25 @@ static void headset_control_proc_rx_cmd(uint16_t op_code, uint8_t *p_data, uint3
 // 20706A2 does not support wiced_platform_transport_init; init in application itself
 static void hci_control_transport_status(wiced_transport_type_t type);
 static uint32_t hci_control_proc_rx_cmd(uint8_t *p_data, uint32_t length);
-static void headset_control_a2dp_sink_event_post_handler(wiced_bt_a2dp_sink_event_t event, wiced_bt_a2dp_sink_event_data_t* p_data);
 #endif
+static void headset_control_a2dp_sink_event_post_handler(wiced_bt_a2dp_sink_event_t event, wiced_bt_a2dp_sink_event_data_t* p_data);
+static void headset_control_hfp_event_post_handler(wiced_bt_hfp_hf_event_t event, wiced_bt_hfp_hf_event_data_t *p_data);
+static void headset_control_conn_status_change_callback(wiced_bt_device_address_t bd_addr, uint8_t *p_features, wiced_bool_t is_connected, uint16_t handle, wiced_bt_transport_t transport, uint8_t reason);
 
 static void headset_control_mic_data_add(uint8_t *p_data, uint16_t len);
 static wiced_bool_t headset_control_mic_data_add_callback(uint8_t *p_data, uint32_t len);
 static void headset_control_mic_data_reset(void);
+static void headset_control_mic_data_reset_work(uint8_t *p_data, uint16_t len);
+static void headset_control_warm_restart_result_send(wiced_result_t status);
+static void headset_control_warm_restart_event_send(wiced_result_t status, uint32_t duration_ms);
+static void headset_control_link_event_handler(const headset_event_data_t *p_data);
+static void headset_control_warm_restart_timeout(uint32_t arg);
 
 /******************************************************
  *               Variables Definitions
  ******************************************************/
 extern wiced_bt_a2dp_config_data_t bt_audio_config;
+extern wiced_bt_a2dp_codec_info_t  bt_audio_codec_capabilities[];
 extern uint8_t                     bt_avrc_ct_supported_events[];
 extern void wiced_audio_sink_set_hci_event_audio_data_extra_header(uint8_t enabled);
 
@@ -225,6 +271,23 @@ typedef struct
 
 static headset_control_local_irk_info_t local_irk_info = { 0 };
 
+/* Local IRK received in the management callback, committed to NVRAM from the work queue. */
+static uint8_t local_irk_pending[BTM_SECURITY_LOCAL_KEY_DATA_LEN];
+
+static headset_control_mgmt_cb_stats_t headset_control_mgmt_cb_stats = { 0 };
+static headset_control_mic_stats_t     headset_control_mic_stats = { 0 };
+
+/* Bluetooth stack start and warm restart. */
+static struct
+{
+    wiced_bool_t    started;        /* one-time initialization done */
+    wiced_bool_t    restarting;     /* warm restart waiting for the links to go down or BTM_ENABLED_EVT */
+    wiced_bool_t    disconnecting;  /* warm restart waiting for the links to go down */
+    uint8_t         br_links;       /* BR/EDR ACL links up */
+    uint64_t        restart_us;
+    headset_timer_t timer;          /* HEADSET_CONTROL_RESTART_DISCONNECT_MS */
+} headset_control_start_info = { 0 };
+
 struct headset_control_mic_data_info_t
 {
     wiced_mutex_t *p_mutex;
@@ -289,6 +352,96 @@ static void headset_control_local_irk_update(uint8_t *p_key)
     }
 }
 
+/*
+ * headset_control_local_irk_update_work
+ *
+ * Commit the pending local IRK to NVRAM (executed in the application thread).
+ */
+static void headset_control_local_irk_update_work(uint8_t *p_data, uint16_t len)
+{
+    headset_control_local_irk_update(local_irk_pending);
+}
+
+/*
+ * headset_control_mgmt_trace_work
+ *
+ * Format the trace of a management event (executed in the application thread).
+ */
+static void headset_control_mgmt_trace_work(uint8_t *p_data, uint16_t len)
+{
+    headset_control_mgmt_trace_t *p_trace = (headset_control_mgmt_trace_t *)p_data;
+
+#if (WICED_HCI_TRANSPORT == WICED_HCI_TRANSPORT_UART)
+    WICED_BT_TRACE("btheadset bluetooth management callback event: %d\n", p_trace->event);
+#endif
+
+    switch (p_trace->event)
+    {
+    case BTM_PAIRING_COMPLETE_EVT:
+        WICED_BT_TRACE("%s Pairing Result: %02x\n",
+                       p_trace->value[0] == BT_TRANSPORT_BR_EDR ? "BREDR" : "LE",
+                       p_trace->status);
+        break;
+
+    case BTM_ENCRYPTION_STATUS_EVT:
+        WICED_BT_TRACE("Encryption Status:(%B) res:%d\n", p_trace->bd_addr, p_trace->status);
+        break;
+
+    case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
+        WICED_BT_TRACE("BLE_ADVERT_STATE_CHANGED_EVT:%d\n", p_trace->status);
+        break;
+
+    case BTM_BLE_CONNECTION_PARAM_UPDATE:
+        WICED_BT_TRACE("BTM_BLE_CONNECTION_PARAM_UPDATE (%B, status: %d, conn_interval: %d, conn_latency: %d, supervision_timeout: %d)\n",
+                       p_trace->bd_addr,
+                       p_trace->status,
+                       p_trace->value[0],
+                       p_trace->value[1],
+                       p_trace->value[2]);
+        break;
+
+#if (!CYW20706A2)
+    case BTM_BLE_PHY_UPDATE_EVT:
+        WICED_BT_TRACE("PHY config is updated as TX_PHY : %dM, RX_PHY : %dM\n",
+                       p_trace->value[0],
+                       p_trace->value[1]);
+        break;
+#endif
+
+    default:
+        break;
+    }
+}
+
+/*
+ * headset_control_mgmt_cb_stats_update
+ */
+static void headset_control_mgmt_cb_stats_update(wiced_bt_management_evt_t event, uint64_t start)
+{
+    uint32_t duration = (uint32_t)(headset_timer_now_us() - start);
+
+    headset_control_mgmt_cb_stats.count++;
+    headset_control_mgmt_cb_stats.total_us += duration;
+
+    /* BTM_ENABLED_EVT runs the whole post-init and would hide the steady state figure. */
+    if ((event != BTM_ENABLED_EVT) &&
+        (duration > headset_control_mgmt_cb_stats.max_us))
+    {
+        headset_control_mgmt_cb_stats.max_us    = duration;
+        headset_control_mgmt_cb_stats.max_event = (uint8_t)event;
+    }
+}
+
+/*
+ * headset_control_mgmt_cb_stats_get
+ *
+ * Duration of the Bluetooth management callback.
+ */
+void headset_control_mgmt_cb_stats_get(headset_control_mgmt_cb_stats_t *p_stats)
+{
+    memcpy((void *)p_stats, (void *)&headset_control_mgmt_cb_stats, sizeof(headset_control_mgmt_cb_stats_t));
+}
+
 /*
  *  btheadset_control_init
  *  Does Bluetooth stack and audio buffer init
@@ -358,6 +511,29 @@ void hci_control_hci_packet_cback(wiced_bt_hci_trace_type_t type, uint16_t lengt
 
 #endif // HCI_TRACE_OVER_TRANSPORT
 
+/*
+ * headset_control_a2dp_tuning_apply
+ *
+ * Load the A2DP sink parameters of the tuning store into the configuration
+ * given to the bt_hs_spk library.
+ */
+static void headset_control_a2dp_tuning_apply(const headset_tuning_t *p_tuning)
+{
+    bt_audio_config.p_param.buf_depth_ms                  = p_tuning->a2dp_buf_depth_ms;
+    bt_audio_config.p_param.start_buf_depth               = p_tuning->a2dp_start_buf_depth;
+    bt_audio_config.p_param.target_buf_depth              = p_tuning->a2dp_target_buf_depth;
+    bt_audio_config.p_param.adj_ppm_max                   = p_tuning->a2dp_adj_ppm_max;
+    bt_audio_config.p_param.adj_ppm_min                   = p_tuning->a2dp_adj_ppm_min;
+    bt_audio_config.p_param.adj_ppb_per_msec              = p_tuning->a2dp_adj_ppb_per_msec;
+    bt_audio_config.p_param.lvl_correction_threshold_high = p_tuning->a2dp_lvl_threshold_high;
+    bt_audio_config.p_param.lvl_correction_threshold_low  = p_tuning->a2dp_lvl_threshold_low;
+    bt_audio_config.p_param.adj_proportional_gain         = p_tuning->a2dp_proportional_gain;
+    bt_audio_config.p_param.adj_integral_gain             = p_tuning->a2dp_integral_gain;
+
+    /* The SBC capabilities come first. */
+    bt_audio_codec_capabilities[0].cie.sbc.max_bitpool    = p_tuning->sbc_max_bitpool;
+}
+
 /*
  * btheadset_post_bt_init
  */
@@ -366,6 +542,47 @@ wiced_result_t btheadset_post_bt_init(void)
     wiced_bool_t               ret    = WICED_FALSE;
     bt_hs_spk_control_config_t config = { 0 };
     bt_hs_spk_eir_config_t     eir    = { 0 };
+    const headset_tuning_t    *p_tuning;
+
+    /* Tuning store, loaded at boot and kept across a warm restart. */
+    headset_tuning_init();
+    p_tuning = headset_tuning_get();
+    headset_control_a2dp_tuning_apply(p_tuning);
+
+    /* Application timer service, shared by all the application timers. */
+    headset_timer_init();
+
+    /* Links followed by the warm restart. */
+    headset_timer_setup(&headset_control_start_info.timer, &headset_control_warm_restart_timeout, 0);
+    headset_event_subscribe(HEADSET_EVENT_MASK_BREDR | HEADSET_EVENT_MASK_LE, &headset_control_link_event_handler);
+
+    /* Sniff policy for the idle ACL links. */
+    headset_sniff_init();
+
+    /* Link quality monitor, selects the EDR packet types allowed on each ACL. */
+    headset_link_monitor_init();
+
+    /* AFH host channel blocklist and optional host channel classification. */
+    headset_afh_init();
+
+    /* SDP database size and peer SDP exchange time. */
+    headset_sdp_init();
+
+    /* Pairing and connection setup timeline of each peer. */
+    headset_timeline_init();
+
+    /* Bonded LE peers in the controller Filter Accept List and resolving list. */
+    headset_le_bond_init();
+
+#ifdef HEADSET_SPP_BULK
+    /* Bulk data service on the SPP record channel. */
+    headset_spp_init();
+#endif
+
+#ifdef HEADSET_LE_COC
+    /* Bulk data service on an LE credit based channel. */
+    headset_le_coc_init();
+#endif
 
     eir.p_dev_name = (char *)wiced_bt_cfg_settings.device_name;
     eir.default_uuid_included = WICED_TRUE;
@@ -382,23 +599,16 @@ wiced_result_t btheadset_post_bt_init(void)
         return WICED_BT_ERROR;
     }
 
-    config.conn_status_change_cb = NULL;
-#ifdef LOW_POWER_MEASURE_MODE
-    config.discoverable_timeout = 60;               /* 60 Sec */
-#else
-    config.discoverable_timeout = 240;              /* 240 Sec */
-#endif
+    config.conn_status_change_cb = &headset_control_conn_status_change_callback;
+    config.discoverable_timeout  = p_tuning->discoverable_timeout;
     config.acl3mbpsPacketSupport            = WICED_TRUE;
     config.audio.a2dp.p_audio_config        = &bt_audio_config;
     config.audio.a2dp.p_pre_handler         = NULL;
-#if defined(CYW20706A2)
     config.audio.a2dp.post_handler          = &headset_control_a2dp_sink_event_post_handler;
-#else
-    config.audio.a2dp.post_handler          = NULL;
-#endif
     config.audio.avrc_ct.p_supported_events = bt_avrc_ct_supported_events;
-    config.hfp.rfcomm.buffer_size           = 700;
-    config.hfp.rfcomm.buffer_count          = 4;
+    config.hfp.rfcomm.buffer_size           = p_tuning->hfp_rfcomm_buffer_size;
+    config.hfp.rfcomm.buffer_count          = p_tuning->hfp_rfcomm_buffer_count;
+    config.hfp.post_handler                 = &headset_control_hfp_event_post_handler;
 #if (WICED_BT_HFP_HF_WBS_INCLUDED == TRUE)
     config.hfp.feature_mask = WICED_BT_HFP_HF_FEATURE_3WAY_CALLING | \
                               WICED_BT_HFP_HF_FEATURE_CLIP_CAPABILITY | \
@@ -444,20 +654,23 @@ wiced_result_t btheadset_post_bt_init(void)
     /* Register the MIC data add callback. */
     bt_hs_spk_handsfree_sco_mic_data_add_callback_register(&headset_control_mic_data_add_callback);
 
-    /* Create mutex for MIC data control. */
-    headset_control_mic_data.p_mutex = wiced_rtos_create_mutex();
-
+    /* Create mutex for MIC data control (kept across a warm restart). */
     if (!headset_control_mic_data.p_mutex)
     {
-        WICED_BT_TRACE("Err: fail to create mutex for MIC data control\n");
-        return WICED_BT_ERROR;
-    }
+        headset_control_mic_data.p_mutex = wiced_rtos_create_mutex();
 
-    /* Initialize the mutex used for MIC data control. */
-    if (wiced_rtos_init_mutex(headset_control_mic_data.p_mutex) != WICED_BT_SUCCESS)
-    {
-        WICED_BT_TRACE("Err: fail to init. mutex for MIC data control\n");
-        return WICED_BT_ERROR;
+        if (!headset_control_mic_data.p_mutex)
+        {
+            WICED_BT_TRACE("Err: fail to create mutex for MIC data control\n");
+            return WICED_BT_ERROR;
+        }
+
+        /* Initialize the mutex used for MIC data control. */
+        if (wiced_rtos_init_mutex(headset_control_mic_data.p_mutex) != WICED_BT_SUCCESS)
+        {
+            WICED_BT_TRACE("Err: fail to init. mutex for MIC data control\n");
+            return WICED_BT_ERROR;
+        }
     }
 
 #if (!CYW20706A2)
@@ -498,10 +711,12 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
     int nvram_id;
     wiced_bt_dev_pairing_cplt_t *p_pairing_cmpl;
     uint8_t pairing_result;
+    uint64_t start = headset_timer_now_us();
+    headset_control_mgmt_trace_t trace = { 0 };
+    wiced_result_t post_init_result;
 
-#if (WICED_HCI_TRANSPORT == WICED_HCI_TRANSPORT_UART)
-    WICED_BT_TRACE("btheadset bluetooth management callback event: %d\n", event);
-#endif
+    /* Trace formatting is deferred to the application thread. */
+    trace.event = (uint8_t)event;
 
     switch (event)
     {
@@ -510,27 +725,36 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         if (p_event_data->enabled.status != WICED_BT_SUCCESS)
         {
             WICED_BT_TRACE("arrived with failure\n");
+
+            headset_control_warm_restart_result_send(p_event_data->enabled.status);
         }
         else
         {
-            btheadset_post_bt_init();
+            post_init_result = btheadset_post_bt_init();
 
 #ifdef HCI_TRACE_OVER_TRANSPORT
             // Disable while streaming audio over the uart.
             wiced_bt_dev_register_hci_trace(hci_control_hci_packet_cback);
 #endif
 
-            if (WICED_SUCCESS != btheadset_init_button_interface())
+            /* Buttons and LED do not depend on the stack, keep them across a warm restart. */
+            if (!headset_control_start_info.started)
             {
-                WICED_BT_TRACE("btheadset button init failed\n");
-            }
+                if (WICED_SUCCESS != btheadset_init_button_interface())
+                {
+                    WICED_BT_TRACE("btheadset button init failed\n");
+                }
 
 #ifndef PLATFORM_LED_DISABLED
-            if (WICED_SUCCESS != wiced_led_manager_init(&led_config))
-            {
-                WICED_BT_TRACE("btheadset LED init failed\n");
-            }
+                if (WICED_SUCCESS != wiced_led_manager_init(&led_config))
+                {
+                    WICED_BT_TRACE("btheadset LED init failed\n");
+                }
 #endif
+                headset_control_start_info.started = WICED_TRUE;
+            }
+
+            headset_control_warm_restart_result_send(post_init_result);
 
             WICED_BT_TRACE("Free RAM sizes: %d\n", wiced_memory_get_free_bytes());
         }
@@ -548,6 +772,9 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
     case BTM_USER_CONFIRMATION_REQUEST_EVT:
         // If this is just works pairing, accept. Otherwise send event to the MCU to confirm the same value.
         WICED_BT_TRACE("BTM_USER_CONFIRMATION_REQUEST_EVT BDA %B\n", p_event_data->user_confirmation_request.bd_addr);
+        headset_timeline_mark(p_event_data->user_confirmation_request.bd_addr,
+                              HEADSET_TIMELINE_STEP_USER_CONFIRMATION,
+                              (uint8_t)p_event_data->user_confirmation_request.just_works);
         if (p_event_data->user_confirmation_request.just_works)
         {
             WICED_BT_TRACE("just_works \n");
@@ -557,6 +784,7 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         {
             WICED_BT_TRACE("Need to send user_confirmation_request, Key %d \n", p_event_data->user_confirmation_request.numeric_value);
 #ifdef FASTPAIR_ENABLE
+            /* The provider needs the passkey before the reply, it is not deferred. */
             wiced_bt_gfps_provider_seeker_passkey_set(p_event_data->user_confirmation_request.numeric_value);
 #endif
             wiced_bt_dev_confirm_req_reply(WICED_BT_SUCCESS, p_event_data->user_confirmation_request.bd_addr);
@@ -572,6 +800,9 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         /* Use the default security for BR/EDR*/
         WICED_BT_TRACE("BTM_PAIRING_IO_CAPABILITIES_BR_EDR_REQUEST_EVT (%B)\n",
                        p_event_data->pairing_io_capabilities_br_edr_request.bd_addr);
+        headset_timeline_mark(p_event_data->pairing_io_capabilities_br_edr_request.bd_addr,
+                              HEADSET_TIMELINE_STEP_IO_CAP_REQUEST,
+                              BT_TRANSPORT_BR_EDR);
 
 #ifdef FASTPAIR_ENABLE
         if (wiced_bt_gfps_provider_pairing_state_get())
@@ -597,6 +828,9 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         WICED_BT_TRACE("BTM_PAIRING_IO_CAPABILITIES_BR_EDR_RESPONSE_EVT (%B, io_cap: 0x%02X) \n",
                        p_event_data->pairing_io_capabilities_br_edr_response.bd_addr,
                        p_event_data->pairing_io_capabilities_br_edr_response.io_cap);
+        headset_timeline_mark(p_event_data->pairing_io_capabilities_br_edr_response.bd_addr,
+                              HEADSET_TIMELINE_STEP_IO_CAP_RESPONSE,
+                              p_event_data->pairing_io_capabilities_br_edr_response.io_cap);
 
 #ifdef FASTPAIR_ENABLE
         if (wiced_bt_gfps_provider_pairing_state_get())
@@ -615,6 +849,9 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         /* Use the default security for LE */
         WICED_BT_TRACE("BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT bda %B\n",
                        p_event_data->pairing_io_capabilities_ble_request.bd_addr);
+        headset_timeline_mark(p_event_data->pairing_io_capabilities_ble_request.bd_addr,
+                              HEADSET_TIMELINE_STEP_IO_CAP_REQUEST,
+                              BT_TRANSPORT_LE);
 
         p_event_data->pairing_io_capabilities_ble_request.local_io_cap = BTM_IO_CAPABILITIES_NONE;
         p_event_data->pairing_io_capabilities_ble_request.oob_data     = BTM_OOB_NONE;
@@ -629,23 +866,40 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         if (p_pairing_cmpl->transport == BT_TRANSPORT_BR_EDR)
         {
             pairing_result = p_pairing_cmpl->pairing_complete_info.br_edr.status;
-            WICED_BT_TRACE("BREDR Pairing Result: %02x\n", pairing_result);
         }
         else
         {
             pairing_result = p_pairing_cmpl->pairing_complete_info.ble.reason;
-            WICED_BT_TRACE("LE Pairing Result: %02x\n", pairing_result);
         }
+
+        trace.status   = pairing_result;
+        trace.value[0] = p_pairing_cmpl->transport;
+
+        headset_timeline_mark(p_pairing_cmpl->bd_addr, HEADSET_TIMELINE_STEP_PAIRING_COMPLETE, pairing_result);
         //btheadset_control_pairing_completed_evt( pairing_result, p_event_data->pairing_complete.bd_addr );
         break;
 
     case BTM_ENCRYPTION_STATUS_EVT:
         p_encryption_status = &p_event_data->encryption_status;
 
-        WICED_BT_TRACE("Encryption Status:(%B) res:%d\n", p_encryption_status->bd_addr, p_encryption_status->result);
+        trace.status = (uint8_t)p_encryption_status->result;
+        memcpy((void *)trace.bd_addr, (void *)p_encryption_status->bd_addr, sizeof(wiced_bt_device_address_t));
+
+        headset_timeline_mark(p_encryption_status->bd_addr, HEADSET_TIMELINE_STEP_ENCRYPTION, trace.status);
 
         bt_hs_spk_control_btm_event_handler_encryption_status(p_encryption_status);
 
+#ifdef HEADSET_SPP_BULK
+        headset_spp_encryption_status(p_encryption_status->bd_addr,
+                                      p_encryption_status->transport,
+                                      p_encryption_status->result);
+#endif
+#ifdef HEADSET_LE_COC
+        headset_le_coc_encryption_status(p_encryption_status->bd_addr,
+                                         p_encryption_status->transport,
+                                         p_encryption_status->result);
+#endif
+
         break;
 
     case BTM_SECURITY_REQUEST_EVT:
@@ -662,6 +916,10 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         break;
 
     case BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT:
+        headset_timeline_mark(p_event_data->paired_device_link_keys_update.bd_addr,
+                              HEADSET_TIMELINE_STEP_LINK_KEY_UPDATE,
+                              0);
+        headset_le_bond_keys_update(&p_event_data->paired_device_link_keys_update);
         result = bt_hs_spk_control_btm_event_handler_link_key(event, &p_event_data->paired_device_link_keys_update) ? WICED_BT_SUCCESS : WICED_BT_ERROR;
         break;
 
@@ -670,9 +928,20 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         break;
 
     case BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT:
-        WICED_BT_TRACE("BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT\n");
+        headset_timeline_mark(NULL, HEADSET_TIMELINE_STEP_IRK_UPDATE, 0);
 
-        headset_control_local_irk_update((uint8_t *)&p_event_data->local_identity_keys_update);
+        /* Stage the key, the NVRAM commit is done from the work queue. */
+        memcpy((void *)local_irk_pending,
+               (void *)&p_event_data->local_identity_keys_update,
+               BTM_SECURITY_LOCAL_KEY_DATA_LEN);
+
+        if (!headset_work_post(HEADSET_WORK_PRIORITY_BACKGROUND,
+                               &headset_control_local_irk_update_work,
+                               NULL,
+                               0))
+        {
+            headset_control_local_irk_update(local_irk_pending);
+        }
         break;
 
     case BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT:
@@ -695,10 +964,13 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         break;
 
     case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
-        WICED_BT_TRACE("BLE_ADVERT_STATE_CHANGED_EVT:%d\n", p_event_data->ble_advert_state_changed);
+        trace.status = (uint8_t)p_event_data->ble_advert_state_changed;
+        headset_le_bond_adv_state(p_event_data->ble_advert_state_changed);
         break;
 
     case BTM_POWER_MANAGEMENT_STATUS_EVT:
+        headset_sniff_power_mgmt_status(&p_event_data->power_mgmt_notification);
+
         bt_hs_spk_control_btm_event_handler_power_management_status(&p_event_data->power_mgmt_notification);
         break;
 
@@ -708,28 +980,47 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
     case BTM_SCO_CONNECTION_CHANGE_EVT:
         hf_sco_management_callback(event, p_event_data);
 
+        if (event == BTM_SCO_CONNECTED_EVT)
+        {
+            headset_event_publish(HEADSET_EVENT_SCO_CONNECTED,
+                                  NULL,
+                                  p_event_data->sco_connected.sco_index,
+                                  0);
+        }
+        else if (event == BTM_SCO_DISCONNECTED_EVT)
+        {
+            headset_event_publish(HEADSET_EVENT_SCO_DISCONNECTED,
+                                  NULL,
+                                  p_event_data->sco_disconnected.sco_index,
+                                  0);
+        }
+
         if (event == BTM_SCO_DISCONNECTED_EVT)
         {
-            headset_control_mic_data_reset();
+            headset_work_post(HEADSET_WORK_PRIORITY_AUDIO,
+                              &headset_control_mic_data_reset_work,
+                              NULL,
+                              0);
         }
         break;
 
     case BTM_BLE_CONNECTION_PARAM_UPDATE:
-        WICED_BT_TRACE("BTM_BLE_CONNECTION_PARAM_UPDATE (%B, status: %d, conn_interval: %d, conn_latency: %d, supervision_timeout: %d)\n",
-                       p_event_data->ble_connection_param_update.bd_addr,
-                       p_event_data->ble_connection_param_update.status,
-                       p_event_data->ble_connection_param_update.conn_interval,
-                       p_event_data->ble_connection_param_update.conn_latency,
-                       p_event_data->ble_connection_param_update.supervision_timeout);
+        memcpy((void *)trace.bd_addr,
+               (void *)p_event_data->ble_connection_param_update.bd_addr,
+               sizeof(wiced_bt_device_address_t));
+
+        trace.status   = p_event_data->ble_connection_param_update.status;
+        trace.value[0] = p_event_data->ble_connection_param_update.conn_interval;
+        trace.value[1] = p_event_data->ble_connection_param_update.conn_latency;
+        trace.value[2] = p_event_data->ble_connection_param_update.supervision_timeout;
         break;
 
 #if (!CYW20706A2)
     // 20706A2 does not support phy update
     case BTM_BLE_PHY_UPDATE_EVT:
         /* LE PHY Update to 1M or 2M */
-        WICED_BT_TRACE("PHY config is updated as TX_PHY : %dM, RX_PHY : %dM\n",
-                       p_event_data->ble_phy_update_event.tx_phy,
-                       p_event_data->ble_phy_update_event.rx_phy);
+        trace.value[0] = p_event_data->ble_phy_update_event.tx_phy;
+        trace.value[1] = p_event_data->ble_phy_update_event.rx_phy;
         break;
 
 #endif
@@ -748,22 +1039,31 @@ wiced_result_t btheadset_control_management_callback(wiced_bt_management_evt_t e
         result = WICED_BT_USE_DEFAULT_SECURITY;
         break;
     }
+
+    headset_work_post(HEADSET_WORK_PRIORITY_BACKGROUND,
+                      &headset_control_mgmt_trace_work,
+                      &trace,
+                      sizeof(trace));
+
+    headset_control_mgmt_cb_stats_update(event, start);
+
     return result;
 }
 
 /*
- * headset_control_start
+ * headset_control_stack_start
  *
- * Start the application.
+ * Create the heap and enable the Bluetooth stack, the application
+ * initialization continues on BTM_ENABLED_EVT.
  */
-static void headset_control_start(uint8_t *p_data, uint32_t data_len)
+static wiced_result_t headset_control_stack_start(void)
 {
     wiced_result_t ret = WICED_BT_ERROR;
 
-    /* Check parameter.*/
-    if (data_len != 0)
+    /* Deferred-work executor used by the stack callbacks. */
+    if (headset_work_init() != WICED_BT_SUCCESS)
     {
-        return;
+        return WICED_BT_ERROR;
     }
 
 #if BTSTACK_VER >= 0x03000001
@@ -773,7 +1073,7 @@ static void headset_control_start(uint8_t *p_data, uint32_t data_len)
     if (p_default_heap == NULL)
     {
         WICED_BT_TRACE("create default heap error: size %d\n", BT_STACK_HEAP_SIZE);
-        return;
+        return WICED_BT_NO_RESOURCES;
     }
 #endif
 
@@ -786,19 +1086,288 @@ static void headset_control_start(uint8_t *p_data, uint32_t data_len)
     if (ret != WICED_BT_SUCCESS)
     {
         WICED_BT_TRACE("wiced_bt_stack_init returns error: %d\n", ret);
+        return ret;
+    }
+
+    /* Configure Audio buffer (the audio buffer pool is kept across a warm restart) */
+    if (!headset_control_start_info.started)
+    {
+        ret = wiced_audio_buffer_initialize(wiced_bt_audio_buf_config);
+        if (ret != WICED_BT_SUCCESS)
+        {
+            WICED_BT_TRACE("wiced_audio_buffer_initialize returns error: %d\n", ret);
+            return ret;
+        }
+    }
+
+    /* Restore local Identify Resolving Key (IRK) for LE Private Resolvable Address. */
+    headset_control_local_irk_restore();
+
+    return WICED_BT_SUCCESS;
+}
+
+/*
+ * headset_control_start
+ *
+ * Start the application.
+ */
+static void headset_control_start(uint8_t *p_data, uint32_t data_len)
+{
+    /* Check parameter.*/
+    if (data_len != 0)
+    {
+        return;
+    }
+
+    headset_control_stack_start();
+}
+
+/*
+ * headset_control_warm_restart_event_send
+ *
+ * Byte: |   0    |    1 - 4    |
+ * Data: | STATUS | DURATION_MS |
+ */
+static void headset_control_warm_restart_event_send(wiced_result_t status, uint32_t duration_ms)
+{
+    uint8_t  event[sizeof(uint8_t) + sizeof(uint32_t)];
+    uint8_t *p = event;
+
+    WICED_BT_TRACE("warm restart status %d, %d ms\n", status, duration_ms);
+
+    UINT8_TO_STREAM(p, status);
+    UINT32_TO_STREAM(p, duration_ms);
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_WARM_RESTART, event, sizeof(event));
+}
+
+/*
+ * headset_control_warm_restart_result_send
+ *
+ * Report the result of the warm restart in progress, if any.
+ */
+static void headset_control_warm_restart_result_send(wiced_result_t status)
+{
+    if (!headset_control_start_info.restarting)
+    {
         return;
     }
 
-    /* Configure Audio buffer */
-    ret = wiced_audio_buffer_initialize(wiced_bt_audio_buf_config);
+    headset_control_start_info.restarting = WICED_FALSE;
+
+    headset_control_warm_restart_event_send(status,
+                                            (uint32_t)((headset_timer_now_us() - headset_control_start_info.restart_us) / 1000));
+}
+
+#if BTSTACK_VER >= 0x03000001
+/*
+ * headset_control_warm_restart_teardown
+ *
+ * Tear down the profiles and the Bluetooth stack once no link is left,
+ * release the heap and reset the application state, then start the stack
+ * again. Serialized to the application thread, out of the stack callbacks.
+ */
+static int headset_control_warm_restart_teardown(void *p_data)
+{
+    wiced_result_t ret;
+
+    /* Profiles */
+    wiced_bt_avrc_ct_cleanup();
+    wiced_bt_a2dp_sink_deinit();
+    wiced_bt_hfp_hf_deinit();
+
+#if (WICED_APP_LE_INCLUDED == TRUE)
+    hci_control_le_disable();
+#endif
+
+    /* Stack and heap */
+    wiced_bt_stack_deinit();
+    wiced_bt_delete_heap(p_default_heap);
+    p_default_heap = NULL;
+
+    headset_control_start_info.br_links = 0;
+
+    /* MIC data ring */
+    wiced_rtos_lock_mutex(headset_control_mic_data.p_mutex);
+    headset_control_mic_data_reset();
+    wiced_rtos_unlock_mutex(headset_control_mic_data.p_mutex);
+
+    /* The application modules are initialized again in btheadset_post_bt_init(). */
+    ret = headset_control_stack_start();
+
     if (ret != WICED_BT_SUCCESS)
     {
-        WICED_BT_TRACE("wiced_audio_buffer_initialize returns error: %d\n", ret);
+        headset_control_warm_restart_result_send(ret);
+    }
+
+    return 0;
+}
+
+/*
+ * headset_control_links_disconnect
+ *
+ * Disconnect every BR/EDR and LE link, return the number of links up.
+ */
+static uint8_t headset_control_links_disconnect(void)
+{
+    uint16_t conn_id[HEADSET_GATT_LINK_MAX];
+    uint8_t  num;
+    uint8_t  i;
+
+    num = headset_gatt_links_get(conn_id, HEADSET_GATT_LINK_MAX);
+
+    for (i = 0; i < num; i++)
+    {
+        wiced_bt_gatt_disconnect(conn_id[i]);
+    }
+
+    if (headset_control_start_info.br_links)
+    {
+        /* All the profiles and the ACL of every peer. */
+        bt_hs_spk_control_disconnect(NULL);
+    }
+
+    return num + headset_control_start_info.br_links;
+}
+#endif /* BTSTACK_VER >= 0x03000001 */
+
+/*
+ * headset_control_link_event_handler
+ *
+ * Count the BR/EDR links, continue the warm restart when the last link is down.
+ */
+static void headset_control_link_event_handler(const headset_event_data_t *p_data)
+{
+#if BTSTACK_VER >= 0x03000001
+    uint16_t conn_id[HEADSET_GATT_LINK_MAX];
+#endif
+
+    switch (p_data->event)
+    {
+    case HEADSET_EVENT_BREDR_CONNECTED:
+        headset_control_start_info.br_links++;
+        break;
+
+    case HEADSET_EVENT_BREDR_DISCONNECTED:
+        if (headset_control_start_info.br_links)
+        {
+            headset_control_start_info.br_links--;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+#if BTSTACK_VER >= 0x03000001
+    if ((headset_control_start_info.disconnecting) &&
+        (headset_control_start_info.br_links == 0) &&
+        (headset_gatt_links_get(conn_id, HEADSET_GATT_LINK_MAX) == 0))
+    {
+        headset_control_start_info.disconnecting = WICED_FALSE;
+        headset_timer_stop(&headset_control_start_info.timer);
+
+        wiced_app_event_serialize(&headset_control_warm_restart_teardown, NULL);
+    }
+#endif
+}
+
+/*
+ * headset_control_warm_restart_timeout
+ *
+ * A link did not go down, give up the warm restart.
+ */
+static void headset_control_warm_restart_timeout(uint32_t arg)
+{
+    if (!headset_control_start_info.disconnecting)
+    {
         return;
     }
 
-    /* Restore local Identify Resolving Key (IRK) for LE Private Resolvable Address. */
-    headset_control_local_irk_restore();
+    headset_control_start_info.disconnecting = WICED_FALSE;
+
+    headset_control_warm_restart_result_send(WICED_BT_TIMEOUT);
+}
+
+/*
+ * headset_control_warm_restart
+ *
+ * Disconnect all the links and wait for their disconnection events, so that
+ * every module and library clears its per link state through its normal
+ * path, then tear down and start the stack again without a new firmware
+ * download. The result is reported on BTM_ENABLED_EVT, or when a link does
+ * not go down within HEADSET_CONTROL_RESTART_DISCONNECT_MS.
+ */
+static void headset_control_warm_restart(uint8_t *p_data, uint32_t data_len)
+{
+    /* Check parameter.*/
+    if (data_len != 0)
+    {
+        return;
+    }
+
+    if ((!headset_control_start_info.started) || headset_control_start_info.restarting)
+    {
+        headset_control_warm_restart_event_send(WICED_BT_BUSY, 0);
+        return;
+    }
+
+#if BTSTACK_VER >= 0x03000001
+    headset_control_start_info.restarting = WICED_TRUE;
+    headset_control_start_info.restart_us = headset_timer_now_us();
+
+    if (headset_control_links_disconnect() == 0)
+    {
+        headset_control_warm_restart_teardown(NULL);
+        return;
+    }
+
+    headset_control_start_info.disconnecting = WICED_TRUE;
+    headset_timer_start(&headset_control_start_info.timer, HEADSET_CONTROL_RESTART_DISCONNECT_MS, 0);
+#else
+    /* The stack of this target cannot be shut down. */
+    headset_control_warm_restart_event_send(WICED_UNSUPPORTED, 0);
+#endif /* BTSTACK_VER >= 0x03000001 */
+}
+
+/*
+ * headset_control_capabilities_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_CAPABILITIES.
+ *
+ * Byte: |    0    |    1 - 4     |     5 - 8    |   9 - 12  |     13 - 14     |
+ * Data: | VERSION | CAPABILITIES | BAUD_DEFAULT | BAUD_MAX  | MIC_BUFFER_LEN  |
+ */
+static void headset_control_capabilities_send(uint8_t *p_data, uint32_t data_len)
+{
+    uint8_t  event[sizeof(uint8_t) + 3 * sizeof(uint32_t) + sizeof(uint16_t)];
+    uint8_t *p = event;
+    uint32_t caps;
+
+    caps = HEADSET_CONTROL_CAPS_STATS |
+           HEADSET_CONTROL_CAPS_AVRC_INFO |
+           HEADSET_CONTROL_CAPS_AFH |
+           HEADSET_CONTROL_CAPS_TIMELINE |
+           HEADSET_CONTROL_CAPS_TUNING;
+
+#if (!CYW20706A2)
+    /* The 20706A2 audio sink library does not add the audio data header. */
+    caps |= HEADSET_CONTROL_CAPS_AUDIO_SN_HEADER;
+#endif
+#if BTSTACK_VER >= 0x03000001
+    caps |= HEADSET_CONTROL_CAPS_WARM_RESTART;
+#endif
+#ifdef FASTPAIR_ENABLE
+    caps |= HEADSET_CONTROL_CAPS_FASTPAIR_PROFILE;
+#endif
+
+    UINT8_TO_STREAM(p, HEADSET_CONTROL_CAPS_VERSION);
+    UINT32_TO_STREAM(p, caps);
+    UINT32_TO_STREAM(p, HEADSET_CONTROL_HCI_BAUD_DEFAULT);
+    UINT32_TO_STREAM(p, HEADSET_CONTROL_HCI_BAUD_MAX);
+    UINT16_TO_STREAM(p, HEADSET_CONTROL_MIC_DATA_BUFFER_LEN);
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_CAPABILITIES, event, sizeof(event));
 }
 
 /*
@@ -827,6 +1396,9 @@ static void headset_control_proc_rx_cmd_button(uint8_t *p_data, uint32_t length)
     STREAM_TO_UINT8(button_event, p_data);
     STREAM_TO_UINT8(button_state, p_data);
 
+    /* A button event is followed by AVRCP/HFP commands, leave sniff now. */
+    headset_sniff_activity();
+
     /* Process this button event. */
     bt_hs_spk_button_event_emulator((platform_button_t)button_id,
                                     (button_manager_event_t)button_event,
@@ -862,6 +1434,52 @@ static void headset_control_proc_rx_cmd(uint16_t op_code, uint8_t *p_data, uint3
         headset_control_proc_rx_cmd_button(p_data, data_len);
         break;
 
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_WIFI_CHANNELS:
+        headset_afh_wifi_channels_set(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_CLASSIFICATION:
+        headset_afh_classification_enable(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_BLOCKLIST:
+        headset_afh_blocklist_send(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_AVRC_INFO:
+        headset_avrc_info_send(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_WARM_RESTART:
+        headset_control_warm_restart(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_CAPABILITIES:
+        headset_control_capabilities_send(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_STATS:
+        headset_stats_send(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_TIMELINE:
+        headset_timeline_send(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_TUNING:
+        headset_tuning_send(p_data, data_len);
+        break;
+
+#ifdef FASTPAIR_ENABLE
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_FASTPAIR_PROFILE:
+        headset_fastpair_profile_send(p_data, data_len);
+        break;
+
+    case HCI_CONTROL_HCI_AUDIO_COMMAND_P256_BENCH:
+        headset_fastpair_bench(p_data, data_len);
+        break;
+#endif
+
     default:
         break;
     }
@@ -926,6 +1544,41 @@ static void headset_control_mic_data_reset(void)
     headset_control_mic_data.index_end   = 0;
 }
 
+/*
+ * headset_control_mic_stats_get
+ */
+void headset_control_mic_stats_get(headset_control_mic_stats_t *p_stats)
+{
+    /* The mutex is created once the Bluetooth stack is up. */
+    if (!headset_control_mic_data.p_mutex)
+    {
+        memset((void *)p_stats, 0, sizeof(headset_control_mic_stats_t));
+        return;
+    }
+
+    wiced_rtos_lock_mutex(headset_control_mic_data.p_mutex);
+
+    memcpy((void *)p_stats, (void *)&headset_control_mic_stats, sizeof(headset_control_mic_stats_t));
+    p_stats->fill = (uint16_t)headset_control_mic_data.data_len;
+
+    wiced_rtos_unlock_mutex(headset_control_mic_data.p_mutex);
+}
+
+/*
+ * headset_control_mic_data_reset_work
+ *
+ * Reset the MIC data buffer after the SCO link is released (executed in the
+ * application thread, serialized with the MIC data producer).
+ */
+static void headset_control_mic_data_reset_work(uint8_t *p_data, uint16_t len)
+{
+    wiced_rtos_lock_mutex(headset_control_mic_data.p_mutex);
+
+    headset_control_mic_data_reset();
+
+    wiced_rtos_unlock_mutex(headset_control_mic_data.p_mutex);
+}
+
 /*
  * headset_control_mic_data_add
  */
@@ -939,6 +1592,8 @@ static void headset_control_mic_data_add(uint8_t *p_data, uint16_t len)
     /* Check available buffer length. */
     if (headset_control_mic_data.data_len == HEADSET_CONTROL_MIC_DATA_BUFFER_LEN)
     {
+        headset_control_mic_stats.overflow += len;
+
         /* Unlock */
         wiced_rtos_unlock_mutex(headset_control_mic_data.p_mutex);
         return;
@@ -975,6 +1630,13 @@ static void headset_control_mic_data_add(uint8_t *p_data, uint16_t len)
     /* Update information. */
     headset_control_mic_data.data_len += data_to_be_fill;
 
+    headset_control_mic_stats.bytes_in += data_to_be_fill;
+    headset_control_mic_stats.overflow += len - data_to_be_fill;
+    if (headset_control_mic_data.data_len > headset_control_mic_stats.fill_max)
+    {
+        headset_control_mic_stats.fill_max = (uint16_t)headset_control_mic_data.data_len;
+    }
+
     headset_control_mic_data.index_end += data_to_be_fill;
     if (headset_control_mic_data.index_end >= HEADSET_CONTROL_MIC_DATA_BUFFER_LEN)
     {
@@ -999,6 +1661,8 @@ static wiced_bool_t headset_control_mic_data_add_callback(uint8_t *p_data, uint3
     /* Check available data length. */
     if (headset_control_mic_data.data_len == 0)
     {
+        headset_control_mic_stats.underrun += len;
+
         /* Unlock */
         wiced_rtos_unlock_mutex(headset_control_mic_data.p_mutex);
         return WICED_FALSE;
@@ -1041,6 +1705,9 @@ static wiced_bool_t headset_control_mic_data_add_callback(uint8_t *p_data, uint3
     /* Update information. */
     headset_control_mic_data.data_len -= data_to_be_fill;
 
+    headset_control_mic_stats.bytes_out += data_to_be_fill;
+    headset_control_mic_stats.underrun  += len - data_to_be_fill;
+
     headset_control_mic_data.index_start += data_to_be_fill;
     if (headset_control_mic_data.index_start >= HEADSET_CONTROL_MIC_DATA_BUFFER_LEN)
     {
@@ -1052,7 +1719,25 @@ static wiced_bool_t headset_control_mic_data_add_callback(uint8_t *p_data, uint3
     return WICED_TRUE;
 }
 
-#if defined(CYW20706A2)
+/*
+ * headset_control_conn_status_change_callback
+ *
+ * ACL link status change reported by the bt_hs_spk library.
+ */
+static void headset_control_conn_status_change_callback(wiced_bt_device_address_t bd_addr, uint8_t *p_features, wiced_bool_t is_connected, uint16_t handle, wiced_bt_transport_t transport, uint8_t reason)
+{
+    /* LE links are published from the GATT connection status. */
+    if (transport != BT_TRANSPORT_BR_EDR)
+    {
+        return;
+    }
+
+    headset_event_publish(is_connected ? HEADSET_EVENT_BREDR_CONNECTED : HEADSET_EVENT_BREDR_DISCONNECTED,
+                          bd_addr,
+                          handle,
+                          reason);
+}
+
 /*
  * A2DP event post-handler
  */
@@ -1060,8 +1745,26 @@ static void headset_control_a2dp_sink_event_post_handler(wiced_bt_a2dp_sink_even
 {
     switch (event)
     {
+    case WICED_BT_A2DP_SINK_CONNECT_EVT:
+        if (p_data->connect.result == WICED_SUCCESS)
+        {
+            headset_event_publish(HEADSET_EVENT_A2DP_CONNECTED,
+                                  p_data->connect.bd_addr,
+                                  p_data->connect.handle,
+                                  0);
+        }
+        break;
+
+    case WICED_BT_A2DP_SINK_DISCONNECT_EVT:
+        headset_event_publish(HEADSET_EVENT_A2DP_DISCONNECTED,
+                              p_data->disconnect.bd_addr,
+                              p_data->disconnect.handle,
+                              (uint8_t)p_data->disconnect.result);
+        break;
+
     case WICED_BT_A2DP_SINK_START_IND_EVT:
     case WICED_BT_A2DP_SINK_START_CFM_EVT:
+#if defined(CYW20706A2)
         if (bt_hs_spk_audio_is_a2dp_streaming_started())
         {
             if (!wiced_update_cpu_clock(WICED_TRUE, WICED_CPU_CLK_96MHZ))
@@ -1069,9 +1772,16 @@ static void headset_control_a2dp_sink_event_post_handler(wiced_bt_a2dp_sink_even
                 WICED_BT_TRACE("Err: faile to update cpu clk\n");
             }
         }
+#endif // defined(CYW20706A2)
+
+        headset_event_publish(HEADSET_EVENT_A2DP_STREAM_STARTED,
+                              NULL,
+                              event == WICED_BT_A2DP_SINK_START_IND_EVT ? p_data->start_ind.handle : p_data->start_cfm.handle,
+                              0);
         break;
 
     case WICED_BT_A2DP_SINK_SUSPEND_EVT:
+#if defined(CYW20706A2)
         if (!bt_hs_spk_audio_is_a2dp_streaming_started())
         {
             if (!wiced_update_cpu_clock(WICED_FALSE, WICED_CPU_CLK_96MHZ))
@@ -1079,10 +1789,52 @@ static void headset_control_a2dp_sink_event_post_handler(wiced_bt_a2dp_sink_even
                 WICED_BT_TRACE("Err: faile to update cpu clk\n");
             }
         }
+#endif // defined(CYW20706A2)
+
+        headset_event_publish(HEADSET_EVENT_A2DP_STREAM_SUSPENDED,
+                              NULL,
+                              p_data->suspend.handle,
+                              (uint8_t)p_data->suspend.result);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * HFP event post-handler
+ */
+static void headset_control_hfp_event_post_handler(wiced_bt_hfp_hf_event_t event, wiced_bt_hfp_hf_event_data_t *p_data)
+{
+    switch (event)
+    {
+    case WICED_BT_HFP_HF_CONNECTION_STATE_EVT:
+        if (p_data->conn_data.conn_state == WICED_BT_HFP_HF_STATE_SLC_CONNECTED)
+        {
+            headset_event_publish(HEADSET_EVENT_HFP_CONNECTED,
+                                  p_data->conn_data.remote_address,
+                                  p_data->handle,
+                                  0);
+        }
+        else if (p_data->conn_data.conn_state == WICED_BT_HFP_HF_STATE_DISCONNECTED)
+        {
+            headset_event_publish(HEADSET_EVENT_HFP_DISCONNECTED,
+                                  p_data->conn_data.remote_address,
+                                  p_data->handle,
+                                  0);
+        }
+        break;
+
+    case WICED_BT_HFP_HF_CALL_SETUP_EVT:
+        headset_event_publish(HEADSET_EVENT_HFP_CALL_STATE,
+                              NULL,
+                              p_data->handle,
+                              ((p_data->call_data.active_call_present) ||
+                               (p_data->call_data.setup_state != WICED_BT_HFP_HF_CALLSETUP_STATE_IDLE)) ? WICED_TRUE : WICED_FALSE);
         break;
 
     default:
         break;
     }
 }
-#endif // defined(CYW20706A2)
@@ -41,6 +41,7 @@
 
 #include "wiced_app.h"
 #include "wiced_result.h"
+#include "hci_control_api.h"
 
 /*****************************************************************************
 **  Constants that define the capabilities and configuration
@@ -52,6 +53,68 @@
 #define TRANS_UART_BUFFER_SIZE          1024
 #endif
 
+/*****************************************************************************
+**  Application specific commands and events (HCI_CONTROL_GROUP_HCI_AUDIO)
+*****************************************************************************/
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_WIFI_CHANNELS     ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x40)    /* Wi-Fi channels in use */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_CLASSIFICATION    ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x41)    /* Enable/disable host channel classification */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_AFH_BLOCKLIST         ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x42)    /* Read the host channel blocklist */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_AVRC_INFO             ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x43)    /* Read the AVRCP play status and metadata */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_WARM_RESTART          ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x44)    /* Restart the Bluetooth stack in place */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_CAPABILITIES          ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x45)    /* Read the device capabilities */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_STATS                 ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x46)    /* Read the statistics snapshot */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_FASTPAIR_PROFILE      ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x47)    /* Read the Fast Pair crypto timings */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_P256_BENCH            ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x48)    /* Benchmark the P-256 implementations */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_TIMELINE              ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x49)    /* Read the pairing and connection timelines */
+#define HCI_CONTROL_HCI_AUDIO_COMMAND_TUNING                ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x4A)    /* Get, set or commit the tuning store */
+
+#define HCI_CONTROL_HCI_AUDIO_EVENT_AFH_BLOCKLIST           ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x40)    /* Host channel blocklist */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_AVRC_INFO               ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x41)    /* AVRCP play status and metadata */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_WARM_RESTART            ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x42)    /* Warm restart result */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_CAPABILITIES            ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x43)    /* Device capabilities */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_STATS                   ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x44)    /* Statistics snapshot */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_FASTPAIR_PROFILE        ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x45)    /* Fast Pair crypto timings */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_P256_BENCH              ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x46)    /* P-256 benchmark result */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_TIMELINE                ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x47)    /* Pairing and connection timelines */
+#define HCI_CONTROL_HCI_AUDIO_EVENT_TUNING                  ((HCI_CONTROL_GROUP_HCI_AUDIO << 8) | 0x48)    /* Tuning store command response */
+
+/* Capabilities reported in HCI_CONTROL_HCI_AUDIO_EVENT_CAPABILITIES */
+#define HEADSET_CONTROL_CAPS_VERSION                        1
+#define HEADSET_CONTROL_CAPS_AUDIO_SN_HEADER                0x00000001  /* audio data preceded by type and serial number */
+#define HEADSET_CONTROL_CAPS_AUDIO_AGGREGATION              0x00000002  /* reserved, several audio frames per event */
+#define HEADSET_CONTROL_CAPS_AUDIO_COMPRESSION              0x00000004  /* reserved, compressed audio data */
+#define HEADSET_CONTROL_CAPS_FLOW_CREDITS                   0x00000008  /* reserved, credit based MIC data flow control */
+#define HEADSET_CONTROL_CAPS_STATS                          0x00000010  /* statistics commands */
+#define HEADSET_CONTROL_CAPS_WARM_RESTART                   0x00000020
+#define HEADSET_CONTROL_CAPS_AVRC_INFO                      0x00000040
+#define HEADSET_CONTROL_CAPS_AFH                            0x00000080
+#define HEADSET_CONTROL_CAPS_FASTPAIR_PROFILE               0x00000100  /* Fast Pair timings and P-256 benchmark */
+#define HEADSET_CONTROL_CAPS_TIMELINE                       0x00000200  /* pairing and connection timelines */
+#define HEADSET_CONTROL_CAPS_TUNING                         0x00000400  /* runtime tuning store */
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+/* Duration of the Bluetooth management callback. */
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_us;
+    uint8_t  max_event;     /* event which took max_us (BTM_ENABLED_EVT excluded) */
+    uint64_t total_us;
+} headset_control_mgmt_cb_stats_t;
+
+/* MIC data ring filled from the host and drained by the SCO path. */
+typedef struct
+{
+    uint16_t fill;              /* bytes currently buffered */
+    uint16_t fill_max;
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+    uint32_t overflow;          /* bytes dropped, ring full */
+    uint32_t underrun;          /* bytes zero filled, ring empty */
+} headset_control_mic_stats_t;
+
 /*****************************************************************************
 **  Function prototypes
 *****************************************************************************/
@@ -59,5 +122,7 @@
 void     btheadset_control_init( void );
 wiced_result_t btheadset_post_bt_init(void);
 wiced_result_t btheadset_init_button_interface(void);
+void     headset_control_mgmt_cb_stats_get(headset_control_mgmt_cb_stats_t *p_stats);
+void     headset_control_mic_stats_get(headset_control_mic_stats_t *p_stats);
 
 #endif /* BTA_HS_INT_H */
@@ -52,6 +52,13 @@
 #include "wiced_app_cfg.h"
 #include "headset_nvram.h"
 #include "headset_control_le.h"
+#include "headset_event.h"
+#include "headset_avrc.h"
+#include "headset_gatt.h"
+#include "headset_le_coc.h"
+#include "headset_timer.h"
+#include "headset_tuning.h"
+#include "headset_work.h"
 #include "wiced_memory.h"
 #ifdef FASTPAIR_ENABLE
 #include "wiced_bt_gfps.h"
@@ -72,6 +79,29 @@
 /* UUID value of the Hello Sensor Characteristic, Configuration */
 #define UUID_HELLO_CHARACTERISTIC_LONG_MSG    0x2a, 0x99, 0x17, 0x5a, 0x3f, 0x4b, 0x8e, 0xb6, 0x91, 0x54, 0x2f, 0x09, 0xb8, 0x02, 0xab, 0x6e
 
+/* UUID value of the Headset application Service */
+#define UUID_HEADSET_APP_SERVICE              0x6b, 0x3c, 0x21, 0x90, 0x5e, 0x0d, 0x4a, 0x8f, 0x9d, 0x52, 0x17, 0xc4, 0x00, 0x01, 0x5a, 0x9e
+/* UUID value of the Headset application Characteristic, AVRCP information */
+#define UUID_HEADSET_APP_CHAR_AVRC_INFO       0x6b, 0x3c, 0x21, 0x90, 0x5e, 0x0d, 0x4a, 0x8f, 0x9d, 0x52, 0x17, 0xc4, 0x01, 0x01, 0x5a, 0x9e
+/* UUID value of the Headset application Characteristic, GATT sink of the LE CoC benchmark */
+#define UUID_HEADSET_APP_CHAR_GATT_SINK       0x6b, 0x3c, 0x21, 0x90, 0x5e, 0x0d, 0x4a, 0x8f, 0x9d, 0x52, 0x17, 0xc4, 0x02, 0x01, 0x5a, 0x9e
+/* UUID value of the Headset application Characteristic, runtime tuning store */
+#define UUID_HEADSET_APP_CHAR_TUNING          0x6b, 0x3c, 0x21, 0x90, 0x5e, 0x0d, 0x4a, 0x8f, 0x9d, 0x52, 0x17, 0xc4, 0x03, 0x01, 0x5a, 0x9e
+
+#ifndef GATT_UUID_CLIENT_SUP_FEAT
+#define GATT_UUID_CLIENT_SUP_FEAT             0x2B29
+#endif
+#ifndef GATT_UUID_SERVER_SUP_FEAT
+#define GATT_UUID_SERVER_SUP_FEAT             0x2B3A
+#endif
+
+/* Characteristics which can be notified, index of their configuration bit in headset_gatt. */
+enum
+{
+    HCI_CONTROL_LE_NOTIFY_AVRC_INFO,
+    HCI_CONTROL_LE_NOTIFY_MAX,
+};
+
 #ifdef FASTPAIR_ENABLE
 /* MODEL-specific definitions */
 #if defined(CYW20721B2) || BTSTACK_VER >= 0x03000001
@@ -135,6 +165,22 @@ const uint8_t gatt_server_db[] =
     PRIMARY_SERVICE_UUID16(HANDLE_HSENS_GATT_SERVICE,
                            UUID_SERVICE_GATT),
 
+#if BTSTACK_VER >= 0x03000001
+    /* Server Supported Features: EATT */
+    CHARACTERISTIC_UUID16(HANDLE_HSENS_GATT_SERVICE_CHAR_SERVER_FEATURES,
+                          HANDLE_HSENS_GATT_SERVICE_CHAR_SERVER_FEATURES_VAL,
+                          GATT_UUID_SERVER_SUP_FEAT,
+                          GATTDB_CHAR_PROP_READ,
+                          GATTDB_PERM_READABLE),
+
+    /* Client Supported Features: EATT */
+    CHARACTERISTIC_UUID16_WRITABLE(HANDLE_HSENS_GATT_SERVICE_CHAR_CLIENT_FEATURES,
+                                   HANDLE_HSENS_GATT_SERVICE_CHAR_CLIENT_FEATURES_VAL,
+                                   GATT_UUID_CLIENT_SUP_FEAT,
+                                   GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE,
+                                   GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+#endif
+
     /* Declare mandatory GAP service. Device Name and Appearance are mandatory
      * characteristics of GAP service */
     PRIMARY_SERVICE_UUID16(HANDLE_HSENS_GAP_SERVICE,
@@ -225,6 +271,37 @@ const uint8_t gatt_server_db[] =
                                     UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
                                     GATTDB_PERM_AUTH_READABLE | GATTDB_PERM_WRITE_REQ),
 #endif /* ifdef FASTPAIR_ENABLE */
+
+    /* Declare the application service */
+    PRIMARY_SERVICE_UUID128(HANDLE_HEADSET_APP_SERVICE,
+                            UUID_HEADSET_APP_SERVICE),
+
+    /* AVRCP play status and metadata of the current track (see headset_avrc.h) */
+    CHARACTERISTIC_UUID128(HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO,
+                           HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_VAL,
+                           UUID_HEADSET_APP_CHAR_AVRC_INFO,
+                           GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_NOTIFY,
+                           GATTDB_PERM_READABLE),
+
+    CHAR_DESCRIPTOR_UUID16_WRITABLE(HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_CFG_DESC,
+                                    UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                                    GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+
+#ifdef HEADSET_LE_COC
+    /* Write without response counterpart of the LE CoC benchmark (see headset_le_coc.h) */
+    CHARACTERISTIC_UUID128_WRITABLE(HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK,
+                                    HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL,
+                                    UUID_HEADSET_APP_CHAR_GATT_SINK,
+                                    GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE_NO_RESPONSE,
+                                    GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_CMD | GATTDB_PERM_VARIABLE_LENGTH),
+#endif
+
+    /* Tuning command, the response is read back (see headset_tuning.h) */
+    CHARACTERISTIC_UUID128_WRITABLE(HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING,
+                                    HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING_VAL,
+                                    UUID_HEADSET_APP_CHAR_TUNING,
+                                    GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE,
+                                    GATTDB_PERM_AUTH_READABLE | GATTDB_PERM_WRITE_REQ | GATTDB_PERM_AUTH_WRITABLE | GATTDB_PERM_VARIABLE_LENGTH),
 };
 
 typedef struct
@@ -242,6 +319,30 @@ char    btheadset_sensor_char_model_num_value[] = { '1', '2', '3', '4', 0, 0, 0,
 uint8_t btheadset_sensor_char_system_id_value[] = { 0xbb, 0xb8, 0xa1, 0x80, 0x5f, 0x9f, 0x91, 0x71 };
 
 static uint8_t btheadset_battery_level;
+static uint8_t headset_control_le_avrc_info[HEADSET_AVRC_INFO_LEN_MAX];
+#ifdef HEADSET_LE_COC
+static uint8_t headset_control_le_gatt_sink[HEADSET_LE_COC_GATT_SINK_LEN];
+#endif
+
+/* Per link values, refreshed for the link of each request. */
+#if defined(HEADSET_EATT) && (BTSTACK_VER >= 0x03000001)
+static uint8_t headset_control_le_server_features = HEADSET_GATT_SERVER_FEATURE_EATT;
+#else
+static uint8_t headset_control_le_server_features = 0;
+#endif
+static uint8_t headset_control_le_client_features;
+static uint8_t headset_control_le_avrc_info_cccd[2];
+static uint8_t headset_control_le_tuning[HEADSET_TUNING_RSP_LEN_MAX];
+static uint16_t headset_control_le_tuning_len;
+
+/* Notifiable characteristics, in HCI_CONTROL_LE_NOTIFY_xxx order. */
+static const uint16_t headset_control_le_notify_handle[HCI_CONTROL_LE_NOTIFY_MAX] =
+{
+    HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_VAL,
+};
+
+static uint32_t     headset_control_le_notify_pending;
+static wiced_bool_t headset_control_le_notify_posted;
 
 static char *p_headset_control_le_dev_name = NULL;
 static wiced_bt_ble_advert_elem_t headset_control_le_adv_elem = { 0 };
@@ -253,6 +354,14 @@ attribute_t gauAttributes[] =
     { HANDLE_HSENS_DEV_INFO_SERVICE_CHAR_MODEL_NUM_VAL, sizeof(btheadset_sensor_char_model_num_value), btheadset_sensor_char_model_num_value },
     { HANDLE_HSENS_DEV_INFO_SERVICE_CHAR_SYSTEM_ID_VAL, sizeof(btheadset_sensor_char_system_id_value), btheadset_sensor_char_system_id_value },
     { HANDLE_HSENS_BATTERY_SERVICE_CHAR_LEVEL_VAL,      1,                                             &btheadset_battery_level              },
+    { HANDLE_HSENS_GATT_SERVICE_CHAR_SERVER_FEATURES_VAL, 1,                                           &headset_control_le_server_features   },
+    { HANDLE_HSENS_GATT_SERVICE_CHAR_CLIENT_FEATURES_VAL, 1,                                           &headset_control_le_client_features   },
+    { HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_VAL,    0,                                             headset_control_le_avrc_info          },
+    { HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_CFG_DESC, sizeof(headset_control_le_avrc_info_cccd),   headset_control_le_avrc_info_cccd     },
+#ifdef HEADSET_LE_COC
+    { HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL,    0,                                             headset_control_le_gatt_sink          },
+#endif
+    { HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING_VAL,       0,                                             headset_control_le_tuning             },
 };
 
 #if BTSTACK_VER >= 0x03000001
@@ -274,6 +383,8 @@ static void headset_control_le_discoverabilty_change_callback(wiced_bool_t disco
 #ifdef FASTPAIR_ENABLE
     wiced_bt_gfps_provider_discoverablility_set(discoverable);
 #endif
+
+    headset_event_publish(HEADSET_EVENT_LE_DISCOVERABILITY, NULL, 0, discoverable);
 }
 
 /*
@@ -304,6 +415,10 @@ void hci_control_le_enable(void)
 
     WICED_BT_TRACE("wiced_bt_gatt_db_init %d\n", gatt_status);
 
+    headset_gatt_init();
+    headset_control_le_notify_pending = 0;
+    headset_control_le_notify_posted  = WICED_FALSE;
+
 #ifdef FASTPAIR_ENABLE
     // set Tx power level data type in LE advertisement
 #if defined(CYW20719B2) || defined(CYW20721B2) || defined(CYW20819A1) || defined (CYW20820A1)
@@ -393,6 +508,22 @@ void hci_control_le_enable(void)
     bt_hs_spk_ble_discoverability_change_callback_register(&headset_control_le_discoverabilty_change_callback);
 }
 
+/*
+ * Disable LE Control
+ *
+ * Release the LE resources before the Bluetooth stack is restarted.
+ */
+void hci_control_le_disable(void)
+{
+    if (p_headset_control_le_dev_name)
+    {
+        wiced_memory_free((void *)p_headset_control_le_dev_name);
+        p_headset_control_le_dev_name = NULL;
+    }
+
+    memset((void *)&headset_control_le_adv_elem, 0, sizeof(headset_control_le_adv_elem));
+}
+
 /*
  * Process connection up event
  */
@@ -400,6 +531,10 @@ wiced_result_t hci_control_le_connection_up(wiced_bt_gatt_connection_status_t *p
 {
     WICED_BT_TRACE("le_connection_up, id:%d bd (%B) role:%d\n:", p_status->conn_id, p_status->bd_addr);
 
+    headset_gatt_link_up(p_status->bd_addr, p_status->conn_id);
+
+    headset_event_publish(HEADSET_EVENT_LE_CONNECTED, p_status->bd_addr, p_status->conn_id, 0);
+
     return (WICED_SUCCESS);
 }
 
@@ -410,6 +545,10 @@ wiced_result_t hci_control_le_connection_down(wiced_bt_gatt_connection_status_t
 {
     WICED_BT_TRACE("le_connection_down id:%x Disc_Reason: %02x\n", p_status->conn_id, p_status->reason);
 
+    headset_gatt_link_down(p_status->conn_id);
+
+    headset_event_publish(HEADSET_EVENT_LE_DISCONNECTED, p_status->bd_addr, p_status->conn_id, (uint8_t)p_status->reason);
+
     return (WICED_SUCCESS);
 }
 
@@ -428,6 +567,63 @@ wiced_result_t hci_control_le_conn_status_callback(wiced_bt_gatt_connection_stat
     }
 }
 
+/*
+ * hci_control_le_link_values_refresh
+ *
+ * Load the values kept per link by headset_gatt for the link of a request.
+ */
+static void hci_control_le_link_values_refresh(uint16_t conn_id)
+{
+    headset_control_le_client_features = headset_gatt_client_features_get(conn_id);
+
+    headset_control_le_avrc_info_cccd[0] = headset_gatt_cccd_get(conn_id, HCI_CONTROL_LE_NOTIFY_AVRC_INFO) ?
+                                           GATT_CLIENT_CONFIG_NOTIFICATION : 0;
+    headset_control_le_avrc_info_cccd[1] = 0;
+
+    headset_control_le_tuning_len = headset_tuning_le_read(conn_id, headset_control_le_tuning,
+                                                           sizeof(headset_control_le_tuning));
+}
+
+/*
+ * hci_control_le_link_value_write
+ *
+ * Store a value written by the peer which is kept per link.
+ */
+static void hci_control_le_link_value_write(uint16_t conn_id, uint16_t handle, uint8_t *p_val, uint16_t val_len)
+{
+    switch (handle)
+    {
+    case HANDLE_HSENS_GATT_SERVICE_CHAR_CLIENT_FEATURES_VAL:
+        if (val_len >= 1)
+        {
+            headset_gatt_client_features_set(conn_id, p_val[0]);
+        }
+        break;
+
+    case HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_CFG_DESC:
+        if (val_len >= 2)
+        {
+            headset_gatt_cccd_set(conn_id,
+                                  HCI_CONTROL_LE_NOTIFY_AVRC_INFO,
+                                  (p_val[0] & GATT_CLIENT_CONFIG_NOTIFICATION) ? WICED_TRUE : WICED_FALSE);
+        }
+        break;
+
+#ifdef HEADSET_LE_COC
+    case HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL:
+        headset_le_coc_gatt_sink_write(val_len);
+        break;
+#endif
+
+    case HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING_VAL:
+        headset_tuning_le_write(conn_id, p_val, val_len);
+        break;
+
+    default:
+        break;
+    }
+}
+
 /*
  * Find attribute description by handle
  */
@@ -438,6 +634,26 @@ attribute_t *hci_control_get_attribute(uint16_t handle)
     {
         if (gauAttributes[i].handle == handle)
         {
+            /* The AVRCP information is the value built at the last change. */
+            if (handle == HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_VAL)
+            {
+                gauAttributes[i].attr_len = headset_avrc_info_get(headset_control_le_avrc_info,
+                                                                  sizeof(headset_control_le_avrc_info));
+            }
+#ifdef HEADSET_LE_COC
+            /* Reading the GATT sink ends a benchmark run and starts the next. */
+            if (handle == HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL)
+            {
+                gauAttributes[i].attr_len = headset_le_coc_gatt_sink_read(headset_control_le_gatt_sink,
+                                                                          sizeof(headset_control_le_gatt_sink));
+            }
+#endif
+            /* The tuning characteristic reads the response of the last write
+             * of the link, refreshed with the other per link values. */
+            if (handle == HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING_VAL)
+            {
+                gauAttributes[i].attr_len = headset_control_le_tuning_len;
+            }
             return (&gauAttributes[i]);
         }
     }
@@ -668,6 +884,8 @@ wiced_bt_gatt_status_t hci_control_le_write_handler(uint16_t conn_id,
     WICED_BT_TRACE("[%s] conn_id:%d handle:%04x\n", __FUNCTION__, conn_id,
                    p_data->handle);
 
+    hci_control_le_link_value_write(conn_id, p_data->handle, p_data->p_val, p_data->val_len);
+
     return WICED_BT_GATT_SUCCESS;
 }
 
@@ -679,6 +897,9 @@ wiced_bt_gatt_status_t hci_control_le_mtu_handler(uint16_t conn_id, uint16_t mtu
     WICED_BT_TRACE("req_mtu: %d\n", mtu);
     wiced_bt_gatt_server_send_mtu_rsp(conn_id, mtu,
                                       wiced_bt_cfg_settings.p_ble_cfg->ble_max_rx_pdu_size);
+
+    /* MTU of the fixed ATT bearer, each EATT bearer has its own. */
+    headset_gatt_mtu_set(conn_id, MIN(mtu, wiced_bt_cfg_settings.p_ble_cfg->ble_max_rx_pdu_size));
     return WICED_BT_GATT_SUCCESS;
 }
 
@@ -768,6 +989,8 @@ wiced_result_t hci_control_le_write_handler(uint16_t conn_id, wiced_bt_gatt_writ
 {
     WICED_BT_TRACE("hci_control_le_write_handler: conn_id:%d handle:%04x\n", conn_id, p_req->handle);
 
+    hci_control_le_link_value_write(conn_id, p_req->handle, p_req->p_val, p_req->val_len);
+
     return (WICED_BT_GATT_SUCCESS);
 }
 
@@ -783,12 +1006,64 @@ wiced_result_t hci_control_le_conf_handler(uint16_t conn_id, uint16_t handle)
 
 #endif /* BTSTACK_VER */
 
+#ifdef HEADSET_LE_COC
+/*
+ * hci_control_le_gatt_sink_write
+ *
+ * Count a write to the GATT sink characteristic. The benchmark compares the
+ * ATT data path with the LE CoC one, so these writes skip the trace and the
+ * request timing of the other requests. Return WICED_FALSE for any other
+ * request.
+ */
+static wiced_bool_t hci_control_le_gatt_sink_write(wiced_bt_gatt_attribute_request_t *p_req)
+{
+#if BTSTACK_VER >= 0x03000001
+    if (((p_req->opcode != GATT_REQ_WRITE) && (p_req->opcode != GATT_CMD_WRITE)) ||
+        (p_req->data.write_req.handle != HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL))
+    {
+        return WICED_FALSE;
+    }
+
+    headset_le_coc_gatt_sink_write(p_req->data.write_req.val_len);
+
+    if (p_req->opcode == GATT_REQ_WRITE)
+    {
+        wiced_bt_gatt_server_send_write_rsp(p_req->conn_id, p_req->opcode, p_req->data.write_req.handle);
+    }
+#else /* !BTSTACK_VER */
+    if ((p_req->request_type != GATTS_REQ_TYPE_WRITE) ||
+        (p_req->data.write_req.handle != HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL))
+    {
+        return WICED_FALSE;
+    }
+
+    headset_le_coc_gatt_sink_write(p_req->data.write_req.val_len);
+#endif /* BTSTACK_VER */
+
+    return WICED_TRUE;
+}
+#endif /* HEADSET_LE_COC */
+
 /*
  * This is a GATT request callback
  */
 wiced_bt_gatt_status_t hci_control_le_gatt_req_cb(wiced_bt_gatt_attribute_request_t *p_req)
 {
     wiced_bt_gatt_status_t result = WICED_BT_GATT_SUCCESS;
+    uint64_t               start;
+
+#ifdef HEADSET_LE_COC
+    if (hci_control_le_gatt_sink_write(p_req))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+#endif
+
+    start = headset_timer_now_us();
+
+    /* conn_id identifies the bearer (ATT or EATT) the request came on, the
+     * response goes back on the same bearer. */
+    hci_control_le_link_values_refresh(p_req->conn_id);
 
 #if BTSTACK_VER >= 0x03000001
     switch (p_req->opcode)
@@ -869,6 +1144,7 @@ wiced_bt_gatt_status_t hci_control_le_gatt_req_cb(wiced_bt_gatt_attribute_reques
 
     case GATTS_REQ_TYPE_MTU:
         WICED_BT_TRACE("conn_id:%d mtu:%x\n", p_req->conn_id, p_req->data.mtu);
+        headset_gatt_mtu_set(p_req->conn_id, p_req->data.mtu);
         break;
 
     case GATTS_REQ_TYPE_CONF:
@@ -881,6 +1157,8 @@ wiced_bt_gatt_status_t hci_control_le_gatt_req_cb(wiced_bt_gatt_attribute_reques
     }
 #endif /* BTSTACK_VER */
 
+    headset_gatt_request_handled(p_req->conn_id, start);
+
     return result;
 }
 
@@ -942,3 +1220,98 @@ wiced_bt_gatt_status_t hci_control_le_gatt_callback(wiced_bt_gatt_evt_t event, w
 
     return result;
 }
+
+/*
+ * hci_control_le_notify_send
+ *
+ * Send one Handle Value Notification, truncated to the bearer MTU.
+ */
+static void hci_control_le_notify_send(uint16_t bearer, uint16_t mtu, attribute_t *p_attr)
+{
+    uint16_t len = MIN(p_attr->attr_len, mtu - 3);
+
+#if BTSTACK_VER >= 0x03000001
+    wiced_bt_gatt_server_send_notification(bearer, p_attr->handle, len, (uint8_t *)p_attr->p_attr, NULL);
+#else
+    wiced_bt_gatt_send_notification(bearer, p_attr->handle, len, (uint8_t *)p_attr->p_attr);
+#endif
+
+    headset_gatt_notification_sent(bearer);
+}
+
+/*
+ * hci_control_le_notify_link
+ *
+ * Notify the pending characteristics enabled on one link.
+ */
+static void hci_control_le_notify_link(uint16_t conn_id, uint32_t pending)
+{
+    attribute_t *p_attr;
+    uint16_t     bearer = headset_gatt_notify_bearer_get(conn_id);
+    uint16_t     mtu = headset_gatt_mtu_get(bearer);
+    uint8_t      i;
+
+    for (i = 0; i < HCI_CONTROL_LE_NOTIFY_MAX; i++)
+    {
+        if ((pending & (1UL << i)) &&
+            headset_gatt_cccd_get(conn_id, i) &&
+            ((p_attr = hci_control_get_attribute(headset_control_le_notify_handle[i])) != NULL))
+        {
+            hci_control_le_notify_send(bearer, mtu, p_attr);
+        }
+    }
+}
+
+/*
+ * hci_control_le_notify_flush
+ *
+ * Deferred work: notify every characteristic changed since the last flush.
+ */
+static void hci_control_le_notify_flush(uint8_t *p_data, uint16_t len)
+{
+    uint16_t conn_id[HEADSET_GATT_LINK_MAX];
+    uint32_t pending = headset_control_le_notify_pending;
+    uint8_t  num;
+    uint8_t  i;
+
+    headset_control_le_notify_pending = 0;
+    headset_control_le_notify_posted  = WICED_FALSE;
+
+    num = headset_gatt_links_get(conn_id, HEADSET_GATT_LINK_MAX);
+
+    for (i = 0; i < num; i++)
+    {
+        hci_control_le_notify_link(conn_id[i], pending);
+    }
+}
+
+/*
+ * hci_control_le_notify
+ *
+ * The value of a characteristic changed. The notifications are sent later
+ * from the application thread so several changes in a row (e.g. play status,
+ * then track metadata) go out in one batch carrying the latest values.
+ */
+void hci_control_le_notify(uint16_t handle)
+{
+    uint8_t i;
+
+    for (i = 0; i < HCI_CONTROL_LE_NOTIFY_MAX; i++)
+    {
+        if (headset_control_le_notify_handle[i] == handle)
+        {
+            headset_control_le_notify_pending |= (1UL << i);
+            break;
+        }
+    }
+
+    if ((i == HCI_CONTROL_LE_NOTIFY_MAX) || headset_control_le_notify_posted)
+    {
+        return;
+    }
+
+    headset_control_le_notify_posted = headset_work_post(HEADSET_WORK_PRIORITY_NORMAL,
+                                                         &hci_control_le_notify_flush,
+                                                         NULL,
+                                                         0);
+}
@@ -40,6 +40,11 @@
 typedef enum
 {
     HANDLE_HSENS_GATT_SERVICE = 0x1, // service handle
+        HANDLE_HSENS_GATT_SERVICE_CHAR_SERVER_FEATURES, // characteristic handle
+        HANDLE_HSENS_GATT_SERVICE_CHAR_SERVER_FEATURES_VAL, // char value handle
+
+        HANDLE_HSENS_GATT_SERVICE_CHAR_CLIENT_FEATURES, // characteristic handle
+        HANDLE_HSENS_GATT_SERVICE_CHAR_CLIENT_FEATURES_VAL, // char value handle
 
     HANDLE_HSENS_GAP_SERVICE = 0x14, // service handle
         HANDLE_HSENS_GAP_SERVICE_CHAR_DEV_NAME, // characteristic handl
@@ -73,6 +78,15 @@ typedef enum
        HANDLE_FASTPAIR_SERVICE_CHAR_ACCOUNT_KEY_VAL,
        HANDLE_FASTPAIR_SERVICE_CHAR_ACCOUNT_KEY_CFG_DESC,
 
+    HANDLE_HEADSET_APP_SERVICE = 0x90, // service handle
+        HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO, // characteristic handle
+        HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_VAL, // char value handle
+        HANDLE_HEADSET_APP_SERVICE_CHAR_AVRC_INFO_CFG_DESC, // client characteristic configuration
+        HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK, // characteristic handle
+        HANDLE_HEADSET_APP_SERVICE_CHAR_GATT_SINK_VAL, // char value handle
+        HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING, // characteristic handle
+        HANDLE_HEADSET_APP_SERVICE_CHAR_TUNING_VAL, // char value handle
+
        // Client Configuration
        HDLD_CURRENT_TIME_SERVICE_CURRENT_TIME_CLIENT_CONFIGURATION,
 
@@ -80,6 +94,8 @@ typedef enum
 
 
 void hci_control_le_enable( void );
+void hci_control_le_disable( void );
+void hci_control_le_notify( uint16_t handle );
 
 
 #endif /* _HCI_CONTROL_LE_H_ */
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application connection event bus.
+ */
+#include "wiced.h"
+#include "wiced_bt_trace.h"
+#include "headset_event.h"
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint32_t                mask;
+    headset_event_handler_t p_handler;
+} headset_event_subscriber_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_event_subscriber_t headset_event_subscribers[HEADSET_EVENT_SUBSCRIBER_MAX] = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_event_subscribe
+ *
+ * Register a handler for the events set in mask (see HEADSET_EVENT_MASK).
+ * Subscribing an already registered handler replaces its mask.
+ */
+wiced_bool_t headset_event_subscribe(uint32_t mask, headset_event_handler_t p_handler)
+{
+    headset_event_subscriber_t *p_free = NULL;
+    uint8_t                     i;
+
+    if (p_handler == NULL)
+    {
+        return WICED_FALSE;
+    }
+
+    for (i = 0; i < HEADSET_EVENT_SUBSCRIBER_MAX; i++)
+    {
+        if (headset_event_subscribers[i].p_handler == p_handler)
+        {
+            headset_event_subscribers[i].mask = mask;
+            return WICED_TRUE;
+        }
+
+        if ((headset_event_subscribers[i].p_handler == NULL) &&
+            (p_free == NULL))
+        {
+            p_free = &headset_event_subscribers[i];
+        }
+    }
+
+    if (p_free == NULL)
+    {
+        WICED_BT_TRACE("Err: headset_event_subscribe no free entry\n");
+        return WICED_FALSE;
+    }
+
+    p_free->mask      = mask;
+    p_free->p_handler = p_handler;
+
+    return WICED_TRUE;
+}
+
+/*
+ * headset_event_unsubscribe
+ */
+void headset_event_unsubscribe(headset_event_handler_t p_handler)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_EVENT_SUBSCRIBER_MAX; i++)
+    {
+        if (headset_event_subscribers[i].p_handler == p_handler)
+        {
+            headset_event_subscribers[i].mask      = 0;
+            headset_event_subscribers[i].p_handler = NULL;
+        }
+    }
+}
+
+/*
+ * headset_event_publish
+ *
+ * Deliver the event to the matching subscribers. p_bd_addr may be NULL.
+ */
+void headset_event_publish(headset_event_t event, const uint8_t *p_bd_addr, uint16_t handle, uint8_t status)
+{
+    headset_event_data_t data = { 0 };
+    uint32_t             mask;
+    uint8_t              i;
+
+    if (event >= HEADSET_EVENT_MAX)
+    {
+        return;
+    }
+
+    mask = HEADSET_EVENT_MASK(event);
+
+    data.event  = event;
+    data.handle = handle;
+    data.status = status;
+
+    if (p_bd_addr)
+    {
+        memcpy((void *)data.bd_addr, (void *)p_bd_addr, sizeof(wiced_bt_device_address_t));
+    }
+
+    for (i = 0; i < HEADSET_EVENT_SUBSCRIBER_MAX; i++)
+    {
+        if ((headset_event_subscribers[i].p_handler != NULL) &&
+            (headset_event_subscribers[i].mask & mask))
+        {
+            headset_event_subscribers[i].p_handler(&data);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application connection event bus.
+ *
+ * Link state changes (BR/EDR, LE, A2DP, AVRCP, HFP and SCO) are published to every
+ * subscriber whose filter mask includes the event. Fan-out is synchronous, in
+ * the publisher's context, and never allocates memory, so handlers must be short.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_EVENT_SUBSCRIBER_MAX    8
+
+typedef enum
+{
+    HEADSET_EVENT_BREDR_CONNECTED,
+    HEADSET_EVENT_BREDR_DISCONNECTED,
+    HEADSET_EVENT_LE_CONNECTED,
+    HEADSET_EVENT_LE_DISCONNECTED,
+    HEADSET_EVENT_LE_DISCOVERABILITY,   /* status: WICED_TRUE if discoverable */
+    HEADSET_EVENT_A2DP_CONNECTED,
+    HEADSET_EVENT_A2DP_DISCONNECTED,
+    HEADSET_EVENT_A2DP_STREAM_STARTED,
+    HEADSET_EVENT_A2DP_STREAM_SUSPENDED,
+    HEADSET_EVENT_HFP_CONNECTED,        /* service level connection established */
+    HEADSET_EVENT_HFP_DISCONNECTED,
+    HEADSET_EVENT_HFP_CALL_STATE,       /* status: WICED_TRUE if a call is active or being set up */
+    HEADSET_EVENT_SCO_CONNECTED,
+    HEADSET_EVENT_SCO_DISCONNECTED,
+    HEADSET_EVENT_AVRC_CONNECTED,       /* AVRCP controller control channel */
+    HEADSET_EVENT_AVRC_DISCONNECTED,
+    HEADSET_EVENT_MAX,
+} headset_event_t;
+
+#define HEADSET_EVENT_MASK(event)       (1UL << (event))
+#define HEADSET_EVENT_MASK_ALL          (HEADSET_EVENT_MASK(HEADSET_EVENT_MAX) - 1)
+
+#define HEADSET_EVENT_MASK_BREDR        (HEADSET_EVENT_MASK(HEADSET_EVENT_BREDR_CONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_BREDR_DISCONNECTED))
+#define HEADSET_EVENT_MASK_LE           (HEADSET_EVENT_MASK(HEADSET_EVENT_LE_CONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_LE_DISCONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_LE_DISCOVERABILITY))
+#define HEADSET_EVENT_MASK_A2DP         (HEADSET_EVENT_MASK(HEADSET_EVENT_A2DP_CONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_A2DP_DISCONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_A2DP_STREAM_STARTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_A2DP_STREAM_SUSPENDED))
+#define HEADSET_EVENT_MASK_HFP          (HEADSET_EVENT_MASK(HEADSET_EVENT_HFP_CONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_HFP_DISCONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_HFP_CALL_STATE))
+#define HEADSET_EVENT_MASK_SCO          (HEADSET_EVENT_MASK(HEADSET_EVENT_SCO_CONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_SCO_DISCONNECTED))
+#define HEADSET_EVENT_MASK_AVRC         (HEADSET_EVENT_MASK(HEADSET_EVENT_AVRC_CONNECTED) | \
+                                         HEADSET_EVENT_MASK(HEADSET_EVENT_AVRC_DISCONNECTED))
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    headset_event_t           event;
+    wiced_bt_device_address_t bd_addr;     /* all zeros if unknown to the publisher */
+    uint16_t                  handle;      /* ACL handle, GATT conn_id, profile handle or SCO index */
+    uint8_t                   status;      /* disconnection reason, result or event specific value */
+} headset_event_data_t;
+
+typedef void (*headset_event_handler_t)(const headset_event_data_t *p_data);
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+wiced_bool_t headset_event_subscribe(uint32_t mask, headset_event_handler_t p_handler);
+void         headset_event_unsubscribe(headset_event_handler_t p_handler);
+void         headset_event_publish(headset_event_t event, const uint8_t *p_bd_addr, uint16_t handle, uint8_t status);
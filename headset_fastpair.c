@@ -0,0 +1,480 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Fast Pair crypto profiling and P-256 benchmark, see headset_fastpair.h.
+ */
+#ifdef FASTPAIR_ENABLE
+
+#include "wiced.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_hal_rand.h"
+#include "wiced_transport.h"
+#include "p_256_ecc_pp.h"
+#include "headset_control.h"
+#include "headset_control_le.h"
+#include "headset_fastpair.h"
+#include "headset_fastpair_keys.h"
+#include "headset_p256.h"
+#include "headset_timer.h"
+#include "headset_work.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#if defined(HEADSET_FASTPAIR_PROFILE) || defined(HEADSET_P256_FAST)
+/* ECC_PointMult_Bin_NAF is wrapped, reach the ROM through __real. */
+#define HEADSET_FASTPAIR_ECDH_WRAP
+#define HEADSET_FASTPAIR_ROM_POINT_MULT     __real_ECC_PointMult_Bin_NAF
+#else
+#define HEADSET_FASTPAIR_ROM_POINT_MULT     ECC_PointMult_Bin_NAF
+#endif
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint32_t rom_us;
+    uint32_t fast_us;
+} headset_fastpair_bench_time_t;
+
+typedef struct
+{
+#ifdef HEADSET_FASTPAIR_PROFILE
+    wiced_bt_gatt_cback_t        *p_gatt_cb;    /* gfps_provider library callback */
+#endif
+    headset_fastpair_step_stats_t step[HEADSET_FASTPAIR_STEP_MAX];
+
+    /* Benchmark in progress, one iteration per work item */
+    wiced_bool_t                  bench_busy;
+    uint16_t                      bench_iterations;
+    uint16_t                      bench_done;
+    uint16_t                      bench_mismatches;
+    headset_fastpair_bench_time_t bench_base;
+    headset_fastpair_bench_time_t bench_var;
+} headset_fastpair_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_fastpair_cb_t headset_fastpair_cb = { 0 };
+
+#ifdef HEADSET_FASTPAIR_ECDH_WRAP
+extern void __real_ECC_PointMult_Bin_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength);
+#endif
+#ifdef HEADSET_FASTPAIR_PROFILE
+extern wiced_bt_gatt_status_t __real_wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback);
+#endif
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+#ifdef HEADSET_FASTPAIR_ECDH_WRAP
+/*
+ * headset_fastpair_step_update
+ */
+static void headset_fastpair_step_update(headset_fastpair_step_t step, uint64_t start)
+{
+    headset_fastpair_step_stats_t *p_step = &headset_fastpair_cb.step[step];
+    uint32_t                       duration = (uint32_t)(headset_timer_now_us() - start);
+
+    p_step->count++;
+    p_step->last_us   = duration;
+    p_step->total_us += duration;
+
+    if (duration > p_step->max_us)
+    {
+        p_step->max_us = duration;
+    }
+}
+#endif /* HEADSET_FASTPAIR_ECDH_WRAP */
+
+/*
+ * headset_fastpair_point_mult
+ *
+ * q = n * p with headset_p256.c, the generator uses the comb table.
+ */
+static void headset_fastpair_point_mult(Point *q, Point *p, DWORD *n)
+{
+    memset((void *)q->z, 0, sizeof(q->z));
+
+    if (headset_p256_is_base((uint32_t *)p->x, (uint32_t *)p->y))
+    {
+        headset_p256_base_mult((uint32_t *)q->x, (uint32_t *)q->y, (uint32_t *)n);
+    }
+    else
+    {
+        headset_p256_point_mult((uint32_t *)q->x, (uint32_t *)q->y,
+                                (uint32_t *)p->x, (uint32_t *)p->y,
+                                (uint32_t *)n);
+    }
+
+    q->z[0] = 1;
+}
+
+#ifdef HEADSET_FASTPAIR_ECDH_WRAP
+/*
+ * __wrap_ECC_PointMult_Bin_NAF
+ *
+ * ECDH of the gfps_provider library.
+ */
+void __wrap_ECC_PointMult_Bin_NAF(Point *q, Point *p, DWORD *n, uint32_t keyLength)
+{
+    uint64_t start = headset_timer_now_us();
+
+#ifdef HEADSET_P256_FAST
+    if (keyLength == HEADSET_P256_WORDS)
+    {
+        headset_fastpair_point_mult(q, p, n);
+    }
+    else
+#endif
+    {
+        __real_ECC_PointMult_Bin_NAF(q, p, n, keyLength);
+    }
+
+    headset_fastpair_step_update(HEADSET_FASTPAIR_STEP_ECDH, start);
+}
+#endif /* HEADSET_FASTPAIR_ECDH_WRAP */
+
+#ifdef HEADSET_FASTPAIR_PROFILE
+/*
+ * headset_fastpair_gatt_write_step
+ *
+ * Return the step timed for a write request, HEADSET_FASTPAIR_STEP_MAX if none.
+ */
+static headset_fastpair_step_t headset_fastpair_gatt_write_step(wiced_bt_gatt_event_data_t *p_data)
+{
+    uint16_t handle;
+
+#if BTSTACK_VER >= 0x03000001
+    switch (p_data->attribute_request.opcode)
+    {
+    case GATT_REQ_WRITE:
+    case GATT_CMD_WRITE:
+    case GATT_CMD_SIGNED_WRITE:
+        handle = p_data->attribute_request.data.write_req.handle;
+        break;
+
+    default:
+        return HEADSET_FASTPAIR_STEP_MAX;
+    }
+#else
+    if (p_data->attribute_request.request_type != GATTS_REQ_TYPE_WRITE)
+    {
+        return HEADSET_FASTPAIR_STEP_MAX;
+    }
+
+    handle = p_data->attribute_request.data.write_req.handle;
+#endif
+
+    switch (handle)
+    {
+    case HANDLE_FASTPAIR_SERVICE_CHAR_KEY_PAIRING_VAL:
+        return HEADSET_FASTPAIR_STEP_KEY_PAIRING;
+
+    case HANDLE_FASTPAIR_SERVICE_CHAR_PASSKEY_VAL:
+        return HEADSET_FASTPAIR_STEP_PASSKEY;
+
+    case HANDLE_FASTPAIR_SERVICE_CHAR_ACCOUNT_KEY_VAL:
+        return HEADSET_FASTPAIR_STEP_ACCOUNT_KEY;
+
+    default:
+        return HEADSET_FASTPAIR_STEP_MAX;
+    }
+}
+
+/*
+ * headset_fastpair_gatt_cback
+ *
+ * Time the Fast Pair characteristic writes handled by the gfps_provider library.
+ */
+static wiced_bt_gatt_status_t headset_fastpair_gatt_cback(wiced_bt_gatt_evt_t event, wiced_bt_gatt_event_data_t *p_data)
+{
+    headset_fastpair_step_t step = HEADSET_FASTPAIR_STEP_MAX;
+    wiced_bt_gatt_status_t  status;
+    uint64_t                start = headset_timer_now_us();
+
+    if (event == GATT_ATTRIBUTE_REQUEST_EVT)
+    {
+        step = headset_fastpair_gatt_write_step(p_data);
+    }
+
+    status = headset_fastpair_cb.p_gatt_cb(event, p_data);
+
+    if (step != HEADSET_FASTPAIR_STEP_MAX)
+    {
+        headset_fastpair_step_update(step, start);
+    }
+
+    return status;
+}
+
+/*
+ * __wrap_wiced_bt_gatt_register
+ *
+ * The gfps_provider library registers its own GATT callback, interpose on it.
+ */
+wiced_bt_gatt_status_t __wrap_wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback)
+{
+    headset_fastpair_cb.p_gatt_cb = p_gatt_cback;
+
+    return __real_wiced_bt_gatt_register(p_gatt_cback ? headset_fastpair_gatt_cback : NULL);
+}
+#endif /* HEADSET_FASTPAIR_PROFILE */
+
+/*
+ * headset_fastpair_profile_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_FASTPAIR_PROFILE, reply with
+ * HCI_CONTROL_HCI_AUDIO_EVENT_FASTPAIR_PROFILE. A non-zero first byte in the
+ * command clears the statistics after they are sent.
+ *
+ * Byte: |    0    |   1   |   2   | 3 - 18 (x STEP_COUNT)                |
+ * Data: | VERSION | FLAGS | STEPS | COUNT | LAST_US | MAX_US | TOTAL_US |
+ *
+ * followed by the account key store (headset_fastpair_keys.h):
+ * Byte: |    0    | 1 - 2     |   3    | 4 - 7 | 8 - 11       | 12 - 15     |
+ * Data: | KEY_NUM | STORE_LEN | CHUNKS | READS | CHUNK_WRITES | CHUNK_SKIPS |
+ */
+void headset_fastpair_profile_send(uint8_t *p_data, uint32_t data_len)
+{
+    headset_fastpair_keys_stats_t keys;
+    uint8_t                       event[3 + HEADSET_FASTPAIR_STEP_MAX * sizeof(headset_fastpair_step_stats_t) + 16];
+    uint8_t                      *p = event;
+    uint8_t                       flags = 0;
+    int                           i;
+
+#ifdef HEADSET_FASTPAIR_PROFILE
+    flags |= HEADSET_FASTPAIR_PROFILE_FLAG_ENABLED;
+#endif
+#ifdef HEADSET_P256_FAST
+    flags |= HEADSET_FASTPAIR_PROFILE_FLAG_P256_FAST;
+#endif
+
+    UINT8_TO_STREAM(p, HEADSET_FASTPAIR_PROFILE_VERSION);
+    UINT8_TO_STREAM(p, flags);
+    UINT8_TO_STREAM(p, HEADSET_FASTPAIR_STEP_MAX);
+
+    for (i = 0; i < HEADSET_FASTPAIR_STEP_MAX; i++)
+    {
+        UINT32_TO_STREAM(p, headset_fastpair_cb.step[i].count);
+        UINT32_TO_STREAM(p, headset_fastpair_cb.step[i].last_us);
+        UINT32_TO_STREAM(p, headset_fastpair_cb.step[i].max_us);
+        UINT32_TO_STREAM(p, headset_fastpair_cb.step[i].total_us);
+    }
+
+    headset_fastpair_keys_stats_get(&keys);
+
+    UINT8_TO_STREAM(p, FASTPAIR_ACCOUNT_KEY_NUM);
+    UINT16_TO_STREAM(p, keys.store_len);
+    UINT8_TO_STREAM(p, keys.chunks);
+    UINT32_TO_STREAM(p, keys.reads);
+    UINT32_TO_STREAM(p, keys.chunk_writes);
+    UINT32_TO_STREAM(p, keys.chunk_skips);
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_FASTPAIR_PROFILE, event, sizeof(event));
+
+    if ((data_len >= 1) && p_data[0])
+    {
+        memset((void *)headset_fastpair_cb.step, 0, sizeof(headset_fastpair_cb.step));
+    }
+}
+
+/*
+ * headset_fastpair_bench_run
+ *
+ * Time q = k * p with the ROM and with headset_p256.c, compare the results.
+ */
+static wiced_bool_t headset_fastpair_bench_run(Point *q, Point *p, DWORD *k, headset_fastpair_bench_time_t *p_time)
+{
+    Point    q_fast;
+    uint64_t start;
+
+    start = headset_timer_now_us();
+    HEADSET_FASTPAIR_ROM_POINT_MULT(q, p, k, HEADSET_P256_WORDS);
+    p_time->rom_us += (uint32_t)(headset_timer_now_us() - start);
+
+    start = headset_timer_now_us();
+    headset_fastpair_point_mult(&q_fast, p, k);
+    p_time->fast_us += (uint32_t)(headset_timer_now_us() - start);
+
+    return ((memcmp((void *)q->x, (void *)q_fast.x, sizeof(q->x)) == 0) &&
+            (memcmp((void *)q->y, (void *)q_fast.y, sizeof(q->y)) == 0)) ? WICED_TRUE : WICED_FALSE;
+}
+
+/*
+ * headset_fastpair_bench_send
+ *
+ * Send the averages of the iterations done.
+ *
+ * Event:
+ * Byte: | 0 - 1      | 2 - 5       | 6 - 9        | 10 - 13    | 14 - 17     | 18 - 19    | 20     |
+ * Data: | ITERATIONS | ROM_BASE_US | FAST_BASE_US | ROM_VAR_US | FAST_VAR_US | MISMATCHES | STATUS |
+ */
+static void headset_fastpair_bench_send(uint8_t status)
+{
+    uint16_t done = headset_fastpair_cb.bench_done;
+    uint8_t  event[2 + 4 * sizeof(uint32_t) + 2 + 1];
+    uint8_t *p = event;
+
+    UINT16_TO_STREAM(p, done);
+    UINT32_TO_STREAM(p, done ? headset_fastpair_cb.bench_base.rom_us / done : 0);
+    UINT32_TO_STREAM(p, done ? headset_fastpair_cb.bench_base.fast_us / done : 0);
+    UINT32_TO_STREAM(p, done ? headset_fastpair_cb.bench_var.rom_us / done : 0);
+    UINT32_TO_STREAM(p, done ? headset_fastpair_cb.bench_var.fast_us / done : 0);
+    UINT16_TO_STREAM(p, headset_fastpair_cb.bench_mismatches);
+    UINT8_TO_STREAM(p, status);
+
+    WICED_BT_TRACE("P-256 bench %d: base rom %d fast %d us, var rom %d fast %d us, mismatches %d, status %d\n",
+                   done,
+                   done ? headset_fastpair_cb.bench_base.rom_us / done : 0,
+                   done ? headset_fastpair_cb.bench_base.fast_us / done : 0,
+                   done ? headset_fastpair_cb.bench_var.rom_us / done : 0,
+                   done ? headset_fastpair_cb.bench_var.fast_us / done : 0,
+                   headset_fastpair_cb.bench_mismatches,
+                   status);
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_P256_BENCH, event, sizeof(event));
+}
+
+/*
+ * headset_fastpair_bench_work
+ *
+ * One iteration computes a random public key (fixed base) and a shared
+ * secret with it (variable base), as the key-based pairing does. Each
+ * iteration is a background work item of its own, the other work runs in
+ * between.
+ */
+static void headset_fastpair_bench_work(uint8_t *p_data, uint16_t len)
+{
+    uint32_t k[HEADSET_P256_WORDS];
+    Point    g;
+    Point    pub;
+    Point    secret;
+
+    memset((void *)&g, 0, sizeof(g));
+    memcpy((void *)g.x, (void *)curve_p256.G.x, sizeof(g.x));
+    memcpy((void *)g.y, (void *)curve_p256.G.y, sizeof(g.y));
+    g.z[0] = 1;
+
+    /* Clear the top bit to stay below the group order. */
+    wiced_hal_rand_gen_num_array(k, HEADSET_P256_WORDS);
+    k[HEADSET_P256_WORDS - 1] &= 0x7fffffff;
+
+    if (!headset_fastpair_bench_run(&pub, &g, (DWORD *)k, &headset_fastpair_cb.bench_base))
+    {
+        headset_fastpair_cb.bench_mismatches++;
+    }
+
+    wiced_hal_rand_gen_num_array(k, HEADSET_P256_WORDS);
+    k[HEADSET_P256_WORDS - 1] &= 0x7fffffff;
+
+    if (!headset_fastpair_bench_run(&secret, &pub, (DWORD *)k, &headset_fastpair_cb.bench_var))
+    {
+        headset_fastpair_cb.bench_mismatches++;
+    }
+
+    headset_fastpair_cb.bench_done++;
+
+    if (headset_fastpair_cb.bench_done < headset_fastpair_cb.bench_iterations)
+    {
+        if (headset_work_post(HEADSET_WORK_PRIORITY_BACKGROUND, &headset_fastpair_bench_work, NULL, 0))
+        {
+            return;
+        }
+
+        headset_fastpair_bench_send(HEADSET_FASTPAIR_BENCH_STATUS_ERROR);
+    }
+    else
+    {
+        headset_fastpair_bench_send(HEADSET_FASTPAIR_BENCH_STATUS_SUCCESS);
+    }
+
+    headset_fastpair_cb.bench_busy = WICED_FALSE;
+}
+
+/*
+ * headset_fastpair_bench
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_P256_BENCH. The optional command
+ * payload is the number of iterations (2 bytes). The run takes seconds, it is
+ * deferred to the application thread as background work.
+ */
+void headset_fastpair_bench(uint8_t *p_data, uint32_t data_len)
+{
+    headset_fastpair_bench_time_t zero = { 0 };
+    uint16_t                      iterations = HEADSET_FASTPAIR_BENCH_ITERATIONS_DEFAULT;
+
+    if (data_len >= sizeof(uint16_t))
+    {
+        STREAM_TO_UINT16(iterations, p_data);
+    }
+
+    if (iterations > HEADSET_FASTPAIR_BENCH_ITERATIONS_MAX)
+    {
+        iterations = HEADSET_FASTPAIR_BENCH_ITERATIONS_MAX;
+    }
+
+    if (headset_fastpair_cb.bench_busy)
+    {
+        /* Report the progress of the run in progress, it goes on. */
+        headset_fastpair_bench_send(HEADSET_FASTPAIR_BENCH_STATUS_BUSY);
+        return;
+    }
+
+    headset_fastpair_cb.bench_iterations = iterations;
+    headset_fastpair_cb.bench_done       = 0;
+    headset_fastpair_cb.bench_mismatches = 0;
+    headset_fastpair_cb.bench_base       = zero;
+    headset_fastpair_cb.bench_var        = zero;
+
+    if (iterations == 0)
+    {
+        headset_fastpair_bench_send(HEADSET_FASTPAIR_BENCH_STATUS_SUCCESS);
+        return;
+    }
+
+    if (!headset_work_post(HEADSET_WORK_PRIORITY_BACKGROUND, &headset_fastpair_bench_work, NULL, 0))
+    {
+        headset_fastpair_bench_send(HEADSET_FASTPAIR_BENCH_STATUS_ERROR);
+        return;
+    }
+
+    headset_fastpair_cb.bench_busy = WICED_TRUE;
+}
+
+#endif /* FASTPAIR_ENABLE */
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Fast Pair crypto profiling and P-256 benchmark.
+ *
+ * The key-based pairing ECDH runs inside the gfps_provider library, which
+ * calls the ROM ECC_PointMult_Bin_NAF().
+ * - FASTPAIR_PROFILE=1 wraps that function and the GATT registration of the
+ *   library (see the makefile) to time the ECDH and each Fast Pair
+ *   characteristic write as a whole. The remainder of a key-based pairing
+ *   write is the AES/SHA work and the GATT response.
+ * - P256_FAST=1 routes the wrapped ECDH to headset_p256.c.
+ * - The benchmark command compares the ROM and headset_p256.c on the device.
+ * - The profile also reports the account key store, see headset_fastpair_keys.h.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_FASTPAIR_PROFILE_VERSION        2
+
+/* Profile flags */
+#define HEADSET_FASTPAIR_PROFILE_FLAG_ENABLED   0x01
+#define HEADSET_FASTPAIR_PROFILE_FLAG_P256_FAST 0x02
+
+#define HEADSET_FASTPAIR_BENCH_ITERATIONS_DEFAULT   4
+#define HEADSET_FASTPAIR_BENCH_ITERATIONS_MAX       32
+
+/* Benchmark event status */
+#define HEADSET_FASTPAIR_BENCH_STATUS_SUCCESS       0
+#define HEADSET_FASTPAIR_BENCH_STATUS_BUSY          1   /* a run is in progress, the values are its progress */
+#define HEADSET_FASTPAIR_BENCH_STATUS_ERROR         2   /* work queue full, the values are the iterations done */
+
+typedef enum
+{
+    HEADSET_FASTPAIR_STEP_ECDH,                 /* anti-spoofing ECDH */
+    HEADSET_FASTPAIR_STEP_KEY_PAIRING,          /* whole key-based pairing write */
+    HEADSET_FASTPAIR_STEP_PASSKEY,              /* whole passkey write */
+    HEADSET_FASTPAIR_STEP_ACCOUNT_KEY,          /* whole account key write */
+    HEADSET_FASTPAIR_STEP_MAX,
+} headset_fastpair_step_t;
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t total_us;
+} headset_fastpair_step_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void headset_fastpair_profile_send(uint8_t *p_data, uint32_t data_len);
+void headset_fastpair_bench(uint8_t *p_data, uint32_t data_len);
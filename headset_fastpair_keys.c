@@ -0,0 +1,475 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Fast Pair account key store, see headset_fastpair_keys.h.
+ */
+#ifdef FASTPAIR_ENABLE
+
+#include "wiced.h"
+#include "wiced_hal_nvram.h"
+#include "headset_fastpair_keys.h"
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bool_t                  loaded;
+    uint8_t                       slots;    /* bit n set: chunk n in the second slot */
+    uint8_t                       store[HEADSET_FASTPAIR_KEYS_STORE_SIZE];
+    uint8_t                       item[HEADSET_FASTPAIR_KEYS_HEADER_LEN + HEADSET_FASTPAIR_KEYS_CHUNK_SIZE];    /* first chunk */
+    headset_fastpair_keys_stats_t stats;
+} headset_fastpair_keys_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_fastpair_keys_cb_t headset_fastpair_keys_cb = { 0 };
+
+extern uint16_t __real_wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+extern uint16_t __real_wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+extern void __real_wiced_hal_delete_nvram(uint16_t vs_id, wiced_result_t *p_status);
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_fastpair_keys_chunk_id
+ *
+ * NVRAM item of a chunk in the given slots, the first chunk has only one.
+ */
+static uint16_t headset_fastpair_keys_chunk_id(uint8_t chunk, uint8_t slots)
+{
+    if (chunk == 0)
+    {
+        return HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY;
+    }
+
+    return (slots & (1 << chunk) ? HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_B : HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT) + chunk - 1;
+}
+
+/*
+ * headset_fastpair_keys_chunk_len
+ *
+ * Length of a chunk for a list of len bytes, 0 if the chunk is not used.
+ */
+static uint16_t headset_fastpair_keys_chunk_len(uint8_t chunk, uint16_t len)
+{
+    uint16_t offset = chunk * HEADSET_FASTPAIR_KEYS_CHUNK_SIZE;
+
+    if (offset >= len)
+    {
+        return 0;
+    }
+
+    return (len - offset) < HEADSET_FASTPAIR_KEYS_CHUNK_SIZE ? (len - offset) : HEADSET_FASTPAIR_KEYS_CHUNK_SIZE;
+}
+
+/*
+ * headset_fastpair_keys_sum
+ *
+ * Fletcher-16 checksum of the list.
+ */
+static uint16_t headset_fastpair_keys_sum(const uint8_t *p_data, uint16_t len)
+{
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    uint16_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        sum1 = (sum1 + p_data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    return (uint16_t)((sum2 << 8) | sum1);
+}
+
+/*
+ * headset_fastpair_keys_load_legacy
+ *
+ * First chunk without header (list written by a previous firmware): read
+ * the chunks up to the first short or missing one.
+ */
+static void headset_fastpair_keys_load_legacy(uint16_t nb_bytes)
+{
+    headset_fastpair_keys_stats_t *p_stats = &headset_fastpair_keys_cb.stats;
+    wiced_result_t                 result;
+    uint16_t                       len;
+
+    p_stats->store_len = nb_bytes < HEADSET_FASTPAIR_KEYS_CHUNK_SIZE ? nb_bytes : HEADSET_FASTPAIR_KEYS_CHUNK_SIZE;
+    p_stats->chunks    = 1;
+    memcpy((void *)headset_fastpair_keys_cb.store, (void *)headset_fastpair_keys_cb.item, p_stats->store_len);
+
+    while ((p_stats->store_len == p_stats->chunks * HEADSET_FASTPAIR_KEYS_CHUNK_SIZE) &&
+           (p_stats->chunks < HEADSET_FASTPAIR_KEYS_CHUNK_NUM) &&
+           (p_stats->store_len < HEADSET_FASTPAIR_KEYS_STORE_SIZE))
+    {
+        len = headset_fastpair_keys_chunk_len(p_stats->chunks, HEADSET_FASTPAIR_KEYS_STORE_SIZE);
+
+        nb_bytes = __real_wiced_hal_read_nvram(headset_fastpair_keys_chunk_id(p_stats->chunks, 0),
+                                               len,
+                                               &headset_fastpair_keys_cb.store[p_stats->store_len],
+                                               &result);
+
+        if ((result != WICED_SUCCESS) || (nb_bytes == 0))
+        {
+            break;
+        }
+
+        p_stats->store_len += nb_bytes;
+        p_stats->chunks++;
+    }
+}
+
+/*
+ * headset_fastpair_keys_load
+ *
+ * Read the chunks given by the header of the first one and check them
+ * against its length and checksum.
+ */
+static void headset_fastpair_keys_load(void)
+{
+    headset_fastpair_keys_stats_t *p_stats = &headset_fastpair_keys_cb.stats;
+    uint8_t                       *p = headset_fastpair_keys_cb.item;
+    wiced_result_t                 result;
+    uint32_t                       magic;
+    uint16_t                       nb_bytes;
+    uint16_t                       store_len;
+    uint16_t                       sum;
+    uint16_t                       len;
+    uint8_t                        slots;
+    uint8_t                        chunk;
+
+    headset_fastpair_keys_cb.loaded = WICED_TRUE;
+    headset_fastpair_keys_cb.slots  = 0;
+    p_stats->store_len = 0;
+    p_stats->chunks    = 0;
+
+    nb_bytes = __real_wiced_hal_read_nvram(HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY,
+                                           sizeof(headset_fastpair_keys_cb.item),
+                                           headset_fastpair_keys_cb.item,
+                                           &result);
+
+    if ((result != WICED_SUCCESS) || (nb_bytes == 0))
+    {
+        return;
+    }
+
+    if (nb_bytes >= HEADSET_FASTPAIR_KEYS_HEADER_LEN)
+    {
+        STREAM_TO_UINT32(magic, p);
+    }
+    else
+    {
+        magic = 0;
+    }
+
+    if (magic != HEADSET_FASTPAIR_KEYS_MAGIC)
+    {
+        headset_fastpair_keys_load_legacy(nb_bytes);
+        WICED_BT_TRACE("Fast Pair account keys: %d bytes in %d chunks (no header)\n", p_stats->store_len, p_stats->chunks);
+        return;
+    }
+
+    STREAM_TO_UINT16(store_len, p);
+    STREAM_TO_UINT16(sum, p);
+    STREAM_TO_UINT8(slots, p);
+
+    if (store_len > HEADSET_FASTPAIR_KEYS_STORE_SIZE)
+    {
+        WICED_BT_TRACE("Fast Pair account keys: %d bytes do not fit, list dropped\n", store_len);
+        return;
+    }
+
+    for (chunk = 0; chunk < HEADSET_FASTPAIR_KEYS_CHUNK_NUM; chunk++)
+    {
+        len = headset_fastpair_keys_chunk_len(chunk, store_len);
+        if (len == 0)
+        {
+            break;
+        }
+
+        if (chunk == 0)
+        {
+            nb_bytes -= HEADSET_FASTPAIR_KEYS_HEADER_LEN;
+            if (nb_bytes == len)
+            {
+                memcpy((void *)headset_fastpair_keys_cb.store, (void *)p, len);
+            }
+        }
+        else
+        {
+            nb_bytes = __real_wiced_hal_read_nvram(headset_fastpair_keys_chunk_id(chunk, slots),
+                                                   len,
+                                                   &headset_fastpair_keys_cb.store[chunk * HEADSET_FASTPAIR_KEYS_CHUNK_SIZE],
+                                                   &result);
+            if (result != WICED_SUCCESS)
+            {
+                nb_bytes = 0;
+            }
+        }
+
+        if (nb_bytes != len)
+        {
+            break;
+        }
+    }
+
+    if ((headset_fastpair_keys_chunk_len(chunk, store_len) != 0) ||
+        (headset_fastpair_keys_sum(headset_fastpair_keys_cb.store, store_len) != sum))
+    {
+        WICED_BT_TRACE("Fast Pair account keys: chunks do not match the header, list dropped\n");
+        return;
+    }
+
+    headset_fastpair_keys_cb.slots = slots;
+    p_stats->store_len = store_len;
+    p_stats->chunks    = chunk;
+
+    WICED_BT_TRACE("Fast Pair account keys: %d bytes in %d chunks\n", p_stats->store_len, p_stats->chunks);
+}
+
+/*
+ * __wrap_wiced_hal_read_nvram
+ *
+ * The account key list is read from the RAM copy.
+ */
+uint16_t __wrap_wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    headset_fastpair_keys_stats_t *p_stats = &headset_fastpair_keys_cb.stats;
+    uint16_t                       len;
+
+    if (vs_id != HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY)
+    {
+        return __real_wiced_hal_read_nvram(vs_id, data_length, p_data, p_status);
+    }
+
+    if (headset_fastpair_keys_cb.loaded)
+    {
+        p_stats->reads++;
+    }
+    else
+    {
+        headset_fastpair_keys_load();
+    }
+
+    if (p_stats->store_len == 0)
+    {
+        *p_status = WICED_ERROR;
+        return 0;
+    }
+
+    len = data_length < p_stats->store_len ? data_length : p_stats->store_len;
+    memcpy((void *)p_data, (void *)headset_fastpair_keys_cb.store, len);
+
+    *p_status = WICED_SUCCESS;
+
+    return len;
+}
+
+/*
+ * headset_fastpair_keys_write_fail
+ *
+ * A chunk written to its free slot leaves the previous list and the RAM copy
+ * in sync. A failed write of the first chunk may have changed the header:
+ * drop the RAM copy, the next access reads the list again.
+ */
+static uint16_t headset_fastpair_keys_write_fail(uint8_t chunk, wiced_result_t result, wiced_result_t *p_status)
+{
+    WICED_BT_TRACE("Fast Pair account keys: chunk %d write fail (%d)\n", chunk, result);
+
+    if (chunk == 0)
+    {
+        headset_fastpair_keys_cb.loaded          = WICED_FALSE;
+        headset_fastpair_keys_cb.slots           = 0;
+        headset_fastpair_keys_cb.stats.store_len = 0;
+        headset_fastpair_keys_cb.stats.chunks    = 0;
+    }
+
+    *p_status = result;
+
+    return 0;
+}
+
+/*
+ * __wrap_wiced_hal_write_nvram
+ *
+ * Write the chunks of the account key list which changed to their free
+ * slot, then the first chunk with the header of the new list.
+ */
+uint16_t __wrap_wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    headset_fastpair_keys_stats_t *p_stats = &headset_fastpair_keys_cb.stats;
+    wiced_result_t                 result;
+    uint16_t                       offset;
+    uint16_t                       len;
+    uint8_t                        slots = 0;
+    uint8_t                        chunk;
+    uint8_t                       *p;
+
+    if (vs_id != HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY)
+    {
+        return __real_wiced_hal_write_nvram(vs_id, data_length, p_data, p_status);
+    }
+
+    if (data_length > HEADSET_FASTPAIR_KEYS_STORE_SIZE)
+    {
+        WICED_BT_TRACE("Fast Pair account keys: %d bytes do not fit\n", data_length);
+        *p_status = WICED_BADARG;
+        return 0;
+    }
+
+    if (!headset_fastpair_keys_cb.loaded)
+    {
+        headset_fastpair_keys_load();
+    }
+
+    if ((data_length == p_stats->store_len) &&
+        (memcmp((void *)headset_fastpair_keys_cb.store, (void *)p_data, data_length) == 0))
+    {
+        p_stats->chunk_skips += p_stats->chunks;
+        *p_status = WICED_SUCCESS;
+        return data_length;
+    }
+
+    for (chunk = 1; chunk < HEADSET_FASTPAIR_KEYS_CHUNK_NUM; chunk++)
+    {
+        offset = chunk * HEADSET_FASTPAIR_KEYS_CHUNK_SIZE;
+        len    = headset_fastpair_keys_chunk_len(chunk, data_length);
+
+        if (len == 0)
+        {
+            break;
+        }
+
+        if ((len == headset_fastpair_keys_chunk_len(chunk, p_stats->store_len)) &&
+            (memcmp((void *)&headset_fastpair_keys_cb.store[offset], (void *)&p_data[offset], len) == 0))
+        {
+            slots |= headset_fastpair_keys_cb.slots & (1 << chunk);
+            p_stats->chunk_skips++;
+            continue;
+        }
+
+        /* Never overwrite the slot the current header points to. */
+        slots |= ~headset_fastpair_keys_cb.slots & (1 << chunk);
+
+        if (__real_wiced_hal_write_nvram(headset_fastpair_keys_chunk_id(chunk, slots), len, &p_data[offset], &result) != len)
+        {
+            return headset_fastpair_keys_write_fail(chunk, result, p_status);
+        }
+
+        p_stats->chunk_writes++;
+    }
+
+    /* The header of the first chunk validates the others, it goes last. */
+    p = headset_fastpair_keys_cb.item;
+    UINT32_TO_STREAM(p, HEADSET_FASTPAIR_KEYS_MAGIC);
+    UINT16_TO_STREAM(p, data_length);
+    UINT16_TO_STREAM(p, headset_fastpair_keys_sum(p_data, data_length));
+    UINT8_TO_STREAM(p, slots);
+
+    len = headset_fastpair_keys_chunk_len(0, data_length);
+    memcpy((void *)p, (void *)p_data, len);
+    len += HEADSET_FASTPAIR_KEYS_HEADER_LEN;
+
+    if (__real_wiced_hal_write_nvram(HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY, len, headset_fastpair_keys_cb.item, &result) != len)
+    {
+        return headset_fastpair_keys_write_fail(0, result, p_status);
+    }
+
+    p_stats->chunk_writes++;
+
+    /* The list is shorter, drop the chunks it no longer uses. */
+    for (chunk = (data_length + HEADSET_FASTPAIR_KEYS_CHUNK_SIZE - 1) / HEADSET_FASTPAIR_KEYS_CHUNK_SIZE;
+         chunk < p_stats->chunks;
+         chunk++)
+    {
+        if (chunk != 0)
+        {
+            __real_wiced_hal_delete_nvram(headset_fastpair_keys_chunk_id(chunk, 0), &result);
+            __real_wiced_hal_delete_nvram(headset_fastpair_keys_chunk_id(chunk, 1 << chunk), &result);
+        }
+    }
+
+    memcpy((void *)headset_fastpair_keys_cb.store, (void *)p_data, data_length);
+    headset_fastpair_keys_cb.slots = slots;
+    p_stats->store_len = data_length;
+    p_stats->chunks    = (data_length + HEADSET_FASTPAIR_KEYS_CHUNK_SIZE - 1) / HEADSET_FASTPAIR_KEYS_CHUNK_SIZE;
+
+    *p_status = WICED_SUCCESS;
+
+    return data_length;
+}
+
+/*
+ * __wrap_wiced_hal_delete_nvram
+ */
+void __wrap_wiced_hal_delete_nvram(uint16_t vs_id, wiced_result_t *p_status)
+{
+    wiced_result_t result;
+    uint8_t        chunk;
+
+    if (vs_id != HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY)
+    {
+        __real_wiced_hal_delete_nvram(vs_id, p_status);
+        return;
+    }
+
+    /* The header goes first, the list is gone even if a chunk is left. */
+    __real_wiced_hal_delete_nvram(HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY, p_status);
+
+    for (chunk = 1; chunk < HEADSET_FASTPAIR_KEYS_CHUNK_NUM; chunk++)
+    {
+        __real_wiced_hal_delete_nvram(headset_fastpair_keys_chunk_id(chunk, 0), &result);
+        __real_wiced_hal_delete_nvram(headset_fastpair_keys_chunk_id(chunk, 1 << chunk), &result);
+    }
+
+    headset_fastpair_keys_cb.loaded          = WICED_TRUE;
+    headset_fastpair_keys_cb.slots           = 0;
+    headset_fastpair_keys_cb.stats.store_len = 0;
+    headset_fastpair_keys_cb.stats.chunks    = 0;
+}
+
+/*
+ * headset_fastpair_keys_stats_get
+ */
+void headset_fastpair_keys_stats_get(headset_fastpair_keys_stats_t *p_stats)
+{
+    *p_stats = headset_fastpair_keys_cb.stats;
+}
+
+#endif /* FASTPAIR_ENABLE */
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Fast Pair account key store.
+ *
+ * The gfps_provider library keeps its account key list in a single NVRAM
+ * item, which caps FASTPAIR_ACCOUNT_KEY_NUM at a few keys. The NVRAM
+ * accesses of the library to HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY are wrapped
+ * (see the makefile) and the list is stored in chunks:
+ * - The first chunk stays in HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY, a list
+ *   written by a previous firmware is read back as is.
+ * - Each next chunk has two slots, HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT
+ *   and HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_B.
+ * - The list is mirrored in RAM, the library reads never reach the NVRAM
+ *   after the first one.
+ * - A write only updates the chunks which changed, adding a key to a full
+ *   list does not rewrite the keys which did not move.
+ * - The first chunk starts with a header,
+ *   | MAGIC (4) | LEN (2) | SUM (2) | SLOTS (1) |, the length and
+ *   Fletcher-16 checksum of the whole list and the slot in use by each
+ *   chunk (bit n set: chunk n in the second slot).
+ * - A changed chunk is written to the slot not in use, the first chunk with
+ *   the new header goes last. A write which fails part way leaves the
+ *   header and the chunks of the previous list untouched.
+ *
+ * The key-based pairing still tries the stored keys one by one inside the
+ * library, the cost of each request grows with the number of keys. Build
+ * with FASTPAIR_PROFILE=1 and compare the key_pairing step of the Fast Pair
+ * profile for several FASTPAIR_ACCOUNT_KEY_NUM values.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "headset_nvram.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_FASTPAIR_KEYS_KEY_LEN       16
+#define HEADSET_FASTPAIR_KEYS_CHUNK_SIZE    192     /* 12 keys per NVRAM item */
+#define HEADSET_FASTPAIR_KEYS_CHUNK_NUM     (1 + HEADSET_NVRAM_GFPS_EXT_NUM)
+#define HEADSET_FASTPAIR_KEYS_HEADER_LEN    9       /* in front of the first chunk */
+#define HEADSET_FASTPAIR_KEYS_MAGIC         0x324B4148  /* "HAK2" */
+
+/* The library may keep a header with the list, leave one key of margin. */
+#define HEADSET_FASTPAIR_KEYS_STORE_SIZE    ((FASTPAIR_ACCOUNT_KEY_NUM + 1) * HEADSET_FASTPAIR_KEYS_KEY_LEN)
+
+#if HEADSET_FASTPAIR_KEYS_STORE_SIZE > (HEADSET_FASTPAIR_KEYS_CHUNK_NUM * HEADSET_FASTPAIR_KEYS_CHUNK_SIZE)
+#error "FASTPAIR_ACCOUNT_KEY_NUM too large, increase HEADSET_NVRAM_GFPS_EXT_NUM"
+#endif
+
+#if HEADSET_FASTPAIR_KEYS_CHUNK_NUM > 8
+#error "HEADSET_NVRAM_GFPS_EXT_NUM too large for the SLOTS byte of the header"
+#endif
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint16_t store_len;         /* bytes of the list stored by the library */
+    uint8_t  chunks;            /* NVRAM items in use */
+    uint32_t reads;             /* library reads served from RAM */
+    uint32_t chunk_writes;      /* NVRAM items written */
+    uint32_t chunk_skips;       /* NVRAM items left untouched by a write */
+} headset_fastpair_keys_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void headset_fastpair_keys_stats_get(headset_fastpair_keys_stats_t *p_stats);
@@ -0,0 +1,541 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application GATT bearer management, see headset_gatt.h.
+ */
+#include "wiced.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_bt_trace.h"
+#include "headset_timer.h"
+#include "headset_gatt.h"
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    headset_gatt_bearer_stats_t stats;
+    uint32_t                    last_request_ms;
+} headset_gatt_bearer_t;
+
+typedef struct
+{
+    wiced_bool_t              in_use;
+    wiced_bt_device_address_t bd_addr;
+    uint8_t                   client_features;
+    uint32_t                  cccd;         /* one bit per notifiable characteristic */
+    headset_gatt_bearer_t     bearer[HEADSET_GATT_BEARER_MAX];  /* 0: fixed ATT channel */
+} headset_gatt_link_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_gatt_link_t headset_gatt_link[HEADSET_GATT_LINK_MAX];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_gatt_bearer_find
+ *
+ * Find the bearer (ATT or EATT) of a conn_id, optionally return its link.
+ */
+static headset_gatt_bearer_t *headset_gatt_bearer_find(uint16_t conn_id, headset_gatt_link_t **pp_link)
+{
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < HEADSET_GATT_LINK_MAX; i++)
+    {
+        if (!headset_gatt_link[i].in_use)
+        {
+            continue;
+        }
+
+        for (j = 0; j < HEADSET_GATT_BEARER_MAX; j++)
+        {
+            if ((headset_gatt_link[i].bearer[j].stats.conn_id == conn_id) &&
+                (headset_gatt_link[i].bearer[j].stats.mtu != 0))
+            {
+                if (pp_link)
+                {
+                    *pp_link = &headset_gatt_link[i];
+                }
+                return &headset_gatt_link[i].bearer[j];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_gatt_link_find
+ */
+static headset_gatt_link_t *headset_gatt_link_find(uint16_t conn_id)
+{
+    headset_gatt_link_t *p_link = NULL;
+
+    headset_gatt_bearer_find(conn_id, &p_link);
+
+    return p_link;
+}
+
+#if (BTSTACK_VER >= 0x03000001) && defined(HEADSET_EATT)
+/*
+ * headset_gatt_link_find_by_addr
+ */
+static headset_gatt_link_t *headset_gatt_link_find_by_addr(const uint8_t *p_bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_GATT_LINK_MAX; i++)
+    {
+        if (headset_gatt_link[i].in_use &&
+            (memcmp((void *)headset_gatt_link[i].bd_addr, (void *)p_bd_addr, BD_ADDR_LEN) == 0))
+        {
+            return &headset_gatt_link[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_gatt_eatt_free_count
+ */
+static uint8_t headset_gatt_eatt_free_count(headset_gatt_link_t *p_link)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    for (i = 1; i < HEADSET_GATT_BEARER_MAX; i++)
+    {
+        if (p_link->bearer[i].stats.mtu == 0)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * headset_gatt_eatt_connect_ind
+ *
+ * The peer opens EATT bearers, accept as many as there are free entries.
+ */
+static void headset_gatt_eatt_connect_ind(wiced_bt_gatt_eatt_connection_indication_event_t *p_ind)
+{
+    wiced_bt_gatt_eatt_connection_response_t rsp;
+    wiced_bt_gatt_eatt_bearers_t             lcids = { 0 };
+    headset_gatt_link_t                     *p_link;
+    uint8_t                                  accepted = 0;
+    uint8_t                                  i;
+
+    p_link = headset_gatt_link_find_by_addr(p_ind->bdaddr);
+
+    if (p_link)
+    {
+        accepted = headset_gatt_eatt_free_count(p_link);
+
+        if (accepted > p_ind->num_bearers)
+        {
+            accepted = (uint8_t)p_ind->num_bearers;
+        }
+    }
+
+    for (i = 0; i < accepted; i++)
+    {
+        lcids[i] = p_ind->lcid[i];
+    }
+
+    memset((void *)&rsp, 0, sizeof(rsp));
+    memcpy((void *)rsp.bdaddr, (void *)p_ind->bdaddr, BD_ADDR_LEN);
+    rsp.trans_id   = p_ind->trans_id;
+    rsp.our_rx_mtu = HEADSET_GATT_EATT_MTU;
+    rsp.response   = accepted ? L2CAP_LE_RESULT_CONN_OK : L2CAP_LE_RESULT_NO_RESOURCES;
+
+    WICED_BT_TRACE("EATT %B: %d bearers requested, %d accepted\n", p_ind->bdaddr, p_ind->num_bearers, accepted);
+
+    wiced_bt_gatt_eatt_connect_response(&rsp, lcids);
+}
+
+/*
+ * headset_gatt_eatt_connect_complete
+ */
+static void headset_gatt_eatt_connect_complete(wiced_bt_gatt_eatt_connection_complete_event_t *p_complete)
+{
+    headset_gatt_link_t *p_link;
+    uint8_t              i;
+
+    if (p_complete->result != L2CAP_LE_RESULT_CONN_OK)
+    {
+        return;
+    }
+
+    p_link = headset_gatt_link_find_by_addr(p_complete->bdaddr);
+
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    for (i = 1; i < HEADSET_GATT_BEARER_MAX; i++)
+    {
+        if (p_link->bearer[i].stats.mtu == 0)
+        {
+            memset((void *)&p_link->bearer[i], 0, sizeof(headset_gatt_bearer_t));
+            p_link->bearer[i].stats.conn_id = p_complete->conn_id;
+            p_link->bearer[i].stats.mtu     = p_complete->mtu;
+            p_link->bearer[i].stats.eatt    = WICED_TRUE;
+
+            WICED_BT_TRACE("EATT bearer conn_id:%d mtu:%d\n", p_complete->conn_id, p_complete->mtu);
+            return;
+        }
+    }
+}
+
+/*
+ * headset_gatt_eatt_release_ind
+ */
+static void headset_gatt_eatt_release_ind(wiced_bt_gatt_eatt_release_indication_event_t *p_release)
+{
+    headset_gatt_bearer_t *p_bearer = headset_gatt_bearer_find(p_release->conn_id, NULL);
+
+    if (p_bearer && p_bearer->stats.eatt)
+    {
+        memset((void *)p_bearer, 0, sizeof(headset_gatt_bearer_t));
+    }
+}
+
+static wiced_bt_gatt_eatt_callbacks_t headset_gatt_eatt_callbacks =
+{
+    .eatt_connect_ind   = headset_gatt_eatt_connect_ind,
+    .eatt_connect_cmpl  = headset_gatt_eatt_connect_complete,
+    .eatt_release_ind   = headset_gatt_eatt_release_ind,
+};
+#endif /* (BTSTACK_VER >= 0x03000001) && defined(HEADSET_EATT) */
+
+/*
+ * headset_gatt_init
+ *
+ * Called once the GATT database is set, register the EATT server.
+ */
+void headset_gatt_init(void)
+{
+    memset((void *)headset_gatt_link, 0, sizeof(headset_gatt_link));
+
+#if (BTSTACK_VER >= 0x03000001) && defined(HEADSET_EATT)
+    if (wiced_bt_gatt_eatt_register(&headset_gatt_eatt_callbacks,
+                                    HEADSET_GATT_EATT_MTU,
+                                    HEADSET_GATT_LINK_MAX * HEADSET_GATT_EATT_BEARER_MAX,
+                                    0) != WICED_BT_GATT_SUCCESS)
+    {
+        WICED_BT_TRACE("EATT registration failed\n");
+    }
+#endif
+}
+
+/*
+ * headset_gatt_link_up
+ *
+ * An LE link is up, conn_id is its fixed ATT bearer.
+ */
+void headset_gatt_link_up(const uint8_t *p_bd_addr, uint16_t conn_id)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_GATT_LINK_MAX; i++)
+    {
+        if (!headset_gatt_link[i].in_use)
+        {
+            memset((void *)&headset_gatt_link[i], 0, sizeof(headset_gatt_link_t));
+            headset_gatt_link[i].in_use = WICED_TRUE;
+            memcpy((void *)headset_gatt_link[i].bd_addr, (void *)p_bd_addr, BD_ADDR_LEN);
+
+            headset_gatt_link[i].bearer[0].stats.conn_id = conn_id;
+            headset_gatt_link[i].bearer[0].stats.mtu     = GATT_DEF_BLE_MTU_SIZE;
+            return;
+        }
+    }
+
+    WICED_BT_TRACE("headset_gatt_link_up: no room for conn_id:%d\n", conn_id);
+}
+
+/*
+ * headset_gatt_link_down
+ *
+ * The link and all its EATT bearers are gone.
+ */
+void headset_gatt_link_down(uint16_t conn_id)
+{
+    headset_gatt_link_t *p_link = headset_gatt_link_find(conn_id);
+
+    if (p_link)
+    {
+        memset((void *)p_link, 0, sizeof(headset_gatt_link_t));
+    }
+}
+
+/*
+ * headset_gatt_mtu_set
+ */
+void headset_gatt_mtu_set(uint16_t conn_id, uint16_t mtu)
+{
+    headset_gatt_bearer_t *p_bearer = headset_gatt_bearer_find(conn_id, NULL);
+
+    if (p_bearer)
+    {
+        p_bearer->stats.mtu = mtu;
+    }
+}
+
+/*
+ * headset_gatt_mtu_get
+ *
+ * MTU of the bearer, the ATT default if unknown.
+ */
+uint16_t headset_gatt_mtu_get(uint16_t conn_id)
+{
+    headset_gatt_bearer_t *p_bearer = headset_gatt_bearer_find(conn_id, NULL);
+
+    return p_bearer ? p_bearer->stats.mtu : GATT_DEF_BLE_MTU_SIZE;
+}
+
+/*
+ * headset_gatt_request_handled
+ *
+ * The handler of a request on a bearer, entered at start (headset_timer_now_us),
+ * returned. The stack gives no reception time, the time the request waited
+ * in the stack queue is not included.
+ */
+void headset_gatt_request_handled(uint16_t conn_id, uint64_t start)
+{
+    headset_gatt_bearer_t *p_bearer = headset_gatt_bearer_find(conn_id, NULL);
+    uint32_t               elapsed;
+
+    if (p_bearer == NULL)
+    {
+        return;
+    }
+
+    elapsed = (uint32_t)(headset_timer_now_us() - start);
+
+    p_bearer->stats.requests++;
+    p_bearer->stats.handler_total_us += elapsed;
+    p_bearer->last_request_ms         = headset_timer_now_ms();
+
+    if (elapsed > p_bearer->stats.handler_max_us)
+    {
+        p_bearer->stats.handler_max_us = elapsed;
+    }
+}
+
+/*
+ * headset_gatt_notification_sent
+ */
+void headset_gatt_notification_sent(uint16_t conn_id)
+{
+    headset_gatt_bearer_t *p_bearer = headset_gatt_bearer_find(conn_id, NULL);
+
+    if (p_bearer)
+    {
+        p_bearer->stats.notifications++;
+    }
+}
+
+/*
+ * headset_gatt_client_features_set
+ *
+ * Client Supported Features written by the peer. Bits cannot be cleared
+ * once set (Core 5.2 Vol 3 Part G 7.2).
+ */
+void headset_gatt_client_features_set(uint16_t conn_id, uint8_t features)
+{
+    headset_gatt_link_t *p_link = headset_gatt_link_find(conn_id);
+
+    if (p_link)
+    {
+        p_link->client_features |= features;
+    }
+}
+
+/*
+ * headset_gatt_client_features_get
+ */
+uint8_t headset_gatt_client_features_get(uint16_t conn_id)
+{
+    headset_gatt_link_t *p_link = headset_gatt_link_find(conn_id);
+
+    return p_link ? p_link->client_features : 0;
+}
+
+/*
+ * headset_gatt_cccd_set
+ *
+ * Notification configuration of the characteristic index (defined by the
+ * caller) on the link of conn_id.
+ */
+void headset_gatt_cccd_set(uint16_t conn_id, uint8_t index, wiced_bool_t enable)
+{
+    headset_gatt_link_t *p_link = headset_gatt_link_find(conn_id);
+
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    if (enable)
+    {
+        p_link->cccd |= (1UL << index);
+    }
+    else
+    {
+        p_link->cccd &= ~(1UL << index);
+    }
+}
+
+/*
+ * headset_gatt_cccd_get
+ */
+wiced_bool_t headset_gatt_cccd_get(uint16_t conn_id, uint8_t index)
+{
+    headset_gatt_link_t *p_link = headset_gatt_link_find(conn_id);
+
+    return (p_link && (p_link->cccd & (1UL << index))) ? WICED_TRUE : WICED_FALSE;
+}
+
+/*
+ * headset_gatt_links_get
+ *
+ * Return the number of links, with the conn_id of their ATT bearer.
+ */
+uint8_t headset_gatt_links_get(uint16_t *p_conn_id, uint8_t max)
+{
+    uint8_t num = 0;
+    uint8_t i;
+
+    for (i = 0; (i < HEADSET_GATT_LINK_MAX) && (num < max); i++)
+    {
+        if (headset_gatt_link[i].in_use)
+        {
+            p_conn_id[num++] = headset_gatt_link[i].bearer[0].stats.conn_id;
+        }
+    }
+
+    return num;
+}
+
+/*
+ * headset_gatt_link_conn_id_get
+ *
+ * conn_id of the ATT bearer of the link of any bearer, 0 if unknown.
+ */
+uint16_t headset_gatt_link_conn_id_get(uint16_t conn_id)
+{
+    headset_gatt_link_t *p_link = headset_gatt_link_find(conn_id);
+
+    return p_link ? p_link->bearer[0].stats.conn_id : 0;
+}
+
+/*
+ * headset_gatt_notify_bearer_get
+ *
+ * Bearer for the notifications of a link: the EATT bearer which has been idle
+ * the longest, the ATT bearer if there is none. A notification then does not
+ * wait behind a long transaction in progress on another bearer.
+ */
+uint16_t headset_gatt_notify_bearer_get(uint16_t conn_id)
+{
+    headset_gatt_link_t   *p_link = headset_gatt_link_find(conn_id);
+    headset_gatt_bearer_t *p_best = NULL;
+    uint32_t               now = headset_timer_now_ms();
+    uint8_t                i;
+
+    if (p_link == NULL)
+    {
+        return conn_id;
+    }
+
+    for (i = 1; i < HEADSET_GATT_BEARER_MAX; i++)
+    {
+        if (p_link->bearer[i].stats.mtu == 0)
+        {
+            continue;
+        }
+
+        if ((p_best == NULL) ||
+            ((now - p_link->bearer[i].last_request_ms) > (now - p_best->last_request_ms)))
+        {
+            p_best = &p_link->bearer[i];
+        }
+    }
+
+    return p_best ? p_best->stats.conn_id : p_link->bearer[0].stats.conn_id;
+}
+
+/*
+ * headset_gatt_stats_get
+ *
+ * Copy the statistics of every bearer, return the number of entries.
+ */
+uint8_t headset_gatt_stats_get(headset_gatt_bearer_stats_t *p_stats, uint8_t max)
+{
+    uint8_t num = 0;
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < HEADSET_GATT_LINK_MAX; i++)
+    {
+        if (!headset_gatt_link[i].in_use)
+        {
+            continue;
+        }
+
+        for (j = 0; (j < HEADSET_GATT_BEARER_MAX) && (num < max); j++)
+        {
+            if (headset_gatt_link[i].bearer[j].stats.mtu != 0)
+            {
+                memcpy((void *)&p_stats[num++],
+                       (void *)&headset_gatt_link[i].bearer[j].stats,
+                       sizeof(headset_gatt_bearer_stats_t));
+            }
+        }
+    }
+
+    return num;
+}
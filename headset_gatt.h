@@ -0,0 +1,100 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application GATT bearer management.
+ *
+ * With the BTSTACK v3 build (and EATT_ENABLE=1) the peer may open Enhanced
+ * ATT bearers, L2CAP credit based channels carrying ATT in parallel with the
+ * fixed channel. Each bearer has its own conn_id and MTU. A request is
+ * answered on the bearer it was received on, so a slow Fast Pair write no
+ * longer delays a Device Information read issued on another bearer
+ * (audio_client/gatt_latency.py measures both round trip times).
+ *
+ * This module maps every bearer to its LE link, keeps the per bearer MTU and
+ * request handler time, the Client Supported Features and the notification
+ * configuration of the link, and picks the bearer for the notifications.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_GATT_LINK_MAX               1       /* ble_max_simultaneous_links */
+#define HEADSET_GATT_EATT_BEARER_MAX        3       /* EATT bearers accepted per link */
+#define HEADSET_GATT_BEARER_MAX             (1 + HEADSET_GATT_EATT_BEARER_MAX)
+#define HEADSET_GATT_EATT_MTU               365     /* ble_max_rx_pdu_size */
+
+/* Server Supported Features (0x2B3A) */
+#define HEADSET_GATT_SERVER_FEATURE_EATT            0x01
+
+/* Client Supported Features (0x2B29) */
+#define HEADSET_GATT_CLIENT_FEATURE_ROBUST_CACHING  0x01
+#define HEADSET_GATT_CLIENT_FEATURE_EATT            0x02
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint16_t conn_id;
+    uint16_t mtu;
+    uint8_t  eatt;                  /* WICED_FALSE for the fixed ATT channel */
+    uint32_t requests;
+    uint32_t notifications;         /* PDUs sent */
+    uint32_t handler_max_us;        /* time spent in the request handler, queueing excluded */
+    uint32_t handler_total_us;
+} headset_gatt_bearer_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void         headset_gatt_init(void);
+void         headset_gatt_link_up(const uint8_t *p_bd_addr, uint16_t conn_id);
+void         headset_gatt_link_down(uint16_t conn_id);
+void         headset_gatt_mtu_set(uint16_t conn_id, uint16_t mtu);
+uint16_t     headset_gatt_mtu_get(uint16_t conn_id);
+void         headset_gatt_request_handled(uint16_t conn_id, uint64_t start);
+void         headset_gatt_notification_sent(uint16_t conn_id);
+void         headset_gatt_client_features_set(uint16_t conn_id, uint8_t features);
+uint8_t      headset_gatt_client_features_get(uint16_t conn_id);
+void         headset_gatt_cccd_set(uint16_t conn_id, uint8_t index, wiced_bool_t enable);
+wiced_bool_t headset_gatt_cccd_get(uint16_t conn_id, uint8_t index);
+uint8_t      headset_gatt_links_get(uint16_t *p_conn_id, uint8_t max);
+uint16_t     headset_gatt_link_conn_id_get(uint16_t conn_id);
+uint16_t     headset_gatt_notify_bearer_get(uint16_t conn_id);
+uint8_t      headset_gatt_stats_get(headset_gatt_bearer_stats_t *p_stats, uint8_t max);
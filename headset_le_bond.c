@@ -0,0 +1,503 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Bonded LE peers in the controller lists, see headset_le_bond.h.
+ */
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_trace.h"
+#include "wiced_hal_nvram.h"
+#ifdef FASTPAIR_ENABLE
+#include "wiced_bt_gfps.h"
+#endif
+#include "headset_event.h"
+#include "headset_timer.h"
+#include "headset_work.h"
+#include "headset_nvram.h"
+#include "headset_le_bond.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_LE_BOND_REASON_LINK_LOSS    0x08    /* HCI connection timeout */
+
+#if BTSTACK_VER >= 0x03000001
+#define HEADSET_LE_BOND_ADV_POLICY_ALL      BTM_BLE_ADV_POLICY_ACCEPT_CONN_AND_SCAN
+#define HEADSET_LE_BOND_ADV_POLICY_LISTED   BTM_BLE_ADV_POLICY_FILTER_CONN_FILTER_SCAN
+#else
+#define HEADSET_LE_BOND_ADV_POLICY_ALL      BTM_BLE_ADVERT_FILTER_ALL_CONNECTION_REQ_ALL_SCAN_REQ
+#define HEADSET_LE_BOND_ADV_POLICY_LISTED   BTM_BLE_ADVERT_FILTER_ACCEPT_LIST_CONNECTION_REQ_ACCEPT_LIST_SCAN_REQ
+#endif
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+/* NVRAM entry of a bond */
+typedef struct
+{
+    uint32_t                    sequence;       /* highest is the most recent bond */
+    wiced_bt_device_link_keys_t keys;
+} headset_le_bond_nvram_t;
+
+typedef struct
+{
+    wiced_bool_t            in_use;
+    headset_le_bond_nvram_t nvram;
+    uint32_t                disconnected_ms;    /* 0 while connected or never connected */
+} headset_le_bond_t;
+
+typedef struct
+{
+    headset_le_bond_t       bond[HEADSET_LE_BOND_MAX];
+    uint32_t                sequence;
+    wiced_bool_t            discoverable;
+    wiced_bool_t            directed;           /* directed advertising started */
+    headset_le_bond_stats_t stats;
+} headset_le_bond_cb_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+extern wiced_result_t __real_wiced_bt_dev_delete_bonded_device(wiced_bt_device_address_t bd_addr);
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_le_bond_cb_t headset_le_bond_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_le_bond_find
+ */
+static headset_le_bond_t *headset_le_bond_find(const uint8_t *p_bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_LE_BOND_MAX; i++)
+    {
+        if (headset_le_bond_cb.bond[i].in_use &&
+            (memcmp((void *)headset_le_bond_cb.bond[i].nvram.keys.bd_addr,
+                    (void *)p_bd_addr,
+                    sizeof(wiced_bt_device_address_t)) == 0))
+        {
+            return &headset_le_bond_cb.bond[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_le_bond_lists_add
+ *
+ * Load a bond in the controller resolving list and Filter Accept List.
+ */
+static void headset_le_bond_lists_add(headset_le_bond_t *p_bond)
+{
+    wiced_result_t result;
+
+    result = wiced_bt_dev_add_device_to_address_resolution_db(&p_bond->nvram.keys);
+
+    if (!wiced_bt_ble_update_advertising_filter_accept_list(WICED_TRUE, p_bond->nvram.keys.bd_addr))
+    {
+        WICED_BT_TRACE("LE bond %B: Filter Accept List full\n", p_bond->nvram.keys.bd_addr);
+    }
+
+    WICED_BT_TRACE("LE bond %B loaded (resolving list: %d)\n", p_bond->nvram.keys.bd_addr, result);
+}
+
+/*
+ * headset_le_bond_lists_remove
+ */
+static void headset_le_bond_lists_remove(headset_le_bond_t *p_bond)
+{
+    wiced_bt_dev_remove_device_from_address_resolution_db(&p_bond->nvram.keys);
+    wiced_bt_ble_update_advertising_filter_accept_list(WICED_FALSE, p_bond->nvram.keys.bd_addr);
+}
+
+/*
+ * headset_le_bond_count
+ */
+static uint8_t headset_le_bond_count(void)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_LE_BOND_MAX; i++)
+    {
+        if (headset_le_bond_cb.bond[i].in_use)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * headset_le_bond_adv_policy_update
+ *
+ * Without Fast Pair, a headset which is not discoverable only answers the
+ * peers of the Filter Accept List.
+ */
+static void headset_le_bond_adv_policy_update(void)
+{
+#ifndef FASTPAIR_ENABLE
+    wiced_bt_ble_update_advertisement_filter_policy(
+            (!headset_le_bond_cb.discoverable && headset_le_bond_cb.stats.bonds) ?
+                    HEADSET_LE_BOND_ADV_POLICY_LISTED :
+                    HEADSET_LE_BOND_ADV_POLICY_ALL);
+#endif
+}
+
+/*
+ * headset_le_bond_nvram_write_work
+ *
+ * Commit a bond to NVRAM (executed in the application thread).
+ */
+static void headset_le_bond_nvram_write_work(uint8_t *p_data, uint16_t len)
+{
+    headset_le_bond_t *p_bond = &headset_le_bond_cb.bond[p_data[0]];
+    wiced_result_t     result;
+    uint16_t           nb_bytes;
+
+    nb_bytes = wiced_hal_write_nvram(HEADSET_NVRAM_ID_LE_BOND + p_data[0],
+                                     sizeof(headset_le_bond_nvram_t),
+                                     (uint8_t *)&p_bond->nvram,
+                                     &result);
+
+    WICED_BT_TRACE("LE bond %B saved (result: %d, nb_bytes: %d)\n",
+                   p_bond->nvram.keys.bd_addr, result, nb_bytes);
+}
+
+/*
+ * headset_le_bond_nvram_delete_work
+ *
+ * Delete a bond from NVRAM (executed in the application thread).
+ */
+static void headset_le_bond_nvram_delete_work(uint8_t *p_data, uint16_t len)
+{
+    wiced_result_t result;
+
+    wiced_hal_delete_nvram(HEADSET_NVRAM_ID_LE_BOND + p_data[0], &result);
+
+    WICED_BT_TRACE("LE bond %d deleted (result: %d)\n", p_data[0], result);
+}
+
+/*
+ * headset_le_bond_release
+ *
+ * Forget a bond: out of the controller lists and out of NVRAM.
+ */
+static void headset_le_bond_release(headset_le_bond_t *p_bond)
+{
+    uint8_t index = (uint8_t)(p_bond - headset_le_bond_cb.bond);
+
+    WICED_BT_TRACE("LE bond %B removed\n", p_bond->nvram.keys.bd_addr);
+
+    headset_le_bond_lists_remove(p_bond);
+    memset((void *)p_bond, 0, sizeof(headset_le_bond_t));
+
+    headset_le_bond_cb.stats.bonds = headset_le_bond_count();
+    headset_le_bond_adv_policy_update();
+
+    if (!headset_work_post(HEADSET_WORK_PRIORITY_BACKGROUND,
+                           &headset_le_bond_nvram_delete_work,
+                           &index,
+                           sizeof(index)))
+    {
+        headset_le_bond_nvram_delete_work(&index, sizeof(index));
+    }
+}
+
+/*
+ * headset_le_bond_reconnect
+ *
+ * High duty directed advertising to a bonded peer lost by supervision
+ * timeout, it ends by itself after 1.28 s if the peer does not connect.
+ */
+static void headset_le_bond_reconnect(headset_le_bond_t *p_bond)
+{
+#ifdef HEADSET_LE_DIRECTED_ADV
+    wiced_result_t result;
+
+    if (headset_le_bond_cb.discoverable)
+    {
+        return;
+    }
+
+    result = wiced_bt_start_advertisements(BTM_BLE_ADVERT_DIRECTED_HIGH,
+                                           p_bond->nvram.keys.key_data.ble_addr_type,
+                                           p_bond->nvram.keys.bd_addr);
+
+    WICED_BT_TRACE("LE bond %B: directed advertising (%d)\n", p_bond->nvram.keys.bd_addr, result);
+
+    if (result == WICED_BT_SUCCESS)
+    {
+        headset_le_bond_cb.directed = WICED_TRUE;
+        headset_le_bond_cb.stats.directed_adv++;
+    }
+#endif
+}
+
+/*
+ * headset_le_bond_event_handler
+ */
+static void headset_le_bond_event_handler(const headset_event_data_t *p_data)
+{
+    headset_le_bond_t *p_bond;
+    uint32_t           duration;
+
+    switch (p_data->event)
+    {
+    case HEADSET_EVENT_LE_CONNECTED:
+        headset_le_bond_cb.directed = WICED_FALSE;
+
+        p_bond = headset_le_bond_find(p_data->bd_addr);
+        if (p_bond == NULL)
+        {
+            headset_le_bond_cb.stats.unknown_peers++;
+            return;
+        }
+
+        if (p_bond->disconnected_ms)
+        {
+            duration = headset_timer_now_ms() - p_bond->disconnected_ms;
+
+            headset_le_bond_cb.stats.reconnects++;
+            headset_le_bond_cb.stats.last_ms   = duration;
+            headset_le_bond_cb.stats.total_ms += duration;
+            if (duration > headset_le_bond_cb.stats.max_ms)
+            {
+                headset_le_bond_cb.stats.max_ms = duration;
+            }
+
+            WICED_BT_TRACE("LE bond %B reconnected after %d ms\n", p_data->bd_addr, duration);
+
+            p_bond->disconnected_ms = 0;
+        }
+        break;
+
+    case HEADSET_EVENT_LE_DISCONNECTED:
+        p_bond = headset_le_bond_find(p_data->bd_addr);
+        if (p_bond == NULL)
+        {
+            return;
+        }
+
+        /* 0 means connected, the timer starts at 0 */
+        p_bond->disconnected_ms = headset_timer_now_ms() | 1;
+
+        if (p_data->status == HEADSET_LE_BOND_REASON_LINK_LOSS)
+        {
+            headset_le_bond_reconnect(p_bond);
+        }
+        break;
+
+    case HEADSET_EVENT_LE_DISCOVERABILITY:
+        headset_le_bond_cb.discoverable = p_data->status ? WICED_TRUE : WICED_FALSE;
+        headset_le_bond_adv_policy_update();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * headset_le_bond_init
+ *
+ * Load the LE bonds from NVRAM into the controller lists.
+ */
+void headset_le_bond_init(void)
+{
+    headset_le_bond_t *p_bond;
+    wiced_result_t     result;
+    uint16_t           nb_bytes;
+    uint8_t            i;
+
+    memset((void *)&headset_le_bond_cb, 0, sizeof(headset_le_bond_cb));
+
+    headset_le_bond_cb.stats.accept_list_size = wiced_bt_ble_get_filter_accept_list_size();
+
+    for (i = 0; i < HEADSET_LE_BOND_MAX; i++)
+    {
+        p_bond = &headset_le_bond_cb.bond[i];
+
+        nb_bytes = wiced_hal_read_nvram(HEADSET_NVRAM_ID_LE_BOND + i,
+                                        sizeof(headset_le_bond_nvram_t),
+                                        (uint8_t *)&p_bond->nvram,
+                                        &result);
+
+        if ((result != WICED_BT_SUCCESS) || (nb_bytes != sizeof(headset_le_bond_nvram_t)))
+        {
+            continue;
+        }
+
+        p_bond->in_use = WICED_TRUE;
+        if (p_bond->nvram.sequence > headset_le_bond_cb.sequence)
+        {
+            headset_le_bond_cb.sequence = p_bond->nvram.sequence;
+        }
+
+        headset_le_bond_lists_add(p_bond);
+    }
+
+    headset_le_bond_cb.stats.bonds = headset_le_bond_count();
+    headset_le_bond_adv_policy_update();
+
+    WICED_BT_TRACE("LE bonds: %d, Filter Accept List size: %d\n",
+                   headset_le_bond_cb.stats.bonds,
+                   headset_le_bond_cb.stats.accept_list_size);
+
+    headset_event_subscribe(HEADSET_EVENT_MASK_LE, &headset_le_bond_event_handler);
+}
+
+/*
+ * headset_le_bond_keys_update
+ *
+ * Handle BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT: keep the bonds which have
+ * LE keys, the oldest bond is replaced when the table is full.
+ */
+void headset_le_bond_keys_update(const wiced_bt_device_link_keys_t *p_keys)
+{
+    headset_le_bond_t *p_bond;
+    uint8_t            index;
+    uint8_t            i;
+
+    if (p_keys->key_data.le_keys_available_mask == 0)
+    {
+        return;
+    }
+
+    p_bond = headset_le_bond_find(p_keys->bd_addr);
+
+    if (p_bond == NULL)
+    {
+        p_bond = &headset_le_bond_cb.bond[0];
+
+        for (i = 0; i < HEADSET_LE_BOND_MAX; i++)
+        {
+            if (!headset_le_bond_cb.bond[i].in_use)
+            {
+                p_bond = &headset_le_bond_cb.bond[i];
+                break;
+            }
+
+            if (headset_le_bond_cb.bond[i].nvram.sequence < p_bond->nvram.sequence)
+            {
+                p_bond = &headset_le_bond_cb.bond[i];
+            }
+        }
+    }
+    else if (memcmp((void *)&p_bond->nvram.keys, (void *)p_keys, sizeof(wiced_bt_device_link_keys_t)) == 0)
+    {
+        return;
+    }
+
+    if (p_bond->in_use)
+    {
+        headset_le_bond_lists_remove(p_bond);
+    }
+
+    memcpy((void *)&p_bond->nvram.keys, (void *)p_keys, sizeof(wiced_bt_device_link_keys_t));
+    p_bond->nvram.sequence = ++headset_le_bond_cb.sequence;
+    p_bond->disconnected_ms = 0;
+    p_bond->in_use = WICED_TRUE;
+
+    headset_le_bond_lists_add(p_bond);
+
+    headset_le_bond_cb.stats.bonds = headset_le_bond_count();
+    headset_le_bond_adv_policy_update();
+
+    index = (uint8_t)(p_bond - headset_le_bond_cb.bond);
+    if (!headset_work_post(HEADSET_WORK_PRIORITY_BACKGROUND,
+                           &headset_le_bond_nvram_write_work,
+                           &index,
+                           sizeof(index)))
+    {
+        headset_le_bond_nvram_write_work(&index, sizeof(index));
+    }
+}
+
+/*
+ * __wrap_wiced_bt_dev_delete_bonded_device
+ *
+ * The bt_hs_spk library deletes a bond (unpair, reset of the paired device
+ * list): the entry of the peer is removed as well.
+ */
+wiced_result_t __wrap_wiced_bt_dev_delete_bonded_device(wiced_bt_device_address_t bd_addr)
+{
+    headset_le_bond_t *p_bond = headset_le_bond_find(bd_addr);
+
+    if (p_bond != NULL)
+    {
+        headset_le_bond_release(p_bond);
+    }
+
+    return __real_wiced_bt_dev_delete_bonded_device(bd_addr);
+}
+
+/*
+ * headset_le_bond_adv_state
+ *
+ * Handle BTM_BLE_ADVERT_STATE_CHANGED_EVT: restore the normal advertising
+ * when the directed advertising ends without a connection.
+ */
+void headset_le_bond_adv_state(wiced_bt_ble_advert_mode_t mode)
+{
+    if (!headset_le_bond_cb.directed || (mode != BTM_BLE_ADVERT_OFF))
+    {
+        return;
+    }
+
+    headset_le_bond_cb.directed = WICED_FALSE;
+
+#ifdef FASTPAIR_ENABLE
+    wiced_bt_gfps_provider_discoverablility_set(headset_le_bond_cb.discoverable);
+#endif
+}
+
+/*
+ * headset_le_bond_stats_get
+ */
+void headset_le_bond_stats_get(headset_le_bond_stats_t *p_stats)
+{
+    memcpy((void *)p_stats, (void *)&headset_le_bond_cb.stats, sizeof(headset_le_bond_stats_t));
+}
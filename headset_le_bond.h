@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Bonded LE peers in the controller Filter Accept List and resolving list.
+ *
+ * The identity and keys of every LE bond are kept in NVRAM, one entry per
+ * bond, and loaded into the controller resolving list and Filter Accept
+ * List at start up and when a bond is created or updated. The controller
+ * then resolves the RPA of the bonded peers itself, the host no longer
+ * resolves the addresses of every advertising or connection event.
+ *
+ * When a bonded peer is lost (supervision timeout), the headset sends high
+ * duty directed advertising to it (HEADSET_LE_DIRECTED_ADV) and restores
+ * its normal advertising when the directed advertising ends. Without Fast
+ * Pair, a headset which is not discoverable only accepts the connection and
+ * scan requests of the Filter Accept List; Fast Pair seekers are not bonded
+ * over LE, so the filter is not used with Fast Pair.
+ *
+ * The bt_hs_spk link key store stays the reference of the bonded devices:
+ * a bond deleted by the library (wiced_bt_dev_delete_bonded_device() is
+ * wrapped) is removed from the lists and from NVRAM.
+ *
+ * The reconnection time of the bonded peers (disconnection to connection)
+ * and the connections of peers which are not bonded are counted.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "headset_nvram.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_LE_BOND_MAX             HEADSET_NVRAM_LE_BOND_NUM
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint8_t  bonds;             /* LE bonds loaded in the controller lists */
+    uint8_t  accept_list_size;  /* Filter Accept List capacity of the controller */
+    uint16_t directed_adv;      /* directed advertising started */
+    uint16_t reconnects;        /* bonded peer connected again after a disconnection */
+    uint16_t unknown_peers;     /* connections of peers which are not bonded */
+    uint32_t last_ms;           /* disconnection to reconnection */
+    uint32_t max_ms;
+    uint32_t total_ms;
+} headset_le_bond_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void headset_le_bond_init(void);
+void headset_le_bond_keys_update(const wiced_bt_device_link_keys_t *p_keys);
+void headset_le_bond_adv_state(wiced_bt_ble_advert_mode_t mode);
+void headset_le_bond_stats_get(headset_le_bond_stats_t *p_stats);
@@ -0,0 +1,493 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * LE L2CAP connection-oriented channel bulk data service, see
+ * headset_le_coc.h.
+ */
+#ifdef HEADSET_LE_COC
+
+#include "wiced.h"
+#include "wiced_app_cfg.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_l2c.h"
+#include "wiced_bt_trace.h"
+#include "headset_bulk.h"
+#include "headset_event.h"
+#include "headset_le_coc.h"
+#include "headset_timer.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#if HEADSET_LE_COC_MTU > WICED_APP_CFG_MAX_RX_MTU
+#error "HEADSET_LE_COC_MTU exceeds the L2CAP MTU of the application channels"
+#endif
+
+/* Connection response result, Core specification Vol 3 Part A 4.23 */
+#define HEADSET_LE_COC_RESULT_INSUFFICIENT_ENCRYPTION   0x0008
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bool_t              in_use;
+    wiced_bt_device_address_t bd_addr;
+} headset_le_coc_link_t;
+
+typedef struct
+{
+    headset_le_coc_link_t  encrypted[HEADSET_LE_COC_LINK_MAX];
+    uint16_t               lcid;                /* 0 if no channel */
+    wiced_bool_t           congested;
+    uint16_t               sdu_len;             /* SDU size sent to the peer */
+
+    headset_bulk_t         bulk;
+
+    /* GATT sink */
+    uint32_t               gatt_bytes;
+    uint32_t               gatt_start_ms;
+    uint32_t               gatt_last_ms;
+
+    headset_le_coc_stats_t stats;
+    uint8_t                tx_buffer[HEADSET_LE_COC_MTU];
+} headset_le_coc_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_le_coc_cb_t headset_le_coc_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_le_coc_sdu_len
+ *
+ * Largest SDU, within the MTU of the peer, which fills whole PDUs.
+ */
+static uint16_t headset_le_coc_sdu_len(uint16_t mtu_peer)
+{
+    uint16_t len = mtu_peer < sizeof(headset_le_coc_cb.tx_buffer) ? mtu_peer : sizeof(headset_le_coc_cb.tx_buffer);
+    uint16_t pdus = (len + HEADSET_LE_COC_SDU_LEN_FIELD) / HEADSET_LE_COC_MPS;
+
+    return pdus ? (pdus * HEADSET_LE_COC_MPS - HEADSET_LE_COC_SDU_LEN_FIELD) : len;
+}
+
+/*
+ * headset_le_coc_tx_pump
+ *
+ * Write tx_buffer, one SDU of at most sdu_len bytes at a time, until the
+ * channel is congested. The congestion status callback calls back once it
+ * can take more.
+ */
+static void headset_le_coc_tx_pump(void)
+{
+    headset_bulk_t *p_bulk = &headset_le_coc_cb.bulk;
+    uint16_t        len;
+    uint8_t         result;
+
+    while (headset_le_coc_cb.lcid && p_bulk->tx_busy && !headset_le_coc_cb.congested)
+    {
+        len = p_bulk->tx_len - p_bulk->tx_offset;
+        len = len < headset_le_coc_cb.sdu_len ? len : headset_le_coc_cb.sdu_len;
+
+        result = wiced_bt_l2cap_le_data_write(headset_le_coc_cb.lcid,
+                                              &headset_le_coc_cb.tx_buffer[p_bulk->tx_offset],
+                                              len,
+                                              0);
+
+        if (result == L2CAP_DATAWRITE_FAILED)
+        {
+            WICED_BT_TRACE("LE CoC: write fail, cid 0x%x\n", headset_le_coc_cb.lcid);
+            p_bulk->tx_busy = WICED_FALSE;
+            break;
+        }
+
+        /* A congested write has been queued, wait for the channel to drain. */
+        p_bulk->tx_offset                += len;
+        headset_le_coc_cb.stats.tx_bytes += len;
+
+        if (result == L2CAP_DATAWRITE_CONGESTED)
+        {
+            headset_le_coc_cb.congested = WICED_TRUE;
+            headset_le_coc_cb.stats.congested++;
+        }
+
+        /* The stack holds a copy, tx_buffer can be refilled. The response
+         * ends with its last write, the peer may send the next request. */
+        if ((p_bulk->tx_offset == p_bulk->tx_len) && !headset_bulk_tx_next(p_bulk))
+        {
+            p_bulk->tx_busy = WICED_FALSE;
+        }
+    }
+}
+
+/*
+ * headset_le_coc_rsp_start
+ *
+ * Send the response prepared in tx_buffer.
+ */
+static void headset_le_coc_rsp_start(void)
+{
+    headset_le_coc_cb.bulk.tx_busy = WICED_TRUE;
+
+    headset_le_coc_tx_pump();
+}
+
+/*
+ * headset_le_coc_data_ind
+ *
+ * Each SDU starts with a request, except the HEADSET_BULK_OP_BENCH_RX data.
+ */
+static void headset_le_coc_data_ind(void *context, uint16_t local_cid, uint8_t *p_buff, uint16_t buf_len)
+{
+    uint8_t param_len;
+
+    headset_le_coc_cb.stats.rx_bytes += buf_len;
+
+    if (headset_bulk_sink(&headset_le_coc_cb.bulk, buf_len))
+    {
+        return;
+    }
+
+    if (headset_le_coc_cb.bulk.tx_busy)
+    {
+        /* The peer shall wait for the response. */
+        WICED_BT_TRACE("LE CoC: %d bytes received during a response, dropped\n", buf_len);
+        return;
+    }
+
+    if (buf_len < 2)
+    {
+        return;
+    }
+
+    param_len = p_buff[1];
+
+    if ((param_len > HEADSET_BULK_PARAM_MAX) || (2 + param_len > buf_len))
+    {
+        headset_bulk_rsp_header(&headset_le_coc_cb.bulk, p_buff[0], HEADSET_BULK_STATUS_INVALID_PARAM, 0);
+        headset_le_coc_rsp_start();
+        return;
+    }
+
+    headset_bulk_request(&headset_le_coc_cb.bulk, p_buff[0], &p_buff[2], param_len);
+}
+
+/*
+ * headset_le_coc_is_encrypted
+ */
+static wiced_bool_t headset_le_coc_is_encrypted(const wiced_bt_device_address_t bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_LE_COC_LINK_MAX; i++)
+    {
+        if (headset_le_coc_cb.encrypted[i].in_use &&
+            (memcmp((void *)headset_le_coc_cb.encrypted[i].bd_addr, (void *)bd_addr, BD_ADDR_LEN) == 0))
+        {
+            return WICED_TRUE;
+        }
+    }
+
+    return WICED_FALSE;
+}
+
+/*
+ * headset_le_coc_connect_ind
+ *
+ * Accept one channel at a time, over an encrypted link only: the statistics
+ * and the timelines hold peer addresses.
+ */
+static void headset_le_coc_connect_ind(void *context, wiced_bt_device_address_t bd_addr, uint16_t local_cid,
+                                       uint16_t psm, uint8_t id, uint16_t mtu_peer)
+{
+    wiced_bt_l2cap_le_cfg_info_t cfg = { 0 };
+
+    WICED_BT_TRACE("LE CoC: connect %B cid 0x%x mtu %d\n", bd_addr, local_cid, mtu_peer);
+
+    cfg.mtu     = HEADSET_LE_COC_MTU;
+    cfg.mps     = HEADSET_LE_COC_MPS;
+    cfg.credits = HEADSET_LE_COC_CREDITS;
+
+    if (!headset_le_coc_is_encrypted(bd_addr))
+    {
+        wiced_bt_l2cap_le_connect_rsp(bd_addr, id, local_cid, HEADSET_LE_COC_RESULT_INSUFFICIENT_ENCRYPTION, 0, &cfg);
+        return;
+    }
+
+    if (headset_le_coc_cb.lcid)
+    {
+        wiced_bt_l2cap_le_connect_rsp(bd_addr, id, local_cid, L2CAP_LE_RESULT_NO_RESOURCES, 0, &cfg);
+        return;
+    }
+
+    if (!wiced_bt_l2cap_le_connect_rsp(bd_addr, id, local_cid, L2CAP_LE_RESULT_CONN_OK, 0, &cfg))
+    {
+        return;
+    }
+
+    /* Full size LE data PDUs for the SDUs. */
+    wiced_bt_ble_set_data_packet_length(bd_addr, HEADSET_LE_COC_LL_OCTETS, HEADSET_LE_COC_LL_TIME_US);
+
+    headset_le_coc_cb.lcid            = local_cid;
+    headset_le_coc_cb.congested       = WICED_FALSE;
+    headset_le_coc_cb.sdu_len         = headset_le_coc_sdu_len(mtu_peer);
+
+    headset_bulk_reset(&headset_le_coc_cb.bulk);
+    headset_le_coc_cb.bulk.frame_len  = headset_le_coc_cb.sdu_len;
+
+    headset_le_coc_cb.stats.connected = WICED_TRUE;
+    headset_le_coc_cb.stats.sdu_len   = headset_le_coc_cb.sdu_len;
+    headset_le_coc_cb.stats.connections++;
+}
+
+/*
+ * headset_le_coc_connect_cfm
+ *
+ * The headset does not open channels.
+ */
+static void headset_le_coc_connect_cfm(void *context, uint16_t local_cid, uint16_t result, uint16_t mtu_peer)
+{
+}
+
+/*
+ * headset_le_coc_closed
+ */
+static void headset_le_coc_closed(uint16_t local_cid)
+{
+    if (local_cid != headset_le_coc_cb.lcid)
+    {
+        return;
+    }
+
+    headset_le_coc_cb.lcid            = 0;
+    headset_le_coc_cb.bulk.tx_busy    = WICED_FALSE;
+    headset_le_coc_cb.stats.connected = WICED_FALSE;
+}
+
+/*
+ * headset_le_coc_disconnect_ind
+ */
+static void headset_le_coc_disconnect_ind(void *context, uint16_t local_cid, wiced_bool_t ack)
+{
+    WICED_BT_TRACE("LE CoC: disconnect cid 0x%x\n", local_cid);
+
+    if (ack)
+    {
+        wiced_bt_l2cap_le_disconnect_rsp(local_cid);
+    }
+
+    headset_le_coc_closed(local_cid);
+}
+
+/*
+ * headset_le_coc_disconnect_cfm
+ */
+static void headset_le_coc_disconnect_cfm(void *context, uint16_t local_cid, uint16_t result)
+{
+    headset_le_coc_closed(local_cid);
+}
+
+/*
+ * headset_le_coc_congestion_status
+ */
+static void headset_le_coc_congestion_status(void *context, uint16_t local_cid, wiced_bool_t congested)
+{
+    if (local_cid != headset_le_coc_cb.lcid)
+    {
+        return;
+    }
+
+    headset_le_coc_cb.congested = congested;
+
+    headset_le_coc_tx_pump();
+}
+
+/*
+ * headset_le_coc_tx_complete
+ */
+static void headset_le_coc_tx_complete(void *context, uint16_t local_cid, uint16_t buf_count)
+{
+    if (local_cid == headset_le_coc_cb.lcid)
+    {
+        headset_le_coc_tx_pump();
+    }
+}
+
+/*
+ * headset_le_coc_event_handler
+ */
+static void headset_le_coc_event_handler(const headset_event_data_t *p_data)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_LE_COC_LINK_MAX; i++)
+    {
+        if (headset_le_coc_cb.encrypted[i].in_use &&
+            (memcmp((void *)headset_le_coc_cb.encrypted[i].bd_addr, (void *)p_data->bd_addr, BD_ADDR_LEN) == 0))
+        {
+            headset_le_coc_cb.encrypted[i].in_use = WICED_FALSE;
+        }
+    }
+}
+
+/*
+ * headset_le_coc_encryption_status
+ *
+ * BTM_ENCRYPTION_STATUS_EVT, a channel is only accepted from an encrypted
+ * LE peer.
+ */
+void headset_le_coc_encryption_status(const wiced_bt_device_address_t bd_addr, uint8_t transport, wiced_result_t result)
+{
+    headset_le_coc_link_t *p_free = NULL;
+    uint8_t                i;
+
+    if ((transport != BT_TRANSPORT_LE) || (result != WICED_SUCCESS))
+    {
+        return;
+    }
+
+    for (i = 0; i < HEADSET_LE_COC_LINK_MAX; i++)
+    {
+        if (!headset_le_coc_cb.encrypted[i].in_use)
+        {
+            p_free = p_free ? p_free : &headset_le_coc_cb.encrypted[i];
+        }
+        else if (memcmp((void *)headset_le_coc_cb.encrypted[i].bd_addr, (void *)bd_addr, BD_ADDR_LEN) == 0)
+        {
+            return;
+        }
+    }
+
+    if (p_free)
+    {
+        p_free->in_use = WICED_TRUE;
+        memcpy((void *)p_free->bd_addr, (void *)bd_addr, BD_ADDR_LEN);
+    }
+}
+
+/*
+ * headset_le_coc_init
+ */
+void headset_le_coc_init(void)
+{
+    static wiced_bt_l2cap_le_appl_information_t appl_info =
+    {
+        .le_connect_ind_cb       = &headset_le_coc_connect_ind,
+        .le_connect_cfm_cb       = &headset_le_coc_connect_cfm,
+        .le_disconnect_ind_cb    = &headset_le_coc_disconnect_ind,
+        .le_disconnect_cfm_cb    = &headset_le_coc_disconnect_cfm,
+        .le_data_ind_cb          = &headset_le_coc_data_ind,
+        .le_congestion_status_cb = &headset_le_coc_congestion_status,
+        .le_tx_complete_cb       = &headset_le_coc_tx_complete,
+    };
+
+    /* No channel survives a warm restart, the disconnection callbacks are
+     * not called when the stack is shut down. */
+    memset((void *)&headset_le_coc_cb, 0, sizeof(headset_le_coc_cb));
+
+    headset_le_coc_cb.bulk.p_buffer    = headset_le_coc_cb.tx_buffer;
+    headset_le_coc_cb.bulk.buffer_size = sizeof(headset_le_coc_cb.tx_buffer);
+    headset_le_coc_cb.bulk.p_rsp_start = &headset_le_coc_rsp_start;
+
+    if (wiced_bt_l2cap_le_register(HEADSET_LE_COC_PSM, &appl_info, NULL) == 0)
+    {
+        WICED_BT_TRACE("LE CoC: register PSM 0x%x fail\n", HEADSET_LE_COC_PSM);
+    }
+
+    headset_le_coc_cb.gatt_start_ms = headset_timer_now_ms();
+    headset_le_coc_cb.gatt_last_ms  = headset_le_coc_cb.gatt_start_ms;
+
+    headset_event_subscribe(HEADSET_EVENT_MASK(HEADSET_EVENT_LE_DISCONNECTED), &headset_le_coc_event_handler);
+}
+
+/*
+ * headset_le_coc_gatt_sink_write
+ *
+ * Data written to the GATT sink characteristic.
+ */
+void headset_le_coc_gatt_sink_write(uint16_t len)
+{
+    headset_le_coc_cb.gatt_bytes       += len;
+    headset_le_coc_cb.gatt_last_ms      = headset_timer_now_ms();
+    headset_le_coc_cb.stats.gatt_bytes += len;
+}
+
+/*
+ * headset_le_coc_gatt_sink_read
+ *
+ * Value of the GATT sink characteristic, the bytes and the time of the run
+ * since the previous read. Start a new run.
+ */
+uint16_t headset_le_coc_gatt_sink_read(uint8_t *p_data, uint16_t max_len)
+{
+    uint32_t duration = 0;
+    uint8_t *p = p_data;
+
+    if (max_len < HEADSET_LE_COC_GATT_SINK_LEN)
+    {
+        return 0;
+    }
+
+    if (headset_le_coc_cb.gatt_bytes)
+    {
+        duration = headset_le_coc_cb.gatt_last_ms - headset_le_coc_cb.gatt_start_ms;
+
+        headset_le_coc_cb.stats.gatt_kbps = duration ? (uint32_t)(((uint64_t)headset_le_coc_cb.gatt_bytes * 8) / duration) : 0;
+    }
+
+    UINT32_TO_STREAM(p, headset_le_coc_cb.gatt_bytes);
+    UINT32_TO_STREAM(p, duration);
+
+    headset_le_coc_cb.gatt_bytes    = 0;
+    headset_le_coc_cb.gatt_start_ms = headset_timer_now_ms();
+    headset_le_coc_cb.gatt_last_ms  = headset_le_coc_cb.gatt_start_ms;
+
+    return HEADSET_LE_COC_GATT_SINK_LEN;
+}
+
+/*
+ * headset_le_coc_stats_get
+ */
+void headset_le_coc_stats_get(headset_le_coc_stats_t *p_stats)
+{
+    *p_stats            = headset_le_coc_cb.stats;
+    p_stats->bench_kbps = headset_le_coc_cb.bulk.bench_kbps;
+}
+
+#endif /* HEADSET_LE_COC */
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * LE L2CAP connection-oriented channel bulk data service.
+ *
+ * An LE credit based channel server on HEADSET_LE_COC_PSM serves the
+ * bulk data requests (headset_bulk.h) to an LE peer:
+ * HEADSET_BULK_OP_STATS, HEADSET_BULK_OP_TIMELINE, HEADSET_BULK_OP_BENCH_TX
+ * and HEADSET_BULK_OP_BENCH_RX, as the SPP service does. The NVRAM backup
+ * stays on the SPP service. Unlike GATT, the data carries no
+ * ATT header and no attribute handle lookup:
+ * - Every SDU the headset sends fills whole LE data PDUs. An LE data PDU of
+ *   HEADSET_LE_COC_LL_OCTETS carries HEADSET_LE_COC_MPS bytes of K-frame
+ *   payload and the first K-frame of an SDU starts with the SDU length, an
+ *   SDU of n * HEADSET_LE_COC_MPS - 2 bytes leaves no partial PDU. The LE
+ *   data length of the link is raised when the channel opens.
+ * - The peer is given HEADSET_LE_COC_CREDITS credits when the channel opens,
+ *   the stack returns them as the SDUs are received.
+ * - The headset writes until the channel is congested and resumes on the
+ *   congestion status and TX complete callbacks.
+ * A channel is only accepted over an encrypted link, the statistics and the
+ * timelines hold peer addresses.
+ *
+ * The GATT sink characteristic of the application service is the GATT write
+ * without response counterpart of HEADSET_BULK_OP_BENCH_RX: a read returns
+ * | BYTES (4) | MS (4) |, the bytes written to it since the previous read
+ * and the time from that read to the last write, then starts a new run.
+ * Its writes skip the trace and the request timing of the other GATT
+ * requests, the ATT data path is measured alone.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "headset_bulk.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#ifndef HEADSET_LE_COC_PSM
+#define HEADSET_LE_COC_PSM              0x0081  /* dynamic LE PSM range 0x0080 - 0x00FF */
+#endif
+
+#ifndef HEADSET_LE_COC_CREDITS
+#define HEADSET_LE_COC_CREDITS          8       /* initial credits of the peer, in K-frames */
+#endif
+
+#define HEADSET_LE_COC_LL_OCTETS        251     /* LE data length extension maximum */
+#define HEADSET_LE_COC_LL_TIME_US       2120    /* 251 octets on the LE 1M PHY */
+#define HEADSET_LE_COC_L2CAP_HEADER     4
+#define HEADSET_LE_COC_MPS              (HEADSET_LE_COC_LL_OCTETS - HEADSET_LE_COC_L2CAP_HEADER)
+#define HEADSET_LE_COC_SDU_LEN_FIELD    2
+
+/* Four full PDUs per SDU, within the L2CAP MTU of the application channels */
+#define HEADSET_LE_COC_MTU              (4 * HEADSET_LE_COC_MPS - HEADSET_LE_COC_SDU_LEN_FIELD)
+
+#define HEADSET_LE_COC_GATT_SINK_LEN    8
+
+#define HEADSET_LE_COC_LINK_MAX         1       /* ble_max_simultaneous_links */
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint8_t  connected;
+    uint16_t connections;
+    uint16_t congested;         /* writes stopped by channel congestion */
+    uint16_t sdu_len;           /* SDU size sent on the current channel */
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;
+    uint32_t bench_kbps;        /* last L2CAP benchmark, as seen by the headset */
+    uint32_t gatt_bytes;        /* bytes written to the GATT sink */
+    uint32_t gatt_kbps;         /* last GATT sink run, as seen by the headset */
+} headset_le_coc_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void     headset_le_coc_init(void);
+void     headset_le_coc_encryption_status(const wiced_bt_device_address_t bd_addr, uint8_t transport, wiced_result_t result);
+void     headset_le_coc_gatt_sink_write(uint16_t len);
+uint16_t headset_le_coc_gatt_sink_read(uint8_t *p_data, uint16_t max_len);
+void     headset_le_coc_stats_get(headset_le_coc_stats_t *p_stats);
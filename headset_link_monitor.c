@@ -0,0 +1,365 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application ACL link quality monitor.
+ */
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_trace.h"
+#include "headset_event.h"
+#include "headset_timer.h"
+#include "headset_link_monitor.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_LINK_MONITOR_TIMER_WINDOW_MS    150
+#define HEADSET_LINK_MONITOR_AVG_SHIFT          2       /* average weight of a new sample: 1/4 */
+
+/* HCI ACL packet types. */
+#define HEADSET_LINK_MONITOR_PKT_NO_2_DH1       0x0002
+#define HEADSET_LINK_MONITOR_PKT_NO_3_DH1       0x0004
+#define HEADSET_LINK_MONITOR_PKT_DM1            0x0008
+#define HEADSET_LINK_MONITOR_PKT_DH1            0x0010
+#define HEADSET_LINK_MONITOR_PKT_NO_2_DH3       0x0100
+#define HEADSET_LINK_MONITOR_PKT_NO_3_DH3       0x0200
+#define HEADSET_LINK_MONITOR_PKT_DM3            0x0400
+#define HEADSET_LINK_MONITOR_PKT_DH3            0x0800
+#define HEADSET_LINK_MONITOR_PKT_NO_2_DH5       0x1000
+#define HEADSET_LINK_MONITOR_PKT_NO_3_DH5       0x2000
+#define HEADSET_LINK_MONITOR_PKT_DM5            0x4000
+#define HEADSET_LINK_MONITOR_PKT_DH5            0x8000
+
+#define HEADSET_LINK_MONITOR_PKT_EDR_3M         (HEADSET_LINK_MONITOR_PKT_DM1 | HEADSET_LINK_MONITOR_PKT_DH1 | \
+                                                 HEADSET_LINK_MONITOR_PKT_DM3 | HEADSET_LINK_MONITOR_PKT_DH3 | \
+                                                 HEADSET_LINK_MONITOR_PKT_DM5 | HEADSET_LINK_MONITOR_PKT_DH5)
+
+#define HEADSET_LINK_MONITOR_PKT_EDR_2M         (HEADSET_LINK_MONITOR_PKT_EDR_3M | \
+                                                 HEADSET_LINK_MONITOR_PKT_NO_3_DH1 | \
+                                                 HEADSET_LINK_MONITOR_PKT_NO_3_DH3 | \
+                                                 HEADSET_LINK_MONITOR_PKT_NO_3_DH5)
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bool_t              in_use;
+    wiced_bt_device_address_t bd_addr;
+    int16_t                   rssi_avg;     /* scaled by 2^HEADSET_LINK_MONITOR_AVG_SHIFT */
+    int8_t                    rssi;
+    wiced_bool_t              edr_3m;
+    uint8_t                   count;        /* consecutive samples on the other side of the threshold */
+    uint16_t                  switches;
+    uint32_t                  samples;
+} headset_link_monitor_link_t;
+
+typedef struct
+{
+    headset_link_monitor_link_t link[HEADSET_LINK_MONITOR_LINK_MAX];
+    headset_timer_t             timer;
+    uint8_t                     next;           /* next link to sample */
+    wiced_bool_t                read_pending;
+} headset_link_monitor_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+/* Not exposed by wiced_bt_dev.h. */
+extern uint8_t BTM_SetPacketTypes(uint8_t *remote_bda, uint16_t pkt_types);
+
+static headset_link_monitor_cb_t headset_link_monitor_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_link_monitor_link_find
+ */
+static headset_link_monitor_link_t *headset_link_monitor_link_find(const uint8_t *p_bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_LINK_MONITOR_LINK_MAX; i++)
+    {
+        if ((headset_link_monitor_cb.link[i].in_use) &&
+            (memcmp((void *)headset_link_monitor_cb.link[i].bd_addr, (void *)p_bd_addr, sizeof(wiced_bt_device_address_t)) == 0))
+        {
+            return &headset_link_monitor_cb.link[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_link_monitor_packet_types_set
+ */
+static void headset_link_monitor_packet_types_set(headset_link_monitor_link_t *p_link, wiced_bool_t edr_3m)
+{
+    uint8_t status;
+
+    status = BTM_SetPacketTypes(p_link->bd_addr,
+                                edr_3m ? HEADSET_LINK_MONITOR_PKT_EDR_3M : HEADSET_LINK_MONITOR_PKT_EDR_2M);
+
+    WICED_BT_TRACE("headset_link_monitor %B avg rssi %d, %s EDR 3M packets (status: %d)\n",
+                   p_link->bd_addr,
+                   p_link->rssi_avg >> HEADSET_LINK_MONITOR_AVG_SHIFT,
+                   edr_3m ? "enable" : "disable",
+                   status);
+
+    p_link->edr_3m = edr_3m;
+    p_link->count  = 0;
+    p_link->switches++;
+}
+
+/*
+ * headset_link_monitor_rssi_dbm
+ *
+ * Convert the RSSI relative to the golden receive power range to dBm.
+ */
+static int8_t headset_link_monitor_rssi_dbm(int8_t rssi)
+{
+    if (rssi > 0)
+    {
+        return HEADSET_LINK_MONITOR_GOLDEN_RANGE_HIGH + rssi;
+    }
+
+    return HEADSET_LINK_MONITOR_GOLDEN_RANGE_LOW + rssi;
+}
+
+/*
+ * headset_link_monitor_rssi_callback
+ */
+static void headset_link_monitor_rssi_callback(void *p_data)
+{
+    wiced_bt_dev_rssi_result_t  *p_result = (wiced_bt_dev_rssi_result_t *)p_data;
+    headset_link_monitor_link_t *p_link;
+    int8_t                       rssi;
+    int8_t                       rssi_avg;
+
+    headset_link_monitor_cb.read_pending = WICED_FALSE;
+
+    if (p_result->status != WICED_BT_SUCCESS)
+    {
+        return;
+    }
+
+    p_link = headset_link_monitor_link_find(p_result->rem_bda);
+
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    rssi = headset_link_monitor_rssi_dbm(p_result->rssi);
+
+    /* Exponential moving average. */
+    if (p_link->samples == 0)
+    {
+        p_link->rssi_avg = rssi << HEADSET_LINK_MONITOR_AVG_SHIFT;
+    }
+    else
+    {
+        p_link->rssi_avg += rssi - (p_link->rssi_avg >> HEADSET_LINK_MONITOR_AVG_SHIFT);
+    }
+
+    p_link->rssi = rssi;
+    p_link->samples++;
+
+    rssi_avg = (int8_t)(p_link->rssi_avg >> HEADSET_LINK_MONITOR_AVG_SHIFT);
+
+    if (p_link->edr_3m)
+    {
+        p_link->count = (rssi_avg < HEADSET_LINK_MONITOR_3M_OFF_RSSI) ? p_link->count + 1 : 0;
+
+        if (p_link->count >= HEADSET_LINK_MONITOR_3M_OFF_COUNT)
+        {
+            headset_link_monitor_packet_types_set(p_link, WICED_FALSE);
+        }
+    }
+    else
+    {
+        p_link->count = (rssi_avg > HEADSET_LINK_MONITOR_3M_ON_RSSI) ? p_link->count + 1 : 0;
+
+        if (p_link->count >= HEADSET_LINK_MONITOR_3M_ON_COUNT)
+        {
+            headset_link_monitor_packet_types_set(p_link, WICED_TRUE);
+        }
+    }
+}
+
+/*
+ * headset_link_monitor_timeout
+ *
+ * Sample the next connected link.
+ */
+static void headset_link_monitor_timeout(uint32_t arg)
+{
+    headset_link_monitor_link_t *p_link;
+    uint8_t                      i;
+
+    /* Only one read in flight, a read still pending is given up after one period. */
+    if (headset_link_monitor_cb.read_pending)
+    {
+        headset_link_monitor_cb.read_pending = WICED_FALSE;
+        return;
+    }
+
+    for (i = 0; i < HEADSET_LINK_MONITOR_LINK_MAX; i++)
+    {
+        p_link = &headset_link_monitor_cb.link[headset_link_monitor_cb.next];
+
+        headset_link_monitor_cb.next = (headset_link_monitor_cb.next + 1) % HEADSET_LINK_MONITOR_LINK_MAX;
+
+        if (!p_link->in_use)
+        {
+            continue;
+        }
+
+        if (wiced_bt_dev_read_rssi(p_link->bd_addr,
+                                   BT_TRANSPORT_BR_EDR,
+                                   &headset_link_monitor_rssi_callback) == WICED_BT_PENDING)
+        {
+            headset_link_monitor_cb.read_pending = WICED_TRUE;
+        }
+        return;
+    }
+}
+
+/*
+ * headset_link_monitor_event_handler
+ */
+static void headset_link_monitor_event_handler(const headset_event_data_t *p_data)
+{
+    headset_link_monitor_link_t *p_link;
+    uint8_t                      i;
+
+    if (p_data->event == HEADSET_EVENT_BREDR_CONNECTED)
+    {
+        if (headset_link_monitor_link_find(p_data->bd_addr))
+        {
+            return;
+        }
+
+        for (i = 0; i < HEADSET_LINK_MONITOR_LINK_MAX; i++)
+        {
+            p_link = &headset_link_monitor_cb.link[i];
+
+            if (!p_link->in_use)
+            {
+                memset((void *)p_link, 0, sizeof(headset_link_monitor_link_t));
+                memcpy((void *)p_link->bd_addr, (void *)p_data->bd_addr, sizeof(wiced_bt_device_address_t));
+
+                /* acl3mbpsPacketSupport is set, new links start with all EDR packet types. */
+                p_link->in_use = WICED_TRUE;
+                p_link->edr_3m = WICED_TRUE;
+                break;
+            }
+        }
+
+        if (!headset_timer_is_running(&headset_link_monitor_cb.timer))
+        {
+            headset_timer_start_periodic(&headset_link_monitor_cb.timer,
+                                         HEADSET_LINK_MONITOR_PERIOD_MS,
+                                         HEADSET_LINK_MONITOR_TIMER_WINDOW_MS);
+        }
+    }
+    else if (p_data->event == HEADSET_EVENT_BREDR_DISCONNECTED)
+    {
+        p_link = headset_link_monitor_link_find(p_data->bd_addr);
+
+        if (p_link)
+        {
+            p_link->in_use = WICED_FALSE;
+        }
+
+        for (i = 0; i < HEADSET_LINK_MONITOR_LINK_MAX; i++)
+        {
+            if (headset_link_monitor_cb.link[i].in_use)
+            {
+                return;
+            }
+        }
+
+        headset_timer_stop(&headset_link_monitor_cb.timer);
+    }
+}
+
+/*
+ * headset_link_monitor_init
+ */
+void headset_link_monitor_init(void)
+{
+    memset((void *)&headset_link_monitor_cb, 0, sizeof(headset_link_monitor_cb));
+
+    headset_timer_setup(&headset_link_monitor_cb.timer, &headset_link_monitor_timeout, 0);
+
+    headset_event_subscribe(HEADSET_EVENT_MASK_BREDR, &headset_link_monitor_event_handler);
+}
+
+/*
+ * headset_link_monitor_stats_get
+ *
+ * Fill the statistics of the connected links, return the number of links.
+ */
+uint8_t headset_link_monitor_stats_get(headset_link_monitor_stats_t *p_stats, uint8_t max)
+{
+    headset_link_monitor_link_t *p_link;
+    uint8_t                      i;
+    uint8_t                      num = 0;
+
+    for (i = 0; (i < HEADSET_LINK_MONITOR_LINK_MAX) && (num < max); i++)
+    {
+        p_link = &headset_link_monitor_cb.link[i];
+
+        if (!p_link->in_use)
+        {
+            continue;
+        }
+
+        memcpy((void *)p_stats[num].bd_addr, (void *)p_link->bd_addr, sizeof(wiced_bt_device_address_t));
+        p_stats[num].rssi     = p_link->rssi;
+        p_stats[num].rssi_avg = (int8_t)(p_link->rssi_avg >> HEADSET_LINK_MONITOR_AVG_SHIFT);
+        p_stats[num].edr_3m   = p_link->edr_3m;
+        p_stats[num].switches = p_link->switches;
+        p_stats[num].samples  = p_link->samples;
+
+        num++;
+    }
+
+    return num;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application ACL link quality monitor.
+ *
+ * The RSSI of every BR/EDR link is sampled periodically (one link per timer
+ * tick), converted to dBm and averaged. When the average drops below a threshold the 3 Mbps EDR
+ * packet types are disabled on the link, since 2-DH5 retransmits less than
+ * 3-DH5 in poor conditions; they are enabled again once the average has
+ * stayed above a higher threshold for a while.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_LINK_MONITOR_LINK_MAX           2       /* br_max_simultaneous_links */
+#define HEADSET_LINK_MONITOR_PERIOD_MS          1000    /* one link sampled per period */
+
+/*
+ * The controller reports the BR/EDR RSSI relative to its golden receive power
+ * range: 0 inside the range, the distance in dB below the lower limit or above
+ * the upper limit otherwise. The limits convert it to dBm, a reading inside the
+ * range counts as the lower limit. They depend on the controller.
+ */
+#ifndef HEADSET_LINK_MONITOR_GOLDEN_RANGE_LOW
+#define HEADSET_LINK_MONITOR_GOLDEN_RANGE_LOW   (-56)
+#endif
+#ifndef HEADSET_LINK_MONITOR_GOLDEN_RANGE_HIGH
+#define HEADSET_LINK_MONITOR_GOLDEN_RANGE_HIGH  (-36)
+#endif
+
+/* Hysteresis on the averaged RSSI (dBm), the ON threshold is below the golden range. */
+#define HEADSET_LINK_MONITOR_3M_OFF_RSSI        (-72)
+#define HEADSET_LINK_MONITOR_3M_ON_RSSI         (-62)
+#define HEADSET_LINK_MONITOR_3M_OFF_COUNT       3       /* consecutive samples below the threshold */
+#define HEADSET_LINK_MONITOR_3M_ON_COUNT        8       /* consecutive samples above the threshold */
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    int8_t                    rssi;         /* last sample, dBm */
+    int8_t                    rssi_avg;     /* dBm */
+    wiced_bool_t              edr_3m;       /* 3 Mbps packet types allowed */
+    uint16_t                  switches;     /* packet type changes */
+    uint32_t                  samples;
+} headset_link_monitor_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void    headset_link_monitor_init(void);
+uint8_t headset_link_monitor_stats_get(headset_link_monitor_stats_t *p_stats, uint8_t max);
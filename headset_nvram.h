@@ -35,9 +35,20 @@
 
 #include "wiced_hal_nvram.h"
 
+#define HEADSET_NVRAM_LE_BOND_NUM   4   /* LE bonds kept for the controller lists */
+#define HEADSET_NVRAM_GFPS_EXT_NUM  4   /* account key list chunks after the first one */
+
 enum
 {
     HEADSET_NVRAM_ID_LINK_KEYS = WICED_NVRAM_VSID_START,
     HEADSET_NVRAM_ID_LOCAL_IRK,
     HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY,
+    HEADSET_NVRAM_ID_LE_BOND,           /* one ID per LE bond, see headset_le_bond.h */
+    HEADSET_NVRAM_ID_LE_BOND_LAST = HEADSET_NVRAM_ID_LE_BOND + HEADSET_NVRAM_LE_BOND_NUM - 1,
+    HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT,  /* see headset_fastpair_keys.h */
+    HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_LAST = HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT + HEADSET_NVRAM_GFPS_EXT_NUM - 1,
+    HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_B,    /* second slot of each chunk */
+    HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_B_LAST = HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_B + HEADSET_NVRAM_GFPS_EXT_NUM - 1,
+    HEADSET_NVRAM_ID_TUNING,            /* see headset_tuning.h */
+    HEADSET_NVRAM_ID_END,               /* first ID not used by the application */
 };
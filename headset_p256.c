@@ -0,0 +1,583 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * NIST P-256 scalar multiplication, see headset_p256.h.
+ */
+#include "wiced.h"
+#include "headset_p256.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_P256_WINDOW_BITS    4
+#define HEADSET_P256_TABLE_SIZE     ((1 << HEADSET_P256_WINDOW_BITS) - 1)
+#define HEADSET_P256_COMB_SPACING   64      /* 256 bits / 4 teeth */
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef uint32_t headset_p256_fe_t[HEADSET_P256_WORDS];
+
+/* Jacobian point, coordinates in Montgomery form, Z = 0 for infinity. */
+typedef struct
+{
+    headset_p256_fe_t x;
+    headset_p256_fe_t y;
+    headset_p256_fe_t z;
+} headset_p256_jacobian_t;
+
+/* Affine point, coordinates in Montgomery form. */
+typedef struct
+{
+    headset_p256_fe_t x;
+    headset_p256_fe_t y;
+} headset_p256_affine_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+/* p = 2^256 - 2^224 + 2^192 + 2^96 - 1, -p^-1 mod 2^32 = 1 */
+static const headset_p256_fe_t headset_p256_p =
+{
+    0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0xffffffff
+};
+
+/* R^2 mod p, to convert into Montgomery form. */
+static const headset_p256_fe_t headset_p256_r2 =
+{
+    0x00000003, 0x00000000, 0xffffffff, 0xfffffffb, 0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004
+};
+
+/* R mod p, 1 in Montgomery form. */
+static const headset_p256_fe_t headset_p256_one =
+{
+    0x00000001, 0x00000000, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xfffffffe, 0x00000000
+};
+
+/* Generator, plain form. */
+static const headset_p256_fe_t headset_p256_gx =
+{
+    0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81, 0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2
+};
+
+static const headset_p256_fe_t headset_p256_gy =
+{
+    0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357, 0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2
+};
+
+/* Comb table: entry i - 1 is sum(2^(64 * j) * G) over the bits j set in i, Montgomery form. */
+static const headset_p256_affine_t headset_p256_comb[HEADSET_P256_TABLE_SIZE] =
+{
+    { { 0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc, 0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76 },
+      { 0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4, 0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18 } },
+    { { 0x16a0d2bb, 0x4f922fc5, 0x1a623499, 0x0d5cc16c, 0x57c62c8b, 0x9241cf3a, 0xfd1b667f, 0x2f5e6961 },
+      { 0xf5a01797, 0x5c15c70b, 0x60956192, 0x3d20b44d, 0x071fdb52, 0x04911b37, 0x8d6f0f7b, 0xf648f916 } },
+    { { 0xe137bbbc, 0x9e566847, 0x8a6a0bec, 0xe434469e, 0x79d73463, 0xb1c42761, 0x133d0015, 0x5abe0285 },
+      { 0xc04c7dab, 0x92aa837c, 0x43260c07, 0x573d9f4c, 0x78e6cc37, 0x0c931562, 0x6b6f7383, 0x94bb725b } },
+    { { 0xbfe20925, 0x62a8c244, 0x8fdce867, 0x91c19ac3, 0xdd387063, 0x5a96a5d5, 0x21d324f6, 0x61d587d4 },
+      { 0xa37173ea, 0xe87673a2, 0x53778b65, 0x23848008, 0x05bab43e, 0x10f8441e, 0x4621efbe, 0xfa11fe12 } },
+    { { 0x2cb19ffd, 0x1c891f2b, 0xb1923c23, 0x01ba8d5b, 0x8ac5ca8e, 0xb6d03d67, 0x1f13bedc, 0x586eb04c },
+      { 0x27e8ed09, 0x0c35c6e5, 0x1819ede2, 0x1e81a33c, 0x56c652fa, 0x278fd6c0, 0x70864f11, 0x19d5ac08 } },
+    { { 0xd2b533d5, 0x62577734, 0xa1bdddc0, 0x673b8af6, 0xa79ec293, 0x577e7c9a, 0xc3b266b1, 0xbb6de651 },
+      { 0xb65259b3, 0xe7e9303a, 0xd03a7480, 0xd6a0afd3, 0x9b3cfc27, 0xc5ac83d1, 0x5d18b99b, 0x60b4619a } },
+    { { 0x1ae5aa1c, 0xbd6a38e1, 0x49e73658, 0xb8b7652b, 0xee5f87ed, 0x0b130014, 0xaeebffcd, 0x9d0f27b2 },
+      { 0x7a730a55, 0xca924631, 0xddbbc83a, 0x9c955b2f, 0xac019a71, 0x07c1dfe0, 0x356ec48d, 0x244a566d } },
+    { { 0xf4f8b16a, 0x56f8410e, 0xc47b266a, 0x97241afe, 0x6d9c87c1, 0x0a406b8e, 0xcd42ab1b, 0x803f3e02 },
+      { 0x04dbec69, 0x7f0309a8, 0x3bbad05f, 0xa83b85f7, 0xad8e197f, 0xc6097273, 0x5067adc1, 0xc097440e } },
+    { { 0xc379ab34, 0x846a56f2, 0x841df8d1, 0xa8ee068b, 0x176c68ef, 0x20314459, 0x915f1f30, 0xf1af32d5 },
+      { 0x5d75bd50, 0x99c37531, 0xf72f67bc, 0x837cffba, 0x48d7723f, 0x0613a418, 0xe2d41c8b, 0x23d0f130 } },
+    { { 0xd5be5a2b, 0xed93e225, 0x5934f3c6, 0x6fe79983, 0x22626ffc, 0x43140926, 0x7990216a, 0x50bbb4d9 },
+      { 0xe57ec63e, 0x378191c6, 0x181dcdb2, 0x65422c40, 0x0236e0f6, 0x41a8099b, 0x01fe49c3, 0x2b100118 } },
+    { { 0x9b391593, 0xfc68b5c5, 0x598270fc, 0xc385f5a2, 0xd19adcbb, 0x7144f3aa, 0x83fbae0c, 0xdd558999 },
+      { 0x74b82ff4, 0x93b88b8e, 0x71e734c9, 0xd2e03c40, 0x43c0322a, 0x9a7a9eaf, 0x149d6041, 0xe6e4c551 } },
+    { { 0x80ec21fe, 0x5fe14bfe, 0xc255be82, 0xf6ce116a, 0x2f4a5d67, 0x98bc5a07, 0xdb7e63af, 0xfad27148 },
+      { 0x29ab05b3, 0x90c0b6ac, 0x4e251ae6, 0x37a9a83c, 0xc2aade7d, 0x0a7dc875, 0x9f0e1a84, 0x77387de3 } },
+    { { 0xa56c0dd7, 0x1e9ecc49, 0x46086c74, 0xa5cffcd8, 0xf505aece, 0x8f7a1408, 0xbef0c47e, 0xb37b85c0 },
+      { 0xcc0e6a8f, 0x3596b6e4, 0x6b388f23, 0xfd6d4bbf, 0xc39cef4e, 0xaba453fa, 0xf9f628d5, 0x9c135ac8 } },
+    { { 0x95c8f8be, 0x0a1c7294, 0x3bf362bf, 0x2961c480, 0xdf63d4ac, 0x9e418403, 0x91ece900, 0xc109f9cb },
+      { 0x58945705, 0xc2d095d0, 0xddeb85c0, 0xb9083d96, 0x7a40449b, 0x84692b8d, 0x2eee1ee1, 0x9bc3344f } },
+    { { 0x42913074, 0x0d5ae356, 0x48a542b1, 0x55491b27, 0xb310732a, 0x469ca665, 0x5f1a4cc1, 0x29591d52 },
+      { 0xb84f983f, 0xe76f5b6b, 0x9f5f84e1, 0xbe7eef41, 0x80baa189, 0x1200d496, 0x18ef332c, 0x6376551f } },
+};
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * Field arithmetic modulo p
+ */
+static wiced_bool_t headset_p256_fe_is_zero(const headset_p256_fe_t a)
+{
+    uint32_t acc = 0;
+    int      i;
+
+    for (i = 0; i < HEADSET_P256_WORDS; i++)
+    {
+        acc |= a[i];
+    }
+
+    return acc == 0 ? WICED_TRUE : WICED_FALSE;
+}
+
+static void headset_p256_fe_copy(headset_p256_fe_t r, const headset_p256_fe_t a)
+{
+    memcpy((void *)r, (void *)a, sizeof(headset_p256_fe_t));
+}
+
+/* r = a - b, return the borrow */
+static uint32_t headset_p256_fe_sub_raw(headset_p256_fe_t r, const headset_p256_fe_t a, const headset_p256_fe_t b)
+{
+    int64_t borrow = 0;
+    int     i;
+
+    for (i = 0; i < HEADSET_P256_WORDS; i++)
+    {
+        borrow += (int64_t)a[i] - b[i];
+        r[i]    = (uint32_t)borrow;
+        borrow >>= 32;
+    }
+
+    return (uint32_t)(borrow & 1);
+}
+
+/* r = a + b, return the carry */
+static uint32_t headset_p256_fe_add_raw(headset_p256_fe_t r, const headset_p256_fe_t a, const headset_p256_fe_t b)
+{
+    uint64_t carry = 0;
+    int      i;
+
+    for (i = 0; i < HEADSET_P256_WORDS; i++)
+    {
+        carry += (uint64_t)a[i] + b[i];
+        r[i]   = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    return (uint32_t)carry;
+}
+
+static void headset_p256_fe_add(headset_p256_fe_t r, const headset_p256_fe_t a, const headset_p256_fe_t b)
+{
+    headset_p256_fe_t t;
+    uint32_t          carry;
+
+    carry = headset_p256_fe_add_raw(r, a, b);
+
+    /* Reduce if r >= p. */
+    if ((headset_p256_fe_sub_raw(t, r, headset_p256_p) == 0) || carry)
+    {
+        headset_p256_fe_copy(r, t);
+    }
+}
+
+static void headset_p256_fe_sub(headset_p256_fe_t r, const headset_p256_fe_t a, const headset_p256_fe_t b)
+{
+    if (headset_p256_fe_sub_raw(r, a, b))
+    {
+        headset_p256_fe_add_raw(r, r, headset_p256_p);
+    }
+}
+
+/* r = a * b / R mod p (CIOS Montgomery multiplication) */
+static void headset_p256_fe_mul(headset_p256_fe_t r, const headset_p256_fe_t a, const headset_p256_fe_t b)
+{
+    uint32_t t[HEADSET_P256_WORDS + 2] = { 0 };
+    uint64_t c;
+    uint32_t m;
+    int      i;
+    int      j;
+
+    for (i = 0; i < HEADSET_P256_WORDS; i++)
+    {
+        c = 0;
+        for (j = 0; j < HEADSET_P256_WORDS; j++)
+        {
+            c   += (uint64_t)t[j] + (uint64_t)a[j] * b[i];
+            t[j] = (uint32_t)c;
+            c  >>= 32;
+        }
+        c += t[HEADSET_P256_WORDS];
+        t[HEADSET_P256_WORDS]     = (uint32_t)c;
+        t[HEADSET_P256_WORDS + 1] = (uint32_t)(c >> 32);
+
+        /* m = t[0] * (-p^-1) mod 2^32, -p^-1 = 1 */
+        m = t[0];
+        c = ((uint64_t)t[0] + (uint64_t)m * headset_p256_p[0]) >> 32;
+        for (j = 1; j < HEADSET_P256_WORDS; j++)
+        {
+            c       += (uint64_t)t[j] + (uint64_t)m * headset_p256_p[j];
+            t[j - 1] = (uint32_t)c;
+            c      >>= 32;
+        }
+        c += t[HEADSET_P256_WORDS];
+        t[HEADSET_P256_WORDS - 1] = (uint32_t)c;
+        t[HEADSET_P256_WORDS]     = t[HEADSET_P256_WORDS + 1] + (uint32_t)(c >> 32);
+    }
+
+    /* t < 2p */
+    if ((headset_p256_fe_sub_raw(r, t, headset_p256_p) != 0) && (t[HEADSET_P256_WORDS] == 0))
+    {
+        headset_p256_fe_copy(r, t);
+    }
+}
+
+static void headset_p256_fe_sqr(headset_p256_fe_t r, const headset_p256_fe_t a)
+{
+    headset_p256_fe_mul(r, a, a);
+}
+
+/* r = a^(p - 2), Montgomery form in and out */
+static void headset_p256_fe_inv(headset_p256_fe_t r, const headset_p256_fe_t a)
+{
+    headset_p256_fe_t e;
+    headset_p256_fe_t t;
+    int               i;
+
+    /* p - 2 */
+    headset_p256_fe_copy(e, headset_p256_p);
+    e[0] -= 2;
+
+    headset_p256_fe_copy(t, headset_p256_one);
+
+    for (i = 255; i >= 0; i--)
+    {
+        headset_p256_fe_sqr(t, t);
+
+        if ((e[i / 32] >> (i % 32)) & 1)
+        {
+            headset_p256_fe_mul(t, t, a);
+        }
+    }
+
+    headset_p256_fe_copy(r, t);
+}
+
+static void headset_p256_fe_to_mont(headset_p256_fe_t r, const headset_p256_fe_t a)
+{
+    headset_p256_fe_mul(r, a, headset_p256_r2);
+}
+
+static void headset_p256_fe_from_mont(headset_p256_fe_t r, const headset_p256_fe_t a)
+{
+    static const headset_p256_fe_t one = { 1 };
+
+    headset_p256_fe_mul(r, a, one);
+}
+
+/*
+ * headset_p256_point_double
+ *
+ * dbl-2001-b, a = -3. Infinity doubles to infinity.
+ */
+static void headset_p256_point_double(headset_p256_jacobian_t *p_r, const headset_p256_jacobian_t *p_p)
+{
+    headset_p256_fe_t delta;
+    headset_p256_fe_t gamma;
+    headset_p256_fe_t beta;
+    headset_p256_fe_t alpha;
+    headset_p256_fe_t t1;
+    headset_p256_fe_t t2;
+
+    headset_p256_fe_sqr(delta, p_p->z);
+    headset_p256_fe_sqr(gamma, p_p->y);
+    headset_p256_fe_mul(beta, p_p->x, gamma);
+
+    /* alpha = 3 * (x - delta) * (x + delta) */
+    headset_p256_fe_sub(t1, p_p->x, delta);
+    headset_p256_fe_add(t2, p_p->x, delta);
+    headset_p256_fe_mul(alpha, t1, t2);
+    headset_p256_fe_add(t1, alpha, alpha);
+    headset_p256_fe_add(alpha, t1, alpha);
+
+    /* z3 = (y + z)^2 - gamma - delta */
+    headset_p256_fe_add(t1, p_p->y, p_p->z);
+    headset_p256_fe_sqr(t1, t1);
+    headset_p256_fe_sub(t1, t1, gamma);
+    headset_p256_fe_sub(p_r->z, t1, delta);
+
+    /* x3 = alpha^2 - 8 * beta */
+    headset_p256_fe_add(beta, beta, beta);
+    headset_p256_fe_add(beta, beta, beta);          /* 4 * beta */
+    headset_p256_fe_add(t2, beta, beta);            /* 8 * beta */
+    headset_p256_fe_sqr(t1, alpha);
+    headset_p256_fe_sub(p_r->x, t1, t2);
+
+    /* y3 = alpha * (4 * beta - x3) - 8 * gamma^2 */
+    headset_p256_fe_sub(t1, beta, p_r->x);
+    headset_p256_fe_mul(t1, alpha, t1);
+    headset_p256_fe_sqr(gamma, gamma);
+    headset_p256_fe_add(gamma, gamma, gamma);
+    headset_p256_fe_add(gamma, gamma, gamma);
+    headset_p256_fe_add(gamma, gamma, gamma);
+    headset_p256_fe_sub(p_r->y, t1, gamma);
+}
+
+/*
+ * headset_p256_point_add
+ *
+ * add-2007-bl, r = p + q. q is affine (madd) when p_qz is NULL.
+ */
+static void headset_p256_point_add(headset_p256_jacobian_t *p_r,
+                                   const headset_p256_jacobian_t *p_p,
+                                   const headset_p256_fe_t qx,
+                                   const headset_p256_fe_t qy,
+                                   const uint32_t *p_qz)
+{
+    headset_p256_fe_t z1z1;
+    headset_p256_fe_t z2z2;
+    headset_p256_fe_t u1;
+    headset_p256_fe_t u2;
+    headset_p256_fe_t s1;
+    headset_p256_fe_t s2;
+    headset_p256_fe_t h;
+    headset_p256_fe_t i;
+    headset_p256_fe_t j;
+    headset_p256_fe_t r;
+    headset_p256_fe_t v;
+    headset_p256_fe_t t;
+
+    if ((p_qz != NULL) && headset_p256_fe_is_zero(p_qz))
+    {
+        memcpy((void *)p_r, (void *)p_p, sizeof(headset_p256_jacobian_t));
+        return;
+    }
+
+    if (headset_p256_fe_is_zero(p_p->z))
+    {
+        headset_p256_fe_copy(p_r->x, qx);
+        headset_p256_fe_copy(p_r->y, qy);
+        headset_p256_fe_copy(p_r->z, p_qz ? p_qz : headset_p256_one);
+        return;
+    }
+
+    headset_p256_fe_sqr(z1z1, p_p->z);
+
+    if (p_qz)
+    {
+        headset_p256_fe_sqr(z2z2, p_qz);
+        headset_p256_fe_mul(u1, p_p->x, z2z2);
+        headset_p256_fe_mul(s1, p_p->y, p_qz);
+        headset_p256_fe_mul(s1, s1, z2z2);
+    }
+    else
+    {
+        headset_p256_fe_copy(u1, p_p->x);
+        headset_p256_fe_copy(s1, p_p->y);
+    }
+
+    headset_p256_fe_mul(u2, qx, z1z1);
+    headset_p256_fe_mul(s2, qy, p_p->z);
+    headset_p256_fe_mul(s2, s2, z1z1);
+
+    headset_p256_fe_sub(h, u2, u1);
+    headset_p256_fe_sub(r, s2, s1);
+
+    if (headset_p256_fe_is_zero(h))
+    {
+        if (headset_p256_fe_is_zero(r))
+        {
+            /* p == q */
+            headset_p256_point_double(p_r, p_p);
+        }
+        else
+        {
+            /* p == -q */
+            memset((void *)p_r, 0, sizeof(headset_p256_jacobian_t));
+        }
+        return;
+    }
+
+    headset_p256_fe_add(r, r, r);
+
+    /* i = (2 * h)^2, j = h * i, v = u1 * i */
+    headset_p256_fe_add(i, h, h);
+    headset_p256_fe_sqr(i, i);
+    headset_p256_fe_mul(j, h, i);
+    headset_p256_fe_mul(v, u1, i);
+
+    /* z3 = ((z1 + z2)^2 - z1z1 - z2z2) * h, z2 = 1 for madd */
+    if (p_qz)
+    {
+        headset_p256_fe_add(t, p_p->z, p_qz);
+        headset_p256_fe_sqr(t, t);
+        headset_p256_fe_sub(t, t, z1z1);
+        headset_p256_fe_sub(t, t, z2z2);
+        headset_p256_fe_mul(p_r->z, t, h);
+    }
+    else
+    {
+        headset_p256_fe_mul(t, p_p->z, h);
+        headset_p256_fe_add(p_r->z, t, t);
+    }
+
+    /* x3 = r^2 - j - 2 * v */
+    headset_p256_fe_sqr(t, r);
+    headset_p256_fe_sub(t, t, j);
+    headset_p256_fe_sub(t, t, v);
+    headset_p256_fe_sub(p_r->x, t, v);
+
+    /* y3 = r * (v - x3) - 2 * s1 * j */
+    headset_p256_fe_sub(t, v, p_r->x);
+    headset_p256_fe_mul(t, r, t);
+    headset_p256_fe_mul(s1, s1, j);
+    headset_p256_fe_add(s1, s1, s1);
+    headset_p256_fe_sub(p_r->y, t, s1);
+}
+
+/*
+ * headset_p256_to_affine
+ *
+ * Convert to plain affine coordinates, return WICED_FALSE for infinity.
+ */
+static wiced_bool_t headset_p256_to_affine(uint32_t *p_x, uint32_t *p_y, const headset_p256_jacobian_t *p_p)
+{
+    headset_p256_fe_t zi;
+    headset_p256_fe_t zi2;
+    headset_p256_fe_t t;
+
+    if (headset_p256_fe_is_zero(p_p->z))
+    {
+        memset((void *)p_x, 0, sizeof(headset_p256_fe_t));
+        memset((void *)p_y, 0, sizeof(headset_p256_fe_t));
+        return WICED_FALSE;
+    }
+
+    headset_p256_fe_inv(zi, p_p->z);
+    headset_p256_fe_sqr(zi2, zi);
+
+    headset_p256_fe_mul(t, p_p->x, zi2);
+    headset_p256_fe_from_mont(p_x, t);
+
+    headset_p256_fe_mul(t, p_p->y, zi2);
+    headset_p256_fe_mul(t, t, zi);
+    headset_p256_fe_from_mont(p_y, t);
+
+    return WICED_TRUE;
+}
+
+/*
+ * headset_p256_point_mult
+ *
+ * q = k * p, p affine on the curve, k < n.
+ */
+wiced_bool_t headset_p256_point_mult(uint32_t *p_qx, uint32_t *p_qy,
+                                     const uint32_t *p_px, const uint32_t *p_py,
+                                     const uint32_t *p_k)
+{
+    headset_p256_jacobian_t table[HEADSET_P256_TABLE_SIZE];
+    headset_p256_jacobian_t q;
+    headset_p256_affine_t   p;
+    uint8_t                 nibble;
+    int                     i;
+
+    headset_p256_fe_to_mont(p.x, p_px);
+    headset_p256_fe_to_mont(p.y, p_py);
+
+    /* table[i] = (i + 1) * p */
+    headset_p256_fe_copy(table[0].x, p.x);
+    headset_p256_fe_copy(table[0].y, p.y);
+    headset_p256_fe_copy(table[0].z, headset_p256_one);
+
+    headset_p256_point_double(&table[1], &table[0]);
+
+    for (i = 2; i < HEADSET_P256_TABLE_SIZE; i++)
+    {
+        headset_p256_point_add(&table[i], &table[i - 1], p.x, p.y, NULL);
+    }
+
+    memset((void *)&q, 0, sizeof(q));
+
+    for (i = (256 / HEADSET_P256_WINDOW_BITS) - 1; i >= 0; i--)
+    {
+        headset_p256_point_double(&q, &q);
+        headset_p256_point_double(&q, &q);
+        headset_p256_point_double(&q, &q);
+        headset_p256_point_double(&q, &q);
+
+        nibble = (uint8_t)((p_k[i / 8] >> ((i % 8) * HEADSET_P256_WINDOW_BITS)) & HEADSET_P256_TABLE_SIZE);
+
+        if (nibble)
+        {
+            headset_p256_point_add(&q, &q, table[nibble - 1].x, table[nibble - 1].y, table[nibble - 1].z);
+        }
+    }
+
+    return headset_p256_to_affine(p_qx, p_qy, &q);
+}
+
+/*
+ * headset_p256_base_mult
+ *
+ * q = k * G, k < n.
+ */
+wiced_bool_t headset_p256_base_mult(uint32_t *p_qx, uint32_t *p_qy, const uint32_t *p_k)
+{
+    headset_p256_jacobian_t q;
+    uint8_t                 index;
+    int                     i;
+    int                     tooth;
+    int                     bit;
+
+    memset((void *)&q, 0, sizeof(q));
+
+    for (i = HEADSET_P256_COMB_SPACING - 1; i >= 0; i--)
+    {
+        headset_p256_point_double(&q, &q);
+
+        index = 0;
+        for (tooth = 0; tooth < HEADSET_P256_WINDOW_BITS; tooth++)
+        {
+            bit    = tooth * HEADSET_P256_COMB_SPACING + i;
+            index |= (uint8_t)(((p_k[bit / 32] >> (bit % 32)) & 1) << tooth);
+        }
+
+        if (index)
+        {
+            headset_p256_point_add(&q, &q, headset_p256_comb[index - 1].x, headset_p256_comb[index - 1].y, NULL);
+        }
+    }
+
+    return headset_p256_to_affine(p_qx, p_qy, &q);
+}
+
+/*
+ * headset_p256_is_base
+ */
+wiced_bool_t headset_p256_is_base(const uint32_t *p_px, const uint32_t *p_py)
+{
+    return ((memcmp((void *)p_px, (void *)headset_p256_gx, sizeof(headset_p256_fe_t)) == 0) &&
+            (memcmp((void *)p_py, (void *)headset_p256_gy, sizeof(headset_p256_fe_t)) == 0)) ? WICED_TRUE : WICED_FALSE;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * NIST P-256 scalar multiplication.
+ *
+ * Field arithmetic in Montgomery form (R = 2^256) on 32-bit limbs, Jacobian
+ * coordinates with a = -3.
+ * - Variable base: fixed 4-bit window over a table of 15 multiples.
+ * - Fixed base (generator): 4-teeth comb over a constant table of 15 affine
+ *   points, 64 doublings.
+ *
+ * Numbers are 8 little-endian 32-bit words (word 0 least significant), the
+ * layout of the ROM P-256 library. The execution time depends on the scalar.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_P256_WORDS      8
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+wiced_bool_t headset_p256_point_mult(uint32_t *p_qx, uint32_t *p_qy,
+                                     const uint32_t *p_px, const uint32_t *p_py,
+                                     const uint32_t *p_k);
+wiced_bool_t headset_p256_base_mult(uint32_t *p_qx, uint32_t *p_qy, const uint32_t *p_k);
+wiced_bool_t headset_p256_is_base(const uint32_t *p_px, const uint32_t *p_py);
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application SDP database statistics, see headset_sdp.h.
+ */
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_trace.h"
+#include "wiced_app_cfg.h"
+#include "headset_event.h"
+#include "headset_timer.h"
+#include "headset_sdp.h"
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bool_t              in_use;
+    wiced_bt_device_address_t bd_addr;
+    uint32_t                  connected_ms;
+} headset_sdp_link_t;
+
+typedef struct
+{
+    headset_sdp_link_t  link[HEADSET_SDP_LINK_MAX];     /* ACL waiting for a profile connection */
+    headset_sdp_stats_t stats;
+} headset_sdp_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_sdp_cb_t headset_sdp_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_sdp_link_find
+ */
+static headset_sdp_link_t *headset_sdp_link_find(const uint8_t *p_bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_SDP_LINK_MAX; i++)
+    {
+        if (headset_sdp_cb.link[i].in_use &&
+            (memcmp((void *)headset_sdp_cb.link[i].bd_addr, (void *)p_bd_addr, sizeof(wiced_bt_device_address_t)) == 0))
+        {
+            return &headset_sdp_cb.link[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_sdp_event_handler
+ *
+ * A peer connecting to the headset browses the SDP database between the ACL
+ * connection and its first profile connection.
+ */
+static void headset_sdp_event_handler(const headset_event_data_t *p_data)
+{
+    headset_sdp_link_t *p_link = headset_sdp_link_find(p_data->bd_addr);
+    uint32_t            duration;
+    uint8_t             i;
+
+    switch (p_data->event)
+    {
+    case HEADSET_EVENT_BREDR_CONNECTED:
+        if (p_link)
+        {
+            return;
+        }
+
+        for (i = 0; i < HEADSET_SDP_LINK_MAX; i++)
+        {
+            p_link = &headset_sdp_cb.link[i];
+
+            if (!p_link->in_use)
+            {
+                memcpy((void *)p_link->bd_addr, (void *)p_data->bd_addr, sizeof(wiced_bt_device_address_t));
+                p_link->connected_ms = headset_timer_now_ms();
+                p_link->in_use       = WICED_TRUE;
+                return;
+            }
+        }
+        break;
+
+    case HEADSET_EVENT_A2DP_CONNECTED:
+    case HEADSET_EVENT_HFP_CONNECTED:
+        if (p_link == NULL)
+        {
+            return;
+        }
+
+        duration = headset_timer_now_ms() - p_link->connected_ms;
+
+        headset_sdp_cb.stats.exchanges++;
+        headset_sdp_cb.stats.last_ms   = duration;
+        headset_sdp_cb.stats.total_ms += duration;
+        if (duration > headset_sdp_cb.stats.max_ms)
+        {
+            headset_sdp_cb.stats.max_ms = duration;
+        }
+
+        WICED_BT_TRACE("SDP %B: first profile connection after %d ms\n", p_link->bd_addr, duration);
+
+        p_link->in_use = WICED_FALSE;
+        break;
+
+    case HEADSET_EVENT_BREDR_DISCONNECTED:
+        if (p_link)
+        {
+            p_link->in_use = WICED_FALSE;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * headset_sdp_init
+ */
+void headset_sdp_init(void)
+{
+    memset((void *)&headset_sdp_cb, 0, sizeof(headset_sdp_cb));
+
+    headset_sdp_cb.stats.db_size  = wiced_app_cfg_sdp_record_get_size();
+    headset_sdp_cb.stats.db_saved = wiced_app_cfg_sdp_record_get_saved();
+
+    WICED_BT_TRACE("SDP database %d bytes (%d bytes saved)\n",
+                   headset_sdp_cb.stats.db_size, headset_sdp_cb.stats.db_saved);
+
+    headset_event_subscribe(HEADSET_EVENT_MASK_BREDR |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_A2DP_CONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_HFP_CONNECTED),
+                            &headset_sdp_event_handler);
+}
+
+/*
+ * headset_sdp_stats_get
+ */
+void headset_sdp_stats_get(headset_sdp_stats_t *p_stats)
+{
+    memcpy((void *)p_stats, (void *)&headset_sdp_cb.stats, sizeof(headset_sdp_stats_t));
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application SDP database builder and statistics.
+ *
+ * The HEADSET_SDP_SEQ_x() macros emit a data element sequence header whose
+ * length is computed by the compiler from the elements it encloses, so the
+ * records in wiced_app_cfg.c never carry a hand counted length. Records of
+ * the features that are not built are left out of the database.
+ *
+ * A smaller database means shorter ServiceSearchAttribute responses, a
+ * phone discovering the headset on first connection needs fewer
+ * continuation round trips. The time from the ACL connection to the first
+ * profile connection of the peer (A2DP or HFP), which covers the SDP
+ * exchange of the phone, is measured for every new ACL.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_sdp.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_SDP_LINK_MAX            2       /* br_max_simultaneous_links */
+
+/* Number of bytes of a list of data elements, evaluated at compile time */
+#define HEADSET_SDP_LEN(...)            ((uint16_t)sizeof((const uint8_t[]){ __VA_ARGS__ }))
+
+/* Data element sequences with an 8 bit and a 16 bit length */
+#define HEADSET_SDP_SEQ_1(...)          SDP_ATTR_SEQUENCE_1(HEADSET_SDP_LEN(__VA_ARGS__)), __VA_ARGS__
+#define HEADSET_SDP_SEQ_2(...)          SDP_ATTR_SEQUENCE_2(HEADSET_SDP_LEN(__VA_ARGS__)), __VA_ARGS__
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint16_t db_size;           /* bytes of the SDP database */
+    uint16_t db_saved;          /* bytes of the records left out of the build */
+    uint16_t exchanges;         /* ACL connections followed by a profile connection */
+    uint32_t last_ms;           /* ACL connection to first profile connection */
+    uint32_t max_ms;
+    uint32_t total_ms;
+} headset_sdp_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void headset_sdp_init(void);
+void headset_sdp_stats_get(headset_sdp_stats_t *p_stats);
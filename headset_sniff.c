@@ -0,0 +1,530 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application sniff and sniff subrating policy.
+ */
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_trace.h"
+#include "headset_event.h"
+#include "headset_timer.h"
+#include "headset_sniff.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_SNIFF_TIMER_WINDOW_MS       100
+
+/* Reasons for keeping a link active. */
+#define HEADSET_SNIFF_BUSY_STREAMING        0x01
+#define HEADSET_SNIFF_BUSY_CALL             0x02
+
+typedef enum
+{
+    HEADSET_SNIFF_LEVEL_NONE,       /* stay active */
+    HEADSET_SNIFF_LEVEL_SHORT,
+    HEADSET_SNIFF_LEVEL_LONG,
+} headset_sniff_level_t;
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bool_t              in_use;
+    wiced_bt_device_address_t bd_addr;
+    uint16_t                  a2dp_handle;
+    uint16_t                  hfp_handle;
+    uint8_t                   busy;
+    uint8_t                   level;        /* headset_sniff_level_t applied */
+    wiced_bool_t              reapply;      /* sniff cancelled to change the parameters */
+    uint8_t                   mode;         /* headset_sniff_mode_t reported by the controller */
+    uint32_t                  mode_since;
+    uint32_t                  time_ms[HEADSET_SNIFF_MODE_MAX];
+    headset_timer_t           timer;
+} headset_sniff_link_t;
+
+typedef struct
+{
+    headset_sniff_link_t link[HEADSET_SNIFF_LINK_MAX];
+    uint8_t              sco_num;
+} headset_sniff_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_sniff_cb_t headset_sniff_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_sniff_link_find
+ */
+static headset_sniff_link_t *headset_sniff_link_find(const uint8_t *p_bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_SNIFF_LINK_MAX; i++)
+    {
+        if ((headset_sniff_cb.link[i].in_use) &&
+            (memcmp((void *)headset_sniff_cb.link[i].bd_addr, (void *)p_bd_addr, sizeof(wiced_bt_device_address_t)) == 0))
+        {
+            return &headset_sniff_cb.link[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_sniff_link_find_by_handle
+ */
+static headset_sniff_link_t *headset_sniff_link_find_by_handle(uint16_t handle, wiced_bool_t a2dp)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_SNIFF_LINK_MAX; i++)
+    {
+        if ((headset_sniff_cb.link[i].in_use) &&
+            ((a2dp ? headset_sniff_cb.link[i].a2dp_handle : headset_sniff_cb.link[i].hfp_handle) == handle))
+        {
+            return &headset_sniff_cb.link[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_sniff_mode_account
+ *
+ * Add the time spent in the current mode up to now.
+ */
+static void headset_sniff_mode_account(headset_sniff_link_t *p_link)
+{
+    uint32_t now = headset_timer_now_ms();
+
+    p_link->time_ms[p_link->mode] += now - p_link->mode_since;
+    p_link->mode_since             = now;
+}
+
+/*
+ * headset_sniff_apply
+ *
+ * Put the link in sniff mode with the parameters of its current level.
+ */
+static void headset_sniff_apply(headset_sniff_link_t *p_link)
+{
+    wiced_result_t result;
+
+    if (p_link->level == HEADSET_SNIFF_LEVEL_SHORT)
+    {
+        result = wiced_bt_dev_set_sniff_mode(p_link->bd_addr,
+                                             HEADSET_SNIFF_SHORT_MIN_PERIOD,
+                                             HEADSET_SNIFF_SHORT_MAX_PERIOD,
+                                             HEADSET_SNIFF_ATTEMPT,
+                                             HEADSET_SNIFF_TIMEOUT);
+    }
+    else
+    {
+        wiced_bt_dev_set_sniff_subrating(p_link->bd_addr,
+                                         HEADSET_SNIFF_SSR_MAX_LATENCY,
+                                         HEADSET_SNIFF_SSR_MIN_REMOTE_TIMEOUT,
+                                         HEADSET_SNIFF_SSR_MIN_LOCAL_TIMEOUT);
+
+        result = wiced_bt_dev_set_sniff_mode(p_link->bd_addr,
+                                             HEADSET_SNIFF_LONG_MIN_PERIOD,
+                                             HEADSET_SNIFF_LONG_MAX_PERIOD,
+                                             HEADSET_SNIFF_ATTEMPT,
+                                             HEADSET_SNIFF_TIMEOUT);
+    }
+
+    WICED_BT_TRACE("headset_sniff_apply (%B, level: %d, result: %d)\n",
+                   p_link->bd_addr,
+                   p_link->level,
+                   result);
+}
+
+/*
+ * headset_sniff_idle_restart
+ *
+ * The link shall stay active for now, restart the idle period.
+ */
+static void headset_sniff_idle_restart(headset_sniff_link_t *p_link)
+{
+    p_link->level   = HEADSET_SNIFF_LEVEL_NONE;
+    p_link->reapply = WICED_FALSE;
+
+    if (p_link->busy || headset_sniff_cb.sco_num)
+    {
+        headset_timer_stop(&p_link->timer);
+        return;
+    }
+
+    headset_timer_start(&p_link->timer, HEADSET_SNIFF_SHORT_DELAY_MS, HEADSET_SNIFF_TIMER_WINDOW_MS);
+}
+
+/*
+ * headset_sniff_exit
+ *
+ * Leave sniff mode now instead of waiting for the next outgoing packet.
+ */
+static void headset_sniff_exit(headset_sniff_link_t *p_link)
+{
+    if ((p_link->mode == HEADSET_SNIFF_MODE_SNIFF) ||
+        (p_link->mode == HEADSET_SNIFF_MODE_SSR))
+    {
+        wiced_bt_dev_cancel_sniff_mode(p_link->bd_addr);
+    }
+
+    headset_sniff_idle_restart(p_link);
+}
+
+/*
+ * headset_sniff_timeout
+ */
+static void headset_sniff_timeout(uint32_t arg)
+{
+    headset_sniff_link_t *p_link = &headset_sniff_cb.link[arg];
+
+    if ((!p_link->in_use) ||
+        (p_link->busy) ||
+        (headset_sniff_cb.sco_num))
+    {
+        return;
+    }
+
+    if (p_link->level == HEADSET_SNIFF_LEVEL_NONE)
+    {
+        p_link->level = HEADSET_SNIFF_LEVEL_SHORT;
+
+        headset_timer_start(&p_link->timer,
+                            HEADSET_SNIFF_LONG_DELAY_MS - HEADSET_SNIFF_SHORT_DELAY_MS,
+                            HEADSET_SNIFF_TIMER_WINDOW_MS);
+    }
+    else
+    {
+        p_link->level = HEADSET_SNIFF_LEVEL_LONG;
+    }
+
+    if (p_link->mode == HEADSET_SNIFF_MODE_ACTIVE)
+    {
+        headset_sniff_apply(p_link);
+    }
+    else
+    {
+        /* Sniff parameters can only be changed from active mode. */
+        p_link->reapply = WICED_TRUE;
+        wiced_bt_dev_cancel_sniff_mode(p_link->bd_addr);
+    }
+}
+
+/*
+ * headset_sniff_busy_set
+ */
+static void headset_sniff_busy_set(headset_sniff_link_t *p_link, uint8_t busy, wiced_bool_t set)
+{
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    if (set)
+    {
+        p_link->busy |= busy;
+        headset_sniff_exit(p_link);
+    }
+    else
+    {
+        p_link->busy &= ~busy;
+        headset_sniff_idle_restart(p_link);
+    }
+}
+
+/*
+ * headset_sniff_event_handler
+ */
+static void headset_sniff_event_handler(const headset_event_data_t *p_data)
+{
+    headset_sniff_link_t *p_link;
+    uint8_t               i;
+
+    switch (p_data->event)
+    {
+    case HEADSET_EVENT_BREDR_CONNECTED:
+        if (headset_sniff_link_find(p_data->bd_addr))
+        {
+            break;
+        }
+
+        for (i = 0; i < HEADSET_SNIFF_LINK_MAX; i++)
+        {
+            p_link = &headset_sniff_cb.link[i];
+
+            if (!p_link->in_use)
+            {
+                memset((void *)p_link, 0, sizeof(headset_sniff_link_t));
+                headset_timer_setup(&p_link->timer, &headset_sniff_timeout, i);
+
+                p_link->in_use     = WICED_TRUE;
+                p_link->mode       = HEADSET_SNIFF_MODE_ACTIVE;
+                p_link->mode_since = headset_timer_now_ms();
+                memcpy((void *)p_link->bd_addr, (void *)p_data->bd_addr, sizeof(wiced_bt_device_address_t));
+
+                headset_sniff_idle_restart(p_link);
+                break;
+            }
+        }
+        break;
+
+    case HEADSET_EVENT_BREDR_DISCONNECTED:
+        p_link = headset_sniff_link_find(p_data->bd_addr);
+
+        if (p_link)
+        {
+            headset_sniff_mode_account(p_link);
+            headset_timer_stop(&p_link->timer);
+
+            WICED_BT_TRACE("headset_sniff link %B time in mode (ms) active: %d, sniff: %d, ssr: %d, other: %d\n",
+                           p_link->bd_addr,
+                           p_link->time_ms[HEADSET_SNIFF_MODE_ACTIVE],
+                           p_link->time_ms[HEADSET_SNIFF_MODE_SNIFF],
+                           p_link->time_ms[HEADSET_SNIFF_MODE_SSR],
+                           p_link->time_ms[HEADSET_SNIFF_MODE_OTHER]);
+
+            p_link->in_use = WICED_FALSE;
+        }
+        break;
+
+    case HEADSET_EVENT_A2DP_CONNECTED:
+        p_link = headset_sniff_link_find(p_data->bd_addr);
+
+        if (p_link)
+        {
+            p_link->a2dp_handle = p_data->handle;
+        }
+        break;
+
+    case HEADSET_EVENT_HFP_CONNECTED:
+        p_link = headset_sniff_link_find(p_data->bd_addr);
+
+        if (p_link)
+        {
+            p_link->hfp_handle = p_data->handle;
+        }
+        break;
+
+    case HEADSET_EVENT_A2DP_STREAM_STARTED:
+        headset_sniff_busy_set(headset_sniff_link_find_by_handle(p_data->handle, WICED_TRUE),
+                               HEADSET_SNIFF_BUSY_STREAMING,
+                               WICED_TRUE);
+        break;
+
+    case HEADSET_EVENT_A2DP_STREAM_SUSPENDED:
+    case HEADSET_EVENT_A2DP_DISCONNECTED:
+        headset_sniff_busy_set(headset_sniff_link_find_by_handle(p_data->handle, WICED_TRUE),
+                               HEADSET_SNIFF_BUSY_STREAMING,
+                               WICED_FALSE);
+        break;
+
+    case HEADSET_EVENT_HFP_CALL_STATE:
+        headset_sniff_busy_set(headset_sniff_link_find_by_handle(p_data->handle, WICED_FALSE),
+                               HEADSET_SNIFF_BUSY_CALL,
+                               p_data->status ? WICED_TRUE : WICED_FALSE);
+        break;
+
+    case HEADSET_EVENT_HFP_DISCONNECTED:
+        headset_sniff_busy_set(headset_sniff_link_find_by_handle(p_data->handle, WICED_FALSE),
+                               HEADSET_SNIFF_BUSY_CALL,
+                               WICED_FALSE);
+        break;
+
+    case HEADSET_EVENT_SCO_CONNECTED:
+    case HEADSET_EVENT_SCO_DISCONNECTED:
+        /* SCO events do not carry the peer address, hold every link active. */
+        if (p_data->event == HEADSET_EVENT_SCO_CONNECTED)
+        {
+            headset_sniff_cb.sco_num++;
+        }
+        else if (headset_sniff_cb.sco_num)
+        {
+            headset_sniff_cb.sco_num--;
+        }
+
+        for (i = 0; i < HEADSET_SNIFF_LINK_MAX; i++)
+        {
+            if (headset_sniff_cb.link[i].in_use)
+            {
+                headset_sniff_exit(&headset_sniff_cb.link[i]);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * headset_sniff_init
+ */
+void headset_sniff_init(void)
+{
+    memset((void *)&headset_sniff_cb, 0, sizeof(headset_sniff_cb));
+
+    headset_event_subscribe(HEADSET_EVENT_MASK_BREDR |
+                            HEADSET_EVENT_MASK_A2DP |
+                            HEADSET_EVENT_MASK_HFP |
+                            HEADSET_EVENT_MASK_SCO,
+                            &headset_sniff_event_handler);
+}
+
+/*
+ * headset_sniff_activity
+ *
+ * User activity (button) about to generate AVRCP/HFP traffic: exit sniff on
+ * every link so the command is not delayed by the sniff interval.
+ */
+void headset_sniff_activity(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_SNIFF_LINK_MAX; i++)
+    {
+        if (headset_sniff_cb.link[i].in_use)
+        {
+            headset_sniff_exit(&headset_sniff_cb.link[i]);
+        }
+    }
+}
+
+/*
+ * headset_sniff_power_mgmt_status
+ *
+ * Power mode change reported by the controller (BTM_POWER_MANAGEMENT_STATUS_EVT).
+ */
+void headset_sniff_power_mgmt_status(wiced_bt_power_mgmt_notification_t *p_data)
+{
+    headset_sniff_link_t *p_link = headset_sniff_link_find(p_data->bd_addr);
+    uint8_t               mode;
+
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    switch (p_data->status)
+    {
+    case WICED_POWER_STATE_ACTIVE:
+        mode = HEADSET_SNIFF_MODE_ACTIVE;
+        break;
+
+    case WICED_POWER_STATE_SNIFF:
+        mode = HEADSET_SNIFF_MODE_SNIFF;
+        break;
+
+    case WICED_POWER_STATE_SSR:
+        mode = HEADSET_SNIFF_MODE_SSR;
+        break;
+
+    case WICED_POWER_STATE_HOLD:
+    case WICED_POWER_STATE_PARK:
+        mode = HEADSET_SNIFF_MODE_OTHER;
+        break;
+
+    default:
+        /* Pending or error, the mode is unchanged. */
+        return;
+    }
+
+    if (mode == p_link->mode)
+    {
+        return;
+    }
+
+    headset_sniff_mode_account(p_link);
+    p_link->mode = mode;
+
+    if (mode != HEADSET_SNIFF_MODE_ACTIVE)
+    {
+        return;
+    }
+
+    if (p_link->reapply)
+    {
+        /* Sniff was cancelled to change the parameters. */
+        p_link->reapply = WICED_FALSE;
+        headset_sniff_apply(p_link);
+    }
+    else if (p_link->level != HEADSET_SNIFF_LEVEL_NONE)
+    {
+        /* The peer or outgoing traffic took the link out of sniff. */
+        headset_sniff_idle_restart(p_link);
+    }
+}
+
+/*
+ * headset_sniff_stats_get
+ *
+ * Fill the time in mode of the connected links, return the number of links.
+ */
+uint8_t headset_sniff_stats_get(headset_sniff_link_stats_t *p_stats, uint8_t max)
+{
+    headset_sniff_link_t *p_link;
+    uint8_t               i;
+    uint8_t               num = 0;
+
+    for (i = 0; (i < HEADSET_SNIFF_LINK_MAX) && (num < max); i++)
+    {
+        p_link = &headset_sniff_cb.link[i];
+
+        if (!p_link->in_use)
+        {
+            continue;
+        }
+
+        headset_sniff_mode_account(p_link);
+
+        memcpy((void *)p_stats[num].bd_addr, (void *)p_link->bd_addr, sizeof(wiced_bt_device_address_t));
+        memcpy((void *)p_stats[num].time_ms, (void *)p_link->time_ms, sizeof(p_link->time_ms));
+        p_stats[num].mode = p_link->mode;
+
+        num++;
+    }
+
+    return num;
+}
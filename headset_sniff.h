@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application sniff and sniff subrating policy.
+ *
+ * An idle ACL link (no A2DP stream, no call, no SCO) first enters a short
+ * sniff interval so AVRCP/HFP commands still get a quick response, then moves
+ * to a long, subrated sniff interval once the link has been quiet for a while.
+ * A button press takes the links out of sniff ahead of the AVRCP command it
+ * triggers. The time each link spends in every power mode is accounted.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_SNIFF_LINK_MAX              2       /* br_max_simultaneous_links */
+
+/* Idle time before each policy level is applied. */
+#define HEADSET_SNIFF_SHORT_DELAY_MS        2000
+#define HEADSET_SNIFF_LONG_DELAY_MS         30000
+
+/* Sniff parameters (in slots, 0.625 ms) of each policy level. */
+#define HEADSET_SNIFF_SHORT_MIN_PERIOD      96      /* 60 ms */
+#define HEADSET_SNIFF_SHORT_MAX_PERIOD      160     /* 100 ms */
+#define HEADSET_SNIFF_LONG_MIN_PERIOD       640     /* 400 ms */
+#define HEADSET_SNIFF_LONG_MAX_PERIOD       800     /* 500 ms */
+#define HEADSET_SNIFF_ATTEMPT               4
+#define HEADSET_SNIFF_TIMEOUT               1
+
+/* Sniff subrating parameters (in slots) of the long level. */
+#define HEADSET_SNIFF_SSR_MAX_LATENCY       1600    /* 1 s */
+#define HEADSET_SNIFF_SSR_MIN_REMOTE_TIMEOUT 0
+#define HEADSET_SNIFF_SSR_MIN_LOCAL_TIMEOUT  0
+
+typedef enum
+{
+    HEADSET_SNIFF_MODE_ACTIVE,
+    HEADSET_SNIFF_MODE_SNIFF,
+    HEADSET_SNIFF_MODE_SSR,         /* sniff with subrating */
+    HEADSET_SNIFF_MODE_OTHER,       /* hold, park */
+    HEADSET_SNIFF_MODE_MAX,
+} headset_sniff_mode_t;
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint8_t                   mode;                             /* headset_sniff_mode_t */
+    uint32_t                  time_ms[HEADSET_SNIFF_MODE_MAX];  /* time spent in each mode */
+} headset_sniff_link_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void    headset_sniff_init(void);
+void    headset_sniff_activity(void);
+void    headset_sniff_power_mgmt_status(wiced_bt_power_mgmt_notification_t *p_data);
+uint8_t headset_sniff_stats_get(headset_sniff_link_stats_t *p_stats, uint8_t max);
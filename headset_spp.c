@@ -0,0 +1,505 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * SPP bulk data service, see headset_spp.h.
+ */
+#ifdef HEADSET_SPP_BULK
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_rfcomm.h"
+#include "wiced_bt_sdp.h"
+#include "wiced_bt_trace.h"
+#include "wiced_hal_nvram.h"
+#include "headset_bulk.h"
+#include "headset_event.h"
+#include "headset_nvram.h"
+#include "headset_spp.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_SPP_RFCOMM_EVENTS       (WICED_BT_RFCOMM_EV_FC | WICED_BT_RFCOMM_EV_FCS | WICED_BT_RFCOMM_EV_TXEMPTY)
+
+/* NVRAM item header in the backup: ID and length */
+#define HEADSET_SPP_NVRAM_HEADER_LEN    4
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_bool_t              in_use;
+    wiced_bt_device_address_t bd_addr;
+} headset_spp_link_t;
+
+typedef struct
+{
+    uint16_t            handle;
+    wiced_bool_t        connected;
+    wiced_bool_t        flow_on;                /* RFCOMM accepts data */
+    headset_spp_link_t  encrypted[HEADSET_SPP_LINK_MAX];
+
+    /* Request being received */
+    uint8_t             req[2 + HEADSET_BULK_PARAM_MAX];
+    uint8_t             req_len;
+    uint8_t             skip_remaining;         /* parameter bytes of a rejected request */
+
+    headset_bulk_t      bulk;
+    uint16_t            nvram_id;               /* next NVRAM item of the backup */
+
+    headset_spp_stats_t stats;
+    uint8_t             tx_buffer[HEADSET_SPP_MTU];
+} headset_spp_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_spp_cb_t headset_spp_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+static void headset_spp_server_start(void);
+
+/*
+ * headset_spp_is_encrypted
+ */
+static wiced_bool_t headset_spp_is_encrypted(void)
+{
+    wiced_bt_device_address_t bd_addr;
+    uint16_t                  lcid;
+    uint8_t                   i;
+
+    if (wiced_bt_rfcomm_check_connection(headset_spp_cb.handle, bd_addr, &lcid) != WICED_BT_RFCOMM_SUCCESS)
+    {
+        return WICED_FALSE;
+    }
+
+    for (i = 0; i < HEADSET_SPP_LINK_MAX; i++)
+    {
+        if (headset_spp_cb.encrypted[i].in_use &&
+            (memcmp((void *)headset_spp_cb.encrypted[i].bd_addr, (void *)bd_addr, BD_ADDR_LEN) == 0))
+        {
+            return WICED_TRUE;
+        }
+    }
+
+    return WICED_FALSE;
+}
+
+/*
+ * headset_spp_nvram_is_key
+ *
+ * Key material stays out of the backup: the link keys and LE bonds of the
+ * other peers, the local IRK and the Fast Pair account keys.
+ */
+static wiced_bool_t headset_spp_nvram_is_key(uint16_t id)
+{
+    if ((id == HEADSET_NVRAM_ID_LINK_KEYS) ||
+        (id == HEADSET_NVRAM_ID_LOCAL_IRK) ||
+        (id == HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY))
+    {
+        return WICED_TRUE;
+    }
+
+    if ((id >= HEADSET_NVRAM_ID_LE_BOND) && (id <= HEADSET_NVRAM_ID_LE_BOND_LAST))
+    {
+        return WICED_TRUE;
+    }
+
+    if ((id >= HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT) && (id <= HEADSET_NVRAM_ID_GFPS_ACCOUNT_KEY_EXT_B_LAST))
+    {
+        return WICED_TRUE;
+    }
+
+    return WICED_FALSE;
+}
+
+/*
+ * headset_spp_nvram_next
+ *
+ * Read the next NVRAM item of the backup into tx_buffer, the ID 0 item ends
+ * the list. Return WICED_FALSE when the list has been sent.
+ */
+static wiced_bool_t headset_spp_nvram_next(void)
+{
+    wiced_result_t result;
+    uint16_t       nb_bytes = 0;
+    uint16_t       id;
+    uint8_t       *p = headset_spp_cb.tx_buffer;
+
+    if ((headset_spp_cb.bulk.op != HEADSET_BULK_OP_NVRAM) || (headset_spp_cb.nvram_id == 0))
+    {
+        return WICED_FALSE;
+    }
+
+    for (id = headset_spp_cb.nvram_id; id < HEADSET_NVRAM_ID_END; id++)
+    {
+        if (headset_spp_nvram_is_key(id))
+        {
+            continue;
+        }
+
+        nb_bytes = wiced_hal_read_nvram(id,
+                                        sizeof(headset_spp_cb.tx_buffer) - HEADSET_SPP_NVRAM_HEADER_LEN,
+                                        &headset_spp_cb.tx_buffer[HEADSET_SPP_NVRAM_HEADER_LEN],
+                                        &result);
+
+        if ((result == WICED_SUCCESS) && nb_bytes)
+        {
+            break;
+        }
+
+        nb_bytes = 0;
+    }
+
+    if (id < HEADSET_NVRAM_ID_END)
+    {
+        headset_spp_cb.nvram_id = id + 1;
+    }
+    else
+    {
+        id = 0;
+        headset_spp_cb.nvram_id = 0;
+    }
+
+    UINT16_TO_STREAM(p, id);
+    UINT16_TO_STREAM(p, nb_bytes);
+
+    headset_spp_cb.bulk.tx_len    = HEADSET_SPP_NVRAM_HEADER_LEN + nb_bytes;
+    headset_spp_cb.bulk.tx_offset = 0;
+
+    return WICED_TRUE;
+}
+
+/*
+ * headset_spp_request
+ *
+ * Requests of the SPP service only.
+ */
+static wiced_bool_t headset_spp_request(uint8_t op, uint8_t *p_param, uint8_t param_len)
+{
+    if (op != HEADSET_BULK_OP_NVRAM)
+    {
+        return WICED_FALSE;
+    }
+
+    if (!headset_spp_is_encrypted())
+    {
+        headset_bulk_rsp_header(&headset_spp_cb.bulk, op, HEADSET_BULK_STATUS_NOT_ENCRYPTED, 0);
+        return WICED_TRUE;
+    }
+
+    headset_bulk_rsp_header(&headset_spp_cb.bulk, op, HEADSET_BULK_STATUS_SUCCESS, HEADSET_BULK_LEN_STREAM);
+    headset_spp_cb.nvram_id = WICED_NVRAM_VSID_START;
+    return WICED_TRUE;
+}
+
+/*
+ * headset_spp_tx_pump
+ *
+ * Write tx_buffer until RFCOMM stops accepting data, the TX empty or flow
+ * control event calls back once it can take more.
+ */
+static void headset_spp_tx_pump(void)
+{
+    headset_bulk_t          *p_bulk = &headset_spp_cb.bulk;
+    wiced_bt_rfcomm_result_t result;
+    uint16_t                 len;
+    uint16_t                 written;
+
+    while (headset_spp_cb.connected && p_bulk->tx_busy)
+    {
+        if (p_bulk->tx_offset == p_bulk->tx_len)
+        {
+            if (!headset_bulk_tx_next(p_bulk))
+            {
+                /* Response complete, let the peer send the next request. */
+                p_bulk->tx_busy = WICED_FALSE;
+                wiced_bt_rfcomm_flow_control(headset_spp_cb.handle, WICED_TRUE);
+                break;
+            }
+        }
+
+        if (!headset_spp_cb.flow_on)
+        {
+            break;
+        }
+
+        len     = p_bulk->tx_len - p_bulk->tx_offset;
+        written = 0;
+        result  = wiced_bt_rfcomm_write_data(headset_spp_cb.handle,
+                                             (char *)&headset_spp_cb.tx_buffer[p_bulk->tx_offset],
+                                             len,
+                                             &written);
+
+        p_bulk->tx_offset             += written;
+        headset_spp_cb.stats.tx_bytes += written;
+
+        if ((result != WICED_BT_RFCOMM_SUCCESS) || (written < len))
+        {
+            headset_spp_cb.stats.flow_off++;
+            break;
+        }
+    }
+}
+
+/*
+ * headset_spp_rsp_start
+ *
+ * Send the response prepared in tx_buffer.
+ */
+static void headset_spp_rsp_start(void)
+{
+    /* No credit for the peer until the response is sent. */
+    headset_spp_cb.bulk.tx_busy = WICED_TRUE;
+    wiced_bt_rfcomm_flow_control(headset_spp_cb.handle, WICED_FALSE);
+
+    headset_spp_tx_pump();
+}
+
+/*
+ * headset_spp_rfcomm_data_cback
+ */
+static int headset_spp_rfcomm_data_cback(uint16_t port_handle, void *p_data, uint16_t len)
+{
+    uint8_t *p = (uint8_t *)p_data;
+    uint16_t sink;
+
+    headset_spp_cb.stats.rx_bytes += len;
+
+    while (len)
+    {
+        sink = headset_bulk_sink(&headset_spp_cb.bulk, len);
+        if (sink)
+        {
+            p   += sink;
+            len -= sink;
+            continue;
+        }
+
+        if (headset_spp_cb.skip_remaining)
+        {
+            headset_spp_cb.skip_remaining--;
+            p++;
+            len--;
+            continue;
+        }
+
+        if (headset_spp_cb.bulk.tx_busy)
+        {
+            /* The peer shall wait for the response. */
+            WICED_BT_TRACE("SPP: %d bytes received during a response, dropped\n", len);
+            break;
+        }
+
+        headset_spp_cb.req[headset_spp_cb.req_len++] = *p++;
+        len--;
+
+        if ((headset_spp_cb.req_len >= 2) &&
+            (headset_spp_cb.req_len == 2 + headset_spp_cb.req[1]))
+        {
+            headset_spp_cb.req_len = 0;
+            headset_bulk_request(&headset_spp_cb.bulk, headset_spp_cb.req[0], &headset_spp_cb.req[2], headset_spp_cb.req[1]);
+        }
+        else if ((headset_spp_cb.req_len == 2) && (headset_spp_cb.req[1] > HEADSET_BULK_PARAM_MAX))
+        {
+            headset_spp_cb.req_len        = 0;
+            headset_spp_cb.skip_remaining = headset_spp_cb.req[1];
+            headset_bulk_rsp_header(&headset_spp_cb.bulk, headset_spp_cb.req[0], HEADSET_BULK_STATUS_INVALID_PARAM, 0);
+            headset_spp_rsp_start();
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * headset_spp_rfcomm_event_cback
+ */
+static void headset_spp_rfcomm_event_cback(wiced_bt_rfcomm_port_event_t event, uint16_t port_handle)
+{
+    if (event & WICED_BT_RFCOMM_EV_FC)
+    {
+        headset_spp_cb.flow_on = (event & WICED_BT_RFCOMM_EV_FCS) ? WICED_TRUE : WICED_FALSE;
+    }
+
+    if (headset_spp_cb.flow_on && (event & (WICED_BT_RFCOMM_EV_FC | WICED_BT_RFCOMM_EV_TXEMPTY)))
+    {
+        headset_spp_tx_pump();
+    }
+}
+
+/*
+ * headset_spp_rfcomm_mgmt_cback
+ */
+static void headset_spp_rfcomm_mgmt_cback(wiced_bt_rfcomm_result_t code, uint16_t port_handle)
+{
+    WICED_BT_TRACE("SPP: RFCOMM %d, handle %d\n", code, port_handle);
+
+    if (code == WICED_BT_RFCOMM_SUCCESS)
+    {
+        headset_spp_cb.connected      = WICED_TRUE;
+        headset_spp_cb.flow_on        = WICED_TRUE;
+        headset_spp_cb.req_len        = 0;
+        headset_spp_cb.skip_remaining = 0;
+        headset_bulk_reset(&headset_spp_cb.bulk);
+
+        headset_spp_cb.stats.connected = WICED_TRUE;
+        headset_spp_cb.stats.connections++;
+        return;
+    }
+
+    if (headset_spp_cb.connected)
+    {
+        headset_spp_cb.connected       = WICED_FALSE;
+        headset_spp_cb.stats.connected = WICED_FALSE;
+
+        /* Listen again for the next peer. */
+        wiced_bt_rfcomm_remove_connection(headset_spp_cb.handle, WICED_TRUE);
+        headset_spp_server_start();
+    }
+}
+
+/*
+ * headset_spp_server_start
+ */
+static void headset_spp_server_start(void)
+{
+    wiced_bt_device_address_t bd_addr = { 0 };
+    wiced_bt_rfcomm_result_t  result;
+
+    result = wiced_bt_rfcomm_create_connection(UUID_SERVCLASS_SERIAL_PORT,
+                                               OFU_SPP_RFCOMM_SCN,
+                                               WICED_TRUE,
+                                               HEADSET_SPP_MTU,
+                                               bd_addr,
+                                               &headset_spp_cb.handle,
+                                               &headset_spp_rfcomm_mgmt_cback);
+
+    if (result != WICED_BT_RFCOMM_SUCCESS)
+    {
+        WICED_BT_TRACE("SPP: server start fail %d\n", result);
+        return;
+    }
+
+    wiced_bt_rfcomm_set_event_mask(headset_spp_cb.handle, HEADSET_SPP_RFCOMM_EVENTS);
+    wiced_bt_rfcomm_set_event_callback(headset_spp_cb.handle, &headset_spp_rfcomm_event_cback);
+    wiced_bt_rfcomm_set_data_callback(headset_spp_cb.handle, &headset_spp_rfcomm_data_cback);
+}
+
+/*
+ * headset_spp_event_handler
+ */
+static void headset_spp_event_handler(const headset_event_data_t *p_data)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_SPP_LINK_MAX; i++)
+    {
+        if (headset_spp_cb.encrypted[i].in_use &&
+            (memcmp((void *)headset_spp_cb.encrypted[i].bd_addr, (void *)p_data->bd_addr, BD_ADDR_LEN) == 0))
+        {
+            headset_spp_cb.encrypted[i].in_use = WICED_FALSE;
+        }
+    }
+}
+
+/*
+ * headset_spp_encryption_status
+ *
+ * BTM_ENCRYPTION_STATUS_EVT, the NVRAM backup is only sent to an encrypted
+ * BR/EDR peer.
+ */
+void headset_spp_encryption_status(const wiced_bt_device_address_t bd_addr, uint8_t transport, wiced_result_t result)
+{
+    headset_spp_link_t *p_free = NULL;
+    uint8_t             i;
+
+    if ((transport != BT_TRANSPORT_BR_EDR) || (result != WICED_SUCCESS))
+    {
+        return;
+    }
+
+    for (i = 0; i < HEADSET_SPP_LINK_MAX; i++)
+    {
+        if (!headset_spp_cb.encrypted[i].in_use)
+        {
+            p_free = p_free ? p_free : &headset_spp_cb.encrypted[i];
+        }
+        else if (memcmp((void *)headset_spp_cb.encrypted[i].bd_addr, (void *)bd_addr, BD_ADDR_LEN) == 0)
+        {
+            return;
+        }
+    }
+
+    if (p_free)
+    {
+        p_free->in_use = WICED_TRUE;
+        memcpy((void *)p_free->bd_addr, (void *)bd_addr, BD_ADDR_LEN);
+    }
+}
+
+/*
+ * headset_spp_init
+ */
+void headset_spp_init(void)
+{
+    /* No link survives a warm restart. */
+    memset((void *)&headset_spp_cb, 0, sizeof(headset_spp_cb));
+
+    headset_spp_cb.bulk.p_buffer    = headset_spp_cb.tx_buffer;
+    headset_spp_cb.bulk.buffer_size = sizeof(headset_spp_cb.tx_buffer);
+    headset_spp_cb.bulk.frame_len   = sizeof(headset_spp_cb.tx_buffer);
+    headset_spp_cb.bulk.p_rsp_start = &headset_spp_rsp_start;
+    headset_spp_cb.bulk.p_request   = &headset_spp_request;
+    headset_spp_cb.bulk.p_tx_next   = &headset_spp_nvram_next;
+
+    headset_event_subscribe(HEADSET_EVENT_MASK(HEADSET_EVENT_BREDR_DISCONNECTED), &headset_spp_event_handler);
+
+    headset_spp_server_start();
+}
+
+/*
+ * headset_spp_stats_get
+ */
+void headset_spp_stats_get(headset_spp_stats_t *p_stats)
+{
+    *p_stats            = headset_spp_cb.stats;
+    p_stats->bench_kbps = headset_spp_cb.bulk.bench_kbps;
+}
+
+#endif /* HEADSET_SPP_BULK */
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * SPP bulk data service.
+ *
+ * An RFCOMM server on OFU_SPP_RFCOMM_SCN, the channel of the SPP record of
+ * the SDP database, returns the statistics snapshot, the connection
+ * timelines and an NVRAM backup to a BR/EDR peer, and runs throughput
+ * benchmarks. It moves data much faster than the LE GATT notifications:
+ * - The RFCOMM MTU is the L2CAP MTU of the application channels
+ *   (WICED_APP_CFG_MAX_RX_MTU) less the RFCOMM header, every write is one
+ *   full frame.
+ * - The responses are built in place in the frame buffer, which is handed
+ *   to RFCOMM as is; the benchmark sends the same buffer again and again.
+ * - The headset writes until RFCOMM stops accepting data or the peer runs
+ *   out of credits, and resumes on the flow control and TX empty events.
+ *   No credit is given to the peer while a response is being sent.
+ *
+ * The requests and responses are those of headset_bulk.h. The SPP service
+ * adds:
+ * HEADSET_BULK_OP_NVRAM:    LEN is HEADSET_BULK_LEN_STREAM, DATA is a list of
+ *                           | ID (2) | LEN (2) | DATA | NVRAM items ended by
+ *                           ID 0. Only sent over an encrypted link, the
+ *                           items holding keys (link keys, LE bonds, local
+ *                           IRK, Fast Pair account keys) are left out.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_app_cfg.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+/* Address, control, 2 bytes of length, credit and FCS */
+#define HEADSET_SPP_RFCOMM_OVERHEAD     6
+#define HEADSET_SPP_MTU                 (WICED_APP_CFG_MAX_RX_MTU - HEADSET_SPP_RFCOMM_OVERHEAD)
+
+#define HEADSET_SPP_LINK_MAX            2       /* br_max_simultaneous_links */
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint8_t  connected;
+    uint16_t connections;
+    uint16_t flow_off;          /* writes stopped by RFCOMM flow control */
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;
+    uint32_t bench_kbps;        /* last benchmark, as seen by the headset */
+} headset_spp_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void headset_spp_init(void);
+void headset_spp_encryption_status(const wiced_bt_device_address_t bd_addr, uint8_t transport, wiced_result_t result);
+void headset_spp_stats_get(headset_spp_stats_t *p_stats);
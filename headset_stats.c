@@ -0,0 +1,374 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application statistics snapshot.
+ */
+#include "wiced.h"
+#include "wiced_bt_trace.h"
+#include "wiced_memory.h"
+#include "wiced_transport.h"
+#include "headset_control.h"
+#include "headset_timer.h"
+#include "headset_work.h"
+#include "headset_sniff.h"
+#include "headset_link_monitor.h"
+#include "headset_avrc.h"
+#include "headset_gatt.h"
+#include "headset_sdp.h"
+#include "headset_le_bond.h"
+#include "headset_spp.h"
+#include "headset_le_coc.h"
+#include "headset_stats.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_STATS_POOL_MAX      10      /* max_number_of_buffer_pools */
+
+/* Header, then each record is at most 2 + value bytes. */
+#define HEADSET_STATS_LEN_MAX       (1 + 4 + \
+                                     (2 + 4) + \
+                                     (2 + HEADSET_STATS_POOL_MAX * 8) + \
+                                     (2 + 20) + \
+                                     (2 + 13) + \
+                                     (2 + 8 * HEADSET_WORK_PRIORITY_MAX + 10) + \
+                                     (2 + 20) + \
+                                     (2 + HEADSET_LINK_MONITOR_LINK_MAX * 15) + \
+                                     (2 + HEADSET_SNIFF_LINK_MAX * (7 + 4 * HEADSET_SNIFF_MODE_MAX)) + \
+                                     (2 + 12) + \
+                                     (2 + HEADSET_GATT_LINK_MAX * HEADSET_GATT_BEARER_MAX * 21) + \
+                                     (2 + 18) + \
+                                     (2 + 20) + \
+                                     (2 + 17) + \
+                                     (2 + 27))
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static uint8_t headset_stats_buffer[HEADSET_STATS_LEN_MAX];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_stats_record_start
+ *
+ * Write the record type, return the location of the length byte.
+ */
+static uint8_t *headset_stats_record_start(uint8_t **pp, uint8_t type)
+{
+    uint8_t *p_len;
+
+    UINT8_TO_STREAM(*pp, type);
+
+    p_len = *pp;
+    (*pp)++;
+
+    return p_len;
+}
+
+/*
+ * headset_stats_record_end
+ */
+static void headset_stats_record_end(uint8_t *p, uint8_t *p_len)
+{
+    *p_len = (uint8_t)(p - p_len - 1);
+}
+
+/*
+ * headset_stats_pools_add
+ */
+static uint8_t *headset_stats_pools_add(uint8_t *p)
+{
+#if BTSTACK_VER >= 0x03000001
+    /* The v3 stack allocates from heaps, see HEADSET_STATS_TYPE_MEMORY. */
+    return p;
+#else
+    wiced_bt_buffer_statistics_t pools[HEADSET_STATS_POOL_MAX];
+    uint8_t                     *p_len;
+    uint8_t                      i;
+
+    memset((void *)pools, 0, sizeof(pools));
+
+    if (wiced_bt_get_buffer_usage(pools, sizeof(pools)) != WICED_BT_SUCCESS)
+    {
+        return p;
+    }
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_POOLS);
+
+    for (i = 0; i < HEADSET_STATS_POOL_MAX; i++)
+    {
+        if (pools[i].total_count == 0)
+        {
+            continue;
+        }
+
+        UINT16_TO_STREAM(p, pools[i].pool_size);
+        UINT16_TO_STREAM(p, pools[i].current_allocated_count);
+        UINT16_TO_STREAM(p, pools[i].max_allocated_count);
+        UINT16_TO_STREAM(p, pools[i].total_count);
+    }
+
+    headset_stats_record_end(p, p_len);
+
+    return p;
+#endif
+}
+
+/*
+ * headset_stats_build
+ *
+ * Serialize the snapshot, return the length.
+ *
+ * Byte: |    0    |    1 - 4     |           5 ...            |
+ * Data: | VERSION | TIMESTAMP_MS | (TYPE, LEN, VALUE) records |
+ */
+uint16_t headset_stats_build(uint8_t *p_data, uint16_t max_len)
+{
+    headset_control_mic_stats_t     mic;
+    headset_control_mgmt_cb_stats_t mgmt_cb;
+    headset_work_stats_t            work;
+    headset_timer_stats_t           timer;
+    headset_link_monitor_stats_t    link[HEADSET_LINK_MONITOR_LINK_MAX];
+    headset_sniff_link_stats_t      sniff[HEADSET_SNIFF_LINK_MAX];
+    headset_avrc_stats_t            avrc;
+    headset_gatt_bearer_stats_t     gatt[HEADSET_GATT_LINK_MAX * HEADSET_GATT_BEARER_MAX];
+    headset_sdp_stats_t             sdp;
+    headset_le_bond_stats_t         le_bond;
+#ifdef HEADSET_SPP_BULK
+    headset_spp_stats_t             spp;
+#endif
+#ifdef HEADSET_LE_COC
+    headset_le_coc_stats_t          le_coc;
+#endif
+    uint8_t                        *p = p_data;
+    uint8_t                        *p_len;
+    uint8_t                         num;
+    uint8_t                         i;
+    uint8_t                         j;
+
+    if (max_len < HEADSET_STATS_LEN_MAX)
+    {
+        return 0;
+    }
+
+    UINT8_TO_STREAM(p, HEADSET_STATS_VERSION);
+    UINT32_TO_STREAM(p, headset_timer_now_ms());
+
+    /* Memory */
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_MEMORY);
+    UINT32_TO_STREAM(p, wiced_memory_get_free_bytes());
+    headset_stats_record_end(p, p_len);
+
+    p = headset_stats_pools_add(p);
+
+    /* MIC data ring */
+    headset_control_mic_stats_get(&mic);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_MIC);
+    UINT16_TO_STREAM(p, mic.fill);
+    UINT16_TO_STREAM(p, mic.fill_max);
+    UINT32_TO_STREAM(p, mic.bytes_in);
+    UINT32_TO_STREAM(p, mic.bytes_out);
+    UINT32_TO_STREAM(p, mic.overflow);
+    UINT32_TO_STREAM(p, mic.underrun);
+    headset_stats_record_end(p, p_len);
+
+    /* Management callback */
+    headset_control_mgmt_cb_stats_get(&mgmt_cb);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_MGMT_CB);
+    UINT32_TO_STREAM(p, mgmt_cb.count);
+    UINT32_TO_STREAM(p, mgmt_cb.max_us);
+    UINT8_TO_STREAM(p, mgmt_cb.max_event);
+    UINT32_TO_STREAM(p, (uint32_t)(mgmt_cb.total_us / 1000));
+    headset_stats_record_end(p, p_len);
+
+    /* Work queue */
+    headset_work_stats_get(&work);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_WORK);
+    for (i = 0; i < HEADSET_WORK_PRIORITY_MAX; i++)
+    {
+        UINT32_TO_STREAM(p, work.posted[i]);
+        UINT32_TO_STREAM(p, work.executed[i]);
+    }
+    UINT32_TO_STREAM(p, work.dropped);
+    UINT16_TO_STREAM(p, work.in_use_max);
+    UINT32_TO_STREAM(p, work.run_time_max_us);
+    headset_stats_record_end(p, p_len);
+
+    /* Timer service */
+    headset_timer_stats_get(&timer);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_TIMER);
+    UINT32_TO_STREAM(p, timer.wakeups);
+    UINT32_TO_STREAM(p, timer.expired);
+    UINT32_TO_STREAM(p, timer.coalesced);
+    UINT32_TO_STREAM(p, timer.wakeups_per_minute);
+    UINT32_TO_STREAM(p, timer.expired_per_minute);
+    headset_stats_record_end(p, p_len);
+
+    /* Link quality */
+    num = headset_link_monitor_stats_get(link, HEADSET_LINK_MONITOR_LINK_MAX);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_LINK);
+    for (i = 0; i < num; i++)
+    {
+        ARRAY_TO_STREAM(p, link[i].bd_addr, BD_ADDR_LEN);
+        UINT8_TO_STREAM(p, (uint8_t)link[i].rssi);
+        UINT8_TO_STREAM(p, (uint8_t)link[i].rssi_avg);
+        UINT8_TO_STREAM(p, link[i].edr_3m);
+        UINT16_TO_STREAM(p, link[i].switches);
+        UINT32_TO_STREAM(p, link[i].samples);
+    }
+    headset_stats_record_end(p, p_len);
+
+    /* Sleep residency of each ACL */
+    num = headset_sniff_stats_get(sniff, HEADSET_SNIFF_LINK_MAX);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_SNIFF);
+    for (i = 0; i < num; i++)
+    {
+        ARRAY_TO_STREAM(p, sniff[i].bd_addr, BD_ADDR_LEN);
+        UINT8_TO_STREAM(p, sniff[i].mode);
+        for (j = 0; j < HEADSET_SNIFF_MODE_MAX; j++)
+        {
+            UINT32_TO_STREAM(p, sniff[i].time_ms[j]);
+        }
+    }
+    headset_stats_record_end(p, p_len);
+
+    /* AVRCP */
+    headset_avrc_stats_get(&avrc);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_AVRC);
+    UINT32_TO_STREAM(p, avrc.notifications);
+    UINT32_TO_STREAM(p, avrc.registrations);
+    UINT32_TO_STREAM(p, avrc.metadata_requests);
+    headset_stats_record_end(p, p_len);
+
+    /* GATT bearers */
+    num = headset_gatt_stats_get(gatt, HEADSET_GATT_LINK_MAX * HEADSET_GATT_BEARER_MAX);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_GATT);
+    for (i = 0; i < num; i++)
+    {
+        UINT16_TO_STREAM(p, gatt[i].conn_id);
+        UINT16_TO_STREAM(p, gatt[i].mtu);
+        UINT8_TO_STREAM(p, gatt[i].eatt);
+        UINT32_TO_STREAM(p, gatt[i].requests);
+        UINT32_TO_STREAM(p, gatt[i].notifications);
+        UINT32_TO_STREAM(p, gatt[i].handler_max_us);
+        UINT32_TO_STREAM(p, gatt[i].handler_total_us);
+    }
+    headset_stats_record_end(p, p_len);
+
+    /* SDP database */
+    headset_sdp_stats_get(&sdp);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_SDP);
+    UINT16_TO_STREAM(p, sdp.db_size);
+    UINT16_TO_STREAM(p, sdp.db_saved);
+    UINT16_TO_STREAM(p, sdp.exchanges);
+    UINT32_TO_STREAM(p, sdp.last_ms);
+    UINT32_TO_STREAM(p, sdp.max_ms);
+    UINT32_TO_STREAM(p, sdp.total_ms);
+    headset_stats_record_end(p, p_len);
+
+    /* LE bonds in the controller lists */
+    headset_le_bond_stats_get(&le_bond);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_LE_BOND);
+    UINT8_TO_STREAM(p, le_bond.bonds);
+    UINT8_TO_STREAM(p, le_bond.accept_list_size);
+    UINT16_TO_STREAM(p, le_bond.directed_adv);
+    UINT16_TO_STREAM(p, le_bond.reconnects);
+    UINT16_TO_STREAM(p, le_bond.unknown_peers);
+    UINT32_TO_STREAM(p, le_bond.last_ms);
+    UINT32_TO_STREAM(p, le_bond.max_ms);
+    UINT32_TO_STREAM(p, le_bond.total_ms);
+    headset_stats_record_end(p, p_len);
+
+#ifdef HEADSET_SPP_BULK
+    /* SPP bulk data service */
+    headset_spp_stats_get(&spp);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_SPP);
+    UINT8_TO_STREAM(p, spp.connected);
+    UINT16_TO_STREAM(p, spp.connections);
+    UINT16_TO_STREAM(p, spp.flow_off);
+    UINT32_TO_STREAM(p, spp.rx_bytes);
+    UINT32_TO_STREAM(p, spp.tx_bytes);
+    UINT32_TO_STREAM(p, spp.bench_kbps);
+    headset_stats_record_end(p, p_len);
+#endif
+
+#ifdef HEADSET_LE_COC
+    /* LE CoC bulk data service */
+    headset_le_coc_stats_get(&le_coc);
+
+    p_len = headset_stats_record_start(&p, HEADSET_STATS_TYPE_LE_COC);
+    UINT8_TO_STREAM(p, le_coc.connected);
+    UINT16_TO_STREAM(p, le_coc.connections);
+    UINT16_TO_STREAM(p, le_coc.congested);
+    UINT16_TO_STREAM(p, le_coc.sdu_len);
+    UINT32_TO_STREAM(p, le_coc.rx_bytes);
+    UINT32_TO_STREAM(p, le_coc.tx_bytes);
+    UINT32_TO_STREAM(p, le_coc.bench_kbps);
+    UINT32_TO_STREAM(p, le_coc.gatt_bytes);
+    UINT32_TO_STREAM(p, le_coc.gatt_kbps);
+    headset_stats_record_end(p, p_len);
+#endif
+
+    return (uint16_t)(p - p_data);
+}
+
+/*
+ * headset_stats_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_STATS, reply with
+ * HCI_CONTROL_HCI_AUDIO_EVENT_STATS.
+ */
+void headset_stats_send(uint8_t *p_data, uint32_t data_len)
+{
+    uint16_t len;
+
+    len = headset_stats_build(headset_stats_buffer, sizeof(headset_stats_buffer));
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_STATS, headset_stats_buffer, len);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application statistics snapshot.
+ *
+ * All the device counters are returned in a single HCI event so the host
+ * can poll them at a low, fixed cost while streaming. The snapshot is a
+ * version byte and a millisecond timestamp followed by TLV records
+ * (type, length, value). The records are bounded by the number of links,
+ * a host shall skip the record types it does not know.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_STATS_VERSION       1
+
+/* Record types */
+enum
+{
+    HEADSET_STATS_TYPE_MEMORY   = 0x01, /* free bytes */
+    HEADSET_STATS_TYPE_POOLS    = 0x02, /* per buffer pool: size, in use, max in use, total */
+    HEADSET_STATS_TYPE_MIC      = 0x03, /* headset_control_mic_stats_t */
+    HEADSET_STATS_TYPE_MGMT_CB  = 0x04, /* headset_control_mgmt_cb_stats_t */
+    HEADSET_STATS_TYPE_WORK     = 0x05, /* headset_work_stats_t */
+    HEADSET_STATS_TYPE_TIMER    = 0x06, /* headset_timer_stats_t */
+    HEADSET_STATS_TYPE_LINK     = 0x07, /* per ACL: headset_link_monitor_stats_t */
+    HEADSET_STATS_TYPE_SNIFF    = 0x08, /* per ACL: headset_sniff_link_stats_t */
+    HEADSET_STATS_TYPE_AVRC     = 0x09, /* headset_avrc_stats_t */
+    HEADSET_STATS_TYPE_GATT     = 0x0A, /* per ATT/EATT bearer: headset_gatt_bearer_stats_t */
+    HEADSET_STATS_TYPE_SDP      = 0x0B, /* headset_sdp_stats_t */
+    HEADSET_STATS_TYPE_LE_BOND  = 0x0C, /* headset_le_bond_stats_t */
+    HEADSET_STATS_TYPE_SPP      = 0x0D, /* headset_spp_stats_t, SPP_BULK=1 only */
+    HEADSET_STATS_TYPE_LE_COC   = 0x0E, /* headset_le_coc_stats_t, LE_COC=1 only */
+};
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+uint16_t headset_stats_build(uint8_t *p_data, uint16_t max_len);
+void     headset_stats_send(uint8_t *p_data, uint32_t data_len);
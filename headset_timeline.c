@@ -0,0 +1,344 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Pairing and connection setup timeline, see headset_timeline.h.
+ */
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_trace.h"
+#include "wiced_transport.h"
+#include "headset_control.h"
+#include "headset_event.h"
+#include "headset_timer.h"
+#include "headset_timeline.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_TIMELINE_PEER_LEN       (BD_ADDR_LEN + 1 + 4 + HEADSET_TIMELINE_STEP_MAX * 6)
+#define HEADSET_TIMELINE_LEN_MAX        (1 + 4 + 1 + 1 + HEADSET_TIMELINE_PEER_MAX * HEADSET_TIMELINE_PEER_LEN)
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint32_t time_ms;       /* first occurrence */
+    uint8_t  status;        /* last occurrence */
+    uint8_t  count;
+} headset_timeline_step_mark_t;
+
+typedef struct
+{
+    wiced_bool_t                 in_use;
+    wiced_bool_t                 connected;
+    wiced_bt_device_address_t    bd_addr;
+    uint32_t                     start_ms;
+    headset_timeline_step_mark_t step[HEADSET_TIMELINE_STEP_MAX];
+} headset_timeline_peer_t;
+
+typedef struct
+{
+    headset_timeline_peer_t  peer[HEADSET_TIMELINE_PEER_MAX];
+    headset_timeline_peer_t *p_last;    /* peer of the last step, for the events without address */
+} headset_timeline_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_timeline_cb_t headset_timeline_cb = { 0 };
+static uint8_t               headset_timeline_buffer[HEADSET_TIMELINE_LEN_MAX];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_timeline_peer_find
+ */
+static headset_timeline_peer_t *headset_timeline_peer_find(const uint8_t *p_bd_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_TIMELINE_PEER_MAX; i++)
+    {
+        if (headset_timeline_cb.peer[i].in_use &&
+            (memcmp((void *)headset_timeline_cb.peer[i].bd_addr, (void *)p_bd_addr, sizeof(wiced_bt_device_address_t)) == 0))
+        {
+            return &headset_timeline_cb.peer[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_timeline_peer_start
+ *
+ * Start a new timeline for a peer. The slot is a free one, else the oldest
+ * timeline of a disconnected peer, else the oldest timeline.
+ */
+static headset_timeline_peer_t *headset_timeline_peer_start(const uint8_t *p_bd_addr)
+{
+    headset_timeline_peer_t *p_peer = headset_timeline_peer_find(p_bd_addr);
+    headset_timeline_peer_t *p_candidate;
+    uint8_t                  i;
+
+    for (i = 0; (i < HEADSET_TIMELINE_PEER_MAX) && (p_peer == NULL); i++)
+    {
+        if (!headset_timeline_cb.peer[i].in_use)
+        {
+            p_peer = &headset_timeline_cb.peer[i];
+        }
+    }
+
+    if (p_peer == NULL)
+    {
+        for (i = 0; i < HEADSET_TIMELINE_PEER_MAX; i++)
+        {
+            p_candidate = &headset_timeline_cb.peer[i];
+
+            if ((p_peer == NULL) ||
+                (p_peer->connected && !p_candidate->connected) ||
+                ((p_peer->connected == p_candidate->connected) &&
+                 ((int32_t)(p_candidate->start_ms - p_peer->start_ms) < 0)))
+            {
+                p_peer = p_candidate;
+            }
+        }
+    }
+
+    memset((void *)p_peer, 0, sizeof(headset_timeline_peer_t));
+    memcpy((void *)p_peer->bd_addr, (void *)p_bd_addr, sizeof(wiced_bt_device_address_t));
+    p_peer->in_use   = WICED_TRUE;
+    p_peer->start_ms = headset_timer_now_ms();
+
+    return p_peer;
+}
+
+/*
+ * headset_timeline_event_handler
+ */
+static void headset_timeline_event_handler(const headset_event_data_t *p_data)
+{
+    headset_timeline_peer_t *p_peer;
+
+    switch (p_data->event)
+    {
+    case HEADSET_EVENT_BREDR_CONNECTED:
+    case HEADSET_EVENT_LE_CONNECTED:
+        headset_timeline_mark(p_data->bd_addr, HEADSET_TIMELINE_STEP_ACL_CONNECTED, 0);
+        break;
+
+    case HEADSET_EVENT_BREDR_DISCONNECTED:
+    case HEADSET_EVENT_LE_DISCONNECTED:
+        p_peer = headset_timeline_peer_find(p_data->bd_addr);
+        if (p_peer)
+        {
+            p_peer->connected = WICED_FALSE;
+        }
+        break;
+
+    case HEADSET_EVENT_A2DP_CONNECTED:
+        headset_timeline_mark(p_data->bd_addr, HEADSET_TIMELINE_STEP_A2DP_CONNECTED, p_data->status);
+        break;
+
+    case HEADSET_EVENT_AVRC_CONNECTED:
+        headset_timeline_mark(p_data->bd_addr, HEADSET_TIMELINE_STEP_AVRC_CONNECTED, p_data->status);
+        break;
+
+    case HEADSET_EVENT_HFP_CONNECTED:
+        headset_timeline_mark(p_data->bd_addr, HEADSET_TIMELINE_STEP_HFP_CONNECTED, p_data->status);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * headset_timeline_init
+ */
+void headset_timeline_init(void)
+{
+    memset((void *)&headset_timeline_cb, 0, sizeof(headset_timeline_cb));
+
+    headset_event_subscribe(HEADSET_EVENT_MASK(HEADSET_EVENT_BREDR_CONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_BREDR_DISCONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_LE_CONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_LE_DISCONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_A2DP_CONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_AVRC_CONNECTED) |
+                            HEADSET_EVENT_MASK(HEADSET_EVENT_HFP_CONNECTED),
+                            &headset_timeline_event_handler);
+}
+
+/*
+ * headset_timeline_mark
+ *
+ * Timestamp a step of a peer. The ACL connection starts a new timeline, a
+ * NULL address refers to the peer of the previous step (local key updates).
+ * Called from the management callback, keep it short.
+ */
+void headset_timeline_mark(const uint8_t *p_bd_addr, headset_timeline_step_t step, uint8_t status)
+{
+    headset_timeline_peer_t      *p_peer;
+    headset_timeline_step_mark_t *p_mark;
+
+    if (step >= HEADSET_TIMELINE_STEP_MAX)
+    {
+        return;
+    }
+
+    if (p_bd_addr == NULL)
+    {
+        p_peer = headset_timeline_cb.p_last;
+    }
+    else if (step == HEADSET_TIMELINE_STEP_ACL_CONNECTED)
+    {
+        p_peer = headset_timeline_peer_start(p_bd_addr);
+        p_peer->connected = WICED_TRUE;
+    }
+    else
+    {
+        p_peer = headset_timeline_peer_find(p_bd_addr);
+
+        if (p_peer == NULL)
+        {
+            p_peer = headset_timeline_peer_start(p_bd_addr);
+            p_peer->connected = WICED_TRUE;
+        }
+    }
+
+    if ((p_peer == NULL) || !p_peer->in_use)
+    {
+        return;
+    }
+
+    p_mark = &p_peer->step[step];
+
+    if (p_mark->count == 0)
+    {
+        p_mark->time_ms = headset_timer_now_ms();
+    }
+    if (p_mark->count < 0xFF)
+    {
+        p_mark->count++;
+    }
+    p_mark->status = status;
+
+    headset_timeline_cb.p_last = p_peer;
+}
+
+/*
+ * headset_timeline_build
+ *
+ * Write the timelines to p_data, return the length, 0 if max_len is too small.
+ * The step offsets are in ms from START_MS, HEADSET_TIMELINE_NOT_REACHED if
+ * the step did not occur.
+ *
+ * Byte: |    0    | 1 - 4  |   5   |   6   |
+ * Data: | VERSION | NOW_MS | STEPS | PEERS |
+ * Per peer:
+ * Byte: | 0 - 5   |     6     |  7 - 10  | 11 ... (x STEPS)           |
+ * Data: | BD_ADDR | CONNECTED | START_MS | OFFSET_MS | STATUS | COUNT |
+ */
+uint16_t headset_timeline_build(uint8_t *p_data, uint16_t max_len)
+{
+    headset_timeline_peer_t *p_peer;
+    uint8_t                 *p = p_data;
+    uint8_t                 *p_num;
+    uint8_t                  num = 0;
+    uint8_t                  i;
+    uint8_t                  j;
+
+    if (max_len < HEADSET_TIMELINE_LEN_MAX)
+    {
+        return 0;
+    }
+
+    UINT8_TO_STREAM(p, HEADSET_TIMELINE_VERSION);
+    UINT32_TO_STREAM(p, headset_timer_now_ms());
+    UINT8_TO_STREAM(p, HEADSET_TIMELINE_STEP_MAX);
+    p_num = p++;
+
+    for (i = 0; i < HEADSET_TIMELINE_PEER_MAX; i++)
+    {
+        p_peer = &headset_timeline_cb.peer[i];
+
+        if (!p_peer->in_use)
+        {
+            continue;
+        }
+
+        ARRAY_TO_STREAM(p, p_peer->bd_addr, BD_ADDR_LEN);
+        UINT8_TO_STREAM(p, p_peer->connected);
+        UINT32_TO_STREAM(p, p_peer->start_ms);
+
+        for (j = 0; j < HEADSET_TIMELINE_STEP_MAX; j++)
+        {
+            UINT32_TO_STREAM(p, p_peer->step[j].count ?
+                                (p_peer->step[j].time_ms - p_peer->start_ms) : HEADSET_TIMELINE_NOT_REACHED);
+            UINT8_TO_STREAM(p, p_peer->step[j].status);
+            UINT8_TO_STREAM(p, p_peer->step[j].count);
+        }
+
+        num++;
+    }
+
+    *p_num = num;
+
+    return (uint16_t)(p - p_data);
+}
+
+/*
+ * headset_timeline_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_TIMELINE, reply with
+ * HCI_CONTROL_HCI_AUDIO_EVENT_TIMELINE (see headset_timeline_build). A
+ * non-zero first byte in the command clears the timelines after they are
+ * sent.
+ */
+void headset_timeline_send(uint8_t *p_data, uint32_t data_len)
+{
+    uint16_t len = headset_timeline_build(headset_timeline_buffer, sizeof(headset_timeline_buffer));
+
+    wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_TIMELINE, headset_timeline_buffer, len);
+
+    if ((data_len >= 1) && p_data[0])
+    {
+        memset((void *)&headset_timeline_cb, 0, sizeof(headset_timeline_cb));
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Pairing and connection setup timeline.
+ *
+ * Each step of the security procedure handled by the management callback
+ * and the profile connections which follow it are timestamped per peer, so
+ * the host can see where the time goes between the ACL connection and a
+ * fully connected headset. A timeline starts with the ACL connection (or the
+ * first security event of an LE peer) and is kept after the disconnection
+ * until the slot is needed by another peer.
+ */
+#pragma once
+
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_TIMELINE_VERSION        1
+#define HEADSET_TIMELINE_PEER_MAX       4
+
+#define HEADSET_TIMELINE_NOT_REACHED    0xFFFFFFFF      /* step offset */
+
+typedef enum
+{
+    HEADSET_TIMELINE_STEP_ACL_CONNECTED,
+    HEADSET_TIMELINE_STEP_IO_CAP_REQUEST,       /* local IO capabilities requested (BR/EDR or LE) */
+    HEADSET_TIMELINE_STEP_IO_CAP_RESPONSE,      /* peer IO capabilities received */
+    HEADSET_TIMELINE_STEP_USER_CONFIRMATION,
+    HEADSET_TIMELINE_STEP_PAIRING_COMPLETE,     /* status: pairing result */
+    HEADSET_TIMELINE_STEP_ENCRYPTION,           /* status: encryption result */
+    HEADSET_TIMELINE_STEP_LINK_KEY_UPDATE,
+    HEADSET_TIMELINE_STEP_IRK_UPDATE,           /* local identity keys updated */
+    HEADSET_TIMELINE_STEP_A2DP_CONNECTED,
+    HEADSET_TIMELINE_STEP_AVRC_CONNECTED,
+    HEADSET_TIMELINE_STEP_HFP_CONNECTED,        /* service level connection */
+    HEADSET_TIMELINE_STEP_MAX,
+} headset_timeline_step_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void     headset_timeline_init(void);
+void     headset_timeline_mark(const uint8_t *p_bd_addr, headset_timeline_step_t step, uint8_t status);
+uint16_t headset_timeline_build(uint8_t *p_data, uint16_t max_len);
+void     headset_timeline_send(uint8_t *p_data, uint32_t data_len);
@@ -0,0 +1,618 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application timer service: hierarchical timer wheel on top of one wiced timer.
+ *
+ * The wheel has HEADSET_TIMER_LEVELS levels of HEADSET_TIMER_SLOTS slots. Level 0
+ * holds the timers expiring within the next HEADSET_TIMER_SLOTS ticks, level n holds
+ * the timers expiring within the next HEADSET_TIMER_SLOTS^(n+1) ticks and is cascaded
+ * into the lower levels each time the level below wraps around.
+ *
+ * The wheel is not ticked periodically. The wiced timer is armed for the next
+ * expiry and, on expiration, the wheel catches up with the elapsed ticks.
+ */
+#include "wiced.h"
+#include "wiced_timer.h"
+#include "wiced_bt_trace.h"
+#include "headset_timer.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_TIMER_LEVELS        4
+#define HEADSET_TIMER_SLOT_BITS     5
+#define HEADSET_TIMER_SLOTS         (1 << HEADSET_TIMER_SLOT_BITS)
+#define HEADSET_TIMER_SLOT_MASK     (HEADSET_TIMER_SLOTS - 1)
+#define HEADSET_TIMER_RANGE         (1UL << (HEADSET_TIMER_SLOT_BITS * HEADSET_TIMER_LEVELS))   /* ~2.9 hours */
+#define HEADSET_TIMER_MINUTE        (60000 / HEADSET_TIMER_TICK_MS)
+
+#define HEADSET_TIMER_MS_TO_TICKS(ms)   (((ms) + HEADSET_TIMER_TICK_MS - 1) / HEADSET_TIMER_TICK_MS)
+
+/* Both ends of the largest window shall fall into level 0. */
+#if (2 * HEADSET_TIMER_WINDOW_MAX_MS / HEADSET_TIMER_TICK_MS) >= HEADSET_TIMER_SLOTS
+#error "HEADSET_TIMER_WINDOW_MAX_MS too large for the level 0 span"
+#endif
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    wiced_timer_t         hw_timer;
+    wiced_bool_t          hw_timer_armed;
+    uint32_t              hw_timer_tick;    /* tick the hardware timer is armed for */
+    wiced_bool_t          running;          /* expired timers are being processed */
+    uint32_t              now;              /* next tick to be processed by the wheel */
+    headset_timer_t      *p_slot[HEADSET_TIMER_LEVELS][HEADSET_TIMER_SLOTS];
+    uint32_t              occupied[HEADSET_TIMER_LEVELS];  /* bitmap of the non-empty slots */
+    uint32_t              minute_start;
+    uint32_t              minute_wakeups;
+    uint32_t              minute_expired;
+    headset_timer_stats_t stats;
+} headset_timer_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+extern uint64_t clock_SystemTimeMicroseconds64(void);
+
+static headset_timer_cb_t headset_timer_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_timer_tick_get
+ *
+ * Current system time in wheel ticks.
+ */
+static uint32_t headset_timer_tick_get(void)
+{
+    return (uint32_t)(clock_SystemTimeMicroseconds64() / (1000 * HEADSET_TIMER_TICK_MS));
+}
+
+static void headset_timer_list_add(headset_timer_t **pp_head, headset_timer_t *p_timer)
+{
+    p_timer->p_next  = *pp_head;
+    p_timer->pp_prev = pp_head;
+
+    if (*pp_head)
+    {
+        (*pp_head)->pp_prev = &p_timer->p_next;
+    }
+
+    *pp_head = p_timer;
+}
+
+static void headset_timer_list_remove(headset_timer_t *p_timer)
+{
+    *p_timer->pp_prev = p_timer->p_next;
+
+    if (p_timer->p_next)
+    {
+        p_timer->p_next->pp_prev = p_timer->pp_prev;
+    }
+
+    p_timer->p_next  = NULL;
+    p_timer->pp_prev = NULL;
+}
+
+/*
+ * headset_timer_unlink
+ *
+ * Remove the timer from the wheel slot or the expired list it belongs to.
+ */
+static void headset_timer_unlink(headset_timer_t *p_timer)
+{
+    headset_timer_list_remove(p_timer);
+
+    if ((p_timer->level < HEADSET_TIMER_LEVELS) &&
+        (headset_timer_cb.p_slot[p_timer->level][p_timer->slot] == NULL))
+    {
+        headset_timer_cb.occupied[p_timer->level] &= ~(1UL << p_timer->slot);
+    }
+
+    p_timer->level = HEADSET_TIMER_LEVELS;
+}
+
+/*
+ * headset_timer_wheel_insert
+ *
+ * Place the timer in the wheel according to the latest tick it may fire at.
+ */
+static void headset_timer_wheel_insert(headset_timer_t *p_timer)
+{
+    uint32_t expires = p_timer->deadline + p_timer->window;
+    uint32_t delta;
+    uint8_t  level;
+
+    if ((int32_t)(expires - headset_timer_cb.now) < 0)
+    {
+        expires = headset_timer_cb.now;
+    }
+
+    delta = expires - headset_timer_cb.now;
+
+    /* Timers beyond the wheel range are parked in the last level and re-cascaded. */
+    if (delta >= HEADSET_TIMER_RANGE)
+    {
+        delta   = HEADSET_TIMER_RANGE - 1;
+        expires = headset_timer_cb.now + delta;
+    }
+
+    for (level = 0; level < HEADSET_TIMER_LEVELS - 1; level++)
+    {
+        if (delta < (1UL << (HEADSET_TIMER_SLOT_BITS * (level + 1))))
+        {
+            break;
+        }
+    }
+
+    p_timer->level = level;
+    p_timer->slot  = (expires >> (HEADSET_TIMER_SLOT_BITS * level)) & HEADSET_TIMER_SLOT_MASK;
+
+    headset_timer_list_add(&headset_timer_cb.p_slot[level][p_timer->slot], p_timer);
+    headset_timer_cb.occupied[level] |= 1UL << p_timer->slot;
+}
+
+/*
+ * headset_timer_wheel_cascade
+ *
+ * Redistribute the higher level slots which become current at this tick.
+ */
+static void headset_timer_wheel_cascade(void)
+{
+    headset_timer_t *p_list;
+    headset_timer_t *p_timer;
+    uint32_t         index;
+    uint8_t          level;
+
+    for (level = 1; level < HEADSET_TIMER_LEVELS; level++)
+    {
+        index  = (headset_timer_cb.now >> (HEADSET_TIMER_SLOT_BITS * level)) & HEADSET_TIMER_SLOT_MASK;
+        p_list = headset_timer_cb.p_slot[level][index];
+
+        headset_timer_cb.p_slot[level][index] = NULL;
+        headset_timer_cb.occupied[level] &= ~(1UL << index);
+
+        while ((p_timer = p_list) != NULL)
+        {
+            p_list = p_timer->p_next;
+            headset_timer_wheel_insert(p_timer);
+        }
+
+        if (index != 0)
+        {
+            break;
+        }
+    }
+}
+
+/*
+ * headset_timer_wheel_run
+ *
+ * Advance the wheel up to (and including) the given tick and move the expired
+ * timers to the expired list.
+ */
+static void headset_timer_wheel_run(uint32_t tick, headset_timer_t **pp_expired)
+{
+    headset_timer_t *p_timer;
+    uint32_t         index;
+
+    while ((int32_t)(tick - headset_timer_cb.now) >= 0)
+    {
+        index = headset_timer_cb.now & HEADSET_TIMER_SLOT_MASK;
+
+        if (index == 0)
+        {
+            headset_timer_wheel_cascade();
+        }
+
+        /* Skip to the next level 0 wrap-around while there is nothing to expire. */
+        if (headset_timer_cb.occupied[0] == 0)
+        {
+            headset_timer_cb.now |= HEADSET_TIMER_SLOT_MASK;
+
+            if ((int32_t)(headset_timer_cb.now - tick) > 0)
+            {
+                headset_timer_cb.now = tick;
+            }
+
+            headset_timer_cb.now++;
+            continue;
+        }
+
+        while ((p_timer = headset_timer_cb.p_slot[0][index]) != NULL)
+        {
+            headset_timer_unlink(p_timer);
+            headset_timer_list_add(pp_expired, p_timer);
+        }
+
+        headset_timer_cb.now++;
+    }
+}
+
+/*
+ * headset_timer_wheel_coalesce_slot
+ */
+static void headset_timer_wheel_coalesce_slot(headset_timer_t **pp_slot, uint32_t tick, headset_timer_t **pp_expired)
+{
+    headset_timer_t *p_timer = *pp_slot;
+    headset_timer_t *p_next;
+
+    while (p_timer)
+    {
+        p_next = p_timer->p_next;
+
+        if ((int32_t)(p_timer->deadline - p_timer->window - tick) <= 0)
+        {
+            headset_timer_unlink(p_timer);
+            headset_timer_list_add(pp_expired, p_timer);
+            headset_timer_cb.stats.coalesced++;
+        }
+
+        p_timer = p_next;
+    }
+}
+
+/*
+ * headset_timer_wheel_coalesce
+ *
+ * Move the pending timers whose window is already open to the expired list so
+ * they are served by the current wakeup.
+ */
+static void headset_timer_wheel_coalesce(uint32_t tick, headset_timer_t **pp_expired)
+{
+    uint32_t shift;
+    uint32_t index;
+    uint8_t  level;
+
+    for (index = 0; (index < HEADSET_TIMER_SLOTS) && (headset_timer_cb.occupied[0]); index++)
+    {
+        headset_timer_wheel_coalesce_slot(&headset_timer_cb.p_slot[0][index], tick, pp_expired);
+    }
+
+    /* Only the next slot to be cascaded may hold timers close enough to be open. */
+    for (level = 1; level < HEADSET_TIMER_LEVELS; level++)
+    {
+        shift = HEADSET_TIMER_SLOT_BITS * level;
+        index = ((headset_timer_cb.now + (1UL << shift) - 1) >> shift) & HEADSET_TIMER_SLOT_MASK;
+
+        headset_timer_wheel_coalesce_slot(&headset_timer_cb.p_slot[level][index], tick, pp_expired);
+    }
+}
+
+/*
+ * headset_timer_wheel_next
+ *
+ * Find the tick the hardware timer shall be armed for.
+ */
+static wiced_bool_t headset_timer_wheel_next(uint32_t *p_tick)
+{
+    headset_timer_t *p_timer;
+    wiced_bool_t     found = WICED_FALSE;
+    uint32_t         best  = 0;
+    uint32_t         expires;
+    uint32_t         shift;
+    uint32_t         start;
+    uint32_t         i;
+    uint8_t          level;
+
+    for (level = 0; level < HEADSET_TIMER_LEVELS; level++)
+    {
+        if (headset_timer_cb.occupied[level] == 0)
+        {
+            continue;
+        }
+
+        /* Slot which becomes current (level 0) or is cascaded (upper levels) first. */
+        shift = HEADSET_TIMER_SLOT_BITS * level;
+        start = (headset_timer_cb.now + (1UL << shift) - 1) >> shift;
+
+        for (i = 0; i < HEADSET_TIMER_SLOTS; i++)
+        {
+            p_timer = headset_timer_cb.p_slot[level][(start + i) & HEADSET_TIMER_SLOT_MASK];
+
+            if (p_timer == NULL)
+            {
+                continue;
+            }
+
+            for (; p_timer != NULL; p_timer = p_timer->p_next)
+            {
+                expires = p_timer->deadline + p_timer->window;
+
+                if ((found == WICED_FALSE) || ((int32_t)(expires - best) < 0))
+                {
+                    best  = expires;
+                    found = WICED_TRUE;
+                }
+            }
+            break;
+        }
+    }
+
+    if ((found) && ((int32_t)(best - headset_timer_cb.now) < 0))
+    {
+        best = headset_timer_cb.now;
+    }
+
+    *p_tick = best;
+
+    return found;
+}
+
+/*
+ * headset_timer_hw_arm
+ *
+ * (Re)arm the hardware timer for the next expiry.
+ */
+static void headset_timer_hw_arm(void)
+{
+    uint32_t tick;
+    int32_t  delay;
+
+    if (headset_timer_cb.running)
+    {
+        return;
+    }
+
+    if (headset_timer_wheel_next(&tick) == WICED_FALSE)
+    {
+        if (headset_timer_cb.hw_timer_armed)
+        {
+            wiced_stop_timer(&headset_timer_cb.hw_timer);
+            headset_timer_cb.hw_timer_armed = WICED_FALSE;
+        }
+        return;
+    }
+
+    if ((headset_timer_cb.hw_timer_armed) && (headset_timer_cb.hw_timer_tick == tick))
+    {
+        return;
+    }
+
+    delay = (int32_t)(tick - headset_timer_tick_get());
+    if (delay < 1)
+    {
+        delay = 1;
+    }
+
+    if (headset_timer_cb.hw_timer_armed)
+    {
+        wiced_stop_timer(&headset_timer_cb.hw_timer);
+    }
+
+    wiced_start_timer(&headset_timer_cb.hw_timer, (uint32_t)delay * HEADSET_TIMER_TICK_MS);
+
+    headset_timer_cb.hw_timer_armed = WICED_TRUE;
+    headset_timer_cb.hw_timer_tick  = tick;
+}
+
+/*
+ * headset_timer_stats_update
+ */
+static void headset_timer_stats_update(uint32_t tick)
+{
+    uint32_t elapsed = tick - headset_timer_cb.minute_start;
+
+    if (elapsed >= HEADSET_TIMER_MINUTE)
+    {
+        headset_timer_cb.stats.wakeups_per_minute = (uint32_t)(((uint64_t)headset_timer_cb.minute_wakeups * HEADSET_TIMER_MINUTE) / elapsed);
+        headset_timer_cb.stats.expired_per_minute = (uint32_t)(((uint64_t)headset_timer_cb.minute_expired * HEADSET_TIMER_MINUTE) / elapsed);
+
+        headset_timer_cb.minute_start   = tick;
+        headset_timer_cb.minute_wakeups = 0;
+        headset_timer_cb.minute_expired = 0;
+    }
+}
+
+/*
+ * headset_timer_hw_timeout
+ *
+ * Hardware timer expiration: fire every timer which is due or whose window is open.
+ */
+static void headset_timer_hw_timeout(WICED_TIMER_PARAM_TYPE param)
+{
+    headset_timer_t *p_expired = NULL;
+    headset_timer_t *p_timer;
+    uint32_t         tick      = headset_timer_tick_get();
+
+    headset_timer_cb.hw_timer_armed = WICED_FALSE;
+    headset_timer_cb.running        = WICED_TRUE;
+
+    headset_timer_stats_update(tick);
+    headset_timer_cb.stats.wakeups++;
+    headset_timer_cb.minute_wakeups++;
+
+    headset_timer_wheel_run(tick, &p_expired);
+    headset_timer_wheel_coalesce(tick, &p_expired);
+
+    /* The callback may stop or restart any timer, including the ones still in this list. */
+    while ((p_timer = p_expired) != NULL)
+    {
+        headset_timer_unlink(p_timer);
+
+        headset_timer_cb.stats.expired++;
+        headset_timer_cb.minute_expired++;
+
+        if (p_timer->period)
+        {
+            p_timer->deadline += p_timer->period;
+
+            if ((int32_t)(p_timer->deadline - tick) <= 0)
+            {
+                p_timer->deadline = tick + p_timer->period;
+            }
+
+            headset_timer_wheel_insert(p_timer);
+        }
+
+        p_timer->p_callback(p_timer->arg);
+    }
+
+    headset_timer_cb.running = WICED_FALSE;
+
+    headset_timer_hw_arm();
+}
+
+/*
+ * headset_timer_start_internal
+ */
+static void headset_timer_start_internal(headset_timer_t *p_timer, uint32_t timeout_ms, uint32_t period_ms, uint16_t window_ms)
+{
+    if (p_timer->pp_prev)
+    {
+        headset_timer_unlink(p_timer);
+    }
+
+    /* The wheel is not advanced while it is empty. */
+    if ((headset_timer_cb.hw_timer_armed == WICED_FALSE) &&
+        (headset_timer_cb.running == WICED_FALSE))
+    {
+        headset_timer_cb.now = headset_timer_tick_get();
+    }
+
+    if (window_ms > HEADSET_TIMER_WINDOW_MAX_MS)
+    {
+        window_ms = HEADSET_TIMER_WINDOW_MAX_MS;
+    }
+
+    p_timer->window   = window_ms / HEADSET_TIMER_TICK_MS;
+    p_timer->period   = HEADSET_TIMER_MS_TO_TICKS(period_ms);
+    p_timer->deadline = headset_timer_tick_get() + HEADSET_TIMER_MS_TO_TICKS(timeout_ms);
+
+    headset_timer_wheel_insert(p_timer);
+    headset_timer_hw_arm();
+}
+
+/*
+ * headset_timer_init
+ */
+void headset_timer_init(void)
+{
+    /* Warm restart: the hardware timer may still be armed. */
+    if (headset_timer_cb.hw_timer_armed)
+    {
+        wiced_stop_timer(&headset_timer_cb.hw_timer);
+    }
+
+    memset((void *)&headset_timer_cb, 0, sizeof(headset_timer_cb));
+
+    wiced_init_timer(&headset_timer_cb.hw_timer, headset_timer_hw_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+
+    headset_timer_cb.now          = headset_timer_tick_get();
+    headset_timer_cb.minute_start = headset_timer_cb.now;
+}
+
+/*
+ * headset_timer_setup
+ *
+ * Bind a callback to a timer. Must be called once before the timer is started.
+ */
+void headset_timer_setup(headset_timer_t *p_timer, headset_timer_callback_t p_callback, uint32_t arg)
+{
+    memset((void *)p_timer, 0, sizeof(headset_timer_t));
+
+    p_timer->p_callback = p_callback;
+    p_timer->arg        = arg;
+    p_timer->level      = HEADSET_TIMER_LEVELS;
+}
+
+/*
+ * headset_timer_start
+ *
+ * Start (or restart) a one-shot timer. The timer may fire within +/- window_ms
+ * of its deadline.
+ */
+void headset_timer_start(headset_timer_t *p_timer, uint32_t timeout_ms, uint16_t window_ms)
+{
+    headset_timer_start_internal(p_timer, timeout_ms, 0, window_ms);
+}
+
+/*
+ * headset_timer_start_periodic
+ */
+void headset_timer_start_periodic(headset_timer_t *p_timer, uint32_t period_ms, uint16_t window_ms)
+{
+    headset_timer_start_internal(p_timer, period_ms, period_ms, window_ms);
+}
+
+/*
+ * headset_timer_stop
+ */
+void headset_timer_stop(headset_timer_t *p_timer)
+{
+    if (p_timer->pp_prev == NULL)
+    {
+        return;
+    }
+
+    headset_timer_unlink(p_timer);
+    headset_timer_hw_arm();
+}
+
+/*
+ * headset_timer_is_running
+ */
+wiced_bool_t headset_timer_is_running(headset_timer_t *p_timer)
+{
+    return (p_timer->pp_prev != NULL) ? WICED_TRUE : WICED_FALSE;
+}
+
+/*
+ * headset_timer_stats_get
+ */
+void headset_timer_stats_get(headset_timer_stats_t *p_stats)
+{
+    memcpy((void *)p_stats, (void *)&headset_timer_cb.stats, sizeof(headset_timer_stats_t));
+}
+
+/*
+ * headset_timer_now_us
+ */
+uint64_t headset_timer_now_us(void)
+{
+    return clock_SystemTimeMicroseconds64();
+}
+
+/*
+ * headset_timer_now_ms
+ */
+uint32_t headset_timer_now_ms(void)
+{
+    return (uint32_t)(clock_SystemTimeMicroseconds64() / 1000);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application timer service.
+ *
+ * All application timers share one hardware (wiced) timer. Pending timers are
+ * kept in a hierarchical timer wheel and the hardware timer is only armed for
+ * the next expiry, so an idle device is not woken by a periodic tick.
+ *
+ * Each timer may be given a coalescing window: the timer is allowed to fire
+ * anywhere within +/- window_ms of its deadline. The hardware timer is armed
+ * for the latest point allowed by the earliest pending window and, when it
+ * expires, every timer whose window is already open fires in the same wakeup.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_TIMER_TICK_MS               10      /* wheel resolution */
+#define HEADSET_TIMER_WINDOW_MAX_MS         150     /* largest coalescing window accepted */
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef void (*headset_timer_callback_t)(uint32_t arg);
+
+typedef struct headset_timer
+{
+    struct headset_timer     *p_next;
+    struct headset_timer    **pp_prev;
+    headset_timer_callback_t  p_callback;
+    uint32_t                  arg;
+    uint32_t                  deadline;     /* in ticks */
+    uint32_t                  period;       /* in ticks, 0 for one-shot timer */
+    uint16_t                  window;       /* in ticks */
+    uint8_t                   level;        /* wheel position, for internal use */
+    uint8_t                   slot;
+} headset_timer_t;
+
+typedef struct
+{
+    uint32_t wakeups;               /* hardware timer expirations */
+    uint32_t expired;               /* application timer expirations */
+    uint32_t coalesced;             /* expirations served by another timer's wakeup */
+    uint32_t wakeups_per_minute;    /* hardware timer expirations during the last full minute */
+    uint32_t expired_per_minute;    /* application timer expirations during the last full minute */
+} headset_timer_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void         headset_timer_init(void);
+void         headset_timer_setup(headset_timer_t *p_timer, headset_timer_callback_t p_callback, uint32_t arg);
+void         headset_timer_start(headset_timer_t *p_timer, uint32_t timeout_ms, uint16_t window_ms);
+void         headset_timer_start_periodic(headset_timer_t *p_timer, uint32_t period_ms, uint16_t window_ms);
+void         headset_timer_stop(headset_timer_t *p_timer);
+wiced_bool_t headset_timer_is_running(headset_timer_t *p_timer);
+void         headset_timer_stats_get(headset_timer_stats_t *p_stats);
+uint64_t     headset_timer_now_us(void);
+uint32_t     headset_timer_now_ms(void);
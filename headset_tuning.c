@@ -0,0 +1,716 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Runtime tuning store, see headset_tuning.h.
+ */
+#include <stddef.h>
+#include "wiced.h"
+#include "wiced_bt_trace.h"
+#include "wiced_hal_nvram.h"
+#include "wiced_transport.h"
+#include "hci_control_api.h"
+#include "headset_control.h"
+#include "headset_event.h"
+#include "headset_gatt.h"
+#include "headset_nvram.h"
+#include "headset_tuning.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_TUNING_NVRAM_LEN_MAX    (1 + HEADSET_TUNING_TLV_LEN_MAX)
+
+/* Parameter types, the TLV length is the size of the type */
+enum
+{
+    HEADSET_TUNING_TYPE_U8,
+    HEADSET_TUNING_TYPE_U16,
+    HEADSET_TUNING_TYPE_S16,
+};
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct
+{
+    uint8_t  id;
+    uint8_t  type;
+    uint8_t  offset;        /* in headset_tuning_t */
+    int32_t  min;
+    int32_t  max;
+} headset_tuning_param_t;
+
+typedef struct
+{
+    uint16_t conn_id;                       /* ATT bearer of the link, 0 if free */
+    uint16_t len;
+    uint8_t  rsp[HEADSET_TUNING_RSP_LEN_MAX];
+} headset_tuning_le_rsp_t;
+
+typedef struct
+{
+    wiced_bool_t            loaded;
+    uint8_t                 flags;          /* HEADSET_TUNING_FLAG_xxx */
+    headset_tuning_t        values;
+    headset_tuning_le_rsp_t le_rsp[HEADSET_GATT_LINK_MAX];
+} headset_tuning_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+#define HEADSET_TUNING_PARAM(id, type, field, min, max) \
+    { HEADSET_TUNING_ID_##id, HEADSET_TUNING_TYPE_##type, offsetof(headset_tuning_t, field), min, max }
+
+static const headset_tuning_param_t headset_tuning_params[HEADSET_TUNING_PARAM_NUM] =
+{
+    HEADSET_TUNING_PARAM(A2DP_BUF_DEPTH_MS,         U16, a2dp_buf_depth_ms,         50,     1000),
+    HEADSET_TUNING_PARAM(A2DP_START_BUF_DEPTH,      U8,  a2dp_start_buf_depth,      10,     100),
+    HEADSET_TUNING_PARAM(A2DP_TARGET_BUF_DEPTH,     U8,  a2dp_target_buf_depth,     10,     100),
+    HEADSET_TUNING_PARAM(A2DP_ADJ_PPM_MAX,          S16, a2dp_adj_ppm_max,          0,      1000),
+    HEADSET_TUNING_PARAM(A2DP_ADJ_PPM_MIN,          S16, a2dp_adj_ppm_min,          -1000,  0),
+    HEADSET_TUNING_PARAM(A2DP_ADJ_PPB_PER_MSEC,     U16, a2dp_adj_ppb_per_msec,     0,      1000),
+    HEADSET_TUNING_PARAM(A2DP_LVL_THRESHOLD_HIGH,   S16, a2dp_lvl_threshold_high,   0,      10000),
+    HEADSET_TUNING_PARAM(A2DP_LVL_THRESHOLD_LOW,    S16, a2dp_lvl_threshold_low,    -10000, 0),
+    HEADSET_TUNING_PARAM(A2DP_PROPORTIONAL_GAIN,    U16, a2dp_proportional_gain,    0,      1000),
+    HEADSET_TUNING_PARAM(A2DP_INTEGRAL_GAIN,        U16, a2dp_integral_gain,        0,      1000),
+    HEADSET_TUNING_PARAM(SBC_MAX_BITPOOL,           U8,  sbc_max_bitpool,           2,      250),
+    HEADSET_TUNING_PARAM(DISCOVERABLE_TIMEOUT,      U16, discoverable_timeout,      10,     3600),
+    HEADSET_TUNING_PARAM(HFP_RFCOMM_BUFFER_SIZE,    U16, hfp_rfcomm_buffer_size,    128,    1024),
+    HEADSET_TUNING_PARAM(HFP_RFCOMM_BUFFER_COUNT,   U8,  hfp_rfcomm_buffer_count,   1,      8),
+    HEADSET_TUNING_PARAM(BUTTON_SHORT_MS,           U16, button_short_ms,           100,    5000),
+    HEADSET_TUNING_PARAM(BUTTON_MEDIUM_MS,          U16, button_medium_ms,          100,    5000),
+    HEADSET_TUNING_PARAM(BUTTON_LONG_MS,            U16, button_long_ms,            100,    5000),
+    HEADSET_TUNING_PARAM(BUTTON_VERY_LONG_MS,       U16, button_very_long_ms,       100,    10000),
+    HEADSET_TUNING_PARAM(BUTTON_DEBOUNCE_MS,        U16, button_debounce_ms,        10,     500),
+};
+
+static const headset_tuning_t headset_tuning_defaults =
+{
+    .a2dp_buf_depth_ms          = HEADSET_TUNING_DEFAULT_A2DP_BUF_DEPTH_MS,
+    .a2dp_adj_ppm_max           = HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPM_MAX,
+    .a2dp_adj_ppm_min           = HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPM_MIN,
+    .a2dp_adj_ppb_per_msec      = HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPB_PER_MSEC,
+    .a2dp_lvl_threshold_high    = HEADSET_TUNING_DEFAULT_A2DP_LVL_THRESHOLD_HIGH,
+    .a2dp_lvl_threshold_low     = HEADSET_TUNING_DEFAULT_A2DP_LVL_THRESHOLD_LOW,
+    .a2dp_proportional_gain     = HEADSET_TUNING_DEFAULT_A2DP_PROPORTIONAL_GAIN,
+    .a2dp_integral_gain         = HEADSET_TUNING_DEFAULT_A2DP_INTEGRAL_GAIN,
+    .discoverable_timeout       = HEADSET_TUNING_DEFAULT_DISCOVERABLE_TIMEOUT,
+    .hfp_rfcomm_buffer_size     = HEADSET_TUNING_DEFAULT_HFP_RFCOMM_BUFFER_SIZE,
+    .button_short_ms            = HEADSET_TUNING_DEFAULT_BUTTON_SHORT_MS,
+    .button_medium_ms           = HEADSET_TUNING_DEFAULT_BUTTON_MEDIUM_MS,
+    .button_long_ms             = HEADSET_TUNING_DEFAULT_BUTTON_LONG_MS,
+    .button_very_long_ms        = HEADSET_TUNING_DEFAULT_BUTTON_VERY_LONG_MS,
+    .button_debounce_ms         = HEADSET_TUNING_DEFAULT_BUTTON_DEBOUNCE_MS,
+    .a2dp_start_buf_depth       = HEADSET_TUNING_DEFAULT_A2DP_START_BUF_DEPTH,
+    .a2dp_target_buf_depth      = HEADSET_TUNING_DEFAULT_A2DP_TARGET_BUF_DEPTH,
+    .sbc_max_bitpool            = HEADSET_TUNING_DEFAULT_SBC_MAX_BITPOOL,
+    .hfp_rfcomm_buffer_count    = HEADSET_TUNING_DEFAULT_HFP_RFCOMM_BUFFER_COUNT,
+};
+
+static headset_tuning_cb_t headset_tuning_cb = { 0 };
+
+static uint8_t headset_tuning_nvram[HEADSET_TUNING_NVRAM_LEN_MAX];
+static uint8_t headset_tuning_buffer[HEADSET_TUNING_RSP_LEN_MAX];
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_tuning_param_find
+ */
+static const headset_tuning_param_t *headset_tuning_param_find(uint8_t id)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_TUNING_PARAM_NUM; i++)
+    {
+        if (headset_tuning_params[i].id == id)
+        {
+            return &headset_tuning_params[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_tuning_param_len
+ */
+static uint8_t headset_tuning_param_len(const headset_tuning_param_t *p_param)
+{
+    return (p_param->type == HEADSET_TUNING_TYPE_U8) ? 1 : 2;
+}
+
+/*
+ * headset_tuning_value_get
+ */
+static int32_t headset_tuning_value_get(const headset_tuning_t *p_values, const headset_tuning_param_t *p_param)
+{
+    const uint8_t *p_field = (const uint8_t *)p_values + p_param->offset;
+
+    switch (p_param->type)
+    {
+    case HEADSET_TUNING_TYPE_U8:
+        return *p_field;
+
+    case HEADSET_TUNING_TYPE_U16:
+        return *(const uint16_t *)p_field;
+
+    default:
+        return *(const int16_t *)p_field;
+    }
+}
+
+/*
+ * headset_tuning_value_set
+ */
+static void headset_tuning_value_set(headset_tuning_t *p_values, const headset_tuning_param_t *p_param, int32_t value)
+{
+    uint8_t *p_field = (uint8_t *)p_values + p_param->offset;
+
+    switch (p_param->type)
+    {
+    case HEADSET_TUNING_TYPE_U8:
+        *p_field = (uint8_t)value;
+        break;
+
+    case HEADSET_TUNING_TYPE_U16:
+        *(uint16_t *)p_field = (uint16_t)value;
+        break;
+
+    default:
+        *(int16_t *)p_field = (int16_t)value;
+        break;
+    }
+}
+
+/*
+ * headset_tuning_tlv_parse
+ *
+ * Check one TLV, return its length or 0 if it is truncated. *pp_param is
+ * NULL for an unknown ID, *p_valid tells if the value can be used.
+ */
+static uint16_t headset_tuning_tlv_parse(uint8_t *p_data, uint16_t data_len,
+                                         const headset_tuning_param_t **pp_param, int32_t *p_value, wiced_bool_t *p_valid)
+{
+    const headset_tuning_param_t *p_param;
+    uint8_t                       len;
+
+    *p_valid = WICED_FALSE;
+
+    if ((data_len < 2) || (data_len < 2 + p_data[1]))
+    {
+        return 0;
+    }
+
+    len      = p_data[1];
+    p_param  = headset_tuning_param_find(p_data[0]);
+    *pp_param = p_param;
+
+    if ((p_param == NULL) || (len != headset_tuning_param_len(p_param)))
+    {
+        return 2 + len;
+    }
+
+    switch (p_param->type)
+    {
+    case HEADSET_TUNING_TYPE_U8:
+        *p_value = p_data[2];
+        break;
+
+    case HEADSET_TUNING_TYPE_U16:
+        *p_value = (uint16_t)(p_data[2] | (p_data[3] << 8));
+        break;
+
+    default:
+        *p_value = (int16_t)(p_data[2] | (p_data[3] << 8));
+        break;
+    }
+
+    *p_valid = ((*p_value >= p_param->min) && (*p_value <= p_param->max)) ? WICED_TRUE : WICED_FALSE;
+
+    return 2 + len;
+}
+
+/*
+ * headset_tuning_tlv_write
+ */
+static uint8_t *headset_tuning_tlv_write(uint8_t *p, const headset_tuning_param_t *p_param, const headset_tuning_t *p_values)
+{
+    int32_t value = headset_tuning_value_get(p_values, p_param);
+
+    UINT8_TO_STREAM(p, p_param->id);
+    UINT8_TO_STREAM(p, headset_tuning_param_len(p_param));
+
+    if (p_param->type == HEADSET_TUNING_TYPE_U8)
+    {
+        UINT8_TO_STREAM(p, (uint8_t)value);
+    }
+    else
+    {
+        UINT16_TO_STREAM(p, (uint16_t)value);
+    }
+
+    return p;
+}
+
+/*
+ * headset_tuning_get_build
+ */
+static uint16_t headset_tuning_get_build(uint8_t *p_ids, uint16_t ids_len, uint8_t *p_rsp)
+{
+    const headset_tuning_param_t *p_param;
+    uint8_t                      *p = p_rsp;
+    uint16_t                      i;
+
+    UINT8_TO_STREAM(p, HEADSET_TUNING_VERSION);
+    UINT8_TO_STREAM(p, headset_tuning_cb.flags);
+
+    if (ids_len == 0)
+    {
+        for (i = 0; i < HEADSET_TUNING_PARAM_NUM; i++)
+        {
+            p = headset_tuning_tlv_write(p, &headset_tuning_params[i], &headset_tuning_cb.values);
+        }
+    }
+    else
+    {
+        /* Unknown IDs are left out, at most one TLV per known parameter. */
+        for (i = 0; (i < ids_len) && (i < HEADSET_TUNING_PARAM_NUM); i++)
+        {
+            if ((p_param = headset_tuning_param_find(p_ids[i])) != NULL)
+            {
+                p = headset_tuning_tlv_write(p, p_param, &headset_tuning_cb.values);
+            }
+        }
+    }
+
+    return (uint16_t)(p - p_rsp);
+}
+
+/*
+ * headset_tuning_order_check
+ *
+ * Check the parameters which only make sense relative to each other. Return
+ * the ID of the first one out of order, 0 if there is none.
+ */
+static uint8_t headset_tuning_order_check(const headset_tuning_t *p_values)
+{
+    /* A press shorter than the debounce time is never seen. */
+    if (p_values->button_debounce_ms >= p_values->button_short_ms)
+    {
+        return HEADSET_TUNING_ID_BUTTON_DEBOUNCE_MS;
+    }
+
+    if (p_values->button_medium_ms <= p_values->button_short_ms)
+    {
+        return HEADSET_TUNING_ID_BUTTON_MEDIUM_MS;
+    }
+
+    if (p_values->button_long_ms <= p_values->button_medium_ms)
+    {
+        return HEADSET_TUNING_ID_BUTTON_LONG_MS;
+    }
+
+    if (p_values->button_very_long_ms <= p_values->button_long_ms)
+    {
+        return HEADSET_TUNING_ID_BUTTON_VERY_LONG_MS;
+    }
+
+    /* Playback shall not start below the level the drift correction holds. */
+    if (p_values->a2dp_target_buf_depth > p_values->a2dp_start_buf_depth)
+    {
+        return HEADSET_TUNING_ID_A2DP_TARGET_BUF_DEPTH;
+    }
+
+    return 0;
+}
+
+/*
+ * headset_tuning_set
+ *
+ * Apply a list of TLVs, all of them or none. Return the ID of the first
+ * rejected TLV, or of the first parameter left out of order, through *p_id.
+ */
+static wiced_bool_t headset_tuning_set(uint8_t *p_data, uint16_t data_len, uint8_t *p_id)
+{
+    const headset_tuning_param_t *p_param;
+    headset_tuning_t              values = headset_tuning_cb.values;
+    wiced_bool_t                  valid;
+    int32_t                       value;
+    uint16_t                      len;
+
+    while (data_len)
+    {
+        *p_id = p_data[0];
+
+        len = headset_tuning_tlv_parse(p_data, data_len, &p_param, &value, &valid);
+
+        if ((len == 0) || !valid)
+        {
+            return WICED_FALSE;
+        }
+
+        headset_tuning_value_set(&values, p_param, value);
+
+        p_data   += len;
+        data_len -= len;
+    }
+
+    if ((*p_id = headset_tuning_order_check(&values)) != 0)
+    {
+        return WICED_FALSE;
+    }
+
+    if (memcmp((void *)&values, (void *)&headset_tuning_cb.values, sizeof(values)) != 0)
+    {
+        headset_tuning_cb.values = values;
+        headset_tuning_cb.flags |= HEADSET_TUNING_FLAG_CHANGED;
+    }
+
+    return WICED_TRUE;
+}
+
+/*
+ * headset_tuning_commit
+ *
+ * Store the values which differ from the defaults, the defaults of a new
+ * firmware then apply to the others. Delete the item if there is none.
+ */
+static wiced_bool_t headset_tuning_commit(void)
+{
+    wiced_result_t result;
+    uint8_t       *p = headset_tuning_nvram;
+    uint16_t       len;
+    uint8_t        i;
+
+    UINT8_TO_STREAM(p, HEADSET_TUNING_VERSION);
+
+    for (i = 0; i < HEADSET_TUNING_PARAM_NUM; i++)
+    {
+        if (headset_tuning_value_get(&headset_tuning_cb.values, &headset_tuning_params[i]) !=
+            headset_tuning_value_get(&headset_tuning_defaults, &headset_tuning_params[i]))
+        {
+            p = headset_tuning_tlv_write(p, &headset_tuning_params[i], &headset_tuning_cb.values);
+        }
+    }
+
+    len = (uint16_t)(p - headset_tuning_nvram);
+
+    if (len == 1)
+    {
+        wiced_hal_delete_nvram(HEADSET_NVRAM_ID_TUNING, &result);
+        result = WICED_SUCCESS;
+    }
+    else if (wiced_hal_write_nvram(HEADSET_NVRAM_ID_TUNING, len, headset_tuning_nvram, &result) != len)
+    {
+        result = WICED_ERROR;
+    }
+
+    if (result != WICED_SUCCESS)
+    {
+        WICED_BT_TRACE("Tuning: NVRAM write fail %d\n", result);
+        return WICED_FALSE;
+    }
+
+    headset_tuning_cb.flags &= ~HEADSET_TUNING_FLAG_CHANGED;
+    headset_tuning_cb.flags |= HEADSET_TUNING_FLAG_STORED;
+
+    return WICED_TRUE;
+}
+
+/*
+ * headset_tuning_event_handler
+ *
+ * Drop the LE response of a link which is down.
+ */
+static void headset_tuning_event_handler(const headset_event_data_t *p_data)
+{
+    uint8_t i;
+
+    for (i = 0; i < HEADSET_GATT_LINK_MAX; i++)
+    {
+        if (headset_tuning_cb.le_rsp[i].conn_id == p_data->handle)
+        {
+            headset_tuning_cb.le_rsp[i].conn_id = 0;
+            headset_tuning_cb.le_rsp[i].len     = 0;
+        }
+    }
+}
+
+/*
+ * headset_tuning_init
+ *
+ * Load the store once, a warm restart keeps the values set by the host.
+ */
+void headset_tuning_init(void)
+{
+    const headset_tuning_param_t *p_param;
+    wiced_result_t                result;
+    wiced_bool_t                  valid;
+    int32_t                       value;
+    uint16_t                      nb_bytes;
+    uint16_t                      len;
+    uint8_t                       id;
+    uint8_t                      *p;
+
+    /* No LE link survives a warm restart. */
+    memset((void *)headset_tuning_cb.le_rsp, 0, sizeof(headset_tuning_cb.le_rsp));
+
+    headset_event_subscribe(HEADSET_EVENT_MASK(HEADSET_EVENT_LE_DISCONNECTED), &headset_tuning_event_handler);
+
+    if (headset_tuning_cb.loaded)
+    {
+        return;
+    }
+
+    headset_tuning_cb.loaded = WICED_TRUE;
+    headset_tuning_cb.values = headset_tuning_defaults;
+
+    nb_bytes = wiced_hal_read_nvram(HEADSET_NVRAM_ID_TUNING, sizeof(headset_tuning_nvram), headset_tuning_nvram, &result);
+
+    if ((result != WICED_SUCCESS) || (nb_bytes == 0))
+    {
+        return;
+    }
+
+    if (headset_tuning_nvram[0] != HEADSET_TUNING_VERSION)
+    {
+        WICED_BT_TRACE("Tuning: version %d ignored\n", headset_tuning_nvram[0]);
+        return;
+    }
+
+    p = &headset_tuning_nvram[1];
+    nb_bytes--;
+
+    while (nb_bytes)
+    {
+        if ((len = headset_tuning_tlv_parse(p, nb_bytes, &p_param, &value, &valid)) == 0)
+        {
+            break;
+        }
+
+        if (valid)
+        {
+            headset_tuning_value_set(&headset_tuning_cb.values, p_param, value);
+        }
+        else
+        {
+            WICED_BT_TRACE("Tuning: ID 0x%02x skipped\n", p[0]);
+        }
+
+        p        += len;
+        nb_bytes -= len;
+    }
+
+    /* The stored values may be out of order with the defaults of another
+     * firmware. */
+    if ((id = headset_tuning_order_check(&headset_tuning_cb.values)) != 0)
+    {
+        WICED_BT_TRACE("Tuning: ID 0x%02x out of order, defaults used\n", id);
+        headset_tuning_cb.values = headset_tuning_defaults;
+        return;
+    }
+
+    headset_tuning_cb.flags = HEADSET_TUNING_FLAG_STORED;
+}
+
+/*
+ * headset_tuning_get
+ */
+const headset_tuning_t *headset_tuning_get(void)
+{
+    return &headset_tuning_cb.values;
+}
+
+/*
+ * headset_tuning_command
+ *
+ * Process a command, return the length of the response written to p_rsp.
+ */
+uint16_t headset_tuning_command(uint8_t *p_data, uint16_t data_len, uint8_t *p_rsp, uint16_t rsp_max)
+{
+    uint8_t *p = p_rsp;
+    uint8_t  op;
+    uint8_t  status = HEADSET_TUNING_STATUS_SUCCESS;
+    uint8_t  id     = 0;
+    uint16_t len    = 0;
+
+    if ((data_len < 1) || (rsp_max < HEADSET_TUNING_RSP_LEN_MAX))
+    {
+        return 0;
+    }
+
+    op = p_data[0];
+    p_data++;
+    data_len--;
+
+    switch (op)
+    {
+    case HEADSET_TUNING_OP_GET:
+        len = headset_tuning_get_build(p_data, data_len, &p_rsp[2]);
+        break;
+
+    case HEADSET_TUNING_OP_SET:
+        if (!headset_tuning_set(p_data, data_len, &id))
+        {
+            status   = HEADSET_TUNING_STATUS_INVALID_PARAM;
+            p_rsp[2] = id;
+            len      = 1;
+        }
+        break;
+
+    case HEADSET_TUNING_OP_COMMIT:
+        if (!headset_tuning_commit())
+        {
+            status = HEADSET_TUNING_STATUS_NVRAM_ERROR;
+        }
+        break;
+
+    case HEADSET_TUNING_OP_DEFAULTS:
+        if (memcmp((void *)&headset_tuning_defaults, (void *)&headset_tuning_cb.values, sizeof(headset_tuning_t)) != 0)
+        {
+            headset_tuning_cb.values = headset_tuning_defaults;
+            headset_tuning_cb.flags |= HEADSET_TUNING_FLAG_CHANGED;
+        }
+        break;
+
+    default:
+        status = HEADSET_TUNING_STATUS_UNKNOWN_OPCODE;
+        break;
+    }
+
+    UINT8_TO_STREAM(p, op);
+    UINT8_TO_STREAM(p, status);
+
+    return 2 + len;
+}
+
+/*
+ * headset_tuning_send
+ *
+ * Handle HCI_CONTROL_HCI_AUDIO_COMMAND_TUNING, reply with
+ * HCI_CONTROL_HCI_AUDIO_EVENT_TUNING.
+ */
+void headset_tuning_send(uint8_t *p_data, uint32_t data_len)
+{
+    uint16_t len = headset_tuning_command(p_data, (uint16_t)data_len, headset_tuning_buffer, sizeof(headset_tuning_buffer));
+
+    if (len)
+    {
+        wiced_transport_send_data(HCI_CONTROL_HCI_AUDIO_EVENT_TUNING, headset_tuning_buffer, len);
+    }
+}
+
+/*
+ * headset_tuning_le_rsp_find
+ *
+ * LE response of the link of a bearer, a free one if the link has none and
+ * alloc is set.
+ */
+static headset_tuning_le_rsp_t *headset_tuning_le_rsp_find(uint16_t conn_id, wiced_bool_t alloc)
+{
+    headset_tuning_le_rsp_t *p_free = NULL;
+    uint8_t                  i;
+
+    if ((conn_id = headset_gatt_link_conn_id_get(conn_id)) == 0)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < HEADSET_GATT_LINK_MAX; i++)
+    {
+        if (headset_tuning_cb.le_rsp[i].conn_id == conn_id)
+        {
+            return &headset_tuning_cb.le_rsp[i];
+        }
+
+        if ((headset_tuning_cb.le_rsp[i].conn_id == 0) && (p_free == NULL))
+        {
+            p_free = &headset_tuning_cb.le_rsp[i];
+        }
+    }
+
+    if (alloc && p_free)
+    {
+        p_free->conn_id = conn_id;
+        p_free->len     = 0;
+        return p_free;
+    }
+
+    return NULL;
+}
+
+/*
+ * headset_tuning_le_write
+ *
+ * Command written to the tuning characteristic, the response is read back
+ * by the same link.
+ */
+void headset_tuning_le_write(uint16_t conn_id, uint8_t *p_data, uint16_t data_len)
+{
+    headset_tuning_le_rsp_t *p_rsp = headset_tuning_le_rsp_find(conn_id, WICED_TRUE);
+
+    if (p_rsp == NULL)
+    {
+        return;
+    }
+
+    p_rsp->len = headset_tuning_command(p_data, data_len, p_rsp->rsp, sizeof(p_rsp->rsp));
+}
+
+/*
+ * headset_tuning_le_read
+ *
+ * Value of the tuning characteristic, the response to the last command of
+ * the link.
+ */
+uint16_t headset_tuning_le_read(uint16_t conn_id, uint8_t *p_data, uint16_t max_len)
+{
+    headset_tuning_le_rsp_t *p_rsp = headset_tuning_le_rsp_find(conn_id, WICED_FALSE);
+    uint16_t                 len;
+
+    if (p_rsp == NULL)
+    {
+        return 0;
+    }
+
+    len = p_rsp->len < max_len ? p_rsp->len : max_len;
+
+    memcpy((void *)p_data, (void *)p_rsp->rsp, len);
+
+    return len;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Runtime tuning store.
+ *
+ * The audio, link and button parameters which used to be compile time
+ * constants are kept in headset_tuning_t. It is loaded once at boot from
+ * HEADSET_NVRAM_ID_TUNING over the HEADSET_TUNING_DEFAULT_xxx values, and
+ * the host changes it with HCI_CONTROL_HCI_AUDIO_COMMAND_TUNING or with the
+ * tuning characteristic of the LE application service. The modules read it
+ * when they start: the A2DP, SBC, discoverability and HFP RFCOMM parameters
+ * apply from the next warm restart, the button durations from the next boot.
+ *
+ * The NVRAM item is | VERSION (1) | TLV ... |, each TLV is
+ * | ID (1) | LEN (1) | VALUE (LEN, little endian) |. LEN shall match the type
+ * of the parameter. Unknown IDs are skipped, values out of range keep their
+ * default, an item of another version is ignored.
+ *
+ * Command (HCI or LE):
+ * Byte: |   0    | 1 ...  |
+ * Data: | OPCODE | PARAM  |
+ * Response (HCI_CONTROL_HCI_AUDIO_EVENT_TUNING, or read of the LE
+ * characteristic after the write, each link reads the response to its own
+ * command; the characteristic needs an authenticated link):
+ * Byte: |   0    |   1    | 2 ... |
+ * Data: | OPCODE | STATUS | DATA  |
+ *
+ * HEADSET_TUNING_OP_GET:      PARAM is a list of IDs, all if empty. DATA is
+ *                             | VERSION (1) | FLAGS (1) | TLV ... |
+ * HEADSET_TUNING_OP_SET:      PARAM is a list of TLVs, all applied or none.
+ *                             DATA is the ID of the first rejected TLV, or
+ *                             of the first parameter the values would leave
+ *                             out of order: BUTTON_DEBOUNCE < BUTTON_SHORT <
+ *                             BUTTON_MEDIUM < BUTTON_LONG < BUTTON_VERY_LONG,
+ *                             A2DP_TARGET_BUF_DEPTH <= A2DP_START_BUF_DEPTH.
+ * HEADSET_TUNING_OP_COMMIT:   write the values to NVRAM
+ * HEADSET_TUNING_OP_DEFAULTS: restore the defaults, a commit stores them
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_TUNING_VERSION                          1
+
+/* Defaults */
+#define HEADSET_TUNING_DEFAULT_A2DP_BUF_DEPTH_MS        300     /* jitter buffer depth */
+#define HEADSET_TUNING_DEFAULT_A2DP_START_BUF_DEPTH     50      /* start playback, percentage of the depth */
+#define HEADSET_TUNING_DEFAULT_A2DP_TARGET_BUF_DEPTH    50      /* target level, percentage of the depth */
+#define HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPM_MAX         300
+#define HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPM_MIN         (-300)
+#define HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPB_PER_MSEC    200
+#define HEADSET_TUNING_DEFAULT_A2DP_LVL_THRESHOLD_HIGH  2000
+#define HEADSET_TUNING_DEFAULT_A2DP_LVL_THRESHOLD_LOW   (-2000)
+#define HEADSET_TUNING_DEFAULT_A2DP_PROPORTIONAL_GAIN   20
+#define HEADSET_TUNING_DEFAULT_A2DP_INTEGRAL_GAIN       2
+#define HEADSET_TUNING_DEFAULT_SBC_MAX_BITPOOL          53      /* recommended for high quality audio */
+#ifdef LOW_POWER_MEASURE_MODE
+#define HEADSET_TUNING_DEFAULT_DISCOVERABLE_TIMEOUT     60      /* seconds */
+#else
+#define HEADSET_TUNING_DEFAULT_DISCOVERABLE_TIMEOUT     240     /* seconds */
+#endif
+#define HEADSET_TUNING_DEFAULT_HFP_RFCOMM_BUFFER_SIZE   700
+#define HEADSET_TUNING_DEFAULT_HFP_RFCOMM_BUFFER_COUNT  4
+#define HEADSET_TUNING_DEFAULT_BUTTON_SHORT_MS          500
+#define HEADSET_TUNING_DEFAULT_BUTTON_MEDIUM_MS         700
+#define HEADSET_TUNING_DEFAULT_BUTTON_LONG_MS           1000
+#define HEADSET_TUNING_DEFAULT_BUTTON_VERY_LONG_MS      1500
+#define HEADSET_TUNING_DEFAULT_BUTTON_DEBOUNCE_MS       150     /* a click takes around 150-200 ms */
+
+/* Parameter IDs */
+enum
+{
+    HEADSET_TUNING_ID_A2DP_BUF_DEPTH_MS         = 0x01,
+    HEADSET_TUNING_ID_A2DP_START_BUF_DEPTH      = 0x02,
+    HEADSET_TUNING_ID_A2DP_TARGET_BUF_DEPTH     = 0x03,
+    HEADSET_TUNING_ID_A2DP_ADJ_PPM_MAX          = 0x04,
+    HEADSET_TUNING_ID_A2DP_ADJ_PPM_MIN          = 0x05,
+    HEADSET_TUNING_ID_A2DP_ADJ_PPB_PER_MSEC     = 0x06,
+    HEADSET_TUNING_ID_A2DP_LVL_THRESHOLD_HIGH   = 0x07,
+    HEADSET_TUNING_ID_A2DP_LVL_THRESHOLD_LOW    = 0x08,
+    HEADSET_TUNING_ID_A2DP_PROPORTIONAL_GAIN    = 0x09,
+    HEADSET_TUNING_ID_A2DP_INTEGRAL_GAIN        = 0x0A,
+    HEADSET_TUNING_ID_SBC_MAX_BITPOOL           = 0x10,
+    HEADSET_TUNING_ID_DISCOVERABLE_TIMEOUT      = 0x20,
+    HEADSET_TUNING_ID_HFP_RFCOMM_BUFFER_SIZE    = 0x21,
+    HEADSET_TUNING_ID_HFP_RFCOMM_BUFFER_COUNT   = 0x22,
+    HEADSET_TUNING_ID_BUTTON_SHORT_MS           = 0x30,
+    HEADSET_TUNING_ID_BUTTON_MEDIUM_MS          = 0x31,
+    HEADSET_TUNING_ID_BUTTON_LONG_MS            = 0x32,
+    HEADSET_TUNING_ID_BUTTON_VERY_LONG_MS       = 0x33,
+    HEADSET_TUNING_ID_BUTTON_DEBOUNCE_MS        = 0x34,
+};
+
+/* Opcodes */
+enum
+{
+    HEADSET_TUNING_OP_GET       = 0x01,
+    HEADSET_TUNING_OP_SET       = 0x02,
+    HEADSET_TUNING_OP_COMMIT    = 0x03,
+    HEADSET_TUNING_OP_DEFAULTS  = 0x04,
+};
+
+/* Response status */
+enum
+{
+    HEADSET_TUNING_STATUS_SUCCESS           = 0,
+    HEADSET_TUNING_STATUS_UNKNOWN_OPCODE    = 1,
+    HEADSET_TUNING_STATUS_INVALID_PARAM     = 2,
+    HEADSET_TUNING_STATUS_NVRAM_ERROR       = 3,
+};
+
+/* HEADSET_TUNING_OP_GET flags */
+#define HEADSET_TUNING_FLAG_STORED      0x01    /* loaded from NVRAM at boot */
+#define HEADSET_TUNING_FLAG_CHANGED     0x02    /* set since the last commit */
+
+#define HEADSET_TUNING_PARAM_NUM        19
+#define HEADSET_TUNING_TLV_LEN_MAX      (HEADSET_TUNING_PARAM_NUM * (2 + 2))
+#define HEADSET_TUNING_RSP_LEN_MAX      (2 + 2 + HEADSET_TUNING_TLV_LEN_MAX)
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+/* Fields ordered by size, no padding */
+typedef struct
+{
+    uint16_t a2dp_buf_depth_ms;
+    int16_t  a2dp_adj_ppm_max;
+    int16_t  a2dp_adj_ppm_min;
+    uint16_t a2dp_adj_ppb_per_msec;
+    int16_t  a2dp_lvl_threshold_high;
+    int16_t  a2dp_lvl_threshold_low;
+    uint16_t a2dp_proportional_gain;
+    uint16_t a2dp_integral_gain;
+    uint16_t discoverable_timeout;
+    uint16_t hfp_rfcomm_buffer_size;
+    uint16_t button_short_ms;
+    uint16_t button_medium_ms;
+    uint16_t button_long_ms;
+    uint16_t button_very_long_ms;
+    uint16_t button_debounce_ms;
+    uint8_t  a2dp_start_buf_depth;
+    uint8_t  a2dp_target_buf_depth;
+    uint8_t  sbc_max_bitpool;
+    uint8_t  hfp_rfcomm_buffer_count;
+} headset_tuning_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+void                    headset_tuning_init(void);
+const headset_tuning_t *headset_tuning_get(void);
+uint16_t                headset_tuning_command(uint8_t *p_data, uint16_t data_len, uint8_t *p_rsp, uint16_t rsp_max);
+void                    headset_tuning_send(uint8_t *p_data, uint32_t data_len);
+void                    headset_tuning_le_write(uint16_t conn_id, uint8_t *p_data, uint16_t data_len);
+uint16_t                headset_tuning_le_read(uint16_t conn_id, uint8_t *p_data, uint16_t max_len);
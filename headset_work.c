@@ -0,0 +1,342 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application deferred-work executor.
+ *
+ * The queues are drained by a function serialized to the application thread.
+ * One pass executes every audio critical and normal item, but only
+ * HEADSET_WORK_BACKGROUND_BUDGET background items before yielding so that a
+ * burst of NVRAM commits cannot delay the other application events.
+ */
+#include "wiced.h"
+#include "wiced_bt_event.h"
+#include "wiced_bt_trace.h"
+#include "wiced_rtos.h"
+#include "headset_timer.h"
+#include "headset_work.h"
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef struct headset_work_item
+{
+    struct headset_work_item *p_next;
+    headset_work_handler_t    p_handler;
+    uint16_t                  len;
+    uint8_t                   data[HEADSET_WORK_DATA_LEN];
+} headset_work_item_t;
+
+typedef struct
+{
+    headset_work_item_t *p_head;
+    headset_work_item_t *p_tail;
+} headset_work_queue_t;
+
+typedef struct
+{
+    wiced_mutex_t        *p_mutex;
+    wiced_bool_t          drain_pending;
+    headset_work_item_t  *p_free;
+    headset_work_queue_t  queue[HEADSET_WORK_PRIORITY_MAX];
+    headset_work_item_t   pool[HEADSET_WORK_POOL_SIZE];
+    headset_work_stats_t  stats;
+} headset_work_cb_t;
+
+/******************************************************
+ *               Variables Definitions
+ ******************************************************/
+static headset_work_cb_t headset_work_cb = { 0 };
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+/*
+ * headset_work_dequeue
+ *
+ * Take the first item of the queue, NULL if the queue is empty.
+ */
+static headset_work_item_t *headset_work_dequeue(headset_work_priority_t priority)
+{
+    headset_work_queue_t *p_queue = &headset_work_cb.queue[priority];
+    headset_work_item_t  *p_item;
+
+    wiced_rtos_lock_mutex(headset_work_cb.p_mutex);
+
+    p_item = p_queue->p_head;
+
+    if (p_item)
+    {
+        p_queue->p_head = p_item->p_next;
+
+        if (p_queue->p_head == NULL)
+        {
+            p_queue->p_tail = NULL;
+        }
+    }
+
+    wiced_rtos_unlock_mutex(headset_work_cb.p_mutex);
+
+    return p_item;
+}
+
+/*
+ * headset_work_release
+ */
+static void headset_work_release(headset_work_item_t *p_item)
+{
+    wiced_rtos_lock_mutex(headset_work_cb.p_mutex);
+
+    p_item->p_next         = headset_work_cb.p_free;
+    headset_work_cb.p_free = p_item;
+    headset_work_cb.stats.in_use--;
+
+    wiced_rtos_unlock_mutex(headset_work_cb.p_mutex);
+}
+
+/*
+ * headset_work_execute
+ */
+static void headset_work_execute(headset_work_priority_t priority, headset_work_item_t *p_item)
+{
+    uint64_t start = headset_timer_now_us();
+    uint32_t run_time;
+
+    p_item->p_handler(p_item->data, p_item->len);
+
+    run_time = (uint32_t)(headset_timer_now_us() - start);
+
+    if (run_time > headset_work_cb.stats.run_time_max_us)
+    {
+        headset_work_cb.stats.run_time_max_us = run_time;
+    }
+
+    headset_work_cb.stats.executed[priority]++;
+
+    headset_work_release(p_item);
+}
+
+/*
+ * headset_work_drain
+ *
+ * Executed in the application thread context.
+ */
+static int headset_work_drain(void *p_data)
+{
+    headset_work_item_t *p_item;
+    uint8_t              budget = HEADSET_WORK_BACKGROUND_BUDGET;
+    wiced_bool_t         reschedule;
+
+    headset_work_cb.drain_pending = WICED_FALSE;
+
+    while (WICED_TRUE)
+    {
+        /* Audio critical and normal items always run before the next background item. */
+        if ((p_item = headset_work_dequeue(HEADSET_WORK_PRIORITY_AUDIO)) != NULL)
+        {
+            headset_work_execute(HEADSET_WORK_PRIORITY_AUDIO, p_item);
+            continue;
+        }
+
+        if ((p_item = headset_work_dequeue(HEADSET_WORK_PRIORITY_NORMAL)) != NULL)
+        {
+            headset_work_execute(HEADSET_WORK_PRIORITY_NORMAL, p_item);
+            continue;
+        }
+
+        if (budget == 0)
+        {
+            break;
+        }
+
+        if ((p_item = headset_work_dequeue(HEADSET_WORK_PRIORITY_BACKGROUND)) == NULL)
+        {
+            break;
+        }
+
+        headset_work_execute(HEADSET_WORK_PRIORITY_BACKGROUND, p_item);
+        budget--;
+    }
+
+    /* Yield to the other application events if background work is left. */
+    wiced_rtos_lock_mutex(headset_work_cb.p_mutex);
+
+    reschedule = ((headset_work_cb.queue[HEADSET_WORK_PRIORITY_BACKGROUND].p_head != NULL) &&
+                  (headset_work_cb.drain_pending == WICED_FALSE)) ? WICED_TRUE : WICED_FALSE;
+
+    if (reschedule)
+    {
+        headset_work_cb.drain_pending = WICED_TRUE;
+    }
+
+    wiced_rtos_unlock_mutex(headset_work_cb.p_mutex);
+
+    if (reschedule)
+    {
+        wiced_app_event_serialize(headset_work_drain, NULL);
+    }
+
+    return 0;
+}
+
+/*
+ * headset_work_init
+ */
+wiced_result_t headset_work_init(void)
+{
+    wiced_mutex_t *p_mutex = headset_work_cb.p_mutex;
+    uint16_t       i;
+
+    /* Pending work is dropped on a warm restart, the mutex is kept. */
+    memset((void *)&headset_work_cb, 0, sizeof(headset_work_cb));
+
+    if (!p_mutex)
+    {
+        p_mutex = wiced_rtos_create_mutex();
+
+        if (!p_mutex)
+        {
+            WICED_BT_TRACE("Err: fail to create mutex for work queue\n");
+            return WICED_BT_ERROR;
+        }
+
+        if (wiced_rtos_init_mutex(p_mutex) != WICED_BT_SUCCESS)
+        {
+            WICED_BT_TRACE("Err: fail to init. mutex for work queue\n");
+            return WICED_BT_ERROR;
+        }
+    }
+
+    headset_work_cb.p_mutex = p_mutex;
+
+    for (i = 0; i < HEADSET_WORK_POOL_SIZE; i++)
+    {
+        headset_work_cb.pool[i].p_next = headset_work_cb.p_free;
+        headset_work_cb.p_free         = &headset_work_cb.pool[i];
+    }
+
+    return WICED_BT_SUCCESS;
+}
+
+/*
+ * headset_work_post
+ *
+ * Queue a work item. Up to HEADSET_WORK_DATA_LEN bytes of p_data are copied
+ * with the item and passed to the handler.
+ */
+wiced_bool_t headset_work_post(headset_work_priority_t priority, headset_work_handler_t p_handler, void *p_data, uint16_t len)
+{
+    headset_work_queue_t *p_queue;
+    headset_work_item_t  *p_item;
+    wiced_bool_t          schedule = WICED_FALSE;
+
+    if ((priority >= HEADSET_WORK_PRIORITY_MAX) ||
+        (p_handler == NULL) ||
+        (len > HEADSET_WORK_DATA_LEN) ||
+        (headset_work_cb.p_mutex == NULL))
+    {
+        return WICED_FALSE;
+    }
+
+    wiced_rtos_lock_mutex(headset_work_cb.p_mutex);
+
+    p_item = headset_work_cb.p_free;
+
+    if (p_item == NULL)
+    {
+        headset_work_cb.stats.dropped++;
+        wiced_rtos_unlock_mutex(headset_work_cb.p_mutex);
+        return WICED_FALSE;
+    }
+
+    headset_work_cb.p_free = p_item->p_next;
+
+    p_item->p_next    = NULL;
+    p_item->p_handler = p_handler;
+    p_item->len       = len;
+
+    if (len)
+    {
+        memcpy((void *)p_item->data, p_data, len);
+    }
+
+    p_queue = &headset_work_cb.queue[priority];
+
+    if (p_queue->p_tail)
+    {
+        p_queue->p_tail->p_next = p_item;
+    }
+    else
+    {
+        p_queue->p_head = p_item;
+    }
+
+    p_queue->p_tail = p_item;
+
+    headset_work_cb.stats.posted[priority]++;
+    headset_work_cb.stats.in_use++;
+
+    if (headset_work_cb.stats.in_use > headset_work_cb.stats.in_use_max)
+    {
+        headset_work_cb.stats.in_use_max = headset_work_cb.stats.in_use;
+    }
+
+    if (headset_work_cb.drain_pending == WICED_FALSE)
+    {
+        headset_work_cb.drain_pending = WICED_TRUE;
+        schedule                      = WICED_TRUE;
+    }
+
+    wiced_rtos_unlock_mutex(headset_work_cb.p_mutex);
+
+    if (schedule)
+    {
+        wiced_app_event_serialize(headset_work_drain, NULL);
+    }
+
+    return WICED_TRUE;
+}
+
+/*
+ * headset_work_stats_get
+ */
+void headset_work_stats_get(headset_work_stats_t *p_stats)
+{
+    wiced_rtos_lock_mutex(headset_work_cb.p_mutex);
+
+    memcpy((void *)p_stats, (void *)&headset_work_cb.stats, sizeof(headset_work_stats_t));
+
+    wiced_rtos_unlock_mutex(headset_work_cb.p_mutex);
+}
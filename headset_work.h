@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016-2024, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Application deferred-work executor.
+ *
+ * Stack callbacks post small fixed-size work items which are executed later
+ * in the application thread, highest priority first. Items come from a
+ * preallocated pool so posting never allocates memory.
+ */
+#pragma once
+
+#include "wiced.h"
+
+/*****************************************************************************
+**  Constants
+*****************************************************************************/
+#define HEADSET_WORK_POOL_SIZE              16
+#define HEADSET_WORK_DATA_LEN               16      /* bytes of payload copied with each item */
+#define HEADSET_WORK_BACKGROUND_BUDGET      2       /* background items executed per pass */
+
+typedef enum
+{
+    HEADSET_WORK_PRIORITY_AUDIO,        /* audio critical */
+    HEADSET_WORK_PRIORITY_NORMAL,
+    HEADSET_WORK_PRIORITY_BACKGROUND,   /* NVRAM commits, statistics, traces */
+    HEADSET_WORK_PRIORITY_MAX,
+} headset_work_priority_t;
+
+/*****************************************************************************
+**  Structures
+*****************************************************************************/
+typedef void (*headset_work_handler_t)(uint8_t *p_data, uint16_t len);
+
+typedef struct
+{
+    uint32_t posted[HEADSET_WORK_PRIORITY_MAX];
+    uint32_t executed[HEADSET_WORK_PRIORITY_MAX];
+    uint32_t dropped;                   /* pool exhausted */
+    uint16_t in_use;                    /* items currently queued */
+    uint16_t in_use_max;
+    uint32_t run_time_max_us;           /* longest single item */
+} headset_work_stats_t;
+
+/*****************************************************************************
+**  Function prototypes
+*****************************************************************************/
+wiced_result_t headset_work_init(void);
+wiced_bool_t   headset_work_post(headset_work_priority_t priority, headset_work_handler_t p_handler, void *p_data, uint16_t len);
+void           headset_work_stats_get(headset_work_stats_t *p_stats);
@@ -50,6 +50,10 @@
 #include "wiced_bt_audio.h"
 #include "wiced_bt_avdt.h"
 #include "bt_hs_spk_handsfree.h"
+#include "headset_gatt.h"
+#include "headset_sdp.h"
+#include "headset_le_bond.h"
+#include "headset_tuning.h"
 
 #define sizeof_array(a) (sizeof(a)/sizeof(a[0]))
 
@@ -68,11 +72,25 @@ extern wiced_codec_interface_functions_t AAC_codec_function_table;
                                          WICED_BT_HFP_HF_SDP_FEATURE_REMOTE_VOL_CTRL)
 #endif
 
+/* RFCOMM port of the SPP bulk data service, its peer may not be the HFP AG */
+#ifdef HEADSET_SPP_BULK
+#define WICED_APP_CFG_RFCOMM_SPP        1
+#else
+#define WICED_APP_CFG_RFCOMM_SPP        0
+#endif
+
+/* LE credit based channel of the LE CoC bulk data service */
+#ifdef HEADSET_LE_COC
+#define WICED_APP_CFG_LE_COC            1
+#else
+#define WICED_APP_CFG_LE_COC            0
+#endif
+
 /*****************************************************************************
  *   codec and audio tuning configurations
  ****************************************************************************/
 /*  Recommended max_bitpool for high quality audio */
-#define BT_AUDIO_A2DP_SBC_MAX_BITPOOL   53
+#define BT_AUDIO_A2DP_SBC_MAX_BITPOOL   HEADSET_TUNING_DEFAULT_SBC_MAX_BITPOOL
 
 /* Array of decoder capabilities information. */
 wiced_bt_a2dp_codec_info_t bt_audio_codec_capabilities[] =
@@ -123,19 +141,19 @@ wiced_bt_a2dp_config_data_t bt_audio_config =
         .count = sizeof_array(bt_audio_codec_capabilities),
         .info  = bt_audio_codec_capabilities,                   /* codec configuration */
     },
-    .p_param =
+    .p_param =                                                                          /* loaded from the tuning store, see headset_tuning.h */
     {
-        .buf_depth_ms                   = 300,                                          /* in msec */
-        .start_buf_depth                = 50,                                           /* start playback percentage of the buffer depth */
-        .target_buf_depth               = 50,                                           /* target level percentage of the buffer depth */
+        .buf_depth_ms                   = HEADSET_TUNING_DEFAULT_A2DP_BUF_DEPTH_MS,     /* in msec */
+        .start_buf_depth                = HEADSET_TUNING_DEFAULT_A2DP_START_BUF_DEPTH,  /* start playback percentage of the buffer depth */
+        .target_buf_depth               = HEADSET_TUNING_DEFAULT_A2DP_TARGET_BUF_DEPTH, /* target level percentage of the buffer depth */
         .overrun_control                = WICED_BT_A2DP_SINK_OVERRUN_CONTROL_FLUSH_DATA,/* overrun flow control flag */
-        .adj_ppm_max                    = +300,                                         /* Max PPM adjustment value */
-        .adj_ppm_min                    = -300,                                         /* Min PPM adjustment value */
-        .adj_ppb_per_msec               = 200,                                          /* PPM adjustment per milli second */
-        .lvl_correction_threshold_high  = +2000,                                        /* Level correction threshold high value */
-        .lvl_correction_threshold_low   = -2000,                                        /* Level correction threshold low value */
-        .adj_proportional_gain          = 20,                                           /* Proportional component of total PPM adjustment */
-        .adj_integral_gain              = 2,                                            /* Integral component of total PPM adjustment */
+        .adj_ppm_max                    = HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPM_MAX,      /* Max PPM adjustment value */
+        .adj_ppm_min                    = HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPM_MIN,      /* Min PPM adjustment value */
+        .adj_ppb_per_msec               = HEADSET_TUNING_DEFAULT_A2DP_ADJ_PPB_PER_MSEC, /* PPM adjustment per milli second */
+        .lvl_correction_threshold_high  = HEADSET_TUNING_DEFAULT_A2DP_LVL_THRESHOLD_HIGH, /* Level correction threshold high value */
+        .lvl_correction_threshold_low   = HEADSET_TUNING_DEFAULT_A2DP_LVL_THRESHOLD_LOW,  /* Level correction threshold low value */
+        .adj_proportional_gain          = HEADSET_TUNING_DEFAULT_A2DP_PROPORTIONAL_GAIN,  /* Proportional component of total PPM adjustment */
+        .adj_integral_gain              = HEADSET_TUNING_DEFAULT_A2DP_INTEGRAL_GAIN,      /* Integral component of total PPM adjustment */
     },
     .ext_codec =
     {
@@ -258,9 +276,9 @@ const wiced_bt_cfg_ble_advert_settings_t wiced_bt_cfg_adv_settings =
 /* L2CAP Setting */
 const wiced_bt_cfg_l2cap_application_t wiced_bt_cfg_l2cap_app = /* Application managed l2cap protocol configuration */
 {
-    /* BR EDR l2cap configuration */
-    .max_app_l2cap_psms = 0,      /**< Maximum number of application-managed BR/EDR PSMs */
-    .max_app_l2cap_channels = 0, /**< Maximum number of application-managed BR/EDR channels  */
+    /* BR EDR and LE l2cap configuration */
+    .max_app_l2cap_psms = WICED_APP_CFG_LE_COC,     /**< Maximum number of application-managed BR/EDR and LE PSMs */
+    .max_app_l2cap_channels = WICED_APP_CFG_LE_COC, /**< Maximum number of application-managed BR/EDR and LE channels  */
 
     .max_app_l2cap_br_edr_ertm_chnls = 0,  /**< Maximum ERTM channels allowed */
     .max_app_l2cap_br_edr_ertm_tx_win = 0, /**< Maximum ERTM TX Window allowed */
@@ -276,8 +294,8 @@ const wiced_bt_cfg_br_t wiced_bt_cfg_br =
     .device_class = {0x24, 0x04, 0x18},                     /**< Local device class */
     .rfcomm_cfg = /* RFCOMM configuration */
     {
-        .max_links = WICED_BT_HFP_HF_MAX_CONN, /**< Maximum number of simultaneous connected remote devices. Should be less than or equal to l2cap_application_max_links */
-        .max_ports = WICED_BT_HFP_HF_MAX_CONN, /**< Maximum number of simultaneous RFCOMM ports */
+        .max_links = WICED_BT_HFP_HF_MAX_CONN + WICED_APP_CFG_RFCOMM_SPP, /**< Maximum number of simultaneous connected remote devices. Should be less than or equal to l2cap_application_max_links */
+        .max_ports = WICED_BT_HFP_HF_MAX_CONN + WICED_APP_CFG_RFCOMM_SPP, /**< Maximum number of simultaneous RFCOMM ports */
     },
     .avdt_cfg = /* Audio/Video Distribution configuration */
     {
@@ -322,7 +340,11 @@ const wiced_bt_cfg_ble_t wiced_bt_cfg_ble =
 const wiced_bt_cfg_gatt_t wiced_bt_cfg_gatt =
 {
     .max_db_service_modules = 0,  /**< Maximum number of service modules in the DB*/
+#ifdef HEADSET_EATT
+    .max_eatt_bearers = HEADSET_GATT_LINK_MAX * HEADSET_GATT_EATT_BEARER_MAX, /**< Maximum number of allowed gatt bearers */
+#else
     .max_eatt_bearers = 0,        /**< Maximum number of allowed gatt bearers */
+#endif
 };
 
  /* wiced_bt core stack configuration */
@@ -430,27 +452,27 @@ const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
 
     .rfcomm_cfg =                                                   /* RFCOMM configuration */
     {
-        .max_links                      = WICED_BT_HFP_HF_MAX_CONN,                                    /**< Maximum number of simultaneous connected remote devices*/
-        .max_ports                      = WICED_BT_HFP_HF_MAX_CONN,                                    /**< Maximum number of simultaneous RFCOMM ports */
+        .max_links                      = WICED_BT_HFP_HF_MAX_CONN + WICED_APP_CFG_RFCOMM_SPP,         /**< Maximum number of simultaneous connected remote devices*/
+        .max_ports                      = WICED_BT_HFP_HF_MAX_CONN + WICED_APP_CFG_RFCOMM_SPP,         /**< Maximum number of simultaneous RFCOMM ports */
     },
 
     .l2cap_application =                                            /* Application managed l2cap protocol configuration */
     {
-        .max_links                      = 0,                                                           /**< Maximum number of application-managed l2cap links (BR/EDR and LE) */
+        .max_links                      = WICED_APP_CFG_LE_COC,                                        /**< Maximum number of application-managed l2cap links (BR/EDR and LE) */
 
         /* BR EDR l2cap configuration */
         .max_psm                        = 0,                                                           /**< Maximum number of application-managed BR/EDR PSMs */
         .max_channels                   = 0,                                                           /**< Maximum number of application-managed BR/EDR channels  */
 
         /* LE L2cap connection-oriented channels configuration */
-        .max_le_psm                     = 0,                                                           /**< Maximum number of application-managed LE PSMs */
-        .max_le_channels                = 0,                                                           /**< Maximum number of application-managed LE channels */
+        .max_le_psm                     = WICED_APP_CFG_LE_COC,                                        /**< Maximum number of application-managed LE PSMs */
+        .max_le_channels                = WICED_APP_CFG_LE_COC,                                        /**< Maximum number of application-managed LE channels */
 #if !defined(CYW20706A2)
         /* LE L2cap fixed channel configuration */
         .max_le_l2cap_fixed_channels    = 0,                                                           /**< Maximum number of application managed fixed channels supported (in addition to mandatory channels 4, 5 and 6). > */
 #endif
 #if BTSTACK_VER >= 0x03000001
-        .max_rx_mtu                     = 1000,                                                        /**< Maximum RX MTU allowed */
+        .max_rx_mtu                     = WICED_APP_CFG_MAX_RX_MTU,                                    /**< Maximum RX MTU allowed */
         .max_ertm_chnls                 = 0,                                                           /**< Maximum ERTM channels */
         .max_ertm_tx_win                = 0,                                                           /**< Maximum ERTM TX Window */
 #endif
@@ -494,7 +516,7 @@ const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
     .stack_scratch_size                 = WICED_BT_CFG_DEFAULT_STACK_SCRATCH_SIZE,                     /**< Memory area reserved for the stack transient memory requirements */
 #endif
     /* LE Filter Accept List size */
-    .ble_filter_accept_list_size                = 0,                                                           /**< Maximum number of Filter Accept List devices allowed. Cannot be more than 128 */
+    .ble_filter_accept_list_size        = HEADSET_LE_BOND_MAX,                                         /**< Maximum number of Filter Accept List devices allowed. Cannot be more than 128 */
 #endif
 
 #if defined(CYW20719B2) || defined(CYW20721B2) || defined(CYW20819A1) || defined (CYW20820A1) || BTSTACK_VER >= 0x03000001
@@ -506,110 +528,136 @@ const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
 
 /*****************************************************************************
  * SDP database for the hci_control application
+ *
+ * The sequence lengths are computed by HEADSET_SDP_SEQ_x() (headset_sdp.h).
  ****************************************************************************/
 // SDP Record handle for AVDT Sink
 #define HANDLE_AVDT_SINK                        0x10001
 // SDP Record handle for AVRC TARGET
 #define HANDLE_AVRC_TARGET                      0x10002
-// SDP Record handle for AVRC TARGET
+// SDP Record handle for AVRC CONTROLLER
 #define HANDLE_AVRC_CONTROLLER                  0x10003
 // SDP Record handle for SPP OFU
 #define HANDLE_OFU_SPP                          0x10005
 
+// AVCTP Protocol Descriptor List, common to the AVRC Target and Controller
+#define HEADSET_SDP_AVCTP_PROTOCOL_DESC_LIST                                    \
+    SDP_ATTR_ID(ATTR_ID_PROTOCOL_DESC_LIST),                                    \
+        HEADSET_SDP_SEQ_1(                                                      \
+            HEADSET_SDP_SEQ_1(                                                  \
+                SDP_ATTR_UUID16(UUID_PROTOCOL_L2CAP),                           \
+                SDP_ATTR_VALUE_UINT2(BT_PSM_AVCTP)),                            \
+            HEADSET_SDP_SEQ_1(                                                  \
+                SDP_ATTR_UUID16(UUID_PROTOCOL_AVCTP),                           \
+                SDP_ATTR_VALUE_UINT2(0x0104)))
+
+// A/V Remote Control Profile Descriptor List, common to the AVRC Target and Controller
+#define HEADSET_SDP_AVRC_PROFILE_DESC_LIST(version)                             \
+    SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST),                                  \
+        HEADSET_SDP_SEQ_1(                                                      \
+            HEADSET_SDP_SEQ_1(                                                  \
+                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REMOTE_CONTROL),              \
+                SDP_ATTR_VALUE_UINT2(version)))
+
+// SDP Record for A2DP Sink
+#define HEADSET_SDP_RECORD_A2DP_SINK                                            \
+    HEADSET_SDP_SEQ_1(                                                          \
+        SDP_ATTR_RECORD_HANDLE(HANDLE_AVDT_SINK),                               \
+        SDP_ATTR_CLASS_ID(UUID_SERVCLASS_AUDIO_SINK),                           \
+        SDP_ATTR_ID(ATTR_ID_PROTOCOL_DESC_LIST),                                \
+            HEADSET_SDP_SEQ_1(                                                  \
+                HEADSET_SDP_SEQ_1(                                              \
+                    SDP_ATTR_UUID16(UUID_PROTOCOL_L2CAP),                       \
+                    SDP_ATTR_VALUE_UINT2(BT_PSM_AVDTP)),                        \
+                HEADSET_SDP_SEQ_1(                                              \
+                    SDP_ATTR_UUID16(UUID_PROTOCOL_AVDTP),                       \
+                    SDP_ATTR_VALUE_UINT2(AVDT_VERSION_1_3))),                   \
+        SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST),                              \
+            HEADSET_SDP_SEQ_1(                                                  \
+                HEADSET_SDP_SEQ_1(                                              \
+                    SDP_ATTR_UUID16(UUID_SERVCLASS_ADV_AUDIO_DISTRIBUTION),     \
+                    SDP_ATTR_VALUE_UINT2(AVDT_VERSION_1_3))),                   \
+        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, 0x000B),                     \
+        SDP_ATTR_SERVICE_NAME(16),                                              \
+            'W', 'I', 'C', 'E', 'D', ' ', 'A', 'u', 'd', 'i', 'o', ' ', 'S', 'i', 'n', 'k')
+
+// SDP Record for AVRC Target
+#define HEADSET_SDP_RECORD_AVRC_TARGET                                          \
+    HEADSET_SDP_SEQ_1(                                                          \
+        SDP_ATTR_RECORD_HANDLE(HANDLE_AVRC_TARGET),                             \
+        SDP_ATTR_ID(ATTR_ID_SERVICE_CLASS_ID_LIST),                             \
+            HEADSET_SDP_SEQ_1(                                                  \
+                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REM_CTRL_TARGET)),            \
+        HEADSET_SDP_AVCTP_PROTOCOL_DESC_LIST,                                   \
+        HEADSET_SDP_AVRC_PROFILE_DESC_LIST(AVRC_REV_1_5),                       \
+        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, AVRC_SUPF_TG_CAT2))
+
+// SDP Record for AVRC Controller
+#define HEADSET_SDP_RECORD_AVRC_CONTROLLER                                      \
+    HEADSET_SDP_SEQ_1(                                                          \
+        SDP_ATTR_RECORD_HANDLE(HANDLE_AVRC_CONTROLLER),                         \
+        SDP_ATTR_ID(ATTR_ID_SERVICE_CLASS_ID_LIST),                             \
+            HEADSET_SDP_SEQ_1(                                                  \
+                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REMOTE_CONTROL),              \
+                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REM_CTRL_CONTROL)),           \
+        HEADSET_SDP_AVCTP_PROTOCOL_DESC_LIST,                                   \
+        HEADSET_SDP_AVRC_PROFILE_DESC_LIST(AVRC_REV_1_3),                       \
+        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, AVRC_SUPF_CT_CAT1))
+
+// SDP Record for Hands-Free Unit
+#define HEADSET_SDP_RECORD_HANDSFREE                                            \
+    HEADSET_SDP_SEQ_1(                                                          \
+        SDP_ATTR_RECORD_HANDLE(WICED_HANDSFREE_HDLR_UNIT),                      \
+        SDP_ATTR_ID(ATTR_ID_SERVICE_CLASS_ID_LIST),                             \
+            HEADSET_SDP_SEQ_1(                                                  \
+                SDP_ATTR_UUID16(UUID_SERVCLASS_HF_HANDSFREE),                   \
+                SDP_ATTR_UUID16(UUID_SERVCLASS_GENERIC_AUDIO)),                 \
+        SDP_ATTR_RFCOMM_PROTOCOL_DESC_LIST(WICED_HANDSFREE_SCN),                \
+        SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST),                              \
+            HEADSET_SDP_SEQ_1(                                                  \
+                HEADSET_SDP_SEQ_1(                                              \
+                    SDP_ATTR_UUID16(UUID_SERVCLASS_HF_HANDSFREE),               \
+                    SDP_ATTR_VALUE_UINT2(0x0107))),                             \
+        SDP_ATTR_SERVICE_NAME(15),                                              \
+            'W', 'I', 'C', 'E', 'D', ' ', 'H', 'F', ' ', 'D', 'E', 'V', 'I', 'C', 'E', \
+        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, WICED_APP_CFG_SDP_HFP_FEATURE))
+
+// SDP Record for SPP OFU
+#define HEADSET_SDP_RECORD_SPP_OFU                                              \
+    HEADSET_SDP_SEQ_1(                                                          \
+        SDP_ATTR_RECORD_HANDLE(HANDLE_OFU_SPP),                                 \
+        SDP_ATTR_CLASS_ID(UUID_SERVCLASS_SERIAL_PORT),                          \
+        SDP_ATTR_RFCOMM_PROTOCOL_DESC_LIST(OFU_SPP_RFCOMM_SCN),                 \
+        SDP_ATTR_BROWSE_LIST,                                                   \
+        SDP_ATTR_PROFILE_DESC_LIST(UUID_SERVCLASS_SERIAL_PORT, 0x0102),         \
+        SDP_ATTR_SERVICE_NAME(10),                                              \
+            'S', 'P', 'P', ' ', 'S', 'E', 'R', 'V', 'E', 'R')
+
+// Records of the optional features, each one preceded by a comma
+#ifdef HEADSET_SDP_SPP_OFU
+#define HEADSET_SDP_RECORDS_OPTIONAL    , HEADSET_SDP_RECORD_SPP_OFU
+#else
+#define HEADSET_SDP_RECORDS_OPTIONAL
+#endif
+
+#define HEADSET_SDP_RECORDS                                                     \
+    HEADSET_SDP_RECORD_A2DP_SINK,                                               \
+    HEADSET_SDP_RECORD_AVRC_TARGET,                                             \
+    HEADSET_SDP_RECORD_AVRC_CONTROLLER,                                         \
+    HEADSET_SDP_RECORD_HANDSFREE                                                \
+    HEADSET_SDP_RECORDS_OPTIONAL
+
+// Size of the database with every optional record
+#define HEADSET_SDP_DB_FULL_SIZE                                                \
+    HEADSET_SDP_LEN(HEADSET_SDP_SEQ_2(HEADSET_SDP_RECORD_A2DP_SINK,             \
+                                      HEADSET_SDP_RECORD_AVRC_TARGET,           \
+                                      HEADSET_SDP_RECORD_AVRC_CONTROLLER,       \
+                                      HEADSET_SDP_RECORD_HANDSFREE,             \
+                                      HEADSET_SDP_RECORD_SPP_OFU))
+
 const uint8_t btheadset_sdp_db[] =
 {
-    SDP_ATTR_SEQUENCE_2(
-              77 + 2                // A2DP Sink       ==> 77 + 2
-            + 56 + 2                // AVRC Target     ==> 56 + 2
-            + 59 + 2                // AVRC Controller ==> 59 + 2
-            + 75 + 2                // Handsfree       ==> 75 + 2
-            + 69 + 2                // SPP OFU         ==> 69 + 2
-            ),
-
-    // SDP Record for A2DP Sink
-    SDP_ATTR_SEQUENCE_1(77),
-        SDP_ATTR_RECORD_HANDLE(HANDLE_AVDT_SINK),
-        SDP_ATTR_CLASS_ID(UUID_SERVCLASS_AUDIO_SINK),
-        SDP_ATTR_ID(ATTR_ID_PROTOCOL_DESC_LIST),
-            SDP_ATTR_SEQUENCE_1(16),
-                SDP_ATTR_SEQUENCE_1(6),
-                    SDP_ATTR_UUID16(UUID_PROTOCOL_L2CAP),
-                    SDP_ATTR_VALUE_UINT2(BT_PSM_AVDTP),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_PROTOCOL_AVDTP),
-                SDP_ATTR_VALUE_UINT2(AVDT_VERSION_1_3),
-        SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST),
-            SDP_ATTR_SEQUENCE_1(8),
-                SDP_ATTR_SEQUENCE_1(6),
-                    SDP_ATTR_UUID16(UUID_SERVCLASS_ADV_AUDIO_DISTRIBUTION),
-                    SDP_ATTR_VALUE_UINT2(AVDT_VERSION_1_3),
-        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, 0x000B),
-        SDP_ATTR_SERVICE_NAME(16),
-        'W', 'I', 'C', 'E', 'D', ' ', 'A', 'u', 'd', 'i', 'o', ' ', 'S', 'i', 'n', 'k',
-
-    // SDP Record for AVRC Target
-    SDP_ATTR_SEQUENCE_1(56),
-        SDP_ATTR_RECORD_HANDLE(HANDLE_AVRC_TARGET),
-        SDP_ATTR_ID(ATTR_ID_SERVICE_CLASS_ID_LIST),
-            SDP_ATTR_SEQUENCE_1(3),
-                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REM_CTRL_TARGET),
-        SDP_ATTR_ID(ATTR_ID_PROTOCOL_DESC_LIST), SDP_ATTR_SEQUENCE_1(16),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_PROTOCOL_L2CAP),
-                SDP_ATTR_VALUE_UINT2(BT_PSM_AVCTP),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_PROTOCOL_AVCTP),
-                SDP_ATTR_VALUE_UINT2(0x0104),
-        SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST), SDP_ATTR_SEQUENCE_1(8),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REMOTE_CONTROL),
-                SDP_ATTR_VALUE_UINT2(AVRC_REV_1_5),
-        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, AVRC_SUPF_TG_CAT2),
-
-    // SDP Record for AVRC Controller
-    SDP_ATTR_SEQUENCE_1(59),
-        SDP_ATTR_RECORD_HANDLE(HANDLE_AVRC_CONTROLLER),
-        SDP_ATTR_ID(ATTR_ID_SERVICE_CLASS_ID_LIST),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REMOTE_CONTROL),
-                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REM_CTRL_CONTROL),
-        SDP_ATTR_ID(ATTR_ID_PROTOCOL_DESC_LIST), SDP_ATTR_SEQUENCE_1(16),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_PROTOCOL_L2CAP),
-                SDP_ATTR_VALUE_UINT2(BT_PSM_AVCTP),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_PROTOCOL_AVCTP),
-                SDP_ATTR_VALUE_UINT2(0x104),
-        SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST), SDP_ATTR_SEQUENCE_1(8),
-            SDP_ATTR_SEQUENCE_1(6),
-                SDP_ATTR_UUID16(UUID_SERVCLASS_AV_REMOTE_CONTROL),
-                SDP_ATTR_VALUE_UINT2(AVRC_REV_1_3),
-        SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, AVRC_SUPF_CT_CAT1),
-
-        // SDP Record for Hands-Free Unit
-            SDP_ATTR_SEQUENCE_1(75),
-                SDP_ATTR_RECORD_HANDLE(WICED_HANDSFREE_HDLR_UNIT),
-                SDP_ATTR_ID(ATTR_ID_SERVICE_CLASS_ID_LIST), SDP_ATTR_SEQUENCE_1(6),
-                    SDP_ATTR_UUID16(UUID_SERVCLASS_HF_HANDSFREE),
-                    SDP_ATTR_UUID16(UUID_SERVCLASS_GENERIC_AUDIO),
-                SDP_ATTR_RFCOMM_PROTOCOL_DESC_LIST(WICED_HANDSFREE_SCN),
-                SDP_ATTR_ID(ATTR_ID_BT_PROFILE_DESC_LIST), SDP_ATTR_SEQUENCE_1(8),
-                    SDP_ATTR_SEQUENCE_1(6),
-                        SDP_ATTR_UUID16(UUID_SERVCLASS_HF_HANDSFREE),
-                        SDP_ATTR_VALUE_UINT2(0x0107),
-                SDP_ATTR_SERVICE_NAME(15),
-                    'W', 'I', 'C', 'E', 'D', ' ', 'H', 'F', ' ', 'D', 'E', 'V', 'I', 'C', 'E',
-                SDP_ATTR_UINT2(ATTR_ID_SUPPORTED_FEATURES, WICED_APP_CFG_SDP_HFP_FEATURE),
-
-    // SDP Record for SPP OFU
-    SDP_ATTR_SEQUENCE_1(69),                                            // 2 bytes
-        SDP_ATTR_RECORD_HANDLE(HANDLE_OFU_SPP),                         // 8 bytes
-        SDP_ATTR_CLASS_ID(UUID_SERVCLASS_SERIAL_PORT),                  // 8
-        SDP_ATTR_RFCOMM_PROTOCOL_DESC_LIST(OFU_SPP_RFCOMM_SCN),         // 17 bytes
-        SDP_ATTR_BROWSE_LIST,                                           // 8
-        SDP_ATTR_PROFILE_DESC_LIST(UUID_SERVCLASS_SERIAL_PORT, 0x0102), // 13 byte
-        SDP_ATTR_SERVICE_NAME(10),                                      // 15
-        'S', 'P', 'P', ' ', 'S', 'E', 'R', 'V', 'E', 'R',
+    HEADSET_SDP_SEQ_2(HEADSET_SDP_RECORDS)
 };
 
 
@@ -640,6 +688,16 @@ uint16_t wiced_app_cfg_sdp_record_get_size(void)
     return (uint16_t)sizeof(btheadset_sdp_db);
 }
 
+/*
+ * wiced_app_cfg_sdp_record_get_saved
+ *
+ * Bytes of the SDP records left out of the build.
+ */
+uint16_t wiced_app_cfg_sdp_record_get_saved(void)
+{
+    return (uint16_t)(HEADSET_SDP_DB_FULL_SIZE - sizeof(btheadset_sdp_db));
+}
+
 /*
  * wiced_app_cfg_buf_pools_get_num
  */
@@ -49,6 +49,9 @@ enum
     OFU_SPP_RFCOMM_SCN = 2,
 };
 
+/* L2CAP MTU of the application channels */
+#define WICED_APP_CFG_MAX_RX_MTU    1000
+
 extern const wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 #ifndef BTSTACK_VER
 extern const wiced_bt_cfg_buf_pool_t wiced_app_cfg_buf_pools[];
@@ -56,5 +59,6 @@ extern const wiced_bt_cfg_buf_pool_t wiced_app_cfg_buf_pools[];
 extern const wiced_bt_audio_config_buffer_t wiced_bt_audio_buf_config;
 extern int wiced_app_cfg_get_num_buf_pools(void);
 uint16_t wiced_app_cfg_sdp_record_get_size(void);
+uint16_t wiced_app_cfg_sdp_record_get_saved(void);
 
 #endif /* _WICED_APP_CFG_H_ */